@@ -0,0 +1,39 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+
+#include "io/NodeWriter.h"
+#include "mdl/WorldNode.h"
+
+#include <sstream>
+
+namespace tb
+{
+const vm::bbox3d BenchmarkWorldBounds = vm::bbox3d{32768.0};
+
+std::string writeWorld(const mdl::WorldNode& worldNode, kdl::task_manager& taskManager)
+{
+  auto stream = std::stringstream{};
+  auto writer = io::NodeWriter{worldNode, stream};
+  writer.writeMap(taskManager);
+  return stream.str();
+}
+
+} // namespace tb
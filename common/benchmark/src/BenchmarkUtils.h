@@ -0,0 +1,48 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/bbox.h"
+
+#include <string>
+
+namespace kdl
+{
+class task_manager;
+}
+
+namespace tb
+{
+namespace mdl
+{
+class WorldNode;
+} // namespace mdl
+
+/**
+ * The world bounds used to create and read brushes in the benchmarks.
+ */
+extern const vm::bbox3d BenchmarkWorldBounds;
+
+/**
+ * Returns the map file contents for the given world.
+ */
+std::string writeWorld(const mdl::WorldNode& worldNode, kdl::task_manager& taskManager);
+
+} // namespace tb
@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "el/ELParser.h"
+#include "el/EvaluationContext.h"
+#include "el/Expression.h"
+#include "el/VariableStore.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/EntityPropertiesVariableStore.h"
+#include "mdl/ModelDefinition.h"
+
+#include "kd/result.h"
+
+#include <format>
+#include <string>
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::el
+{
+namespace
+{
+
+constexpr auto ModelExpression = R"({{
+  spawnflags == 1 -> { path: "maps/b_bh100.bsp", skin: skin },
+  spawnflags == 2 -> { path: "maps/b_bh10.bsp", skin: skin },
+                     { path: "maps/b_bh25.bsp", skin: skin }
+}})";
+
+/**
+ * Returns item entities whose model depends on their spawnflags and skin properties.
+ */
+std::vector<mdl::Entity> makeItemEntities(const size_t count)
+{
+  auto result = std::vector<mdl::Entity>{};
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    result.push_back(mdl::Entity{{
+      {mdl::EntityPropertyKeys::Classname, "item_health"},
+      {mdl::EntityPropertyKeys::Origin, std::format("{} 0 0", i * 32)},
+      {"spawnflags", std::to_string(i % 3)},
+      {"skin", std::to_string(i % 4)},
+    }});
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("Expression", "[benchmark]")
+{
+  const auto expression = ELParser::parseStrict(ModelExpression) | kdl::value();
+  const auto variables = VariableTable{{
+    {"spawnflags", Value{2}},
+    {"skin", Value{1}},
+  }};
+
+  BENCHMARK("parse") { return ELParser::parseStrict(ModelExpression); };
+
+  BENCHMARK("evaluate")
+  {
+    return withEvaluationContext(
+      [&](auto& context) { return expression.evaluate(context); }, variables);
+  };
+
+  const auto compiledExpression = expression.compile();
+  BENCHMARK("evaluate compiled")
+  {
+    return withEvaluationContext(
+      [&](auto& context) { return compiledExpression.evaluate(context); }, variables);
+  };
+}
+
+TEST_CASE("ModelDefinition", "[benchmark]")
+{
+  const auto entities = makeItemEntities(50'000);
+  const auto expression = ELParser::parseStrict(ModelExpression) | kdl::value();
+
+  BENCHMARK("evaluate model expression for 50k entities")
+  {
+    auto count = size_t(0);
+    for (const auto& entity : entities)
+    {
+      const auto variableStore = mdl::EntityPropertiesVariableStore{entity};
+      count += withEvaluationContext(
+                 [&](auto& context) { return expression.evaluate(context); },
+                 variableStore)
+                 .is_success();
+    }
+    return count;
+  };
+
+  BENCHMARK("modelSpecification for 50k entities")
+  {
+    // the model definition caches specifications, so create a new one per run
+    const auto modelDefinition = mdl::ModelDefinition{expression};
+
+    auto count = size_t(0);
+    for (const auto& entity : entities)
+    {
+      const auto variableStore = mdl::EntityPropertiesVariableStore{entity};
+      count += modelDefinition.modelSpecification(variableStore).is_success();
+    }
+    return count;
+  };
+}
+
+} // namespace tb::el
@@ -0,0 +1,190 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Logger.h"
+#include "fs/DiskFileSystem.h"
+#include "fs/IdPakFileSystem.h"
+#include "fs/TestEnvironment.h"
+#include "fs/TestUtils.h"
+#include "fs/VirtualFileSystem.h"
+#include "fs/WadFileSystem.h"
+#include "io/LoadMaterialCollections.h"
+#include "mdl/GameConfig.h"
+#include "mdl/MaterialCollection.h"
+#include "mdl/Resource.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureResource.h"
+
+#include "kd/result.h"
+#include "kd/task_manager.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto PakEntryNameLength = size_t(56);
+
+std::string readBinaryFile(const std::filesystem::path& path)
+{
+  auto stream = std::ifstream{path, std::ios::in | std::ios::binary};
+  return std::string{std::istreambuf_iterator<char>{stream}, {}};
+}
+
+void writeInt32(std::ostream& stream, const int32_t value)
+{
+  for (size_t i = 0; i < 4; ++i)
+  {
+    stream.put(char((value >> (8 * i)) & 0xff));
+  }
+}
+
+/**
+ * Writes a Quake pak file containing the given entries.
+ */
+void writePak(
+  const std::filesystem::path& path,
+  const std::vector<std::pair<std::string, std::string>>& entries)
+{
+  auto stream = std::ofstream{path, std::ios::out | std::ios::binary};
+
+  constexpr auto HeaderSize = int32_t(12);
+  auto directoryOffset = HeaderSize;
+  for (const auto& [name, contents] : entries)
+  {
+    directoryOffset += int32_t(contents.size());
+  }
+
+  stream.write("PACK", 4);
+  writeInt32(stream, directoryOffset);
+  writeInt32(stream, int32_t(entries.size() * (PakEntryNameLength + 8)));
+
+  for (const auto& [name, contents] : entries)
+  {
+    stream.write(contents.data(), std::streamsize(contents.size()));
+  }
+
+  auto offset = HeaderSize;
+  for (const auto& [name, contents] : entries)
+  {
+    auto paddedName = name;
+    paddedName.resize(PakEntryNameLength, '\0');
+    stream.write(paddedName.data(), std::streamsize(paddedName.size()));
+    writeInt32(stream, offset);
+    writeInt32(stream, int32_t(contents.size()));
+    offset += int32_t(contents.size());
+  }
+}
+
+auto createResource(mdl::ResourceLoader<mdl::Texture> resourceLoader)
+{
+  auto resource = std::make_shared<mdl::TextureResource>(std::move(resourceLoader));
+  resource->loadSync();
+  return resource;
+}
+
+} // namespace
+
+TEST_CASE("loadMaterialCollections", "[benchmark]")
+{
+  auto logger = NullLogger{};
+  auto taskManager = kdl::task_manager{};
+
+  const auto workDir = std::filesystem::current_path();
+
+  SECTION("WAD file")
+  {
+    const auto wadPath = workDir / "fixture/test/io/Wad/cr8_czg.wad";
+
+    auto fs = fs::VirtualFileSystem{};
+    fs.mount("", std::make_unique<fs::DiskFileSystem>(workDir)); // to find the palette
+    fs.mount("textures", fs::openFS<fs::WadFileSystem>(wadPath));
+
+    const auto materialConfig = mdl::MaterialConfig{
+      "textures",
+      {".D"},
+      "fixture/test/palette.lmp",
+      "wad",
+      "",
+      {},
+    };
+
+    BENCHMARK("load materials from wad")
+    {
+      return loadMaterialCollections(
+        fs, materialConfig, createResource, taskManager, logger);
+    };
+  }
+
+  SECTION("Pak file")
+  {
+    // a pak file with 8 collections of Quake 2 textures and their palette
+    const auto walDir = workDir / "fixture/test/io/Wal/rtz";
+    auto entries = std::vector<std::pair<std::string, std::string>>{
+      {"pics/colormap.pcx", readBinaryFile(workDir / "fixture/test/colormap.pcx")},
+    };
+    for (const auto& entry : std::filesystem::directory_iterator{walDir})
+    {
+      const auto contents = readBinaryFile(entry.path());
+      for (size_t i = 0; i < 8; ++i)
+      {
+        entries.emplace_back(
+          std::format("textures/set{}/{}", i, entry.path().filename().string()),
+          contents);
+      }
+    }
+
+    const auto env = fs::TestEnvironment{};
+    const auto pakPath = env.dir() / "pak0.pak";
+    writePak(pakPath, entries);
+
+    auto fs = fs::VirtualFileSystem{};
+    fs.mount("", fs::openFS<fs::IdPakFileSystem>(pakPath));
+
+    const auto materialConfig = mdl::MaterialConfig{
+      "textures",
+      {".wal"},
+      "pics/colormap.pcx",
+      std::nullopt,
+      "",
+      {},
+    };
+
+    BENCHMARK("load materials from pak")
+    {
+      return loadMaterialCollections(
+        fs, materialConfig, createResource, taskManager, logger);
+    };
+  }
+}
+
+} // namespace tb::io
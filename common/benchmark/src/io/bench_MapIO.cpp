@@ -0,0 +1,110 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+#include "Logger.h"
+#include "SimpleParserStatus.h"
+#include "fs/DiskIO.h"
+#include "fs/File.h"
+#include "fs/Reader.h"
+#include "io/StandardMapParser.h"
+#include "io/WorldReader.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/MapFormat.h"
+#include "mdl/MapGenerator.h"
+#include "mdl/WorldNode.h"
+
+#include "kd/result.h"
+#include "kd/task_manager.h"
+
+#include <filesystem>
+#include <string>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::io
+{
+namespace
+{
+
+std::string readFixture(const std::filesystem::path& path)
+{
+  const auto file =
+    fs::Disk::openFile(std::filesystem::current_path() / path) | kdl::value();
+  auto reader = file->reader().buffer();
+  return std::string{reader.stringView()};
+}
+
+size_t countTokens(const std::string& str)
+{
+  auto tokenizer = QuakeMapTokenizer{str};
+  auto count = size_t(0);
+  while (!tokenizer.nextToken().hasType(QuakeMapToken::Eof))
+  {
+    ++count;
+  }
+  return count;
+}
+
+std::unique_ptr<mdl::WorldNode> readWorld(
+  const std::string& str, const mdl::MapFormat mapFormat, kdl::task_manager& taskManager)
+{
+  auto logger = NullLogger{};
+  auto status = SimpleParserStatus{logger};
+  auto reader = WorldReader{str, mapFormat, mdl::EntityPropertyConfig{}};
+  return reader.read(BenchmarkWorldBounds, status, taskManager) | kdl::value();
+}
+
+} // namespace
+
+TEST_CASE("MapIO", "[benchmark]")
+{
+  auto taskManager = kdl::task_manager{};
+
+  const auto fixtureMap = readFixture("fixture/test/io/Map/rtz_q1.map");
+  const auto worldNode = mdl::generateWorld({
+    .mapFormat = mdl::MapFormat::Valve,
+    .brushCount = 10'000,
+    .brushEntityDensity = 0.2,
+    .linkedGroupCount = 50,
+  });
+  const auto syntheticMap = writeWorld(*worldNode, taskManager);
+
+  BENCHMARK("tokenize fixture map") { return countTokens(fixtureMap); };
+  BENCHMARK("tokenize 10k brushes") { return countTokens(syntheticMap); };
+
+  BENCHMARK("read fixture map")
+  {
+    return readWorld(fixtureMap, mdl::MapFormat::Standard, taskManager);
+  };
+  BENCHMARK("read 10k brushes")
+  {
+    return readWorld(syntheticMap, mdl::MapFormat::Valve, taskManager);
+  };
+
+  const auto fixtureWorldNode =
+    readWorld(fixtureMap, mdl::MapFormat::Standard, taskManager);
+  BENCHMARK("write fixture map") { return writeWorld(*fixtureWorldNode, taskManager); };
+  BENCHMARK("write 10k brushes") { return writeWorld(*worldNode, taskManager); };
+}
+
+} // namespace tb::io
@@ -0,0 +1,156 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/CircleShape.h"
+#include "mdl/MapFormat.h"
+#include "mdl/MapGenerator.h"
+#include "mdl/Polyhedron.h"
+#include "mdl/Polyhedron3.h"
+#include "mdl/Polyhedron_Instantiation.h"
+#include "mdl/WorldNode.h"
+
+#include "kd/result.h"
+
+#include "vm/constants.h"
+#include "vm/plane.h"
+#include "vm/vec.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+/**
+ * Returns points that are evenly distributed on a sphere with some noise added. The
+ * points are the same on every run.
+ */
+std::vector<vm::vec3d> makeSpherePoints(const size_t count, const double radius)
+{
+  auto rng = std::mt19937{42};
+  auto noise = std::uniform_real_distribution<double>{-0.5, 0.5};
+
+  auto result = std::vector<vm::vec3d>{};
+  result.reserve(count);
+
+  const auto goldenAngle = vm::Cd::pi() * (3.0 - std::sqrt(5.0));
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto z = 1.0 - 2.0 * (double(i) + 0.5) / double(count);
+    const auto r = std::sqrt(1.0 - z * z);
+    const auto angle = goldenAngle * double(i);
+    result.push_back(
+      vm::vec3d{std::cos(angle) * r, std::sin(angle) * r, z} * radius
+      + vm::vec3d{noise(rng), noise(rng), noise(rng)});
+  }
+  return result;
+}
+
+/**
+ * Returns planes that cut off the corners and edges of a cube with the given size that is
+ * centered at the origin.
+ */
+std::vector<vm::plane3d> makeClipPlanes(const double size)
+{
+  auto result = std::vector<vm::plane3d>{};
+  for (const auto x : {-1.0, 0.0, 1.0})
+  {
+    for (const auto y : {-1.0, 0.0, 1.0})
+    {
+      for (const auto z : {-1.0, 0.0, 1.0})
+      {
+        const auto normal = vm::vec3d{x, y, z};
+        if (vm::squared_length(normal) > 1.0)
+        {
+          result.emplace_back(size * 0.4, vm::normalize(normal));
+        }
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("Brush", "[benchmark]")
+{
+  const auto builder = BrushBuilder{MapFormat::Valve, BenchmarkWorldBounds};
+
+  BENCHMARK("create 1k cubes")
+  {
+    return generateWorld({
+      .mapFormat = MapFormat::Valve,
+      .brushCount = 1'000,
+      .lightDensity = 0.0,
+    });
+  };
+
+  const auto cylinder = builder.createCylinder(
+                          vm::bbox3d{{-64, -64, -64}, {64, 64, 64}},
+                          EdgeAlignedCircle{64},
+                          vm::axis::z,
+                          "material")
+                        | kdl::value();
+
+  BENCHMARK("create cylinder from faces")
+  {
+    return Brush::create(BenchmarkWorldBounds, cylinder.faces());
+  };
+
+  BENCHMARK("create cylinder with builder")
+  {
+    return builder.createCylinder(
+      vm::bbox3d{{-64, -64, -64}, {64, 64, 64}},
+      EdgeAlignedCircle{64},
+      vm::axis::z,
+      "material");
+  };
+}
+
+TEST_CASE("Polyhedron", "[benchmark]")
+{
+  const auto points = makeSpherePoints(100, 512.0);
+  BENCHMARK("convex hull of 100 points") { return Polyhedron3{points}; };
+
+  const auto cube = Polyhedron3{vm::bbox3d{512.0}};
+  const auto planes = makeClipPlanes(1024.0);
+  BENCHMARK("clip cube with 20 planes")
+  {
+    auto polyhedron = cube;
+    for (const auto& plane : planes)
+    {
+      polyhedron.clip(plane);
+    }
+    return polyhedron;
+  };
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/BrushNode.h"
+#include "mdl/EditorContext.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/MapGenerator.h"
+#include "mdl/PickResult.h"
+#include "mdl/WorldNode.h"
+#include "octree.h"
+
+#include "vm/bbox.h"
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <random>
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+/**
+ * Returns rays that start outside of the given bounds and point at random points inside
+ * of them. The rays are the same on every run.
+ */
+std::vector<vm::ray3d> makeRays(const vm::bbox3d& bounds, const size_t count)
+{
+  auto rng = std::mt19937{42};
+  auto x = std::uniform_real_distribution<double>{bounds.min.x(), bounds.max.x()};
+  auto y = std::uniform_real_distribution<double>{bounds.min.y(), bounds.max.y()};
+  auto z = std::uniform_real_distribution<double>{bounds.min.z(), bounds.max.z()};
+
+  const auto origin = bounds.max + bounds.size();
+
+  auto result = std::vector<vm::ray3d>{};
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto target = vm::vec3d{x(rng), y(rng), z(rng)};
+    result.emplace_back(origin, vm::normalize(target - origin));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("Picking", "[benchmark]")
+{
+  const auto worldNode = generateWorld({
+    .mapFormat = MapFormat::Valve,
+    .brushCount = 10'000,
+  });
+  const auto* layerNode = worldNode->defaultLayer();
+  const auto rays = makeRays(layerNode->logicalBounds(), 100);
+
+  const auto& nodes = layerNode->children();
+
+  BENCHMARK("build octree with 10k nodes")
+  {
+    auto tree = octree<double, Node*>{64.0};
+    for (auto* node : nodes)
+    {
+      tree.insert(node->logicalBounds(), node);
+    }
+    return tree;
+  };
+
+  auto tree = octree<double, Node*>{64.0};
+  for (auto* node : nodes)
+  {
+    tree.insert(node->logicalBounds(), node);
+  }
+
+  BENCHMARK("query octree with 100 rays")
+  {
+    auto count = size_t(0);
+    for (const auto& ray : rays)
+    {
+      count += tree.find_intersectors(ray).size();
+    }
+    return count;
+  };
+
+  const auto editorContext = EditorContext{};
+  BENCHMARK("pick 10k nodes with 100 rays")
+  {
+    auto count = size_t(0);
+    for (const auto& ray : rays)
+    {
+      auto pickResult = PickResult::byDistance();
+      worldNode->pick(editorContext, ray, pickResult);
+      count += pickResult.size();
+    }
+    return count;
+  };
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/BrushNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapFormat.h"
+#include "mdl/MapGenerator.h"
+#include "mdl/WorldNode.h"
+#include "render/BrushRenderer.h"
+
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::render
+{
+
+TEST_CASE("BrushRenderer", "[benchmark]")
+{
+  const auto worldNode = mdl::generateWorld({
+    .mapFormat = mdl::MapFormat::Valve,
+    .brushCount = 10'000,
+  });
+
+  auto brushNodes = std::vector<const mdl::BrushNode*>{};
+  for (const auto* node : worldNode->defaultLayer()->children())
+  {
+    if (const auto* brushNode = dynamic_cast<const mdl::BrushNode*>(node))
+    {
+      brushNodes.push_back(brushNode);
+    }
+  }
+
+  // only measures building the vertex and index arrays, uploading them requires an
+  // OpenGL context
+  BENCHMARK_ADVANCED("validate 10k brushes")(Catch::Benchmark::Chronometer meter)
+  {
+    auto renderers = std::vector<BrushRenderer>(size_t(meter.runs()));
+    for (auto& renderer : renderers)
+    {
+      for (const auto* brushNode : brushNodes)
+      {
+        renderer.addBrush(brushNode);
+      }
+    }
+
+    meter.measure([&](const int i) { renderers[size_t(i)].validate(); });
+  };
+}
+
+} // namespace tb::render
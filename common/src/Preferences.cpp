@@ -196,9 +196,11 @@ Preference<Color> GridColor2D("render/Grid/Color2D", RgbaF(0.8f, 0.8f, 0.8f, 0.8
 Preference<int> TextureMinFilter("render/Texture mode min filter", 0x2700);
 Preference<int> TextureMagFilter("render/Texture mode mag filter", 0x2600);
 Preference<bool> EnableMSAA("render/Enable multisampling", true);
+Preference<bool> CacheEntityModels("render/Cache entity models", true);
 
 Preference<bool> AlignmentLock("Editor/Texture lock", true);
 Preference<bool> UVLock("Editor/UV lock", false);
+Preference<bool> RecordTrace("Editor/Record trace", true);
 
 Preference<std::filesystem::path>& RendererFontPath()
 {
@@ -393,8 +395,10 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &GridColor2D,
     &TextureMinFilter,
     &TextureMagFilter,
+    &CacheEntityModels,
     &AlignmentLock,
     &UVLock,
+    &RecordTrace,
     &RendererFontPath(),
     &RendererFontSize,
     &BrowserFontSize,
@@ -133,9 +133,11 @@ extern Preference<Color> GridColor2D;
 extern Preference<int> TextureMinFilter;
 extern Preference<int> TextureMagFilter;
 extern Preference<bool> EnableMSAA;
+extern Preference<bool> CacheEntityModels;
 
 extern Preference<bool> AlignmentLock;
 extern Preference<bool> UVLock;
+extern Preference<bool> RecordTrace;
 
 Preference<std::filesystem::path>& RendererFontPath();
 extern Preference<int> RendererFontSize;
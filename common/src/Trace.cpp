@@ -0,0 +1,232 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Trace.h"
+
+#include "kd/string_format.h"
+
+#include <format>
+#include <ostream>
+
+namespace tb
+{
+namespace
+{
+
+// the time at which the worker running on this thread became busy
+thread_local auto workerBusySince = std::chrono::steady_clock::time_point{};
+
+auto nextRecorderId = std::atomic<size_t>{0};
+
+// the index of this thread in the recorder it last recorded an event in
+struct ThreadSlot
+{
+  std::optional<size_t> recorderId;
+  size_t threadIndex = 0;
+};
+
+thread_local auto threadSlot = ThreadSlot{};
+
+double toMicroseconds(const std::chrono::steady_clock::duration duration)
+{
+  return std::chrono::duration<double, std::micro>{duration}.count();
+}
+
+} // namespace
+
+TraceRecorder& TraceRecorder::instance()
+{
+  static auto instance = TraceRecorder{};
+  return instance;
+}
+
+TraceRecorder::TraceRecorder(const size_t capacity)
+  : m_id{nextRecorderId++}
+  , m_startTime{std::chrono::steady_clock::now()}
+  , m_capacity{capacity}
+{
+}
+
+bool TraceRecorder::enabled() const
+{
+  return m_enabled.load(std::memory_order_relaxed);
+}
+
+void TraceRecorder::setEnabled(const bool enabled)
+{
+  m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::setThreadName(std::string name)
+{
+  const auto index = threadIndex();
+
+  // the last slot is shared and keeps its name
+  if (index < MaxThreadCount - 1)
+  {
+    auto lock = std::lock_guard{m_mutex};
+    m_threadNames[index] = std::move(name);
+  }
+}
+
+void TraceRecorder::record(
+  const char* name,
+  std::string args,
+  const std::chrono::steady_clock::time_point begin,
+  const std::chrono::steady_clock::time_point end)
+{
+  if (!enabled())
+  {
+    return;
+  }
+
+  auto event = TraceEvent{name, std::move(args), threadIndex(), begin, end};
+
+  auto lock = std::lock_guard{m_mutex};
+  if (m_events.size() < m_capacity)
+  {
+    m_events.push_back(std::move(event));
+  }
+  else if (m_capacity > 0)
+  {
+    m_events[m_nextEvent] = std::move(event);
+    m_nextEvent = (m_nextEvent + 1) % m_capacity;
+  }
+}
+
+std::vector<TraceEvent> TraceRecorder::events() const
+{
+  auto lock = std::lock_guard{m_mutex};
+
+  // once the buffer is full, m_nextEvent is the index of the oldest event
+  auto result = std::vector<TraceEvent>{};
+  result.reserve(m_events.size());
+  result.insert(
+    result.end(), m_events.begin() + std::ptrdiff_t(m_nextEvent), m_events.end());
+  result.insert(
+    result.end(), m_events.begin(), m_events.begin() + std::ptrdiff_t(m_nextEvent));
+  return result;
+}
+
+void TraceRecorder::writeChromeTrace(std::ostream& stream) const
+{
+  const auto events = this->events();
+  const auto threadNames = [&] {
+    auto lock = std::lock_guard{m_mutex};
+    return m_threadNames;
+  }();
+
+  stream << R"({"displayTimeUnit":"ms","traceEvents":[)";
+
+  auto separator = "";
+  for (size_t i = 0; i < threadNames.size(); ++i)
+  {
+    const auto name =
+      threadNames[i].empty() ? std::format("Thread {}", i) : threadNames[i];
+    stream << separator
+           << std::format(
+                R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},)"
+                R"("args":{{"name":"{}"}}}})",
+                i,
+                kdl::str_escape_json(name));
+    separator = ",";
+  }
+
+  for (const auto& event : events)
+  {
+    stream << separator
+           << std::format(
+                R"({{"name":"{}","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f})",
+                kdl::str_escape_json(event.name),
+                event.threadIndex,
+                toMicroseconds(event.begin - m_startTime),
+                toMicroseconds(event.end - event.begin));
+    if (!event.args.empty())
+    {
+      stream << std::format(
+        R"(,"args":{{"detail":"{}"}})", kdl::str_escape_json(event.args));
+    }
+    stream << "}";
+    separator = ",";
+  }
+
+  stream << "]}";
+}
+
+size_t TraceRecorder::threadIndex()
+{
+  if (threadSlot.recorderId != m_id)
+  {
+    auto lock = std::lock_guard{m_mutex};
+    if (m_threadNames.size() < MaxThreadCount - 1)
+    {
+      m_threadNames.emplace_back();
+    }
+    else if (m_threadNames.size() == MaxThreadCount - 1)
+    {
+      m_threadNames.emplace_back("Other threads");
+    }
+    threadSlot = ThreadSlot{m_id, m_threadNames.size() - 1};
+  }
+  return threadSlot.threadIndex;
+}
+
+TraceScope::TraceScope(const char* name, std::string args)
+  : TraceScope{TraceRecorder::instance(), name, std::move(args)}
+{
+}
+
+TraceScope::TraceScope(TraceRecorder& recorder, const char* name, std::string args)
+  : m_recorder{recorder}
+  , m_name{name}
+  , m_args{std::move(args)}
+{
+  if (m_recorder.enabled())
+  {
+    m_begin = std::chrono::steady_clock::now();
+  }
+}
+
+TraceScope::~TraceScope()
+{
+  if (m_begin)
+  {
+    m_recorder.record(
+      m_name, std::move(m_args), *m_begin, std::chrono::steady_clock::now());
+  }
+}
+
+kdl::task_manager_observer makeTraceObserver(TraceRecorder& recorder)
+{
+  return {
+    [&](const size_t workerIndex) {
+      recorder.setThreadName(std::format("Worker {}", workerIndex));
+      workerBusySince = std::chrono::steady_clock::now();
+    },
+    [&](size_t, const size_t taskCount) {
+      recorder.record(
+        "Run tasks",
+        std::format("{} tasks", taskCount),
+        workerBusySince,
+        std::chrono::steady_clock::now());
+    },
+  };
+}
+
+} // namespace tb
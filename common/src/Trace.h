@@ -0,0 +1,134 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Macros.h"
+
+#include "kd/task_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace tb
+{
+
+struct TraceEvent
+{
+  // must point to a string with static storage duration
+  const char* name;
+  std::string args;
+  size_t threadIndex;
+  std::chrono::steady_clock::time_point begin;
+  std::chrono::steady_clock::time_point end;
+};
+
+/**
+ * Records trace events in a ring buffer so that the most recent events can be inspected
+ * after an operation was slow. Recording is thread safe. While recording is disabled,
+ * events are dropped without taking a lock.
+ *
+ * The threads that record events are numbered in the order in which they record their
+ * first event. Once MaxThreadCount - 1 threads have been numbered, all further threads
+ * share the last number.
+ */
+class TraceRecorder
+{
+public:
+  static constexpr size_t DefaultCapacity = 65536;
+  static constexpr size_t MaxThreadCount = 256;
+
+private:
+  const size_t m_id;
+  std::atomic<bool> m_enabled = true;
+  mutable std::mutex m_mutex;
+  std::chrono::steady_clock::time_point m_startTime;
+  size_t m_capacity;
+  std::vector<TraceEvent> m_events;
+  size_t m_nextEvent = 0;
+  std::vector<std::string> m_threadNames;
+
+public:
+  static TraceRecorder& instance();
+
+  explicit TraceRecorder(size_t capacity = DefaultCapacity);
+
+  deleteCopyAndMove(TraceRecorder);
+
+  bool enabled() const;
+  void setEnabled(bool enabled);
+
+  /**
+   * Sets the name of the calling thread that is shown in the trace.
+   */
+  void setThreadName(std::string name);
+
+  void record(
+    const char* name,
+    std::string args,
+    std::chrono::steady_clock::time_point begin,
+    std::chrono::steady_clock::time_point end);
+
+  /**
+   * Returns the recorded events from oldest to newest.
+   */
+  std::vector<TraceEvent> events() const;
+
+  /**
+   * Writes the recorded events in the Chrome trace event format, which can be opened with
+   * chrome://tracing or https://ui.perfetto.dev. Every thread gets its own track.
+   */
+  void writeChromeTrace(std::ostream& stream) const;
+
+private:
+  size_t threadIndex();
+};
+
+/**
+ * Records an event that spans the lifetime of this object.
+ */
+class TraceScope
+{
+private:
+  TraceRecorder& m_recorder;
+  const char* m_name;
+  std::string m_args;
+  // unset if the recorder was disabled when this scope began
+  std::optional<std::chrono::steady_clock::time_point> m_begin;
+
+public:
+  explicit TraceScope(const char* name, std::string args = {});
+  TraceScope(TraceRecorder& recorder, const char* name, std::string args = {});
+  ~TraceScope();
+
+  deleteCopyAndMove(TraceScope);
+};
+
+/**
+ * Returns an observer that names the worker threads of a task manager and records an
+ * event for every period in which a worker is busy.
+ */
+kdl::task_manager_observer makeTraceObserver(TraceRecorder& recorder);
+
+} // namespace tb
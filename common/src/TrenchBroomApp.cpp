@@ -23,6 +23,7 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Result.h"
+#include "Trace.h"
 #include "fs/DiskIO.h"
 #include "fs/PathInfo.h"
 #include "io/MapHeader.h"
@@ -136,10 +137,13 @@ TrenchBroomApp::TrenchBroomApp(int& argc, char** argv)
   , m_networkManager{new QNetworkAccessManager{this}}
   , m_httpClient{new upd::QtHttpClient{*m_networkManager}}
   , m_updater{new upd::Updater{*m_httpClient, makeUpdateConfig(), this}}
-  , m_taskManager{std::thread::hardware_concurrency()}
+  , m_taskManager{
+      std::thread::hardware_concurrency(), makeTraceObserver(TraceRecorder::instance())}
 {
   using namespace std::chrono_literals;
 
+  TraceRecorder::instance().setThreadName("Main thread");
+
   // When this flag is enabled, font and palette changes propagate as though the user
   // had manually called the corresponding QWidget methods.
   setAttribute(Qt::AA_UseStyleSheetPropagationInWidgetStyles);
@@ -157,6 +161,8 @@ TrenchBroomApp::TrenchBroomApp(int& argc, char** argv)
 
   applyLanguagePreference();
 
+  TraceRecorder::instance().setEnabled(pref(Preferences::RecordTrace));
+
   m_gameManager = createGameManager();
 
   loadStyleSheets();
@@ -597,6 +603,22 @@ void TrenchBroomApp::showAboutDialog()
   openAbout();
 }
 
+void TrenchBroomApp::saveTrace()
+{
+  const auto defaultPath = io::SystemPaths::userDataDirectory() / "trace.json";
+  const auto pathStr = QFileDialog::getSaveFileName(
+    nullptr, tr("Save Trace"), io::pathAsQString(defaultPath), "Trace files (*.json)");
+
+  if (const auto path = io::pathFromQString(pathStr); !path.empty())
+  {
+    fs::Disk::withOutputStream(path, [](auto& stream) {
+      TraceRecorder::instance().writeChromeTrace(stream);
+    }) | kdl::transform_error([](const auto& e) {
+      QMessageBox::critical(nullptr, "BrümSchtick", e.msg.c_str(), QMessageBox::Ok);
+    });
+  }
+}
+
 void TrenchBroomApp::debugShowCrashReportDialog()
 {
   const auto reportPath = io::SystemPaths::userDataDirectory() / "crashreport.txt";
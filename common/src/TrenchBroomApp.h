@@ -112,6 +112,7 @@ public:
   void showManual();
   void showPreferences();
   void showAboutDialog();
+  void saveTrace();
   void debugShowCrashReportDialog();
 
   bool notify(QObject* receiver, QEvent* event) override;
@@ -26,7 +26,6 @@
 #include "fs/File.h"
 #include "fs/FileSystem.h"
 #include "fs/PathInfo.h"
-#include "fs/PathMatcher.h"
 #include "fs/TraversalMode.h"
 #include "fs/ReaderException.h"
 #include "io/MaterialUtils.h"
@@ -39,11 +38,13 @@
 #include "render/IndexRangeMapBuilder.h"
 #include "render/PrimType.h"
 
+#include "kd/parallel_for.h"
 #include "kd/path_utils.h"
 #include "kd/ranges/as_rvalue_view.h"
 #include "kd/ranges/to.h"
 #include "kd/result.h"
 #include "kd/result_fold.h"
+#include "kd/string_compare.h"
 #include "kd/vector_utils.h"
 
 #include <assimp/IOStream.hpp>
@@ -54,12 +55,12 @@
 #include <assimp/types.h>
 #include <format>
 
+#include <map>
 #include <optional>
 #include <ranges>
 #include <string_view>
 #include <utility>
 
-
 namespace tb::io
 {
 
@@ -203,91 +204,13 @@ bool isEmbeddedTextureReference(const std::filesystem::path& texturePath)
   return !textureString.empty() && textureString.front() == '*';
 }
 
-std::optional<std::filesystem::path> findTextureFileInDirectory(
-  const fs::FileSystem& fs,
-  const std::filesystem::path& directory,
-  const std::filesystem::path& texturePath)
-{
-  if (directory.empty() || fs.pathInfo(directory) != fs::PathInfo::Directory)
-  {
-    return std::nullopt;
-  }
-
-  const auto basename = texturePath.stem().string();
-  if (basename.empty())
-  {
-    return std::nullopt;
-  }
-
-  const auto candidates =
-    fs.find(
-      directory, fs::TraversalMode::Flat, fs::makeFilenamePathMatcher(basename + ".*"))
-    | kdl::value_or(std::vector<std::filesystem::path>{});
-
-  for (const auto& candidate : candidates)
-  {
-    if (isSupportedFreeImageExtension(candidate.extension()))
-    {
-      return candidate;
-    }
-  }
-
-  return std::nullopt;
-}
-
-std::optional<std::filesystem::path> resolveTextureFilePath(
-  const std::filesystem::path& texturePath,
-  const std::filesystem::path& modelPath,
-  const fs::FileSystem& fs)
-{
-  if (texturePath.empty())
-  {
-    return std::nullopt;
-  }
-
-  if (fs.pathInfo(texturePath) == fs::PathInfo::File)
-  {
-    return texturePath;
-  }
-
-  if (!texturePath.has_root_path())
-  {
-    const auto relativePath = modelPath.parent_path() / texturePath;
-    if (fs.pathInfo(relativePath) == fs::PathInfo::File)
-    {
-      return relativePath;
-    }
-  }
-
-  if (auto match = findTextureFileInDirectory(fs, texturePath.parent_path(), texturePath))
-  {
-    return match;
-  }
-
-  if (!texturePath.has_root_path())
-  {
-    const auto relativeDir = modelPath.parent_path() / texturePath.parent_path();
-    if (auto match = findTextureFileInDirectory(fs, relativeDir, texturePath))
-    {
-      return match;
-    }
-  }
-
-  if (auto match = findTextureFileInDirectory(fs, modelPath.parent_path(), texturePath))
-  {
-    return match;
-  }
-
-  return std::nullopt;
-}
-
 mdl::Texture loadTextureFromFileSystem(
   const std::filesystem::path& texturePath,
+  const std::optional<std::filesystem::path>& resolvedPath,
   const std::filesystem::path& modelPath,
   const fs::FileSystem& fs,
   Logger& logger)
 {
-  const auto resolvedPath = resolveTextureFilePath(texturePath, modelPath, fs);
   if (!resolvedPath)
   {
     logger.error() << std::format(
@@ -327,17 +250,131 @@ Result<mdl::Texture> loadCompressedEmbeddedTexture(
   return readFreeImageTextureFromMemory(reinterpret_cast<const uint8_t*>(&data), size);
 }
 
+/**
+ * A texture of a surface. If no diffuse textures are found for the surface's material, it
+ * has a single texture without a path.
+ */
+struct AssimpTextureReference
+{
+  size_t surfaceIndex;
+  std::filesystem::path texturePath;
+  const aiTexture* embeddedTexture = nullptr;
+  std::optional<std::filesystem::path> resolvedPath = std::nullopt;
+};
+
+std::vector<AssimpTextureReference> getTextureReferences(
+  const aiScene& scene, const std::filesystem::path& modelPath, Logger& logger)
+{
+  auto result = std::vector<AssimpTextureReference>{};
+
+  for (size_t surfaceIndex = 0; surfaceIndex < scene.mNumMeshes; ++surfaceIndex)
+  {
+    // an assimp mesh will only ever have one material, but a material can have
+    // multiple alternatives (this is how assimp handles skins)
+    const auto materialIndex = scene.mMeshes[surfaceIndex]->mMaterialIndex;
+    const auto& material = *scene.mMaterials[materialIndex];
+
+    // Is there even a single diffuse texture? If not, load fallback texture.
+    const auto textureCount = material.GetTextureCount(aiTextureType_DIFFUSE);
+    if (textureCount == 0)
+    {
+      logger.error() << std::format(
+        "No diffuse textures found for material {} of model '{}', loading fallback "
+        "texture",
+        materialIndex,
+        modelPath.string());
+
+      result.push_back({surfaceIndex, {}});
+      continue;
+    }
+
+    // load up every diffuse texture
+    for (unsigned int ti = 0; ti < textureCount; ++ti)
+    {
+      auto path = aiString{};
+      material.GetTexture(aiTextureType_DIFFUSE, ti, &path);
+
+      result.push_back(
+        {surfaceIndex,
+         std::filesystem::path{path.C_Str()},
+         scene.GetEmbeddedTexture(path.C_Str())});
+    }
+  }
+
+  return result;
+}
+
+/**
+ * Resolves the paths of all textures that are not embedded. Every distinct path is
+ * resolved once, and the distinct paths are resolved in parallel.
+ */
+void resolveTexturePaths(
+  std::vector<AssimpTextureReference>& textureReferences,
+  const std::filesystem::path& modelPath,
+  const fs::FileSystem& fs,
+  AssimpTexturePathCache& texturePathCache,
+  const RecordAssimpTexturePathLookup& recordLookup,
+  kdl::task_manager& taskManager)
+{
+  using ResolvedPaths =
+    std::map<std::filesystem::path, std::optional<std::filesystem::path>>;
+
+  auto uniquePaths = ResolvedPaths{};
+  for (const auto& textureReference : textureReferences)
+  {
+    if (!textureReference.embeddedTexture && !textureReference.texturePath.empty())
+    {
+      uniquePaths.emplace(textureReference.texturePath, std::nullopt);
+    }
+  }
+
+  auto pathsToResolve = uniquePaths | std::views::keys
+                        | std::views::transform([](const auto& path) { return &path; })
+                        | kdl::ranges::to<std::vector>();
+  auto resolvedPaths =
+    std::vector<std::optional<std::filesystem::path>>(pathsToResolve.size());
+
+  kdl::parallel_for(taskManager, pathsToResolve.size(), 1, [&](const size_t i) {
+    resolvedPaths[i] =
+      texturePathCache.resolve(fs, *pathsToResolve[i], modelPath, recordLookup);
+  });
+
+  for (size_t i = 0; i < pathsToResolve.size(); ++i)
+  {
+    uniquePaths[*pathsToResolve[i]] = std::move(resolvedPaths[i]);
+  }
+
+  for (auto& textureReference : textureReferences)
+  {
+    if (const auto it = uniquePaths.find(textureReference.texturePath);
+        !textureReference.embeddedTexture && it != uniquePaths.end())
+    {
+      textureReference.resolvedPath = it->second;
+    }
+  }
+}
+
 mdl::Texture loadTexture(
-  const aiTexture* texture,
-  const std::filesystem::path& texturePath,
+  const AssimpTextureReference& textureReference,
   const std::filesystem::path& modelPath,
   const fs::FileSystem& fs,
+  AssimpTexturePathCache& texturePathCache,
+  const RecordAssimpTexturePathLookup& recordLookup,
   Logger& logger)
 {
+  const auto& texturePath = textureReference.texturePath;
+  const auto* texture = textureReference.embeddedTexture;
+
+  if (texturePath.empty())
+  {
+    return loadFallbackOrDefaultTexture(fs, logger);
+  }
+
   if (!texture)
   {
     // The texture is not embedded. Load it using the file system.
-    return loadTextureFromFileSystem(texturePath, modelPath, fs, logger);
+    return loadTextureFromFileSystem(
+      texturePath, textureReference.resolvedPath, modelPath, fs, logger);
   }
 
   if (texture->mHeight != 0)
@@ -365,45 +402,44 @@ mdl::Texture loadTexture(
     return loadFallbackOrDefaultTexture(fs, logger);
   }
 
-  return loadTextureFromFileSystem(texturePath, modelPath, fs, logger);
+  return loadTextureFromFileSystem(
+    texturePath,
+    texturePathCache.resolve(fs, texturePath, modelPath, recordLookup),
+    modelPath,
+    fs,
+    logger);
 }
 
-std::vector<mdl::Texture> loadTexturesForMaterial(
+/**
+ * Loads the skins of every surface of the given scene. The texture paths are resolved
+ * first, then all embedded and external textures are decoded in parallel.
+ */
+std::vector<std::vector<mdl::Material>> loadSkins(
   const aiScene& scene,
-  const size_t materialIndex,
   const std::filesystem::path& modelPath,
   const fs::FileSystem& fs,
+  AssimpTexturePathCache& texturePathCache,
+  const RecordAssimpTexturePathLookup& recordLookup,
+  kdl::task_manager& taskManager,
   Logger& logger)
 {
-  auto textures = std::vector<mdl::Texture>{};
-
-  // Is there even a single diffuse texture? If not, fail and load fallback texture.
-  const auto textureCount =
-    scene.mMaterials[materialIndex]->GetTextureCount(aiTextureType_DIFFUSE);
-  if (textureCount > 0)
+  auto textureReferences = getTextureReferences(scene, modelPath, logger);
+  resolveTexturePaths(
+    textureReferences, modelPath, fs, texturePathCache, recordLookup, taskManager);
+
+  auto textures = std::vector<std::optional<mdl::Texture>>(textureReferences.size());
+  kdl::parallel_for(taskManager, textureReferences.size(), 1, [&](const size_t i) {
+    textures[i] = loadTexture(
+      textureReferences[i], modelPath, fs, texturePathCache, recordLookup, logger);
+  });
+
+  auto skins = std::vector<std::vector<mdl::Material>>(scene.mNumMeshes);
+  for (size_t i = 0; i < textureReferences.size(); ++i)
   {
-    // load up every diffuse texture
-    for (unsigned int ti = 0; ti < textureCount; ++ti)
-    {
-      auto path = aiString{};
-      scene.mMaterials[materialIndex]->GetTexture(aiTextureType_DIFFUSE, ti, &path);
-
-      const auto texturePath = std::filesystem::path{path.C_Str()};
-      const auto* texture = scene.GetEmbeddedTexture(path.C_Str());
-      textures.push_back(loadTexture(texture, texturePath, modelPath, fs, logger));
-    }
-  }
-  else
-  {
-    logger.error() << std::format(
-      "No diffuse textures found for material {} of model '{}', loading fallback texture",
-      materialIndex,
-      modelPath.string());
-
-    textures.push_back(loadFallbackOrDefaultTexture(fs, logger));
+    auto textureResource = createTextureResource(std::move(*textures[i]));
+    skins[textureReferences[i].surfaceIndex].emplace_back("", std::move(textureResource));
   }
-
-  return textures;
+  return skins;
 }
 
 struct AssimpComputedMeshData
@@ -906,9 +942,186 @@ Result<void> loadSceneFrame(
 
 } // namespace
 
-AssimpLoader::AssimpLoader(std::filesystem::path path, const fs::FileSystem& fs)
+std::optional<std::filesystem::path> AssimpTexturePathCache::resolve(
+  const fs::FileSystem& fs,
+  const std::filesystem::path& texturePath,
+  const std::filesystem::path& modelPath,
+  const RecordAssimpTexturePathLookup& recordLookup)
+{
+  if (texturePath.empty())
+  {
+    return std::nullopt;
+  }
+
+  const auto modelDirectory = modelPath.parent_path();
+  auto key = ResolvedPathKey{modelDirectory, texturePath};
+
+  auto cachedPath = std::optional<ResolvedPath>{};
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (const auto it = m_resolvedPaths.find(key); it != m_resolvedPaths.end())
+    {
+      cachedPath = it->second;
+    }
+  }
+
+  if (cachedPath)
+  {
+    if (recordLookup)
+    {
+      for (const auto& lookup : cachedPath->lookups)
+      {
+        recordLookup(lookup.path, lookup.pathInfo);
+      }
+    }
+    return std::move(cachedPath->path);
+  }
+
+  // The file system is probed without holding the lock. If another thread resolves the
+  // same path concurrently, both arrive at the same result.
+  auto lookups = std::vector<Lookup>{};
+  const auto isFile = [&](const std::filesystem::path& path) {
+    const auto pathInfo = fs.pathInfo(path);
+    lookups.push_back({path, pathInfo});
+    return pathInfo == fs::PathInfo::File;
+  };
+  const auto findInDirectory = [&](const std::filesystem::path& directory) {
+    return findTextureFileInDirectory(fs, directory, texturePath, lookups, recordLookup);
+  };
+
+  auto resolvedPath = [&]() -> std::optional<std::filesystem::path> {
+    if (isFile(texturePath))
+    {
+      return texturePath;
+    }
+
+    if (!texturePath.has_root_path())
+    {
+      const auto relativePath = modelDirectory / texturePath;
+      if (isFile(relativePath))
+      {
+        return relativePath;
+      }
+    }
+
+    if (auto match = findInDirectory(texturePath.parent_path()))
+    {
+      return match;
+    }
+
+    if (!texturePath.has_root_path())
+    {
+      if (auto match = findInDirectory(modelDirectory / texturePath.parent_path()))
+      {
+        return match;
+      }
+    }
+
+    return findInDirectory(modelDirectory);
+  }();
+
+  const auto lock = std::lock_guard{m_mutex};
+  m_resolvedPaths.emplace(std::move(key), ResolvedPath{resolvedPath, std::move(lookups)});
+  return resolvedPath;
+}
+
+void AssimpTexturePathCache::clear()
+{
+  const auto lock = std::lock_guard{m_mutex};
+  m_resolvedPaths.clear();
+  m_directoryContents.clear();
+}
+
+std::optional<std::filesystem::path> AssimpTexturePathCache::findTextureFileInDirectory(
+  const fs::FileSystem& fs,
+  const std::filesystem::path& directory,
+  const std::filesystem::path& texturePath,
+  std::vector<Lookup>& lookups,
+  const RecordAssimpTexturePathLookup& recordLookup)
+{
+  const auto basename = texturePath.stem().string();
+  if (directory.empty() || basename.empty())
+  {
+    return std::nullopt;
+  }
+
+  const auto pattern = basename + ".*";
+  for (const auto& candidate : directoryContents(fs, directory, lookups, recordLookup))
+  {
+    if (
+      kdl::ci::str_matches_glob(candidate.filename().string(), pattern)
+      && isSupportedFreeImageExtension(candidate.extension()))
+    {
+      return candidate;
+    }
+  }
+
+  return std::nullopt;
+}
+
+std::vector<std::filesystem::path> AssimpTexturePathCache::directoryContents(
+  const fs::FileSystem& fs,
+  const std::filesystem::path& directory,
+  std::vector<Lookup>& lookups,
+  const RecordAssimpTexturePathLookup& recordLookup)
+{
+  // the directory is listed only if it exists
+  const auto addLookups = [&](const fs::PathInfo pathInfo, const bool skipped) {
+    auto directoryLookups = std::vector<Lookup>{{directory, pathInfo}};
+    if (pathInfo == fs::PathInfo::Directory)
+    {
+      directoryLookups.push_back({directory, std::nullopt});
+    }
+
+    for (auto& lookup : directoryLookups)
+    {
+      if (skipped && recordLookup)
+      {
+        recordLookup(lookup.path, lookup.pathInfo);
+      }
+      lookups.push_back(std::move(lookup));
+    }
+  };
+
+  auto cachedContents = std::optional<DirectoryContents>{};
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (const auto it = m_directoryContents.find(directory);
+        it != m_directoryContents.end())
+    {
+      cachedContents = it->second;
+    }
+  }
+
+  if (cachedContents)
+  {
+    addLookups(cachedContents->pathInfo, true);
+    return std::move(cachedContents->paths);
+  }
+
+  const auto pathInfo = fs.pathInfo(directory);
+  auto paths = pathInfo == fs::PathInfo::Directory
+                 ? fs.find(directory, fs::TraversalMode::Flat)
+                     | kdl::value_or(std::vector<std::filesystem::path>{})
+                 : std::vector<std::filesystem::path>{};
+  addLookups(pathInfo, false);
+
+  const auto lock = std::lock_guard{m_mutex};
+  m_directoryContents.emplace(directory, DirectoryContents{pathInfo, paths});
+  return paths;
+}
+
+AssimpLoader::AssimpLoader(
+  std::filesystem::path path,
+  const fs::FileSystem& fs,
+  kdl::task_manager& taskManager,
+  std::shared_ptr<AssimpTexturePathCache> texturePathCache,
+  RecordAssimpTexturePathLookup recordTexturePathLookup)
   : m_path{std::move(path)}
   , m_fs{fs}
+  , m_taskManager{taskManager}
+  , m_texturePathCache{std::move(texturePathCache)}
+  , m_recordTexturePathLookup{std::move(recordTexturePathLookup)}
 {
 }
 
@@ -935,11 +1148,6 @@ bool AssimpLoader::canParse(const std::filesystem::path& path)
 
 Result<mdl::EntityModelData> AssimpLoader::load(tb::Logger& logger)
 {
-  const auto createMaterial = [](auto texture) {
-    auto textureResource = createTextureResource(std::move(texture));
-    return mdl::Material{"", std::move(textureResource)};
-  };
-
   try
   {
     constexpr auto assimpFlags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices
@@ -968,29 +1176,44 @@ Result<mdl::EntityModelData> AssimpLoader::load(tb::Logger& logger)
     // if we have no animations, always load 1 frame for the reference model
     const auto numSequences = std::max(scene->mNumAnimations, 1u);
 
-    // create a surface for each mesh in the scene and assign the skins/materials to it
+    // create a surface for each mesh in the scene
     const auto numMeshes = scene->mNumMeshes;
     for (size_t i = 0; i < numMeshes; ++i)
     {
-      const auto& mesh = scene->mMeshes[i];
-
-      auto& surface = data.addSurface(scene->mMeshes[i]->mName.data, numSequences);
+      data.addSurface(scene->mMeshes[i]->mName.data, numSequences);
+    }
 
-      // an assimp mesh will only ever have one material, but a material can have
-      // multiple alternatives (this is how assimp handles skins)
+    // The skins are loaded while the frames are built from the scene.
+    auto framesResult = Result<void>{};
+    auto skins = std::vector<std::vector<mdl::Material>>{};
+    kdl::parallel_for(m_taskManager, 2, 1, [&](const size_t i) {
+      if (i == 0)
+      {
+        framesResult = std::views::iota(0u, numSequences)
+                       | std::views::transform([&](const auto j) {
+                           return loadSceneFrame(*scene, j, data, modelPath);
+                         })
+                       | kdl::fold;
+      }
+      else
+      {
+        skins = loadSkins(
+          *scene,
+          m_path,
+          m_fs,
+          *m_texturePathCache,
+          m_recordTexturePathLookup,
+          m_taskManager,
+          logger);
+      }
+    });
 
-      // load skins for this surface
-      auto materials =
-        loadTexturesForMaterial(*scene, mesh->mMaterialIndex, m_path, m_fs, logger)
-        | kdl::views::as_rvalue | std::views::transform(createMaterial)
-        | kdl::ranges::to<std::vector>();
-      surface.setSkins(std::move(materials));
+    for (size_t i = 0; i < numMeshes; ++i)
+    {
+      data.surface(i).setSkins(std::move(skins[i]));
     }
 
-    return std::views::iota(0u, numSequences) | std::views::transform([&](const auto i) {
-             return loadSceneFrame(*scene, i, data, modelPath);
-           })
-           | kdl::fold | kdl::transform([&]() { return std::move(data); });
+    return std::move(framesResult) | kdl::transform([&]() { return std::move(data); });
   }
   catch (const ParserException& e)
   {
@@ -21,16 +21,32 @@
 
 #pragma once
 
+#include "fs/PathInfo.h"
 #include "io/EntityModelLoader.h"
 
 #include <assimp/matrix4x4.h>
 
+#include "kd/path_hash.h"
+
 #include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 struct aiNode;
 struct aiScene;
 struct aiMesh;
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb
 {
 namespace fs
@@ -53,14 +69,104 @@ struct AssimpMeshWithTransforms
   aiMatrix4x4 m_axisTransform;
 };
 
+/**
+ * Called for a file system access that was skipped because a texture path was resolved
+ * from the cache. If pathInfo is set, the info of the given path was queried, otherwise
+ * the contents of the given directory were listed.
+ */
+using RecordAssimpTexturePathLookup = std::function<void(
+  const std::filesystem::path& path, const std::optional<fs::PathInfo>& pathInfo)>;
+
+/**
+ * Caches the results of resolving the texture paths of Assimp models.
+ *
+ * Resolving a texture path probes the file system for several candidate files and
+ * searches several directories for files with the same name as the texture. The resolved
+ * paths are cached per model directory, and the contents of each searched directory are
+ * listed only once.
+ *
+ * Every cached result keeps the file system accesses that were made to resolve it. These
+ * accesses are reported whenever they are skipped, so that a loader whose file system
+ * accesses are recorded can still depend on them.
+ *
+ * The cache can be shared by loaders running on different threads. It must be cleared
+ * when the contents of the file system change.
+ */
+class AssimpTexturePathCache
+{
+private:
+  using ResolvedPathKey = std::tuple<std::filesystem::path, std::filesystem::path>;
+
+  struct Lookup
+  {
+    std::filesystem::path path;
+    std::optional<fs::PathInfo> pathInfo;
+  };
+
+  struct ResolvedPath
+  {
+    std::optional<std::filesystem::path> path;
+    std::vector<Lookup> lookups;
+  };
+
+  struct DirectoryContents
+  {
+    fs::PathInfo pathInfo;
+    std::vector<std::filesystem::path> paths;
+  };
+
+  std::mutex m_mutex;
+  std::map<ResolvedPathKey, ResolvedPath> m_resolvedPaths;
+  std::unordered_map<std::filesystem::path, DirectoryContents, kdl::path_hash>
+    m_directoryContents;
+
+public:
+  /**
+   * Returns the path of the file that the given texture path of the given model refers
+   * to, or nullopt if no such file exists.
+   *
+   * The given function is called for every file system access that is skipped because
+   * its result is cached.
+   */
+  std::optional<std::filesystem::path> resolve(
+    const fs::FileSystem& fs,
+    const std::filesystem::path& texturePath,
+    const std::filesystem::path& modelPath,
+    const RecordAssimpTexturePathLookup& recordLookup = {});
+
+  void clear();
+
+private:
+  std::optional<std::filesystem::path> findTextureFileInDirectory(
+    const fs::FileSystem& fs,
+    const std::filesystem::path& directory,
+    const std::filesystem::path& texturePath,
+    std::vector<Lookup>& lookups,
+    const RecordAssimpTexturePathLookup& recordLookup);
+  std::vector<std::filesystem::path> directoryContents(
+    const fs::FileSystem& fs,
+    const std::filesystem::path& directory,
+    std::vector<Lookup>& lookups,
+    const RecordAssimpTexturePathLookup& recordLookup);
+};
+
 class AssimpLoader : public EntityModelLoader
 {
 private:
   std::filesystem::path m_path;
   const fs::FileSystem& m_fs;
+  kdl::task_manager& m_taskManager;
+  std::shared_ptr<AssimpTexturePathCache> m_texturePathCache;
+  RecordAssimpTexturePathLookup m_recordTexturePathLookup;
 
 public:
-  AssimpLoader(std::filesystem::path path, const fs::FileSystem& fs);
+  AssimpLoader(
+    std::filesystem::path path,
+    const fs::FileSystem& fs,
+    kdl::task_manager& taskManager,
+    std::shared_ptr<AssimpTexturePathCache> texturePathCache =
+      std::make_shared<AssimpTexturePathCache>(),
+    RecordAssimpTexturePathLookup recordTexturePathLookup = {});
 
   static bool canParse(const std::filesystem::path& path);
 
@@ -28,16 +28,18 @@
 #include "mdl/EntityModel.h"
 #include "mdl/Material.h"
 #include "mdl/Texture.h"
+#include "render/GLVertex.h"
 #include "render/MaterialIndexRangeMap.h"
-#include "render/MaterialIndexRangeMapBuilder.h"
 #include "render/PrimType.h"
 
+#include "kd/parallel_for.h"
 #include "kd/path_utils.h"
 #include "kd/result.h"
 #include "kd/string_format.h"
 
 #include <format>
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -95,17 +97,26 @@ struct FaceInfo
   size_t materialInfoIndex;
 };
 
+struct MipTextureEntry
+{
+  std::string name;
+  std::optional<fs::Reader> textureReader;
+};
 
 std::vector<mdl::Material> parseMaterials(
   fs::Reader reader,
   const int version,
   const mdl::Palette& palette,
   const fs::FileSystem& fs,
+  kdl::task_manager& taskManager,
   Logger& logger)
 {
+  static constexpr auto MinMaterialsPerChunk = size_t(4);
+
   const auto materialCount = reader.readSize<int32_t>();
-  auto result = std::vector<mdl::Material>{};
-  result.reserve(materialCount);
+
+  auto entries = std::vector<MipTextureEntry>{};
+  entries.reserve(materialCount);
 
   for (size_t i = 0; i < materialCount; ++i)
   {
@@ -113,25 +124,49 @@ std::vector<mdl::Material> parseMaterials(
     // 2153: Some BSPs contain negative offsets.
     if (offset < 0)
     {
-      result.push_back(loadDefaultMaterial(fs, "unknown", logger));
+      entries.push_back({"unknown", std::nullopt});
       continue;
     }
 
     auto materialName = readMipTextureName(reader);
-    auto textureReader = reader.subReaderFromBegin(size_t(offset)).buffer();
-    const auto mask = getTextureMaskFromName(materialName);
+    entries.push_back(
+      {std::move(materialName), reader.subReaderFromBegin(size_t(offset))});
+  }
+
+  // only the embedded textures are decoded in parallel, each into its own slot; loading
+  // the default material accesses the file system and the logger, so it is done serially
+  auto textures = std::vector<std::optional<Result<mdl::Texture>>>(materialCount);
+  kdl::parallel_for(
+    taskManager, materialCount, MinMaterialsPerChunk, [&](const size_t i) {
+      const auto& entry = entries[i];
+      if (entry.textureReader)
+      {
+        const auto mask = getTextureMaskFromName(entry.name);
+        auto textureReader = entry.textureReader->buffer();
+        textures[i] = version == 29 ? readIdMipTexture(textureReader, palette, mask)
+                                    : readHlMipTexture(textureReader, mask);
+      }
+    });
+
+  auto result = std::vector<mdl::Material>{};
+  result.reserve(materialCount);
+  for (size_t i = 0; i < materialCount; ++i)
+  {
+    auto& entry = entries[i];
+    if (!textures[i])
+    {
+      result.push_back(loadDefaultMaterial(fs, std::move(entry.name), logger));
+      continue;
+    }
 
     result.push_back(
-      (version == 29 ? readIdMipTexture(textureReader, palette, mask)
-                     : readHlMipTexture(textureReader, mask))
-      | kdl::or_else(makeReadTextureErrorHandler(fs, logger))
+      std::move(*textures[i]) | kdl::or_else(makeReadTextureErrorHandler(fs, logger))
       | kdl::transform([&](auto texture) {
           auto textureResource = createTextureResource(std::move(texture));
-          return mdl::Material{std::move(materialName), std::move(textureResource)};
+          return mdl::Material{std::move(entry.name), std::move(textureResource)};
         })
       | kdl::value());
   }
-
   return result;
 }
 
@@ -212,6 +247,14 @@ vm::vec2f uvCoords(
   return vm::vec2f{0, 0};
 }
 
+struct FaceRange
+{
+  const FaceInfo* faceInfo;
+  const MaterialInfo* materialInfo;
+  const mdl::Material* skin;
+  size_t vertexIndex;
+};
+
 void parseFrame(
   fs::Reader reader,
   const size_t frameIndex,
@@ -220,10 +263,13 @@ void parseFrame(
   const std::vector<vm::vec3f>& vertices,
   const std::vector<EdgeInfo>& edgeInfos,
   const std::vector<FaceInfo>& faceInfos,
-  const std::vector<int>& faceEdges)
+  const std::vector<int>& faceEdges,
+  kdl::task_manager& taskManager)
 {
   using Vertex = mdl::EntityModelVertex;
 
+  static constexpr auto MinFacesPerChunk = size_t(1024);
+
   auto& surface = modelData.surface(0);
 
   reader.seekForward(BspLayout::ModelFaceIndex);
@@ -232,6 +278,11 @@ void parseFrame(
   auto totalVertexCount = size_t(0);
   auto size = render::MaterialIndexRangeMap::Size{};
 
+  // assign each face a range of the frame's vertices so that faces can be processed
+  // independently
+  auto faceRanges = std::vector<FaceRange>{};
+  faceRanges.reserve(modelFaceCount);
+
   for (size_t i = 0; i < modelFaceCount; ++i)
   {
     const auto& faceInfo = faceInfos[modelFaceIndex + i];
@@ -240,47 +291,42 @@ void parseFrame(
     {
       const auto faceVertexCount = faceInfo.edgeCount;
       size.inc(skin, render::PrimType::Polygon, faceVertexCount);
+      faceRanges.push_back({&faceInfo, &materialInfo, skin, totalVertexCount});
       totalVertexCount += faceVertexCount;
     }
   }
 
-  auto bounds = vm::bbox3f::builder{};
-
-  auto builder =
-    render::MaterialIndexRangeMapBuilder<Vertex::Type>{totalVertexCount, size};
-  for (size_t i = 0; i < modelFaceCount; ++i)
-  {
-    const auto& faceInfo = faceInfos[modelFaceIndex + i];
-    const auto& materialInfo = materialInfos[faceInfo.materialInfoIndex];
-    if (const auto* skin = surface.skin(materialInfo.materialIndex))
-    {
-      const auto faceVertexCount = faceInfo.edgeCount;
-
-      auto faceVertices = std::vector<Vertex>{};
-      faceVertices.reserve(faceVertexCount);
-
-      for (size_t k = 0; k < faceVertexCount; ++k)
+  auto frameVertices = std::vector<Vertex>(totalVertexCount);
+  kdl::parallel_for(
+    taskManager, faceRanges.size(), MinFacesPerChunk, [&](const size_t i) {
+      const auto& [faceInfo, materialInfo, skin, vertexIndex] = faceRanges[i];
+      for (size_t k = 0; k < faceInfo->edgeCount; ++k)
       {
-        const auto faceEdgeIndex = faceEdges[faceInfo.edgeIndex + k];
-        const auto vertexIndex = faceEdgeIndex < 0
-                                   ? edgeInfos[size_t(-faceEdgeIndex)].vertexIndex2
-                                   : edgeInfos[size_t(faceEdgeIndex)].vertexIndex1;
-
-        const auto& position = vertices[vertexIndex];
-        const auto uvCoordss = uvCoords(position, materialInfo, skin);
-
-        bounds.add(position);
-
-        faceVertices.emplace_back(position, uvCoordss);
+        const auto faceEdgeIndex = faceEdges[faceInfo->edgeIndex + k];
+        const auto positionIndex = faceEdgeIndex < 0
+                                     ? edgeInfos[size_t(-faceEdgeIndex)].vertexIndex2
+                                     : edgeInfos[size_t(faceEdgeIndex)].vertexIndex1;
+
+        const auto& position = vertices[positionIndex];
+        frameVertices[vertexIndex + k] =
+          Vertex{position, uvCoords(position, *materialInfo, skin)};
       }
+    });
 
-      builder.addPolygon(skin, faceVertices);
-    }
+  auto bounds = vm::bbox3f::builder{};
+  auto indices = render::MaterialIndexRangeMap{size};
+  for (const auto& [faceInfo, materialInfo, skin, vertexIndex] : faceRanges)
+  {
+    indices.add(skin, render::PrimType::Polygon, vertexIndex, faceInfo->edgeCount);
+  }
+  for (const auto& vertex : frameVertices)
+  {
+    bounds.add(render::getVertexComponent<0>(vertex));
   }
 
   auto frameName = std::format("frame_{}", frameIndex);
   auto& frame = modelData.addFrame(std::move(frameName), bounds.bounds());
-  surface.addMesh(frame, std::move(builder.vertices()), std::move(builder.indices()));
+  surface.addMesh(frame, std::move(frameVertices), std::move(indices));
 }
 
 } // namespace
@@ -289,11 +335,13 @@ BspLoader::BspLoader(
   std::string name,
   const fs::Reader& reader,
   mdl::Palette palette,
-  const fs::FileSystem& fs)
+  const fs::FileSystem& fs,
+  kdl::task_manager& taskManager)
   : m_name{std::move(name)}
   , m_reader{reader}
   , m_palette{std::move(palette)}
   , m_fs{fs}
+  , m_taskManager{taskManager}
 {
 }
 
@@ -312,7 +360,8 @@ Result<mdl::EntityModelData> BspLoader::load(Logger& logger)
 {
   try
   {
-    auto reader = m_reader;
+    // the lumps are read concurrently, which requires a reader that is backed by memory
+    auto reader = fs::Reader{m_reader.buffer()};
     const auto version = reader.readInt<int32_t>();
     if (!isBSPVersionSupported(version))
     {
@@ -355,7 +404,12 @@ Result<mdl::EntityModelData> BspLoader::load(Logger& logger)
     auto data = mdl::EntityModelData{mdl::PitchType::Normal, mdl::Orientation::Oriented};
 
     auto materials = parseMaterials(
-      reader.subReaderFromBegin(materialsOffset), version, m_palette, m_fs, logger);
+      reader.subReaderFromBegin(materialsOffset),
+      version,
+      m_palette,
+      m_fs,
+      m_taskManager,
+      logger);
 
     auto& surface = data.addSurface(m_name, frameCount);
     surface.setSkins(std::move(materials));
@@ -371,7 +425,6 @@ Result<mdl::EntityModelData> BspLoader::load(Logger& logger)
     const auto faceEdges =
       parseFaceEdges(reader.subReaderFromBegin(faceEdgesOffset), faceEdgesCount);
 
-
     for (size_t i = 0; i < frameCount; ++i)
     {
       parseFrame(
@@ -383,7 +436,8 @@ Result<mdl::EntityModelData> BspLoader::load(Logger& logger)
         vertices,
         edgeInfos,
         faceInfos,
-        faceEdges);
+        faceEdges,
+        m_taskManager);
     }
 
     return data;
@@ -25,6 +25,11 @@
 #include <filesystem>
 #include <string>
 
+namespace kdl
+{
+class task_manager;
+}
+
 namespace tb
 {
 namespace fs
@@ -43,13 +48,15 @@ private:
   const fs::Reader& m_reader;
   const mdl::Palette m_palette;
   const fs::FileSystem& m_fs;
+  kdl::task_manager& m_taskManager;
 
 public:
   BspLoader(
     std::string name,
     const fs::Reader& reader,
     mdl::Palette palette,
-    const fs::FileSystem& fs);
+    const fs::FileSystem& fs,
+    kdl::task_manager& taskManager);
 
   static bool canParse(const std::filesystem::path& path, fs::Reader reader);
 
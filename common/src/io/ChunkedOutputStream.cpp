@@ -0,0 +1,160 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ChunkedOutputStream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace tb::io
+{
+namespace
+{
+constexpr auto MinChunkSize = size_t(4096);
+}
+
+ChunkedOutputBuffer::ChunkedOutputBuffer(const size_t initialCapacity)
+{
+  if (initialCapacity > 0)
+  {
+    addChunk(initialCapacity);
+  }
+}
+
+size_t ChunkedOutputBuffer::size() const
+{
+  const auto written = size_t(pptr() - pbase());
+  return m_chunks.empty() ? 0
+                          : std::accumulate(
+                              m_chunks.begin(),
+                              std::prev(m_chunks.end()),
+                              written,
+                              [](const auto sum, const auto& chunk) {
+                                return sum + chunk.size();
+                              });
+}
+
+std::string ChunkedOutputBuffer::str() &&
+{
+  if (m_chunks.empty())
+  {
+    return {};
+  }
+
+  truncateChunk();
+  setp(nullptr, nullptr);
+
+  auto chunks = std::move(m_chunks);
+  m_chunks.clear();
+
+  if (chunks.size() == 1)
+  {
+    return std::move(chunks.front());
+  }
+
+  auto result = std::string{};
+  result.reserve(std::accumulate(
+    chunks.begin(), chunks.end(), size_t(0), [](const auto sum, const auto& chunk) {
+      return sum + chunk.size();
+    }));
+  for (const auto& chunk : chunks)
+  {
+    result += chunk;
+  }
+  return result;
+}
+
+ChunkedOutputBuffer::int_type ChunkedOutputBuffer::overflow(const int_type c)
+{
+  if (traits_type::eq_int_type(c, traits_type::eof()))
+  {
+    return traits_type::not_eof(c);
+  }
+
+  addChunk(nextChunkSize(1));
+  *pptr() = traits_type::to_char_type(c);
+  pbump(1);
+  return c;
+}
+
+std::streamsize ChunkedOutputBuffer::xsputn(
+  const char_type* s, const std::streamsize count)
+{
+  auto remaining = size_t(count);
+  while (remaining > 0)
+  {
+    if (pptr() == epptr())
+    {
+      addChunk(nextChunkSize(remaining));
+    }
+
+    // pbump takes an int, so copy at most INT_MAX bytes per iteration
+    const auto n = std::min(
+      {remaining, size_t(epptr() - pptr()), size_t(std::numeric_limits<int>::max())});
+    std::memcpy(pptr(), s, n);
+    pbump(int(n));
+    s += n;
+    remaining -= n;
+  }
+  return count;
+}
+
+size_t ChunkedOutputBuffer::nextChunkSize(const size_t minCapacity) const
+{
+  return std::max({MinChunkSize, minCapacity, size()});
+}
+
+void ChunkedOutputBuffer::addChunk(const size_t capacity)
+{
+  truncateChunk();
+
+  auto& chunk = m_chunks.emplace_back();
+  chunk.resize(capacity);
+  setp(chunk.data(), chunk.data() + chunk.size());
+}
+
+void ChunkedOutputBuffer::truncateChunk()
+{
+  if (!m_chunks.empty())
+  {
+    // shrinking a string never reallocates its storage
+    m_chunks.back().resize(size_t(pptr() - pbase()));
+  }
+}
+
+ChunkedOutputStream::ChunkedOutputStream(const size_t initialCapacity)
+  : std::ostream{nullptr}
+  , m_buffer{initialCapacity}
+{
+  rdbuf(&m_buffer);
+}
+
+size_t ChunkedOutputStream::size() const
+{
+  return m_buffer.size();
+}
+
+std::string ChunkedOutputStream::str() &&
+{
+  return std::move(m_buffer).str();
+}
+
+} // namespace tb::io
@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace tb::io
+{
+
+/**
+ * A stream buffer that stores the written characters in a list of chunks.
+ *
+ * When the current chunk is full, a new chunk is added instead of reallocating and
+ * copying the characters written so far. The chunks grow geometrically, so the number of
+ * chunks remains small. If the initial capacity suffices, the contents are stored in a
+ * single chunk that is moved out of the buffer without copying.
+ */
+class ChunkedOutputBuffer : public std::streambuf
+{
+private:
+  std::vector<std::string> m_chunks;
+
+public:
+  explicit ChunkedOutputBuffer(size_t initialCapacity = 0);
+
+  /**
+   * Returns the number of characters written to this buffer.
+   */
+  size_t size() const;
+
+  /**
+   * Returns the written characters and clears this buffer.
+   */
+  std::string str() &&;
+
+protected:
+  int_type overflow(int_type c) override;
+  std::streamsize xsputn(const char_type* s, std::streamsize count) override;
+
+private:
+  size_t nextChunkSize(size_t minCapacity) const;
+  void addChunk(size_t capacity);
+  void truncateChunk();
+};
+
+/**
+ * An output stream that writes to a ChunkedOutputBuffer.
+ */
+class ChunkedOutputStream : public std::ostream
+{
+private:
+  ChunkedOutputBuffer m_buffer;
+
+public:
+  explicit ChunkedOutputStream(size_t initialCapacity = 0);
+
+  size_t size() const;
+  std::string str() &&;
+};
+
+} // namespace tb::io
@@ -0,0 +1,923 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityModelCache.h"
+
+#include "Color.h"
+#include "Logger.h"
+#include "fs/DiskFileSystem.h"
+#include "fs/DiskIO.h"
+#include "fs/File.h"
+#include "fs/FileSystem.h"
+#include "fs/PathInfo.h"
+#include "fs/Reader.h"
+#include "fs/ReaderException.h"
+#include "mdl/EntityModel.h"
+#include "mdl/Material.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureBuffer.h"
+#include "mdl/TextureResource.h"
+#include "render/IndexRangeMap.h"
+#include "render/MaterialIndexRangeMap.h"
+#include "render/PrimType.h"
+
+#include "kd/overload.h"
+#include "kd/result.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto Magic = std::string_view{"BSEM"};
+constexpr auto Version = std::uint32_t{2};
+
+/**
+ * A stable 64 bit FNV-1a hash. Unlike std::hash, its values can be stored on disk.
+ */
+class Hash
+{
+private:
+  std::uint64_t m_value = 0xcbf29ce484222325ull;
+
+public:
+  Hash& add(const std::string_view bytes)
+  {
+    for (const auto c : bytes)
+    {
+      m_value ^= static_cast<unsigned char>(c);
+      m_value *= 0x100000001b3ull;
+    }
+    return *this;
+  }
+
+  std::uint64_t value() const { return m_value; }
+};
+
+struct Dependency
+{
+  std::filesystem::path path;
+  fs::PathInfo pathInfo;
+  std::optional<std::uint64_t> contentsHash;
+};
+
+std::uint64_t hashContents(const fs::File& file)
+{
+  return Hash{}.add(file.reader().buffer().stringView()).value();
+}
+
+/**
+ * Forwards to another file system and records every path that is accessed so that a
+ * cache entry can be invalidated when any of these paths change.
+ *
+ * Loaders may access the file system from several threads, so the recorded accesses are
+ * guarded by a mutex.
+ */
+class RecordingFileSystem : public fs::FileSystem
+{
+private:
+  const fs::FileSystem& m_fs;
+  mutable std::mutex m_mutex;
+  mutable std::vector<Dependency> m_dependencies;
+  mutable bool m_complete = true;
+
+public:
+  explicit RecordingFileSystem(const fs::FileSystem& fs)
+    : m_fs{fs}
+  {
+  }
+
+  std::vector<Dependency> dependencies() const
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    return m_dependencies;
+  }
+
+  /**
+   * Indicates whether every access could be recorded. Directory listings and metadata
+   * cannot be validated later, so models that use them are not cached.
+   */
+  bool complete() const
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    return m_complete;
+  }
+
+  Result<std::filesystem::path> makeAbsolute(
+    const std::filesystem::path& path) const override
+  {
+    return m_fs.makeAbsolute(path);
+  }
+
+  fs::PathInfo pathInfo(const std::filesystem::path& path) const override
+  {
+    const auto pathInfo = m_fs.pathInfo(path);
+    addDependency({path, pathInfo, std::nullopt});
+    return pathInfo;
+  }
+
+  const fs::FileSystemMetadata* metadata(
+    const std::filesystem::path& path, const std::string& key) const override
+  {
+    setIncomplete();
+    return m_fs.metadata(path, key);
+  }
+
+protected:
+  Result<std::vector<std::filesystem::path>> doFind(
+    const std::filesystem::path& path,
+    const fs::TraversalMode& traversalMode) const override
+  {
+    setIncomplete();
+    return m_fs.find(path, traversalMode);
+  }
+
+  Result<std::shared_ptr<fs::File>> doOpenFile(
+    const std::filesystem::path& path) const override
+  {
+    return m_fs.openFile(path) | kdl::transform([&](auto file) {
+             addDependency({path, fs::PathInfo::File, hashContents(*file)});
+             return file;
+           })
+           | kdl::if_error([&](const auto&) {
+               addDependency({path, fs::PathInfo::Unknown, std::nullopt});
+             });
+  }
+
+public:
+  void setIncomplete() const
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    m_complete = false;
+  }
+
+  void addDependency(Dependency dependency) const
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    m_dependencies.push_back(std::move(dependency));
+  }
+};
+
+class Writer
+{
+private:
+  std::string m_buffer;
+
+public:
+  template <typename T>
+  void write(const T value)
+  {
+    m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void writeSize(const size_t value) { write(std::uint64_t(value)); }
+
+  void writeBytes(const void* data, const size_t size)
+  {
+    writeSize(size);
+    m_buffer.append(static_cast<const char*>(data), size);
+  }
+
+  void writeString(const std::string_view str) { writeBytes(str.data(), str.size()); }
+
+  void writeRaw(const std::string_view bytes) { m_buffer.append(bytes); }
+
+  void writePath(const std::filesystem::path& path)
+  {
+    writeString(path.generic_string());
+  }
+
+  template <size_t S>
+  void writeVec(const vm::vec<float, S>& vec)
+  {
+    for (size_t i = 0; i < S; ++i)
+    {
+      write(vec[i]);
+    }
+  }
+
+  std::string release() { return std::move(m_buffer); }
+};
+
+size_t readSize(fs::Reader& reader)
+{
+  return size_t(reader.read<std::uint64_t, std::uint64_t>());
+}
+
+std::string readString(fs::Reader& reader)
+{
+  const auto size = readSize(reader);
+  if (!reader.canRead(size))
+  {
+    throw fs::ReaderException{"Invalid string size"};
+  }
+
+  auto result = std::string(size, '\0');
+  reader.read(result.data(), size);
+  return result;
+}
+
+std::filesystem::path readPath(fs::Reader& reader)
+{
+  return std::filesystem::path{readString(reader)};
+}
+
+template <size_t S>
+vm::vec<float, S> readVec(fs::Reader& reader)
+{
+  return reader.readVec<float, S>();
+}
+
+void writeDependencies(Writer& writer, const std::vector<Dependency>& dependencies)
+{
+  writer.writeSize(dependencies.size());
+  for (const auto& dependency : dependencies)
+  {
+    writer.writePath(dependency.path);
+    writer.write(std::uint8_t(dependency.pathInfo));
+    writer.write(std::uint8_t(dependency.contentsHash ? 1 : 0));
+    writer.write(dependency.contentsHash.value_or(0));
+  }
+}
+
+std::vector<Dependency> readDependencies(fs::Reader& reader)
+{
+  auto dependencies = std::vector<Dependency>{};
+
+  const auto count = readSize(reader);
+  for (size_t i = 0; i < count; ++i)
+  {
+    auto path = readPath(reader);
+    const auto pathInfo = fs::PathInfo(reader.read<std::uint8_t, std::uint8_t>());
+    const auto hasContentsHash = reader.readBool<std::uint8_t>();
+    const auto contentsHash = reader.read<std::uint64_t, std::uint64_t>();
+    dependencies.push_back(
+      {std::move(path),
+       pathInfo,
+       hasContentsHash ? std::optional{contentsHash} : std::nullopt});
+  }
+
+  return dependencies;
+}
+
+bool isUpToDate(const fs::FileSystem& fs, const Dependency& dependency)
+{
+  if (dependency.contentsHash)
+  {
+    return fs.openFile(dependency.path) | kdl::transform([&](auto file) {
+             return hashContents(*file) == *dependency.contentsHash;
+           })
+           | kdl::value_or(false);
+  }
+  return fs.pathInfo(dependency.path) == dependency.pathInfo;
+}
+
+bool writeTexture(Writer& writer, const mdl::Texture& texture)
+{
+  const auto& buffers = texture.buffersIfLoaded();
+  if (buffers.empty())
+  {
+    return false;
+  }
+
+  writer.writeSize(texture.width());
+  writer.writeSize(texture.height());
+  writer.writeVec(texture.averageColor().to<RgbaF>().toVec());
+  writer.write(std::uint32_t(texture.format()));
+  writer.write(std::uint8_t(texture.mask()));
+  std::visit(
+    kdl::overload(
+      [&](const mdl::NoEmbeddedDefaults&) { writer.write(std::uint8_t(0)); },
+      [&](const mdl::Q2EmbeddedDefaults& defaults) {
+        writer.write(std::uint8_t(1));
+        writer.write(std::int32_t(defaults.flags));
+        writer.write(std::int32_t(defaults.contents));
+        writer.write(std::int32_t(defaults.value));
+      }),
+    texture.embeddedDefaults());
+
+  writer.writeSize(buffers.size());
+  for (const auto& buffer : buffers)
+  {
+    writer.writeBytes(buffer.data(), buffer.size());
+  }
+  return true;
+}
+
+mdl::Texture readTexture(fs::Reader& reader)
+{
+  const auto width = readSize(reader);
+  const auto height = readSize(reader);
+  const auto averageColor = RgbaF::fromVec(readVec<4>(reader)) | kdl::value();
+  const auto format = GLenum(reader.read<std::uint32_t, std::uint32_t>());
+  const auto mask = mdl::TextureMask(reader.read<std::uint8_t, std::uint8_t>());
+
+  auto embeddedDefaults = mdl::EmbeddedDefaults{mdl::NoEmbeddedDefaults{}};
+  if (reader.readBool<std::uint8_t>())
+  {
+    const auto flags = reader.readInt<std::int32_t>();
+    const auto contents = reader.readInt<std::int32_t>();
+    const auto value = reader.readInt<std::int32_t>();
+    embeddedDefaults = mdl::Q2EmbeddedDefaults{flags, contents, value};
+  }
+
+  auto buffers = std::vector<mdl::TextureBuffer>{};
+  const auto bufferCount = readSize(reader);
+  for (size_t i = 0; i < bufferCount; ++i)
+  {
+    const auto size = readSize(reader);
+    if (!reader.canRead(size))
+    {
+      throw fs::ReaderException{"Invalid texture buffer size"};
+    }
+
+    auto& buffer = buffers.emplace_back(size);
+    reader.read(buffer.data(), size);
+  }
+
+  return mdl::Texture{
+    width,
+    height,
+    Color{averageColor},
+    format,
+    mask,
+    std::move(embeddedDefaults),
+    std::move(buffers)};
+}
+
+bool writeMaterial(Writer& writer, const mdl::Material& material)
+{
+  const auto* texture = material.texture();
+  if (!texture)
+  {
+    return false;
+  }
+
+  writer.writeString(material.name());
+  writer.writeString(material.collectionName());
+  writer.writePath(material.absolutePath());
+  writer.writePath(material.relativePath());
+
+  writer.writeSize(material.hotspots().size());
+  for (const auto& hotspot : material.hotspots())
+  {
+    writer.writeVec(hotspot.min);
+    writer.writeVec(hotspot.size);
+    writer.write(std::uint8_t(hotspot.tileU));
+    writer.write(std::uint8_t(hotspot.tileV));
+    writer.write(hotspot.weight);
+  }
+
+  writer.writeSize(material.surfaceParms().size());
+  for (const auto& surfaceParm : material.surfaceParms())
+  {
+    writer.writeString(surfaceParm);
+  }
+
+  writer.write(std::uint8_t(material.culling()));
+  writer.write(std::uint8_t(material.blendFunc().enable));
+  writer.write(std::uint32_t(material.blendFunc().srcFactor));
+  writer.write(std::uint32_t(material.blendFunc().destFactor));
+
+  return writeTexture(writer, *texture);
+}
+
+mdl::Material readMaterial(fs::Reader& reader)
+{
+  auto name = readString(reader);
+  auto collectionName = readString(reader);
+  auto absolutePath = readPath(reader);
+  auto relativePath = readPath(reader);
+
+  auto hotspots = std::vector<mdl::HotspotRect>{};
+  const auto hotspotCount = readSize(reader);
+  for (size_t i = 0; i < hotspotCount; ++i)
+  {
+    const auto min = readVec<2>(reader);
+    const auto size = readVec<2>(reader);
+    const auto tileU = reader.readBool<std::uint8_t>();
+    const auto tileV = reader.readBool<std::uint8_t>();
+    const auto weight = reader.readFloat<float>();
+    hotspots.push_back({min, size, tileU, tileV, weight});
+  }
+
+  auto surfaceParms = std::set<std::string>{};
+  const auto surfaceParmCount = readSize(reader);
+  for (size_t i = 0; i < surfaceParmCount; ++i)
+  {
+    surfaceParms.insert(readString(reader));
+  }
+
+  const auto culling = mdl::MaterialCulling(reader.read<std::uint8_t, std::uint8_t>());
+  const auto blendEnable =
+    mdl::MaterialBlendFunc::Enable(reader.read<std::uint8_t, std::uint8_t>());
+  const auto srcFactor = GLenum(reader.read<std::uint32_t, std::uint32_t>());
+  const auto destFactor = GLenum(reader.read<std::uint32_t, std::uint32_t>());
+
+  auto texture = readTexture(reader);
+  auto textureResource = mdl::createTextureResource(std::move(texture));
+
+  auto material = mdl::Material{std::move(name), std::move(textureResource)};
+  material.setCollectionName(std::move(collectionName));
+  material.setAbsolutePath(std::move(absolutePath));
+  material.setRelativePath(std::move(relativePath));
+  material.setHotspots(std::move(hotspots));
+  material.setSurfaceParms(std::move(surfaceParms));
+  material.setCulling(culling);
+  switch (blendEnable)
+  {
+  case mdl::MaterialBlendFunc::Enable::UseFactors:
+    material.setBlendFunc(srcFactor, destFactor);
+    break;
+  case mdl::MaterialBlendFunc::Enable::DisableBlend:
+    material.disableBlend();
+    break;
+  case mdl::MaterialBlendFunc::Enable::UseDefault:
+    break;
+  }
+
+  return material;
+}
+
+std::optional<std::int64_t> findSkinIndex(
+  const mdl::EntityModelSurface& surface, const mdl::Material* material)
+{
+  if (!material)
+  {
+    return -1;
+  }
+
+  for (size_t i = 0; i < surface.skinCount(); ++i)
+  {
+    if (surface.skin(i) == material)
+    {
+      return std::int64_t(i);
+    }
+  }
+  return std::nullopt;
+}
+
+bool writeMesh(Writer& writer, const mdl::EntityModelSurface& surface, size_t frameIndex)
+{
+  const auto* vertices = surface.vertices(frameIndex);
+  writer.write(std::uint8_t(vertices ? 1 : 0));
+  if (!vertices)
+  {
+    return true;
+  }
+
+  // every mesh is written as a block so that it can be decoded on demand
+  auto meshWriter = Writer{};
+  meshWriter.writeSize(vertices->size());
+  for (const auto& vertex : *vertices)
+  {
+    meshWriter.writeVec(render::getVertexComponent<0>(vertex));
+    meshWriter.writeVec(render::getVertexComponent<1>(vertex));
+  }
+
+  struct Primitive
+  {
+    std::int64_t skinIndex;
+    render::PrimType primType;
+    size_t index;
+    size_t count;
+  };
+
+  auto primitives = std::vector<Primitive>{};
+  auto valid = true;
+  surface.forEachPrimitive(
+    frameIndex,
+    [&](const auto* material, const auto primType, const auto index, const auto count) {
+      if (const auto skinIndex = findSkinIndex(surface, material))
+      {
+        primitives.push_back({*skinIndex, primType, index, count});
+      }
+      else
+      {
+        valid = false;
+      }
+    });
+
+  meshWriter.writeSize(primitives.size());
+  for (const auto& primitive : primitives)
+  {
+    meshWriter.write(primitive.skinIndex);
+    meshWriter.write(std::uint8_t(primitive.primType));
+    meshWriter.writeSize(primitive.index);
+    meshWriter.writeSize(primitive.count);
+  }
+
+  writer.writeString(meshWriter.release());
+  return valid;
+}
+
+mdl::EntityModelMeshData decodeMesh(
+  fs::Reader& reader, const std::vector<const mdl::Material*>& skins)
+{
+  auto vertices = std::vector<mdl::EntityModelVertex>{};
+  const auto vertexCount = readSize(reader);
+  vertices.reserve(vertexCount);
+  for (size_t i = 0; i < vertexCount; ++i)
+  {
+    const auto position = readVec<3>(reader);
+    const auto uv = readVec<2>(reader);
+    vertices.emplace_back(position, uv);
+  }
+
+  struct Primitive
+  {
+    const mdl::Material* material;
+    render::PrimType primType;
+    size_t index;
+    size_t count;
+  };
+
+  auto primitives = std::vector<Primitive>{};
+  auto hasMaterials = false;
+  const auto primitiveCount = readSize(reader);
+  for (size_t i = 0; i < primitiveCount; ++i)
+  {
+    const auto skinIndex = reader.read<std::int64_t, std::int64_t>();
+    const auto primType = render::PrimType(reader.read<std::uint8_t, std::uint8_t>());
+    const auto index = readSize(reader);
+    const auto count = readSize(reader);
+
+    if (skinIndex >= std::int64_t(skins.size()))
+    {
+      throw fs::ReaderException{std::format("Invalid skin index {}", skinIndex)};
+    }
+
+    const auto* material = skinIndex >= 0 ? skins[size_t(skinIndex)] : nullptr;
+    hasMaterials = hasMaterials || material;
+    primitives.push_back({material, primType, index, count});
+  }
+
+  if (hasMaterials)
+  {
+    auto size = render::MaterialIndexRangeMap::Size{};
+    for (const auto& primitive : primitives)
+    {
+      size.inc(primitive.material, primitive.primType);
+    }
+
+    auto indices = render::MaterialIndexRangeMap{size};
+    for (const auto& primitive : primitives)
+    {
+      indices.add(
+        primitive.material, primitive.primType, primitive.index, primitive.count);
+    }
+    return {std::move(vertices), std::move(indices)};
+  }
+
+  auto indices = render::IndexRangeMap{};
+  for (const auto& primitive : primitives)
+  {
+    indices.add(primitive.primType, primitive.index, primitive.count);
+  }
+  return {std::move(vertices), std::move(indices)};
+}
+
+void readMesh(
+  fs::Reader& reader, mdl::EntityModelSurface& surface, mdl::EntityModelFrame& frame)
+{
+  if (!reader.readBool<std::uint8_t>())
+  {
+    return;
+  }
+
+  // the skins have been set already, so their addresses are stable
+  auto skins = std::vector<const mdl::Material*>{};
+  skins.reserve(surface.skinCount());
+  for (size_t i = 0; i < surface.skinCount(); ++i)
+  {
+    skins.push_back(surface.skin(i));
+  }
+
+  surface.addMesh(
+    frame, [skins = std::move(skins), mesh = readString(reader)]() {
+      try
+      {
+        auto meshReader = fs::Reader::from(mesh.data(), mesh.data() + mesh.size());
+        return decodeMesh(meshReader, skins);
+      }
+      catch (const fs::ReaderException&)
+      {
+        // only a corrupt entry can get here; render nothing rather than fail while
+        // drawing
+        return mdl::EntityModelMeshData{};
+      }
+    });
+}
+
+std::filesystem::path cacheEntryName(
+  const std::filesystem::path& modelPath, const std::string_view key)
+{
+  const auto hash = Hash{}.add(modelPath.generic_string()).add("\n").add(key).value();
+  return std::format("{:016x}.bin", hash);
+}
+
+/**
+ * Returns the cached model data if the entry at the given path is valid and up to date.
+ */
+std::optional<mdl::EntityModelData> readCacheEntry(
+  const std::filesystem::path& entryPath,
+  const fs::FileSystem& fs,
+  const std::filesystem::path& modelPath,
+  const std::string_view key)
+{
+  if (fs::Disk::pathInfo(entryPath) != fs::PathInfo::File)
+  {
+    return std::nullopt;
+  }
+
+  return fs::Disk::openFile(entryPath)
+         | kdl::transform([&](auto file) -> std::optional<mdl::EntityModelData> {
+             try
+             {
+               fs::Reader reader = file->reader().buffer();
+               if (
+                 reader.readString(Magic.size()) != Magic
+                 || reader.read<std::uint32_t, std::uint32_t>() != Version
+                 || readPath(reader) != modelPath || readString(reader) != key)
+               {
+                 return std::nullopt;
+               }
+
+               const auto dependencies = readDependencies(reader);
+               for (const auto& dependency : dependencies)
+               {
+                 if (!isUpToDate(fs, dependency))
+                 {
+                   return std::nullopt;
+                 }
+               }
+
+               // mark the entry as recently used so that it is pruned last
+               auto error = std::error_code{};
+               std::filesystem::last_write_time(
+                 entryPath, std::filesystem::file_time_type::clock::now(), error);
+
+               return readEntityModelData(reader) | kdl::transform([](auto modelData) {
+                        return std::optional{std::move(modelData)};
+                      })
+                      | kdl::value_or(std::nullopt);
+             }
+             catch (const fs::ReaderException&)
+             {
+               return std::nullopt;
+             }
+           })
+         | kdl::value_or(std::nullopt);
+}
+
+/**
+ * Writes a cache entry and returns the serialized model data it contains.
+ */
+Result<std::string> writeCacheEntry(
+  const std::filesystem::path& cacheDirectory,
+  const std::filesystem::path& entryName,
+  const std::filesystem::path& modelPath,
+  const std::string_view key,
+  const std::vector<Dependency>& dependencies,
+  const mdl::EntityModelData& modelData)
+{
+  return writeEntityModelData(modelData) | kdl::and_then([&](auto data) {
+           auto writer = Writer{};
+           writer.writeRaw(Magic);
+           writer.write(Version);
+           writer.writePath(modelPath);
+           writer.writeString(key);
+           writeDependencies(writer, dependencies);
+           writer.writeRaw(data);
+
+           const auto contents = writer.release();
+
+           return fs::Disk::createDirectory(cacheDirectory)
+                  | kdl::and_then([&](auto) {
+                      return fs::WritableDiskFileSystem{cacheDirectory}.createFileAtomic(
+                        entryName, contents);
+                    })
+                  | kdl::transform([&]() { return std::move(data); });
+         });
+}
+
+} // namespace
+
+Result<std::string> writeEntityModelData(const mdl::EntityModelData& modelData)
+{
+  auto writer = Writer{};
+  writer.write(std::uint8_t(modelData.pitchType()));
+  writer.write(std::uint8_t(modelData.orientation()));
+
+  writer.writeSize(modelData.frameCount());
+  for (const auto& frame : modelData.frames())
+  {
+    writer.writeString(frame.name());
+    writer.writeVec(frame.bounds().min);
+    writer.writeVec(frame.bounds().max);
+    writer.writeSize(frame.skinOffset());
+  }
+
+  writer.writeSize(modelData.surfaceCount());
+  for (const auto& surface : modelData.surfaces())
+  {
+    writer.writeString(surface.name());
+    writer.writeSize(surface.frameCount());
+
+    writer.writeSize(surface.skinCount());
+    for (size_t i = 0; i < surface.skinCount(); ++i)
+    {
+      if (!writeMaterial(writer, *surface.skin(i)))
+      {
+        return Error{std::format(
+          "Skin '{}' of surface '{}' has no texture data",
+          surface.skin(i)->name(),
+          surface.name())};
+      }
+    }
+
+    for (size_t i = 0; i < surface.frameCount(); ++i)
+    {
+      if (!writeMesh(writer, surface, i))
+      {
+        return Error{std::format(
+          "Mesh of surface '{}' refers to a material that is not a skin",
+          surface.name())};
+      }
+    }
+  }
+
+  return writer.release();
+}
+
+Result<mdl::EntityModelData> readEntityModelData(fs::Reader& reader)
+{
+  try
+  {
+    const auto pitchType = mdl::PitchType(reader.read<std::uint8_t, std::uint8_t>());
+    const auto orientation = mdl::Orientation(reader.read<std::uint8_t, std::uint8_t>());
+    auto modelData = mdl::EntityModelData{pitchType, orientation};
+
+    const auto frameCount = readSize(reader);
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+      auto name = readString(reader);
+      const auto min = readVec<3>(reader);
+      const auto max = readVec<3>(reader);
+      auto& frame = modelData.addFrame(std::move(name), vm::bbox3f{min, max});
+      frame.setSkinOffset(readSize(reader));
+    }
+
+    const auto surfaceCount = readSize(reader);
+    for (size_t i = 0; i < surfaceCount; ++i)
+    {
+      auto name = readString(reader);
+      const auto surfaceFrameCount = readSize(reader);
+      if (surfaceFrameCount > frameCount)
+      {
+        return Error{std::format("Invalid surface frame count {}", surfaceFrameCount)};
+      }
+
+      auto& surface = modelData.addSurface(std::move(name), surfaceFrameCount);
+
+      auto skins = std::vector<mdl::Material>{};
+      const auto skinCount = readSize(reader);
+      for (size_t j = 0; j < skinCount; ++j)
+      {
+        skins.push_back(readMaterial(reader));
+      }
+      surface.setSkins(std::move(skins));
+
+      for (size_t j = 0; j < surfaceFrameCount; ++j)
+      {
+        readMesh(reader, surface, modelData.frames()[j]);
+      }
+    }
+
+    return modelData;
+  }
+  catch (const fs::ReaderException& e)
+  {
+    return Error{e.what()};
+  }
+}
+
+Result<mdl::EntityModelData> loadCachedEntityModelData(
+  const std::filesystem::path& cacheDirectory,
+  const fs::FileSystem& fs,
+  const std::filesystem::path& modelPath,
+  const std::string_view key,
+  const LoadEntityModelDataFunc& loadEntityModelData,
+  Logger& logger)
+{
+  const auto entryName = cacheEntryName(modelPath, key);
+  if (auto modelData = readCacheEntry(cacheDirectory / entryName, fs, modelPath, key))
+  {
+    return std::move(*modelData);
+  }
+
+  auto recordingFs = RecordingFileSystem{fs};
+  const auto recordDependency = [&](const auto& path, const auto& pathInfo) {
+    if (pathInfo)
+    {
+      recordingFs.addDependency({path, *pathInfo, std::nullopt});
+    }
+    else
+    {
+      recordingFs.setIncomplete();
+    }
+  };
+
+  return loadEntityModelData(recordingFs, recordDependency)
+         | kdl::and_then([&](auto modelData) {
+             if (!recordingFs.complete())
+             {
+               return Result<mdl::EntityModelData>{std::move(modelData)};
+             }
+
+             // writing the entry decoded every frame, so read the model back to release
+             // the decoded frames until they are used again
+             return writeCacheEntry(
+                      cacheDirectory,
+                      entryName,
+                      modelPath,
+                      key,
+                      recordingFs.dependencies(),
+                      modelData)
+                    | kdl::and_then([](const auto& data) {
+                        auto reader =
+                          fs::Reader::from(data.data(), data.data() + data.size());
+                        return readEntityModelData(reader);
+                      })
+                    | kdl::or_else([&](const auto& e) {
+                        logger.debug() << "Could not cache entity model '"
+                                       << modelPath.string() << "': " << e.msg;
+                        return Result<mdl::EntityModelData>{std::move(modelData)};
+                      });
+           });
+}
+
+void pruneEntityModelCache(
+  const std::filesystem::path& cacheDirectory, const std::uintmax_t maxSize)
+{
+  struct Entry
+  {
+    std::filesystem::path path;
+    std::filesystem::file_time_type lastUsed;
+    std::uintmax_t size;
+  };
+
+  auto error = std::error_code{};
+  auto entries = std::vector<Entry>{};
+  auto totalSize = std::uintmax_t{0};
+  for (auto it = std::filesystem::directory_iterator{cacheDirectory, error};
+       !error && it != std::filesystem::directory_iterator{};
+       it.increment(error))
+  {
+    auto entryError = std::error_code{};
+    const auto lastUsed = it->last_write_time(entryError);
+    const auto size = it->file_size(entryError);
+    if (!entryError && it->is_regular_file(entryError) && !entryError)
+    {
+      entries.push_back({it->path(), lastUsed, size});
+      totalSize += size;
+    }
+  }
+
+  std::ranges::sort(entries, std::greater{}, &Entry::lastUsed);
+  while (totalSize > maxSize && !entries.empty())
+  {
+    if (std::filesystem::remove(entries.back().path, error))
+    {
+      totalSize -= entries.back().size;
+    }
+    entries.pop_back();
+  }
+}
+
+} // namespace tb::io
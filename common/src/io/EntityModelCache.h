@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+#include "fs/PathInfo.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace tb
+{
+class Logger;
+
+namespace fs
+{
+class FileSystem;
+class Reader;
+} // namespace fs
+
+namespace mdl
+{
+class EntityModelData;
+}
+
+namespace io
+{
+
+/**
+ * Records a file system access that a loader skipped because its result was cached
+ * elsewhere. If pathInfo is set, the model depends on the info of the given path,
+ * otherwise it depends on the contents of the given directory.
+ */
+using RecordEntityModelDependencyFunc = std::function<void(
+  const std::filesystem::path& path, const std::optional<fs::PathInfo>& pathInfo)>;
+
+using LoadEntityModelDataFunc = std::function<Result<mdl::EntityModelData>(
+  const fs::FileSystem&, const RecordEntityModelDependencyFunc&)>;
+
+/**
+ * Serializes the given model data into the binary format of the entity model cache.
+ *
+ * Returns an error if the model data cannot be cached, e.g. because one of its skins has
+ * no texture data.
+ */
+Result<std::string> writeEntityModelData(const mdl::EntityModelData& modelData);
+
+/**
+ * Deserializes model data that was serialized with writeEntityModelData.
+ */
+Result<mdl::EntityModelData> readEntityModelData(fs::Reader& reader);
+
+/**
+ * Loads entity model data using a cache of decoded models in the given directory.
+ *
+ * A cache entry is identified by the model path and the given key. It records the
+ * contents hash of every file that was read while decoding the model, and it is only used
+ * if none of these files have changed. Otherwise, the given function is called to decode
+ * the model, and the result is stored in the cache for later sessions.
+ *
+ * The given function must read all files through the file system passed to it so that
+ * the cache can track them. Accesses that it skips because their results are cached
+ * elsewhere must be reported to the record function passed to it.
+ */
+Result<mdl::EntityModelData> loadCachedEntityModelData(
+  const std::filesystem::path& cacheDirectory,
+  const fs::FileSystem& fs,
+  const std::filesystem::path& modelPath,
+  std::string_view key,
+  const LoadEntityModelDataFunc& loadEntityModelData,
+  Logger& logger);
+
+/**
+ * Removes the least recently used entries from the cache in the given directory until the
+ * remaining entries take up at most the given number of bytes. Entries that belong to
+ * models of other games are removed the same way once they are no longer used.
+ */
+void pruneEntityModelCache(
+  const std::filesystem::path& cacheDirectory, std::uintmax_t maxSize);
+
+} // namespace io
+} // namespace tb
@@ -0,0 +1,77 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/ExportGeometry.h"
+
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/PatchNode.h"
+#include "mdl/Polyhedron.h"
+
+namespace tb::io
+{
+
+void forEachExportFace(
+  const mdl::BrushNode& brushNode,
+  const std::function<void(const mdl::BrushFace&, const std::vector<ExportVertex>&)>& f)
+{
+  auto vertices = std::vector<ExportVertex>{};
+  for (const auto& face : brushNode.brush().faces())
+  {
+    const auto& normal = face.boundary().normal;
+
+    vertices.clear();
+    vertices.reserve(face.vertexCount());
+    for (const auto* vertex : face.vertices())
+    {
+      const auto& position = vertex->position();
+      vertices.push_back(ExportVertex{position, face.uvCoords(position), normal});
+    }
+
+    f(face, vertices);
+  }
+}
+
+void forEachExportQuad(
+  const mdl::PatchNode& patchNode,
+  const std::function<void(const std::array<ExportVertex, 4>&)>& f)
+{
+  const auto& patchGrid = patchNode.grid();
+
+  const auto makeVertex = [&](const size_t row, const size_t col) {
+    const auto& p = patchGrid.point(row, col);
+    return ExportVertex{p.position, vm::vec2f{p.uvCoords}, p.normal};
+  };
+
+  for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row)
+  {
+    for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col)
+    {
+      // counter clockwise order
+      f({
+        makeVertex(row, col),
+        makeVertex(row + 1u, col),
+        makeVertex(row + 1u, col + 1u),
+        makeVertex(row, col + 1u),
+      });
+    }
+  }
+}
+
+} // namespace tb::io
@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Trace.h"
+
+#include "kd/task_manager.h"
+
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <functional>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace tb
+{
+namespace mdl
+{
+class BrushFace;
+class BrushNode;
+class PatchNode;
+} // namespace mdl
+
+namespace io
+{
+
+/**
+ * A brush or patch to export along with the numbers that identify it in the exported
+ * file.
+ */
+struct ExportObject
+{
+  std::variant<const mdl::BrushNode*, const mdl::PatchNode*> node;
+  size_t entityNo;
+  size_t brushNo;
+};
+
+struct ExportVertex
+{
+  vm::vec3d position;
+  vm::vec2f uvCoords;
+  vm::vec3d normal;
+};
+
+/**
+ * Calls the given function for every face of the given brush with the vertices of the
+ * face in counter clockwise order.
+ */
+void forEachExportFace(
+  const mdl::BrushNode& brushNode,
+  const std::function<void(const mdl::BrushFace&, const std::vector<ExportVertex>&)>& f);
+
+/**
+ * Calls the given function with the corners of every quad of the given patch in counter
+ * clockwise order.
+ */
+void forEachExportQuad(
+  const mdl::PatchNode& patchNode,
+  const std::function<void(const std::array<ExportVertex, 4>&)>& f);
+
+/**
+ * Splits the given objects into blocks of at most the given number of consecutive
+ * objects and converts the blocks in parallel using the given function. Returns the
+ * converted blocks in the order of the objects.
+ *
+ * The given function is called with a span of the objects of a block. It must be safe to
+ * call concurrently.
+ */
+template <typename ConvertBlock>
+auto convertExportBlocks(
+  const std::vector<ExportObject>& objects,
+  const size_t blockSize,
+  kdl::task_manager& taskManager,
+  const ConvertBlock& convertBlock)
+{
+  using Block = std::invoke_result_t<ConvertBlock, std::span<const ExportObject>>;
+
+  const auto trace =
+    TraceScope{"convertExportBlocks", std::format("{} objects", objects.size())};
+
+  auto blockIndices = std::vector<size_t>((objects.size() + blockSize - 1) / blockSize);
+  std::iota(blockIndices.begin(), blockIndices.end(), size_t(0));
+
+  const auto tasks = blockIndices | std::views::transform([&](const auto i) {
+                       return std::function<Block()>{[&, i]() {
+                         const auto first = i * blockSize;
+                         const auto count = std::min(blockSize, objects.size() - first);
+                         return convertBlock(std::span{objects}.subspan(first, count));
+                       }};
+                     });
+  return taskManager.run_tasks_and_wait(tasks);
+}
+
+} // namespace io
+} // namespace tb
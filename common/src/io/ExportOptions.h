@@ -51,7 +51,15 @@ struct ObjExportOptions
   kdl_reflect_decl(ObjExportOptions, exportPath, mtlPathMode);
 };
 
-using ExportOptions = std::variant<MapExportOptions, ObjExportOptions>;
+struct GltfExportOptions
+{
+  std::filesystem::path exportPath;
+
+  kdl_reflect_decl(GltfExportOptions, exportPath);
+};
+
+using ExportOptions =
+  std::variant<MapExportOptions, ObjExportOptions, GltfExportOptions>;
 
 std::ostream& operator<<(std::ostream& lhs, const ExportOptions& rhs);
 
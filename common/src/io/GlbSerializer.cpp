@@ -0,0 +1,513 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GlbSerializer.h"
+
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Material.h"
+#include "mdl/PatchNode.h"
+
+#include "kd/contracts.h"
+#include "kd/hash_utils.h"
+#include "kd/overload.h"
+#include "kd/string_format.h"
+
+#include "vm/vec.h"
+
+#include <array>
+#include <bit>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace tb::io
+{
+namespace
+{
+
+constexpr auto GlbMagic = uint32_t(0x46546C67);
+constexpr auto GlbVersion = uint32_t(2);
+constexpr auto JsonChunkType = uint32_t(0x4E4F534A);
+constexpr auto BinaryChunkType = uint32_t(0x004E4942);
+
+constexpr auto ComponentTypeFloat = 5126;
+constexpr auto ComponentTypeUnsignedInt = 5125;
+constexpr auto TargetArrayBuffer = 34962;
+constexpr auto TargetElementArrayBuffer = 34963;
+
+using Vertex = std::array<float, GlbSerializer::VertexSize>;
+
+struct VertexHash
+{
+  size_t operator()(const Vertex& vertex) const
+  {
+    auto result = size_t(0);
+    for (const auto f : vertex)
+    {
+      result = kdl::combine_hash(result, kdl::hash(f));
+    }
+    return result;
+  }
+};
+
+/**
+ * Converts the given vertex to the Y up coordinate system of glTF.
+ */
+Vertex toGltfVertex(const ExportVertex& vertex)
+{
+  const auto& p = vertex.position;
+  const auto& n = vertex.normal;
+  const auto& uv = vertex.uvCoords;
+  return {
+    float(p.x()),
+    float(p.z()),
+    float(-p.y()),
+    float(n.x()),
+    float(n.z()),
+    float(-n.y()),
+    uv.x(),
+    uv.y(),
+  };
+}
+
+class BlockBuilder
+{
+private:
+  struct IndexedPrimitive
+  {
+    GlbSerializer::Primitive primitive;
+    std::unordered_map<Vertex, uint32_t, VertexHash> indices;
+  };
+
+  std::map<std::string, IndexedPrimitive> m_primitives;
+
+public:
+  void addObject(const ExportObject& object)
+  {
+    std::visit(
+      kdl::overload(
+        [&](const mdl::BrushNode* brushNode) {
+          forEachExportFace(*brushNode, [&](const auto& face, const auto& vertices) {
+            addPolygon(face.attributes().materialName(), face.material(), vertices);
+          });
+        },
+        [&](const mdl::PatchNode* patchNode) {
+          const auto& patch = patchNode->patch();
+          forEachExportQuad(*patchNode, [&](const auto& quad) {
+            addPolygon(patch.materialName(), patch.material(), quad);
+          });
+        }),
+      object.node);
+  }
+
+  std::map<std::string, GlbSerializer::Primitive> build() &&
+  {
+    auto result = std::map<std::string, GlbSerializer::Primitive>{};
+    for (auto& [materialName, indexedPrimitive] : m_primitives)
+    {
+      result.emplace(materialName, std::move(indexedPrimitive.primitive));
+    }
+    return result;
+  }
+
+private:
+  template <typename Vertices>
+  void addPolygon(
+    const std::string& materialName,
+    const mdl::Material* material,
+    const Vertices& vertices)
+  {
+    auto& indexedPrimitive = m_primitives[materialName];
+    auto& primitive = indexedPrimitive.primitive;
+    primitive.material = material;
+
+    const auto index = [&](const ExportVertex& exportVertex) {
+      const auto vertex = toGltfVertex(exportVertex);
+      const auto [it, inserted] = indexedPrimitive.indices.emplace(
+        vertex, uint32_t(primitive.vertices.size() / GlbSerializer::VertexSize));
+      if (inserted)
+      {
+        primitive.vertices.insert(primitive.vertices.end(), vertex.begin(), vertex.end());
+        primitive.bounds.add(vm::vec3f{vertex[0], vertex[1], vertex[2]});
+      }
+      return it->second;
+    };
+
+    // the polygons are convex, so they can be triangulated as a fan
+    const auto first = index(vertices[0]);
+    auto previous = index(vertices[1]);
+    for (size_t i = 2; i < vertices.size(); ++i)
+    {
+      const auto current = index(vertices[i]);
+      primitive.indices.insert(primitive.indices.end(), {first, previous, current});
+      previous = current;
+    }
+  }
+};
+
+void appendPrimitive(GlbSerializer::Primitive& target, GlbSerializer::Primitive source)
+{
+  const auto offset = uint32_t(target.vertices.size() / GlbSerializer::VertexSize);
+
+  target.material = source.material;
+  target.vertices.insert(
+    target.vertices.end(), source.vertices.begin(), source.vertices.end());
+
+  target.indices.reserve(target.indices.size() + source.indices.size());
+  for (const auto index : source.indices)
+  {
+    target.indices.push_back(offset + index);
+  }
+
+  if (source.bounds.initialized())
+  {
+    target.bounds.add(source.bounds.bounds());
+  }
+}
+
+std::optional<std::string> textureUri(
+  const mdl::Material* material, const GltfExportOptions& options)
+{
+  // materials loaded from image files (pak files) don't have absolute paths
+  if (!material || material->absolutePath().empty())
+  {
+    return std::nullopt;
+  }
+
+  const auto basePath = options.exportPath.parent_path();
+  return encodeUriPath(
+    material->absolutePath().lexically_relative(basePath).generic_string());
+}
+
+/**
+ * Returns the JSON chunk of the GLB file. The binary chunk contains the vertices and then
+ * the indices of each primitive in order.
+ */
+std::string writeJson(
+  const std::map<std::string, GlbSerializer::Primitive>& primitives,
+  const size_t bufferLength,
+  const GltfExportOptions& options)
+{
+  auto json = std::string{};
+  auto out = std::back_inserter(json);
+
+  json += R"({"asset":{"version":"2.0","generator":"BrumSchtick"},"scene":0,)";
+  if (primitives.empty())
+  {
+    json += R"("scenes":[{}]})";
+    return json;
+  }
+
+  json += R"("scenes":[{"nodes":[0]}],"nodes":[{"mesh":0}],)";
+
+  auto meshPrimitives = std::vector<std::string>{};
+  auto materials = std::vector<std::string>{};
+  auto images = std::vector<std::string>{};
+  auto accessors = std::vector<std::string>{};
+  auto bufferViews = std::vector<std::string>{};
+
+  auto byteOffset = size_t(0);
+  for (const auto& [materialName, primitive] : primitives)
+  {
+    const auto vertexCount = primitive.vertices.size() / GlbSerializer::VertexSize;
+    const auto vertexLength = primitive.vertices.size() * sizeof(float);
+    const auto indexLength = primitive.indices.size() * sizeof(uint32_t);
+    const auto& bounds = primitive.bounds.bounds();
+
+    const auto vertexView = bufferViews.size();
+    bufferViews.push_back(std::format(
+      R"({{"buffer":0,"byteOffset":{},"byteLength":{},"byteStride":{},"target":{}}})",
+      byteOffset,
+      vertexLength,
+      GlbSerializer::VertexSize * sizeof(float),
+      TargetArrayBuffer));
+    byteOffset += vertexLength;
+
+    const auto indexView = bufferViews.size();
+    bufferViews.push_back(std::format(
+      R"({{"buffer":0,"byteOffset":{},"byteLength":{},"target":{}}})",
+      byteOffset,
+      indexLength,
+      TargetElementArrayBuffer));
+    byteOffset += indexLength;
+
+    const auto firstAccessor = accessors.size();
+    accessors.push_back(std::format(
+      R"({{"bufferView":{},"byteOffset":0,"componentType":{},"count":{},"type":"VEC3",)"
+      R"("min":[{},{},{}],"max":[{},{},{}]}})",
+      vertexView,
+      ComponentTypeFloat,
+      vertexCount,
+      bounds.min.x(),
+      bounds.min.y(),
+      bounds.min.z(),
+      bounds.max.x(),
+      bounds.max.y(),
+      bounds.max.z()));
+    accessors.push_back(std::format(
+      R"({{"bufferView":{},"byteOffset":12,"componentType":{},"count":{},)"
+      R"("type":"VEC3"}})",
+      vertexView,
+      ComponentTypeFloat,
+      vertexCount));
+    accessors.push_back(std::format(
+      R"({{"bufferView":{},"byteOffset":24,"componentType":{},"count":{},)"
+      R"("type":"VEC2"}})",
+      vertexView,
+      ComponentTypeFloat,
+      vertexCount));
+    accessors.push_back(std::format(
+      R"({{"bufferView":{},"componentType":{},"count":{},"type":"SCALAR"}})",
+      indexView,
+      ComponentTypeUnsignedInt,
+      primitive.indices.size()));
+
+    auto material =
+      std::format(R"({{"name":"{}")", kdl::str_escape_json(materialName));
+    if (const auto uri = textureUri(primitive.material, options))
+    {
+      std::format_to(
+        std::back_inserter(material),
+        R"(,"pbrMetallicRoughness":{{"baseColorTexture":{{"index":{}}},)"
+        R"("metallicFactor":0}})",
+        images.size());
+      images.push_back(std::format(R"({{"uri":"{}"}})", kdl::str_escape_json(*uri)));
+    }
+    material += "}";
+
+    meshPrimitives.push_back(std::format(
+      R"({{"attributes":{{"POSITION":{},"NORMAL":{},"TEXCOORD_0":{}}},)"
+      R"("indices":{},"material":{}}})",
+      firstAccessor,
+      firstAccessor + 1,
+      firstAccessor + 2,
+      firstAccessor + 3,
+      materials.size()));
+    materials.push_back(std::move(material));
+  }
+
+  const auto writeArray = [&](const std::string_view name, const auto& elements) {
+    std::format_to(out, R"("{}":[)", name);
+    for (size_t i = 0; i < elements.size(); ++i)
+    {
+      json += i > 0 ? "," : "";
+      json += elements[i];
+    }
+    json += "],";
+  };
+
+  json += R"("meshes":[{"primitives":[)";
+  for (size_t i = 0; i < meshPrimitives.size(); ++i)
+  {
+    json += i > 0 ? "," : "";
+    json += meshPrimitives[i];
+  }
+  json += "]}],";
+
+  writeArray("materials", materials);
+  if (!images.empty())
+  {
+    // every image is used by exactly one texture
+    auto textures = std::vector<std::string>{};
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+      textures.push_back(std::format(R"({{"source":{}}})", i));
+    }
+    writeArray("textures", textures);
+    writeArray("images", images);
+  }
+  writeArray("accessors", accessors);
+  writeArray("bufferViews", bufferViews);
+  std::format_to(out, R"("buffers":[{{"byteLength":{}}}]}})", bufferLength);
+
+  return json;
+}
+
+void writeUInt32(std::ostream& stream, const uint32_t value)
+{
+  static_assert(std::endian::native == std::endian::little);
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+void writeData(std::ostream& stream, const std::vector<T>& data)
+{
+  stream.write(
+    reinterpret_cast<const char*>(data.data()), std::streamsize(data.size() * sizeof(T)));
+}
+
+size_t paddedLength(const size_t length)
+{
+  return (length + 3u) & ~size_t(3u);
+}
+
+} // namespace
+
+GlbSerializer::GlbSerializer(std::ostream& stream, GltfExportOptions options)
+  : m_stream{stream}
+  , m_options{std::move(options)}
+{
+  contract_pre(m_stream.good());
+}
+
+const Result<void>& GlbSerializer::result() const
+{
+  return m_result;
+}
+
+void GlbSerializer::doBeginFile(
+  const std::vector<const mdl::Node*>& /* rootNodes */, kdl::task_manager& taskManager)
+{
+  m_taskManager = &taskManager;
+  m_pendingObjects.reserve(BatchSize);
+}
+
+void GlbSerializer::doEndFile()
+{
+  convertPendingObjects();
+
+  auto bufferLength = size_t(0);
+  for (const auto& [materialName, primitive] : m_primitives)
+  {
+    bufferLength += primitive.vertices.size() * sizeof(float);
+    bufferLength += primitive.indices.size() * sizeof(uint32_t);
+  }
+
+  auto json = writeJson(m_primitives, bufferLength, m_options);
+  json.resize(paddedLength(json.size()), ' ');
+
+  const auto binaryChunkLength = bufferLength > 0 ? 8u + paddedLength(bufferLength) : 0u;
+  const auto totalLength = 12u + 8u + json.size() + binaryChunkLength;
+  if (totalLength > std::numeric_limits<uint32_t>::max())
+  {
+    m_result = Error{std::format(
+      "Exported geometry is too large for a GLB file ({} bytes)", totalLength)};
+    return;
+  }
+
+  writeUInt32(m_stream, GlbMagic);
+  writeUInt32(m_stream, GlbVersion);
+  writeUInt32(m_stream, uint32_t(totalLength));
+
+  writeUInt32(m_stream, uint32_t(json.size()));
+  writeUInt32(m_stream, JsonChunkType);
+  m_stream << json;
+
+  if (bufferLength > 0)
+  {
+    writeUInt32(m_stream, uint32_t(paddedLength(bufferLength)));
+    writeUInt32(m_stream, BinaryChunkType);
+    for (const auto& [materialName, primitive] : m_primitives)
+    {
+      writeData(m_stream, primitive.vertices);
+      writeData(m_stream, primitive.indices);
+    }
+    for (size_t i = bufferLength; i < paddedLength(bufferLength); ++i)
+    {
+      m_stream.put('\0');
+    }
+  }
+}
+
+void GlbSerializer::doBeginEntity(const mdl::Node*) {}
+void GlbSerializer::doEndEntity(const mdl::Node*) {}
+void GlbSerializer::doEntityProperty(const mdl::EntityProperty&) {}
+
+void GlbSerializer::doBrush(const mdl::BrushNode* brush)
+{
+  addObject(ExportObject{brush, entityNo(), brushNo()});
+}
+
+void GlbSerializer::doBrushFace(const mdl::BrushFace&) {}
+
+void GlbSerializer::doPatch(const mdl::PatchNode* patchNode)
+{
+  addObject(ExportObject{patchNode, entityNo(), brushNo()});
+}
+
+void GlbSerializer::addObject(ExportObject object)
+{
+  m_pendingObjects.push_back(std::move(object));
+  if (m_pendingObjects.size() == BatchSize)
+  {
+    convertPendingObjects();
+  }
+}
+
+void GlbSerializer::convertPendingObjects()
+{
+  contract_pre(m_taskManager != nullptr);
+
+  if (m_pendingObjects.empty())
+  {
+    return;
+  }
+
+  auto blocks = convertExportBlocks(
+    m_pendingObjects, BlockSize, *m_taskManager, [](const auto& objects) {
+      auto builder = BlockBuilder{};
+      for (const auto& object : objects)
+      {
+        builder.addObject(object);
+      }
+      return std::move(builder).build();
+    });
+
+  for (auto& block : blocks)
+  {
+    for (auto& [materialName, primitive] : block)
+    {
+      appendPrimitive(m_primitives[materialName], std::move(primitive));
+    }
+  }
+
+  m_pendingObjects.clear();
+}
+
+std::string encodeUriPath(const std::string_view path)
+{
+  const auto isUnreserved = [](const unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+           || c == '-' || c == '.' || c == '_' || c == '~' || c == '/';
+  };
+
+  auto result = std::string{};
+  result.reserve(path.size());
+  for (const auto c : path)
+  {
+    const auto uc = static_cast<unsigned char>(c);
+    if (isUnreserved(uc))
+    {
+      result += c;
+    }
+    else
+    {
+      std::format_to(std::back_inserter(result), "%{:02X}", uc);
+    }
+  }
+  return result;
+}
+
+} // namespace tb::io
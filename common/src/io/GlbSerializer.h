@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Result.h"
+#include "io/ExportGeometry.h"
+#include "io/ExportOptions.h"
+#include "io/NodeSerializer.h"
+
+#include "vm/bbox.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tb
+{
+namespace mdl
+{
+class BrushNode;
+class BrushFace;
+class EntityProperty;
+class Material;
+class Node;
+class PatchNode;
+} // namespace mdl
+
+namespace io
+{
+
+/**
+ * Exports brushes and patches to a binary glTF (GLB) file.
+ *
+ * The geometry is grouped into one primitive per material. Each primitive has an
+ * interleaved vertex buffer with positions, normals and UV coordinates and a buffer of
+ * triangle indices. Materials refer to their textures relative to the export path if
+ * their absolute path is known.
+ *
+ * Like ObjSerializer, the exporter converts the brushes and patches passed to it in
+ * batches of blocks that are processed in parallel. Since a GLB file stores the sizes of
+ * all buffers in its header, the binary geometry is kept in memory until the end of the
+ * file. Since the GLB header stores the file length as a 32 bit integer, no file is
+ * written if the exported geometry exceeds that length, and result() returns an error.
+ */
+class GlbSerializer : public NodeSerializer
+{
+public:
+  static constexpr size_t BlockSize = 256;
+  static constexpr size_t BatchSize = 16 * BlockSize;
+
+  // position, normal and UV coordinates
+  static constexpr size_t VertexSize = 8;
+
+  struct Primitive
+  {
+    const mdl::Material* material = nullptr;
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    vm::bbox3f::builder bounds;
+  };
+
+private:
+  std::ostream& m_stream;
+  GltfExportOptions m_options;
+
+  kdl::task_manager* m_taskManager = nullptr;
+  std::vector<ExportObject> m_pendingObjects;
+
+  std::map<std::string, Primitive> m_primitives;
+  Result<void> m_result;
+
+public:
+  GlbSerializer(std::ostream& stream, GltfExportOptions options);
+
+  /**
+   * Returns an error if the GLB file could not be written.
+   */
+  const Result<void>& result() const;
+
+private:
+  void doBeginFile(
+    const std::vector<const mdl::Node*>& rootNodes,
+    kdl::task_manager& taskManager) override;
+  void doEndFile() override;
+
+  void doBeginEntity(const mdl::Node* node) override;
+  void doEndEntity(const mdl::Node* node) override;
+  void doEntityProperty(const mdl::EntityProperty& property) override;
+
+  void doBrush(const mdl::BrushNode* brush) override;
+  void doBrushFace(const mdl::BrushFace& face) override;
+
+  void doPatch(const mdl::PatchNode* patchNode) override;
+
+  void addObject(ExportObject object);
+  void convertPendingObjects();
+};
+
+/**
+ * Percent encodes the given relative path so that it can be used as a URI reference.
+ * Unreserved characters and path separators are kept, every other byte is encoded.
+ */
+std::string encodeUriPath(std::string_view path);
+
+} // namespace io
+} // namespace tb
@@ -25,6 +25,7 @@
 #include "io/AssimpLoader.h"
 #include "io/BspLoader.h"
 #include "io/DkmLoader.h"
+#include "io/EntityModelCache.h"
 #include "io/ImageSpriteLoader.h"
 #include "io/Md2Loader.h"
 #include "io/Md3Loader.h"
@@ -35,9 +36,12 @@
 #include "mdl/GameConfig.h"
 #include "mdl/Palette.h"
 
+#include "kd/path_utils.h"
 #include "kd/result.h"
 
 #include <format>
+#include <memory>
+#include <optional>
 
 namespace tb::io
 {
@@ -52,11 +56,14 @@ auto loadPalette(const fs::FileSystem& fs, const mdl::MaterialConfig& materialCo
          | kdl::and_then([&](auto file) { return mdl::loadPalette(*file, path); });
 }
 
-Result<mdl::EntityModelData> loadEntityModelData(
+Result<mdl::EntityModelData> decodeEntityModelData(
   const fs::FileSystem& fs,
   const mdl::MaterialConfig& materialConfig,
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
+  const std::shared_ptr<AssimpTexturePathCache>& assimpTexturePathCache,
+  const RecordEntityModelDependencyFunc& recordDependency,
+  kdl::task_manager& taskManager,
   Logger& logger)
 {
   const auto modelName = path.filename().string();
@@ -81,7 +88,8 @@ Result<mdl::EntityModelData> loadEntityModelData(
              if (io::BspLoader::canParse(path, reader))
              {
                return loadPalette(fs, materialConfig) | kdl::and_then([&](auto palette) {
-                        auto loader = io::BspLoader{modelName, reader, palette, fs};
+                        auto loader =
+                          io::BspLoader{modelName, reader, palette, fs, taskManager};
                         return loader.load(logger);
                       });
              }
@@ -119,14 +127,59 @@ Result<mdl::EntityModelData> loadEntityModelData(
              }
              if (io::AssimpLoader::canParse(path))
              {
-               auto loader = io::AssimpLoader{path, fs};
+               auto loader = io::AssimpLoader{
+                 path, fs, taskManager, assimpTexturePathCache, recordDependency};
                return loader.load(logger);
              }
              return Error{std::format("Unknown model format: {}", path.string())};
-           })
+           });
+}
+
+/**
+ * MD3 and ASE models load their skins from shaders, which the entity model cache cannot
+ * track, so these models are never cached.
+ */
+bool canCacheEntityModel(const std::filesystem::path& path)
+{
+  const auto lowerPath = kdl::path_to_lower(path);
+  return !kdl::path_has_extension(lowerPath, ".md3")
+         && !kdl::path_has_extension(lowerPath, ".ase");
+}
+
+Result<mdl::EntityModelData> loadEntityModelData(
+  const fs::FileSystem& fs,
+  const mdl::MaterialConfig& materialConfig,
+  const std::filesystem::path& path,
+  const LoadMaterialFunc& loadMaterial,
+  const std::optional<std::filesystem::path>& cacheDirectory,
+  const std::shared_ptr<AssimpTexturePathCache>& assimpTexturePathCache,
+  kdl::task_manager& taskManager,
+  Logger& logger)
+{
+  const auto decode = [&](const auto& decodeFs, const auto& recordDependency) {
+    return decodeEntityModelData(
+      decodeFs,
+      materialConfig,
+      path,
+      loadMaterial,
+      assimpTexturePathCache,
+      recordDependency,
+      taskManager,
+      logger);
+  };
+
+  return (cacheDirectory && canCacheEntityModel(path)
+            ? loadCachedEntityModelData(
+                *cacheDirectory,
+                fs,
+                path,
+                materialConfig.palette.generic_string(),
+                decode,
+                logger)
+            : decode(fs, RecordEntityModelDependencyFunc{}))
          | kdl::or_else([&](const auto& e) {
-             return Result<mdl::EntityModelData>{Error{
-               std::format("Failed to load entity model '{}': {}", modelName, e.msg)}};
+             return Result<mdl::EntityModelData>{Error{std::format(
+               "Failed to load entity model '{}': {}", path.filename().string(), e.msg)}};
            });
 }
 
@@ -135,10 +188,28 @@ mdl::ResourceLoader<mdl::EntityModelData> makeEntityModelDataResourceLoader(
   const mdl::MaterialConfig& materialConfig,
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
+  const std::optional<std::filesystem::path>& cacheDirectory,
+  std::shared_ptr<AssimpTexturePathCache> assimpTexturePathCache,
+  kdl::task_manager& taskManager,
   Logger& logger)
 {
-  return [&fs, materialConfig, path, loadMaterial, &logger]() {
-    return loadEntityModelData(fs, materialConfig, path, loadMaterial, logger);
+  return [&fs,
+          materialConfig,
+          path,
+          loadMaterial,
+          cacheDirectory,
+          assimpTexturePathCache = std::move(assimpTexturePathCache),
+          &taskManager,
+          &logger]() {
+    return loadEntityModelData(
+      fs,
+      materialConfig,
+      path,
+      loadMaterial,
+      cacheDirectory,
+      assimpTexturePathCache,
+      taskManager,
+      logger);
   };
 }
 
@@ -149,9 +220,18 @@ Result<mdl::EntityModel> loadEntityModelSync(
   const mdl::MaterialConfig& materialConfig,
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
+  kdl::task_manager& taskManager,
   Logger& logger)
 {
-  return loadEntityModelData(fs, materialConfig, path, loadMaterial, logger)
+  return loadEntityModelData(
+           fs,
+           materialConfig,
+           path,
+           loadMaterial,
+           std::nullopt,
+           std::make_shared<AssimpTexturePathCache>(),
+           taskManager,
+           logger)
          | kdl::transform([&](auto modelData) {
              auto modelName = path.filename().string();
              auto modelResource =
@@ -165,12 +245,22 @@ mdl::EntityModel loadEntityModelAsync(
   const mdl::MaterialConfig& materialConfig,
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
+  const std::optional<std::filesystem::path>& cacheDirectory,
+  std::shared_ptr<AssimpTexturePathCache> assimpTexturePathCache,
   const mdl::CreateEntityModelDataResource& createResource,
+  kdl::task_manager& taskManager,
   Logger& logger)
 {
   auto name = path.filename().string();
-  auto loader =
-    makeEntityModelDataResourceLoader(fs, materialConfig, path, loadMaterial, logger);
+  auto loader = makeEntityModelDataResourceLoader(
+    fs,
+    materialConfig,
+    path,
+    loadMaterial,
+    cacheDirectory,
+    std::move(assimpTexturePathCache),
+    taskManager,
+    logger);
   auto resource = createResource(std::move(loader));
   return mdl::EntityModel{std::move(name), std::move(resource)};
 }
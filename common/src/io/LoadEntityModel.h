@@ -24,6 +24,13 @@
 
 #include <filesystem>
 #include <functional>
+#include <memory>
+#include <optional>
+
+namespace kdl
+{
+class task_manager;
+}
 
 namespace tb
 {
@@ -43,6 +50,7 @@ struct MaterialConfig;
 
 namespace io
 {
+class AssimpTexturePathCache;
 
 using LoadMaterialFunc = std::function<mdl::Material(const std::filesystem::path&)>;
 
@@ -51,6 +59,7 @@ Result<mdl::EntityModel> loadEntityModelSync(
   const mdl::MaterialConfig& materialConfig,
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
+  kdl::task_manager& taskManager,
   Logger& logger);
 
 mdl::EntityModel loadEntityModelAsync(
@@ -58,7 +67,10 @@ mdl::EntityModel loadEntityModelAsync(
   const mdl::MaterialConfig& materialConfig,
   const std::filesystem::path& path,
   const LoadMaterialFunc& loadMaterial,
+  const std::optional<std::filesystem::path>& cacheDirectory,
+  std::shared_ptr<AssimpTexturePathCache> assimpTexturePathCache,
   const mdl::CreateEntityModelDataResource& createResource,
+  kdl::task_manager& taskManager,
   Logger& logger);
 
 } // namespace io
@@ -22,6 +22,7 @@
 #include "Error.h" // IWYU pragma: keep
 #include "Logger.h"
 #include "SimpleParserStatus.h"
+#include "Trace.h"
 #include "fs/FileSystem.h"
 #include "fs/PathInfo.h"
 #include "fs/TraversalMode.h"
@@ -77,6 +78,8 @@ Result<std::vector<mdl::Quake3Shader>> loadShaders(
            fs::TraversalMode::Flat,
            fs::makeExtensionPathMatcher({".shader"}))
          | kdl::and_then([&](auto paths) {
+             const auto trace =
+               TraceScope{"loadShaders", std::format("{} files", paths.size())};
              auto tasks =
                paths | std::views::transform([&](const auto& path) {
                  return std::function{[&]() { return loadShader(fs, path, logger); }};
@@ -20,6 +20,8 @@
 #include "MapFileSerializer.h"
 
 #include "Macros.h"
+#include "Trace.h"
+#include "io/ChunkedOutputStream.h"
 #include "mdl/BezierPatch.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushFaceAttributes.h"
@@ -40,7 +42,6 @@
 
 #include <iterator>
 #include <memory>
-#include <sstream>
 #include <string_view>
 #include <utility>
 #include <variant>
@@ -50,6 +51,7 @@ namespace tb::io
 {
 namespace
 {
+
 bool shouldQuoteMaterialName(const std::string_view materialName)
 {
   return materialName.empty()
@@ -340,6 +342,10 @@ void MapFileSerializer::doBeginFile(
         nodesToSerialize.emplace_back(patchNode);
       }));
 
+  const auto trace = TraceScope{
+    "MapFileSerializer::doBeginFile",
+    std::format("{} nodes", nodesToSerialize.size())};
+
   // serialize brushes to strings in parallel
   using Entry = std::pair<const mdl::Node*, PrecomputedString>;
   auto tasks = nodesToSerialize | std::views::transform([&](const auto& node) {
@@ -406,6 +412,7 @@ void MapFileSerializer::doBrush(const mdl::BrushNode* brush)
   const auto& precomputedString = it->second;
   m_stream << precomputedString.string;
   m_line += precomputedString.lineCount;
+  m_nodeToPrecomputedString.erase(it);
 
   std::format_to(std::ostreambuf_iterator<char>{m_stream}, "}}\n");
   ++m_line;
@@ -433,6 +440,7 @@ void MapFileSerializer::doPatch(const mdl::PatchNode* patchNode)
   const auto& precomputedString = it->second;
   m_stream << precomputedString.string;
   m_line += precomputedString.lineCount;
+  m_nodeToPrecomputedString.erase(it);
 
   setFilePosition(patchNode);
 }
@@ -458,19 +466,21 @@ size_t MapFileSerializer::startLine()
 MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(
   const mdl::Brush& brush) const
 {
-  auto stream = std::stringstream{};
+  auto stream = ChunkedOutputStream{brush.faces().size() * EstimatedFaceLength};
   for (const auto& face : brush.faces())
   {
     doWriteBrushFace(stream, face);
   }
-  return {stream.str(), brush.faces().size()};
+  return {std::move(stream).str(), brush.faces().size()};
 }
 
 MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
   const mdl::BezierPatch& patch) const
 {
   size_t lineCount = 0u;
-  auto stream = std::stringstream{};
+  auto stream = ChunkedOutputStream{
+    (patch.pointRowCount() + 1u) * (patch.pointColumnCount() + 1u)
+    * EstimatedPatchPointLength};
   const bool writeNormals = patch.hasControlNormals();
 
   std::format_to(std::ostreambuf_iterator<char>{stream}, "{{\n");
@@ -547,7 +557,7 @@ MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
   std::format_to(std::ostreambuf_iterator<char>{stream}, "}}\n");
   ++lineCount;
 
-  return {stream.str(), lineCount};
+  return {std::move(stream).str(), lineCount};
 }
 
 } // namespace tb::io
@@ -46,6 +46,11 @@ namespace io
 
 class MapFileSerializer : public NodeSerializer
 {
+public:
+  // estimated serialized lengths, used to pre-size output buffers
+  static constexpr size_t EstimatedFaceLength = 128;
+  static constexpr size_t EstimatedPatchPointLength = 48;
+
 private:
   using LineStack = std::vector<size_t>;
   LineStack m_startLineStack;
@@ -22,6 +22,7 @@
 #include "Error.h" // IWYU pragma: keep
 #include "FileLocation.h"
 #include "ParserStatus.h"
+#include "Trace.h"
 #include "Uuid.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
@@ -654,6 +655,9 @@ std::vector<std::optional<NodeInfo>> createNodesFromObjectInfos(
   ParserStatus& status,
   kdl::task_manager& taskManager)
 {
+  const auto trace = TraceScope{
+    "createNodesFromObjectInfos", std::format("{} objects", objectInfos.size())};
+
   // create nodes in parallel, moving data out of objectInfos
   // we store optionals in the result vector to make the elements default constructible,
   // which is a requirement for parallel transform
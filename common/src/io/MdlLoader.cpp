@@ -36,6 +36,7 @@
 
 #include <format>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -250,21 +251,26 @@ auto unpackFrameVertex(
   return result;
 }
 
-auto parseFrameVertices(
-  fs::Reader reader,
-  const std::vector<MdlSkinVertex>& vertices,
-  const vm::vec3f& origin,
-  const vm::vec3f& scale)
+using PackedFrameVertex = vm::vec<unsigned char, 4>;
+
+auto parsePackedFrameVertices(fs::Reader reader, const size_t vertexCount)
 {
-  auto packedVertices = std::vector<vm::vec<unsigned char, 4>>{vertices.size()};
-  for (size_t i = 0; i < vertices.size(); ++i)
+  auto packedVertices = std::vector<PackedFrameVertex>{vertexCount};
+  for (size_t i = 0; i < vertexCount; ++i)
   {
     for (size_t j = 0; j < 4; ++j)
     {
       packedVertices[i][j] = reader.readUnsignedChar<char>();
     }
   }
+  return packedVertices;
+}
 
+auto unpackFrameVertices(
+  const std::vector<PackedFrameVertex>& packedVertices,
+  const vm::vec3f& origin,
+  const vm::vec3f& scale)
+{
   return packedVertices | std::views::transform([&](const auto& vertex) {
            return unpackFrameVertex(vertex, origin, scale);
          })
@@ -307,8 +313,8 @@ void doParseFrame(
   fs::Reader reader,
   mdl::EntityModelData& model,
   mdl::EntityModelSurface& surface,
-  const std::vector<MdlSkinTriangle>& triangles,
-  const std::vector<MdlSkinVertex>& vertices,
+  const std::shared_ptr<const std::vector<MdlSkinTriangle>>& triangles,
+  const std::shared_ptr<const std::vector<MdlSkinVertex>>& vertices,
   const size_t skinWidth,
   const size_t skinHeight,
   const vm::vec3f& origin,
@@ -317,38 +323,47 @@ void doParseFrame(
   reader.seekForward(MdlLayout::SimpleFrameName);
   auto name = reader.readString(MdlLayout::SimpleFrameLength);
 
-  const auto positions = parseFrameVertices(reader, vertices, origin, scale);
+  // only the packed vertices are kept until the frame is decoded
+  auto packedVertices = parsePackedFrameVertices(reader, vertices->size());
 
   auto bounds = vm::bbox3f::builder{};
-  bounds.add(positions.begin(), positions.end());
-
-  const auto frameTriangles =
-    makeFrameTriangles(triangles, vertices, positions, skinWidth, skinHeight);
-
-  auto size = render::IndexRangeMap::Size{};
-  size.inc(render::PrimType::Triangles, frameTriangles.size());
-
-  auto builder = render::IndexRangeMapBuilder<mdl::EntityModelVertex::Type>{
-    frameTriangles.size() * 3, size};
-  builder.addTriangles(frameTriangles);
+  for (const auto& packedVertex : packedVertices)
+  {
+    bounds.add(unpackFrameVertex(packedVertex, origin, scale));
+  }
 
   auto& frame = model.addFrame(std::move(name), bounds.bounds());
-  surface.addMesh(frame, std::move(builder.vertices()), std::move(builder.indices()));
+  surface.addMesh(
+    frame,
+    [=, packedVertices = std::move(packedVertices)]() -> mdl::EntityModelMeshData {
+      const auto positions = unpackFrameVertices(packedVertices, origin, scale);
+      const auto frameTriangles =
+        makeFrameTriangles(*triangles, *vertices, positions, skinWidth, skinHeight);
+
+      auto size = render::IndexRangeMap::Size{};
+      size.inc(render::PrimType::Triangles, frameTriangles.size());
+
+      auto builder = render::IndexRangeMapBuilder<mdl::EntityModelVertex::Type>{
+        frameTriangles.size() * 3, size};
+      builder.addTriangles(frameTriangles);
+
+      return {std::move(builder.vertices()), std::move(builder.indices())};
+    });
 }
 
 void parseFrame(
   fs::Reader& reader,
   mdl::EntityModelData& model,
   mdl::EntityModelSurface& surface,
-  const std::vector<MdlSkinTriangle>& triangles,
-  const std::vector<MdlSkinVertex>& vertices,
+  const std::shared_ptr<const std::vector<MdlSkinTriangle>>& triangles,
+  const std::shared_ptr<const std::vector<MdlSkinVertex>>& vertices,
   size_t skinWidth,
   size_t skinHeight,
   const vm::vec3f& origin,
   const vm::vec3f& scale)
 {
   const auto frameLength =
-    MdlLayout::SimpleFrameName + MdlLayout::SimpleFrameLength + vertices.size() * 4;
+    MdlLayout::SimpleFrameName + MdlLayout::SimpleFrameLength + vertices->size() * 4;
 
   const auto type = reader.readInt<int32_t>();
   if (type == 0)
@@ -559,8 +574,10 @@ Result<mdl::EntityModelData> MdlLoader::load(Logger& /* logger */)
     parseSkins(
       reader, surface, skinCount, skinWidth, skinHeight, flags, m_name, m_palette);
 
-    const auto vertices = parseVertices(reader, vertexCount);
-    const auto triangles = parseTriangles(reader, triangleCount);
+    const auto vertices = std::make_shared<const std::vector<MdlSkinVertex>>(
+      parseVertices(reader, vertexCount));
+    const auto triangles = std::make_shared<const std::vector<MdlSkinTriangle>>(
+      parseTriangles(reader, triangleCount));
 
     for (size_t i = 0; i < frameCount; ++i)
     {
@@ -19,21 +19,244 @@
 
 #include "NodeReader.h"
 
+#include "Macros.h"
+#include "ParserException.h"
 #include "ParserStatus.h"
+#include "io/StandardMapParser.h"
 #include "mdl/BrushNode.h"
 #include "mdl/EntityNode.h"
 #include "mdl/EntityProperties.h"
 #include "mdl/LayerNode.h"
 #include "mdl/LinkedGroupUtils.h"
+#include "mdl/MapFormat.h"
 #include "mdl/WorldNode.h"
 
 #include "kd/vector_utils.h"
 
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace tb::io
 {
+namespace
+{
+
+/**
+ * The syntax of the brushes and patches found in map data. Each map format accepts only
+ * some of these.
+ */
+enum class ObjectSyntax
+{
+  None,
+  ParaxialFaces,
+  ParallelFaces,
+  BrushPrimitives,
+  Patches,
+};
+
+bool isQuake3Format(const mdl::MapFormat mapFormat)
+{
+  return mapFormat == mdl::MapFormat::Quake3 || mapFormat == mdl::MapFormat::Quake3_Valve
+         || mapFormat == mdl::MapFormat::Quake3_Legacy;
+}
+
+bool acceptsSyntax(const mdl::MapFormat mapFormat, const ObjectSyntax syntax)
+{
+  switch (syntax)
+  {
+  case ObjectSyntax::None:
+    return true;
+  case ObjectSyntax::ParaxialFaces:
+    return !mdl::isParallelUVCoordSystem(mapFormat);
+  case ObjectSyntax::ParallelFaces:
+    return mdl::isParallelUVCoordSystem(mapFormat);
+  case ObjectSyntax::BrushPrimitives:
+    return mapFormat == mdl::MapFormat::Quake3;
+  case ObjectSyntax::Patches:
+    return isQuake3Format(mapFormat);
+    switchDefault();
+  }
+}
+
+bool isPatchId(const std::string& str)
+{
+  return str == StandardMapParser::PatchId || str == StandardMapParser::Patch3Id;
+}
+
+/**
+ * Determines the face syntax from the tokens following the opening parenthesis of the
+ * first face point: three points, the material name and then either the first texture
+ * axis of a parallel face or the first offset of a paraxial face.
+ */
+std::optional<ObjectSyntax> scanFace(QuakeMapTokenizer& tokenizer)
+{
+  for (size_t i = 0; i < 3;)
+  {
+    const auto token = tokenizer.nextToken();
+    if (token.hasType(QuakeMapToken::Eof))
+    {
+      return std::nullopt;
+    }
+    if (token.hasType(QuakeMapToken::CParenthesis))
+    {
+      ++i;
+    }
+  }
+
+  // skip the material name
+  if (tokenizer.nextToken().hasType(QuakeMapToken::Eof))
+  {
+    return std::nullopt;
+  }
+
+  const auto token = tokenizer.nextToken();
+  if (token.hasType(QuakeMapToken::OBracket))
+  {
+    return ObjectSyntax::ParallelFaces;
+  }
+  if (token.hasType(QuakeMapToken::Number))
+  {
+    return ObjectSyntax::ParaxialFaces;
+  }
+  return std::nullopt;
+}
+
+/**
+ * Skips the braced block of a patch definition.
+ */
+bool skipPatch(QuakeMapTokenizer& tokenizer)
+{
+  if (!tokenizer.nextToken().hasType(QuakeMapToken::OBrace))
+  {
+    return false;
+  }
+
+  for (size_t depth = 1; depth > 0;)
+  {
+    const auto token = tokenizer.nextToken();
+    if (token.hasType(QuakeMapToken::Eof))
+    {
+      return false;
+    }
+    if (token.hasType(QuakeMapToken::OBrace))
+    {
+      ++depth;
+    }
+    else if (token.hasType(QuakeMapToken::CBrace))
+    {
+      --depth;
+    }
+  }
+  return true;
+}
+
+/**
+ * Scans the remaining tokens until the syntax of the first brush is known. Patches are
+ * skipped because every Quake 3 format accepts them, so the brushes following them must
+ * decide between these formats.
+ */
+std::optional<ObjectSyntax> scanObjects(QuakeMapTokenizer& tokenizer)
+{
+  auto foundPatch = false;
+  while (true)
+  {
+    const auto token = tokenizer.nextToken();
+    if (token.hasType(QuakeMapToken::Eof))
+    {
+      return foundPatch ? ObjectSyntax::Patches : ObjectSyntax::None;
+    }
+    if (token.hasType(QuakeMapToken::OParenthesis))
+    {
+      return scanFace(tokenizer);
+    }
+    if (token.hasType(QuakeMapToken::String))
+    {
+      const auto data = token.data();
+      if (data == StandardMapParser::BrushPrimitiveId)
+      {
+        return ObjectSyntax::BrushPrimitives;
+      }
+      if (isPatchId(data))
+      {
+        if (!skipPatch(tokenizer))
+        {
+          return std::nullopt;
+        }
+        foundPatch = true;
+      }
+    }
+  }
+}
+
+std::optional<MapDataKind> scanKind(QuakeMapTokenizer& tokenizer)
+{
+  const auto first = tokenizer.skipAndPeekToken(QuakeMapToken::Comment);
+  if (first.hasType(QuakeMapToken::OParenthesis))
+  {
+    return MapDataKind::BrushFaces;
+  }
+  if (!first.hasType(QuakeMapToken::OBrace))
+  {
+    return std::nullopt;
+  }
+
+  // peek at the token following the opening brace without consuming it, so that the
+  // object scan sees the entire first object
+  const auto snapshot = tokenizer.snapshot();
+  tokenizer.nextToken();
+  const auto second = tokenizer.skipAndNextToken(QuakeMapToken::Comment);
+  tokenizer.restore(snapshot);
+
+  if (second.hasType(QuakeMapToken::OParenthesis))
+  {
+    return MapDataKind::Brushes;
+  }
+  if (second.hasType(QuakeMapToken::String))
+  {
+    const auto data = second.data();
+    return data == StandardMapParser::BrushPrimitiveId || isPatchId(data)
+             ? MapDataKind::Brushes
+             : MapDataKind::Entities;
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+std::optional<MapDataFormat> detectMapDataFormat(
+  const std::string_view str, const mdl::MapFormat preferredMapFormat)
+{
+  try
+  {
+    auto tokenizer = QuakeMapTokenizer{str};
+    const auto kind = scanKind(tokenizer);
+    if (!kind)
+    {
+      return std::nullopt;
+    }
+
+    const auto syntax = scanObjects(tokenizer);
+    if (!syntax)
+    {
+      return std::nullopt;
+    }
+
+    for (const auto mapFormat : mdl::compatibleFormats(preferredMapFormat))
+    {
+      if (mapFormat != mdl::MapFormat::Unknown && acceptsSyntax(mapFormat, *syntax))
+      {
+        return MapDataFormat{*kind, mapFormat};
+      }
+    }
+    return std::nullopt;
+  }
+  catch (const ParserException&)
+  {
+    return std::nullopt;
+  }
+}
 
 NodeReader::NodeReader(
   const std::string_view str,
@@ -52,7 +275,45 @@ Result<std::vector<mdl::Node*>> NodeReader::read(
   ParserStatus& status,
   kdl::task_manager& taskManager)
 {
-  // Try preferred format first
+  const auto initializeLinkIds = [&](auto nodes) {
+    for (const auto& error : mdl::initializeLinkIds(nodes))
+    {
+      status.error("Could not restore linked groups: " + error.msg);
+    }
+    return nodes;
+  };
+
+  if (const auto format = detectMapDataFormat(str, preferredMapFormat))
+  {
+    switch (format->kind)
+    {
+    case MapDataKind::Entities:
+      return readEntitiesAsFormat(
+               format->mapFormat,
+               preferredMapFormat,
+               str,
+               worldBounds,
+               entityPropertyConfig,
+               status,
+               taskManager)
+             | kdl::transform(initializeLinkIds);
+    case MapDataKind::Brushes:
+      return readBrushesAsFormat(
+               format->mapFormat,
+               preferredMapFormat,
+               str,
+               worldBounds,
+               entityPropertyConfig,
+               status,
+               taskManager)
+             | kdl::transform(initializeLinkIds);
+    case MapDataKind::BrushFaces:
+      return Error{"Map data contains brush faces"};
+      switchDefault();
+    }
+  }
+
+  // Detection was ambiguous, try preferred format first
   for (const auto compatibleMapFormat : mdl::compatibleFormats(preferredMapFormat))
   {
     if (
@@ -65,13 +326,7 @@ Result<std::vector<mdl::Node*>> NodeReader::read(
         status,
         taskManager))
     {
-      return std::move(result) | kdl::transform([&](auto nodes) {
-               for (const auto& error : mdl::initializeLinkIds(nodes))
-               {
-                 status.error("Could not restore linked groups: " + error.msg);
-               }
-               return nodes;
-             });
+      return std::move(result) | kdl::transform(initializeLinkIds);
     }
   }
 
@@ -79,6 +334,56 @@ Result<std::vector<mdl::Node*>> NodeReader::read(
   return Error{"Could not parse map data"};
 }
 
+Result<std::vector<mdl::Node*>> NodeReader::readEntitiesAsFormat(
+  const mdl::MapFormat sourceMapFormat,
+  const mdl::MapFormat targetMapFormat,
+  const std::string& str,
+  const vm::bbox3d& worldBounds,
+  const mdl::EntityPropertyConfig& entityPropertyConfig,
+  ParserStatus& status,
+  kdl::task_manager& taskManager)
+{
+  auto reader = NodeReader{str, sourceMapFormat, targetMapFormat, entityPropertyConfig};
+  return reader.readEntities(worldBounds, status, taskManager)
+         | kdl::transform([&]() {
+             status.info(
+               "Parsed successfully as " + mdl::formatName(sourceMapFormat)
+               + " entities");
+             return reader.m_nodes;
+           })
+         | kdl::if_error([&](const auto& error) {
+             status.info(
+               "Couldn't parse as " + mdl::formatName(sourceMapFormat)
+               + " entities: " + error.msg);
+             kdl::vec_clear_and_delete(reader.m_nodes);
+           });
+}
+
+Result<std::vector<mdl::Node*>> NodeReader::readBrushesAsFormat(
+  const mdl::MapFormat sourceMapFormat,
+  const mdl::MapFormat targetMapFormat,
+  const std::string& str,
+  const vm::bbox3d& worldBounds,
+  const mdl::EntityPropertyConfig& entityPropertyConfig,
+  ParserStatus& status,
+  kdl::task_manager& taskManager)
+{
+  auto reader = NodeReader{str, sourceMapFormat, targetMapFormat, entityPropertyConfig};
+  return reader.readBrushes(worldBounds, status, taskManager)
+         | kdl::transform([&]() {
+             status.info(
+               "Parsed successfully as " + mdl::formatName(sourceMapFormat)
+               + " brushes");
+             return reader.m_nodes;
+           })
+         | kdl::if_error([&](const auto& error) {
+             status.info(
+               "Couldn't parse as " + mdl::formatName(sourceMapFormat)
+               + " brushes: " + error.msg);
+             kdl::vec_clear_and_delete(reader.m_nodes);
+           });
+}
+
 /**
  * Attempts to parse the string as one or more entities (in the given source format),
  * and if that fails, as one or more brushes.
@@ -97,36 +402,23 @@ Result<std::vector<mdl::Node*>> NodeReader::readAsFormat(
   ParserStatus& status,
   kdl::task_manager& taskManager)
 {
-  auto entityReader =
-    NodeReader{str, sourceMapFormat, targetMapFormat, entityPropertyConfig};
-  return entityReader.readEntities(worldBounds, status, taskManager)
-         | kdl::transform([&]() {
-             status.info(
-               "Parsed successfully as " + mdl::formatName(sourceMapFormat)
-               + " entities");
-             return entityReader.m_nodes;
-           })
-         | kdl::or_else([&](const auto& entityReaderError) {
-             status.info(
-               "Couldn't parse as " + mdl::formatName(sourceMapFormat)
-               + " entities: " + entityReaderError.msg);
-             kdl::vec_clear_and_delete(entityReader.m_nodes);
-
-             auto brushReader =
-               NodeReader{str, sourceMapFormat, targetMapFormat, entityPropertyConfig};
-             return brushReader.readBrushes(worldBounds, status, taskManager)
-                    | kdl::transform([&]() {
-                        status.info(
-                          "Parsed successfully as " + mdl::formatName(sourceMapFormat)
-                          + " brushes");
-                        return brushReader.m_nodes;
-                      })
-                    | kdl::if_error([&](const auto& brushReaderError) {
-                        status.info(
-                          "Couldn't parse as " + mdl::formatName(sourceMapFormat)
-                          + " brushes: " + brushReaderError.msg);
-                        kdl::vec_clear_and_delete(brushReader.m_nodes);
-                      });
+  return readEntitiesAsFormat(
+           sourceMapFormat,
+           targetMapFormat,
+           str,
+           worldBounds,
+           entityPropertyConfig,
+           status,
+           taskManager)
+         | kdl::or_else([&](const auto&) {
+             return readBrushesAsFormat(
+               sourceMapFormat,
+               targetMapFormat,
+               str,
+               worldBounds,
+               entityPropertyConfig,
+               status,
+               taskManager);
            });
 }
 
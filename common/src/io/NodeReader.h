@@ -22,6 +22,7 @@
 #include "Result.h"
 #include "io/MapReader.h"
 
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -38,6 +39,32 @@ class ParserStatus;
 namespace io
 {
 
+enum class MapDataKind
+{
+  Entities,
+  Brushes,
+  BrushFaces,
+};
+
+struct MapDataFormat
+{
+  MapDataKind kind;
+  mdl::MapFormat mapFormat;
+
+  bool operator==(const MapDataFormat& other) const = default;
+};
+
+/**
+ * Determines what kind of objects the given map data contains and which of the formats
+ * compatible with the given preferred format it is written in.
+ *
+ * Only the tokens up to the first brush face are inspected, so this is much cheaper than
+ * parsing the data. Returns nullopt if the kind or the format cannot be determined
+ * unambiguously.
+ */
+std::optional<MapDataFormat> detectMapDataFormat(
+  std::string_view str, mdl::MapFormat preferredMapFormat);
+
 /**
  * MapReader subclass for loading the clipboard contents, rather than an entire .map
  */
@@ -62,6 +89,12 @@ public:
     mdl::MapFormat targetMapFormat,
     const mdl::EntityPropertyConfig& entityPropertyConfig);
 
+  /**
+   * Parses the given string as entities or brushes.
+   *
+   * If the kind and format of the data can be detected, the data is parsed only once as
+   * what was detected. Otherwise, every compatible format is tried in turn.
+   */
   static Result<std::vector<mdl::Node*>> read(
     const std::string& str,
     mdl::MapFormat preferredMapFormat,
@@ -71,6 +104,24 @@ public:
     kdl::task_manager& taskManager);
 
 private:
+  static Result<std::vector<mdl::Node*>> readEntitiesAsFormat(
+    mdl::MapFormat sourceMapFormat,
+    mdl::MapFormat targetMapFormat,
+    const std::string& str,
+    const vm::bbox3d& worldBounds,
+    const mdl::EntityPropertyConfig& entityPropertyConfig,
+    ParserStatus& status,
+    kdl::task_manager& taskManager);
+
+  static Result<std::vector<mdl::Node*>> readBrushesAsFormat(
+    mdl::MapFormat sourceMapFormat,
+    mdl::MapFormat targetMapFormat,
+    const std::string& str,
+    const vm::bbox3d& worldBounds,
+    const mdl::EntityPropertyConfig& entityPropertyConfig,
+    ParserStatus& status,
+    kdl::task_manager& taskManager);
+
   static Result<std::vector<mdl::Node*>> readAsFormat(
     mdl::MapFormat sourceMapFormat,
     mdl::MapFormat targetMapFormat,
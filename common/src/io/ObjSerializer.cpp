@@ -19,115 +19,341 @@
 
 #include "ObjSerializer.h"
 
+#include "Trace.h"
+#include "io/ExportGeometry.h"
 #include "io/ExportOptions.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
 #include "mdl/Material.h"
 #include "mdl/PatchNode.h"
-#include "mdl/Polyhedron.h"
 
 #include "kd/contracts.h"
+#include "kd/hash_utils.h"
 #include "kd/overload.h"
+#include "kd/task_manager.h"
 
-#include <format>
+#include "vm/vec.h"
 
+#include <array>
+#include <format>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <unordered_map>
 #include <utility>
 
 namespace tb::io
 {
-
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::IndexedVertex& vertex)
+namespace
 {
-  str << " " << (vertex.vertex + 1u) << "/" << (vertex.uvCoords + 1u) << "/"
-      << (vertex.normal + 1u);
-  return str;
-}
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::BrushObject& object)
+struct VecHash
 {
-  str << "o entity" << object.entityNo << "_brush" << object.brushNo << "\n";
-  for (const auto& face : object.faces)
+  template <typename T, size_t S>
+  size_t operator()(const vm::vec<T, S>& v) const
   {
-    str << "usemtl " << face.materialName << "\n";
-    str << "f";
-    for (const auto& vertex : face.verts)
+    auto result = size_t(0);
+    for (size_t i = 0; i < S; ++i)
     {
-      str << " " << vertex;
+      result = kdl::combine_hash(result, kdl::hash(v[i]));
     }
-    str << "\n";
+    return result;
   }
-  return str;
-}
+};
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::PatchObject& object)
+template <typename V>
+class IndexMap
 {
-  str << "o entity" << object.entityNo << "_patch" << object.patchNo << "\n";
-  str << "usemtl " << object.materialName << "\n";
-  for (const auto& quad : object.quads)
+private:
+  std::unordered_map<V, size_t, VecHash> m_map;
+  std::vector<V> m_list;
+
+public:
+  const std::vector<V>& list() const { return m_list; }
+
+  size_t index(const V& v)
   {
-    str << "f";
-    for (const auto& vertex : quad.verts)
+    const auto [it, inserted] = m_map.emplace(v, m_list.size());
+    if (inserted)
     {
-      str << " " << vertex;
+      m_list.push_back(v);
     }
-    str << "\n";
+    return it->second;
   }
-  return str;
+
+  /**
+   * Values inserted after this is called will not reuse indices from before this
+   * is called.
+   */
+  void clearIndices() { m_map.clear(); }
+};
+
+struct IndexedVertex
+{
+  size_t vertex;
+  size_t uvCoords;
+  size_t normal;
+};
+
+struct BrushFace
+{
+  std::vector<IndexedVertex> verts;
+  std::string materialName;
+  const mdl::Material* material;
+};
+
+struct BrushObject
+{
+  size_t entityNo;
+  size_t brushNo;
+  std::vector<BrushFace> faces;
+};
+
+struct PatchQuad
+{
+  std::array<IndexedVertex, 4u> verts;
+};
+
+struct PatchObject
+{
+  size_t entityNo;
+  size_t patchNo;
+  std::vector<PatchQuad> quads;
+  std::string materialName;
+  const mdl::Material* material;
+};
+
+using Object = std::variant<BrushObject, PatchObject>;
+
+/**
+ * A sequence of consecutive objects. The indices of the objects refer to the vertices,
+ * UV coordinates and normals of the block.
+ */
+struct Block
+{
+  std::vector<vm::vec3d> vertices;
+  std::vector<vm::vec2f> uvCoords;
+  std::vector<vm::vec3d> normals;
+  std::vector<Object> objects;
+};
+
+/**
+ * The number of vertices, UV coordinates and normals written before a block.
+ */
+struct BlockOffsets
+{
+  size_t vertices;
+  size_t uvCoords;
+  size_t normals;
+};
+
+class BlockBuilder
+{
+private:
+  IndexMap<vm::vec3d> m_vertices;
+  IndexMap<vm::vec2f> m_uvCoords;
+  IndexMap<vm::vec3d> m_normals;
+  std::vector<Object> m_objects;
+
+public:
+  void addObject(const ExportObject& object)
+  {
+    // Vertex positions inserted from now on should get new indices
+    m_vertices.clearIndices();
+
+    std::visit(
+      kdl::overload(
+        [&](const mdl::BrushNode* brushNode) {
+          addBrush(*brushNode, object.entityNo, object.brushNo);
+        },
+        [&](const mdl::PatchNode* patchNode) {
+          addPatch(*patchNode, object.entityNo, object.brushNo);
+        }),
+      object.node);
+  }
+
+  Block build() &&
+  {
+    return Block{
+      m_vertices.list(), m_uvCoords.list(), m_normals.list(), std::move(m_objects)};
+  }
+
+private:
+  void addBrush(
+    const mdl::BrushNode& brushNode, const size_t entityNo, const size_t brushNo)
+  {
+    auto brushObject = BrushObject{entityNo, brushNo, {}};
+    brushObject.faces.reserve(brushNode.brush().faceCount());
+
+    forEachExportFace(brushNode, [&](const auto& face, const auto& vertices) {
+      const auto normalIndex = m_normals.index(face.boundary().normal);
+
+      auto indexedVertices = std::vector<IndexedVertex>{};
+      indexedVertices.reserve(vertices.size());
+
+      for (const auto& vertex : vertices)
+      {
+        const auto vertexIndex = m_vertices.index(vertex.position);
+        const auto uvCoordsIndex = m_uvCoords.index(vertex.uvCoords);
+
+        indexedVertices.push_back(IndexedVertex{vertexIndex, uvCoordsIndex, normalIndex});
+      }
+
+      brushObject.faces.push_back(BrushFace{
+        std::move(indexedVertices), face.attributes().materialName(), face.material()});
+    });
+
+    m_objects.emplace_back(std::move(brushObject));
+  }
+
+  void addPatch(
+    const mdl::PatchNode& patchNode, const size_t entityNo, const size_t patchNo)
+  {
+    const auto& patch = patchNode.patch();
+    auto patchObject =
+      PatchObject{entityNo, patchNo, {}, patch.materialName(), patch.material()};
+
+    const auto& patchGrid = patchNode.grid();
+    patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
+
+    const auto makeIndexedVertex = [&](const auto& vertex) {
+      const auto positionIndex = m_vertices.index(vertex.position);
+      const auto uvCoordsIndex = m_uvCoords.index(vertex.uvCoords);
+      const auto normalIndex = m_normals.index(vertex.normal);
+
+      return IndexedVertex{positionIndex, uvCoordsIndex, normalIndex};
+    };
+
+    forEachExportQuad(patchNode, [&](const auto& quad) {
+      patchObject.quads.push_back(PatchQuad{{
+        makeIndexedVertex(quad[0]),
+        makeIndexedVertex(quad[1]),
+        makeIndexedVertex(quad[2]),
+        makeIndexedVertex(quad[3]),
+      }});
+    });
+
+    m_objects.emplace_back(std::move(patchObject));
+  }
+};
+
+void writeIndexedVertex(
+  std::string& str, const IndexedVertex& vertex, const BlockOffsets& offsets)
+{
+  std::format_to(
+    std::back_inserter(str),
+    "  {}/{}/{}",
+    offsets.vertices + vertex.vertex + 1u,
+    offsets.uvCoords + vertex.uvCoords + 1u,
+    offsets.normals + vertex.normal + 1u);
 }
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::Object& object)
+void writeObject(std::string& str, const Object& object, const BlockOffsets& offsets)
 {
   std::visit(
     kdl::overload(
-      [&](const ObjSerializer::BrushObject& brushObject) { str << brushObject; },
-      [&](const ObjSerializer::PatchObject& patchObject) { str << patchObject; }),
+      [&](const BrushObject& brushObject) {
+        std::format_to(
+          std::back_inserter(str),
+          "o entity{}_brush{}\n",
+          brushObject.entityNo,
+          brushObject.brushNo);
+        for (const auto& face : brushObject.faces)
+        {
+          std::format_to(std::back_inserter(str), "usemtl {}\nf", face.materialName);
+          for (const auto& vertex : face.verts)
+          {
+            writeIndexedVertex(str, vertex, offsets);
+          }
+          str += "\n";
+        }
+      },
+      [&](const PatchObject& patchObject) {
+        std::format_to(
+          std::back_inserter(str),
+          "o entity{}_patch{}\nusemtl {}\n",
+          patchObject.entityNo,
+          patchObject.patchNo,
+          patchObject.materialName);
+        for (const auto& quad : patchObject.quads)
+        {
+          str += "f";
+          for (const auto& vertex : quad.verts)
+          {
+            writeIndexedVertex(str, vertex, offsets);
+          }
+          str += "\n";
+        }
+      }),
     object);
-  return str;
 }
 
-ObjSerializer::ObjSerializer(
-  std::ostream& objStream,
-  std::ostream& mtlStream,
-  std::string mtlFilename,
-  io::ObjExportOptions options)
-  : m_objStream{objStream}
-  , m_mtlStream{mtlStream}
-  , m_mtlFilename{std::move(mtlFilename)}
-  , m_options{std::move(options)}
+std::string writeBlock(const Block& block, const BlockOffsets& offsets)
 {
-  contract_pre(m_objStream.good());
-  contract_pre(m_mtlStream.good());
-}
+  auto str = std::string{};
+  auto out = std::back_inserter(str);
 
-void ObjSerializer::doBeginFile(
-  const std::vector<const mdl::Node*>& /* rootNodes */, kdl::task_manager&)
-{
+  str += "# vertices\n";
+  for (const auto& elem : block.vertices)
+  {
+    // no idea why I have to switch Y and Z
+    std::format_to(out, "v {} {} {}\n", elem.x(), elem.z(), -elem.y());
+  }
+  str += "\n";
+
+  str += "# texture coordinates\n";
+  for (const auto& elem : block.uvCoords)
+  {
+    // multiplying Y by -1 needed to get the UV's to appear correct in Blender and UE4
+    // (see: https://github.com/TrenchBroom/TrenchBroom/issues/2851 )
+    std::format_to(out, "vt {} {}\n", elem.x(), -elem.y());
+  }
+  str += "\n";
+
+  str += "# normals\n";
+  for (const auto& elem : block.normals)
+  {
+    // no idea why I have to switch Y and Z
+    std::format_to(out, "vn {} {} {}\n", elem.x(), elem.z(), -elem.y());
+  }
+  str += "\n";
+
+  for (const auto& object : block.objects)
+  {
+    writeObject(str, object, offsets);
+    str += "\n";
+  }
+
+  return str;
 }
 
-static void writeMtlFile(
-  std::ostream& str,
-  const std::vector<ObjSerializer::Object>& objects,
-  const io::ObjExportOptions& options)
+void collectUsedMaterials(
+  const Block& block, std::map<std::string, const mdl::Material*>& usedMaterials)
 {
-  auto usedMaterials = std::map<std::string, const mdl::Material*>{};
-
-  for (const auto& object : objects)
+  for (const auto& object : block.objects)
   {
     std::visit(
       kdl::overload(
-        [&](const ObjSerializer::BrushObject& brushObject) {
+        [&](const BrushObject& brushObject) {
           for (const auto& face : brushObject.faces)
           {
             usedMaterials[face.materialName] = face.material;
           }
         },
-        [&](const ObjSerializer::PatchObject& patchObject) {
+        [&](const PatchObject& patchObject) {
           usedMaterials[patchObject.materialName] = patchObject.material;
         }),
       object);
   }
+}
 
+void writeMtlFile(
+  std::ostream& str,
+  const std::map<std::string, const mdl::Material*>& usedMaterials,
+  const io::ObjExportOptions& options)
+{
   const auto basePath = options.exportPath.parent_path();
   for (const auto& [materialName, material] : usedMaterials)
   {
@@ -153,78 +379,35 @@ static void writeMtlFile(
   }
 }
 
-static void writeVertices(std::ostream& str, const std::vector<vm::vec3d>& vertices)
-{
-  str << "# vertices\n";
-  for (const auto& elem : vertices)
-  {
-    // no idea why I have to switch Y and Z
-    std::format_to(
-      std::ostreambuf_iterator<char>(str), "v {} {} {}\n", elem.x(), elem.z(), -elem.y());
-  }
-}
-
-static void writeUVCoords(std::ostream& str, const std::vector<vm::vec2f>& uvCoords)
-{
-  str << "# texture coordinates\n";
-  for (const auto& elem : uvCoords)
-  {
-    // multiplying Y by -1 needed to get the UV's to appear correct in Blender and UE4
-    // (see: https://github.com/TrenchBroom/TrenchBroom/issues/2851 )
-    std::format_to(
-      std::ostreambuf_iterator<char>(str), "vt {} {}\n", elem.x(), -elem.y());
-  }
-}
+} // namespace
 
-static void writeNormals(std::ostream& str, const std::vector<vm::vec3d>& normals)
+ObjSerializer::ObjSerializer(
+  std::ostream& objStream,
+  std::ostream& mtlStream,
+  std::string mtlFilename,
+  io::ObjExportOptions options)
+  : m_objStream{objStream}
+  , m_mtlStream{mtlStream}
+  , m_mtlFilename{std::move(mtlFilename)}
+  , m_options{std::move(options)}
 {
-  str << "# normals\n";
-  for (const auto& elem : normals)
-  {
-    // no idea why I have to switch Y and Z
-    std::format_to(
-      std::ostreambuf_iterator<char>(str),
-      "vn {} {} {}\n",
-      elem.x(),
-      elem.z(),
-      -elem.y());
-  }
+  contract_pre(m_objStream.good());
+  contract_pre(m_mtlStream.good());
 }
 
-static void writeObjFile(
-  std::ostream& str,
-  const std::string mtlFilename,
-  const std::vector<vm::vec3d>& vertices,
-  const std::vector<vm::vec2f>& uvCoords,
-  const std::vector<vm::vec3d>& normals,
-  const std::vector<ObjSerializer::Object>& objects)
+void ObjSerializer::doBeginFile(
+  const std::vector<const mdl::Node*>& /* rootNodes */, kdl::task_manager& taskManager)
 {
+  m_taskManager = &taskManager;
+  m_pendingObjects.reserve(BatchSize);
 
-  str << "mtllib " << mtlFilename << "\n";
-  writeVertices(str, vertices);
-  str << "\n";
-  writeUVCoords(str, uvCoords);
-  str << "\n";
-  writeNormals(str, normals);
-  str << "\n";
-
-  for (const auto& object : objects)
-  {
-    str << object;
-    str << "\n";
-  }
+  m_objStream << "mtllib " << m_mtlFilename << "\n";
 }
 
 void ObjSerializer::doEndFile()
 {
-  writeMtlFile(m_mtlStream, m_objects, m_options);
-  writeObjFile(
-    m_objStream,
-    m_mtlFilename,
-    m_vertices.list(),
-    m_uvCoords.list(),
-    m_normals.list(),
-    m_objects);
+  writePendingObjects();
+  writeMtlFile(m_mtlStream, m_usedMaterials, m_options);
 }
 
 void ObjSerializer::doBeginEntity(const mdl::Node*) {}
@@ -233,79 +416,74 @@ void ObjSerializer::doEntityProperty(const mdl::EntityProperty&) {}
 
 void ObjSerializer::doBrush(const mdl::BrushNode* brush)
 {
-  m_currentBrush = BrushObject{entityNo(), brushNo(), {}};
-  m_currentBrush->faces.reserve(brush->brush().faceCount());
+  addObject(ExportObject{brush, entityNo(), brushNo()});
+}
 
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
+void ObjSerializer::doBrushFace(const mdl::BrushFace&) {}
 
-  for (const auto& face : brush->brush().faces())
-  {
-    doBrushFace(face);
-  }
-
-  m_objects.emplace_back(std::move(*m_currentBrush));
-  m_currentBrush = std::nullopt;
+void ObjSerializer::doPatch(const mdl::PatchNode* patchNode)
+{
+  addObject(ExportObject{patchNode, entityNo(), brushNo()});
 }
 
-void ObjSerializer::doBrushFace(const mdl::BrushFace& face)
+void ObjSerializer::addObject(ExportObject object)
 {
-  const auto& normal = face.boundary().normal;
-  const auto normalIndex = m_normals.index(normal);
-
-  auto indexedVertices = std::vector<IndexedVertex>{};
-  indexedVertices.reserve(face.vertexCount());
-
-  for (const auto* vertex : face.vertices())
+  m_pendingObjects.push_back(std::move(object));
+  if (m_pendingObjects.size() == BatchSize)
   {
-    const auto& position = vertex->position();
-    const auto uvCoords = face.uvCoords(position);
-
-    const auto vertexIndex = m_vertices.index(position);
-    const auto uvCoordsIndex = m_uvCoords.index(uvCoords);
-
-    indexedVertices.push_back(IndexedVertex{vertexIndex, uvCoordsIndex, normalIndex});
+    writePendingObjects();
   }
-
-  m_currentBrush->faces.emplace_back(BrushFace{
-    std::move(indexedVertices), face.attributes().materialName(), face.material()});
 }
 
-void ObjSerializer::doPatch(const mdl::PatchNode* patchNode)
+void ObjSerializer::writePendingObjects()
 {
-  const auto& patch = patchNode->patch();
-  auto patchObject =
-    PatchObject{entityNo(), brushNo(), {}, patch.materialName(), patch.material()};
+  contract_pre(m_taskManager != nullptr);
+
+  if (m_pendingObjects.empty())
+  {
+    return;
+  }
 
-  const auto& patchGrid = patchNode->grid();
-  patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
+  const auto trace = TraceScope{
+    "ObjSerializer::writePendingObjects",
+    std::format("{} objects", m_pendingObjects.size())};
 
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
+  // convert the pending objects into blocks in parallel
+  const auto blocks = convertExportBlocks(
+    m_pendingObjects, BlockSize, *m_taskManager, [](const auto& objects) {
+      auto builder = BlockBuilder{};
+      for (const auto& object : objects)
+      {
+        builder.addObject(object);
+      }
+      return std::move(builder).build();
+    });
 
-  const auto makeIndexedVertex = [&](const auto& p) {
-    const auto positionIndex = m_vertices.index(p.position);
-    const auto uvCoordsIndex = m_uvCoords.index(vm::vec2f{p.uvCoords});
-    const auto normalIndex = m_normals.index(p.normal);
+  // the indices of each block are offset by the sizes of the preceding blocks
+  auto offsets = std::vector<BlockOffsets>{};
+  offsets.reserve(blocks.size());
+  for (const auto& block : blocks)
+  {
+    offsets.push_back(BlockOffsets{m_vertexCount, m_uvCoordsCount, m_normalCount});
+    m_vertexCount += block.vertices.size();
+    m_uvCoordsCount += block.uvCoords.size();
+    m_normalCount += block.normals.size();
+    collectUsedMaterials(block, m_usedMaterials);
+  }
 
-    return IndexedVertex{positionIndex, uvCoordsIndex, normalIndex};
-  };
+  // render the blocks to strings in parallel and write them in order
+  auto blockIndices = std::vector<size_t>(blocks.size());
+  std::iota(blockIndices.begin(), blockIndices.end(), size_t(0));
 
-  for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row)
+  const auto writeTasks = blockIndices | std::views::transform([&](const auto i) {
+    return std::function{[&, i]() { return writeBlock(blocks[i], offsets[i]); }};
+  });
+  for (const auto& str : m_taskManager->run_tasks_and_wait(writeTasks))
   {
-    for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col)
-    {
-      // counter clockwise order
-      patchObject.quads.push_back(PatchQuad{{
-        makeIndexedVertex(patchGrid.point(row, col)),
-        makeIndexedVertex(patchGrid.point(row + 1u, col)),
-        makeIndexedVertex(patchGrid.point(row + 1u, col + 1u)),
-        makeIndexedVertex(patchGrid.point(row, col + 1u)),
-      }});
-    }
+    m_objStream << str;
   }
 
-  m_objects.emplace_back(std::move(patchObject));
+  m_pendingObjects.clear();
 }
 
 } // namespace tb::io
@@ -19,17 +19,13 @@
 
 #pragma once
 
+#include "io/ExportGeometry.h"
 #include "io/ExportOptions.h"
 #include "io/NodeSerializer.h"
 
-#include "vm/vec.h"
-
-#include <array>
 #include <iosfwd>
 #include <map>
-#include <optional>
 #include <string>
-#include <variant>
 #include <vector>
 
 namespace tb
@@ -41,85 +37,27 @@ class BrushFace;
 class EntityProperty;
 class Material;
 class Node;
+class PatchNode;
 } // namespace mdl
 
 namespace io
 {
 
+/**
+ * Exports brushes and patches to an OBJ file and their materials to an MTL file.
+ *
+ * The exporter does not keep the entire map in memory. Instead, it collects the brushes
+ * and patches passed to it into batches. Each batch is split into blocks of consecutive
+ * objects that are converted in parallel. Every block indexes its vertices, UV
+ * coordinates and normals locally, and the blocks are written in order with their
+ * indices offset by the number of elements written before them. Therefore, the memory
+ * used by the exporter depends on the batch size and not on the size of the map.
+ */
 class ObjSerializer : public NodeSerializer
 {
 public:
-  template <typename V>
-  class IndexMap
-  {
-  private:
-    std::map<V, size_t> m_map;
-    std::vector<V> m_list;
-
-  public:
-    const std::vector<V>& list() const { return m_list; }
-
-    size_t index(const V& v)
-    {
-      const auto it = m_map.emplace(v, m_list.size()).first;
-      const size_t index = it->second;
-      if (index == m_list.size())
-      {
-        m_list.push_back(v);
-      }
-      return index;
-    }
-
-    /**
-     * Values inserted after this is called will not reuse indices from before this
-     * is called.
-     */
-    void clearIndices() { m_map.clear(); }
-  };
-
-  struct IndexedVertex
-  {
-    size_t vertex;
-    size_t uvCoords;
-    size_t normal;
-  };
-
-  struct BrushFace
-  {
-    std::vector<IndexedVertex> verts;
-    std::string materialName;
-    const mdl::Material* material;
-  };
-
-  struct BrushObject
-  {
-    size_t entityNo;
-    size_t brushNo;
-    std::vector<BrushFace> faces;
-  };
-
-  struct PatchQuad
-  {
-    std::array<IndexedVertex, 4u> verts;
-  };
-
-  struct PatchObject
-  {
-    size_t entityNo;
-    size_t patchNo;
-    std::vector<PatchQuad> quads;
-    std::string materialName;
-    const mdl::Material* material;
-  };
-
-  using Object = std::variant<BrushObject, PatchObject>;
-
-  friend std::ostream& operator<<(std::ostream& str, const IndexedVertex& vertex);
-  friend std::ostream& operator<<(std::ostream& str, const BrushFace& face);
-  friend std::ostream& operator<<(std::ostream& str, const BrushObject& object);
-  friend std::ostream& operator<<(std::ostream& str, const PatchQuad& quad);
-  friend std::ostream& operator<<(std::ostream& str, const PatchObject& object);
-  friend std::ostream& operator<<(std::ostream& str, const Object& object);
+  static constexpr size_t BlockSize = 256;
+  static constexpr size_t BatchSize = 16 * BlockSize;
 
 private:
   std::ostream& m_objStream;
@@ -127,12 +65,13 @@ private:
   std::string m_mtlFilename;
   ObjExportOptions m_options;
 
-  IndexMap<vm::vec3d> m_vertices;
-  IndexMap<vm::vec2f> m_uvCoords;
-  IndexMap<vm::vec3d> m_normals;
+  kdl::task_manager* m_taskManager = nullptr;
+  std::vector<ExportObject> m_pendingObjects;
 
-  std::optional<BrushObject> m_currentBrush;
-  std::vector<Object> m_objects;
+  size_t m_vertexCount = 0;
+  size_t m_uvCoordsCount = 0;
+  size_t m_normalCount = 0;
+  std::map<std::string, const mdl::Material*> m_usedMaterials;
 
 public:
   ObjSerializer(
@@ -155,6 +94,9 @@ private:
   void doBrushFace(const mdl::BrushFace& face) override;
 
   void doPatch(const mdl::PatchNode* patchNode) override;
+
+  void addObject(ExportObject object);
+  void writePendingObjects();
 };
 
 } // namespace io
@@ -75,13 +75,14 @@ private:
 
 class StandardMapParser : public MapParser, public Parser<QuakeMapToken::Type>
 {
-private:
-  using Token = QuakeMapTokenizer::Token;
-
+public:
   static const std::string BrushPrimitiveId;
   static const std::string PatchId;
   static const std::string Patch3Id;
 
+private:
+  using Token = QuakeMapTokenizer::Token;
+
   QuakeMapTokenizer m_tokenizer;
 
 protected:
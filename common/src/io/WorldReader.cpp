@@ -59,9 +59,22 @@ WorldReader::WorldReader(
   std::string_view str,
   const mdl::MapFormat sourceAndTargetMapFormat,
   const mdl::EntityPropertyConfig& entityPropertyConfig)
-  : MapReader{std::move(str), sourceAndTargetMapFormat, sourceAndTargetMapFormat, entityPropertyConfig}
+  : WorldReader{
+      std::move(str),
+      sourceAndTargetMapFormat,
+      sourceAndTargetMapFormat,
+      entityPropertyConfig}
+{
+}
+
+WorldReader::WorldReader(
+  std::string_view str,
+  const mdl::MapFormat sourceMapFormat,
+  const mdl::MapFormat targetMapFormat,
+  const mdl::EntityPropertyConfig& entityPropertyConfig)
+  : MapReader{std::move(str), sourceMapFormat, targetMapFormat, entityPropertyConfig}
   , m_worldNode{std::make_unique<mdl::WorldNode>(
-      entityPropertyConfig, mdl::Entity{}, sourceAndTargetMapFormat)}
+      entityPropertyConfig, mdl::Entity{}, targetMapFormat)}
 {
   m_worldNode->disableNodeTreeUpdates();
 }
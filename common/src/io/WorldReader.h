@@ -56,6 +56,16 @@ public:
     mdl::MapFormat sourceAndTargetMapFormat,
     const mdl::EntityPropertyConfig& entityPropertyConfig);
 
+  /**
+   * Creates a reader that parses the given string in the given source format and converts
+   * the world and its contents to the given target format.
+   */
+  WorldReader(
+    std::string_view str,
+    mdl::MapFormat sourceMapFormat,
+    mdl::MapFormat targetMapFormat,
+    const mdl::EntityPropertyConfig& entityPropertyConfig);
+
   Result<std::unique_ptr<mdl::WorldNode>> read(
     const vm::bbox3d& worldBounds, ParserStatus& status, kdl::task_manager& taskManager);
 
@@ -23,6 +23,7 @@
 #include "mdl/AddRemoveNodesUtils.h"
 #include "mdl/Map.h"
 #include "mdl/Node.h"
+#include "mdl/NodeContents.h"
 
 #include "kd/map_utils.h"
 
@@ -75,6 +76,20 @@ std::string AddRemoveNodesCommand::makeName(const Action action)
   }
 }
 
+size_t AddRemoveNodesCommand::memoryUsage() const
+{
+  // the command owns the nodes that are not currently in the map
+  auto result = UpdateLinkedGroupsCommandBase::memoryUsage();
+  for (const auto& [parent, children] : m_nodesToAdd)
+  {
+    for (const auto* child : children)
+    {
+      result += mdl::memoryUsage(*child);
+    }
+  }
+  return result;
+}
+
 bool AddRemoveNodesCommand::doPerformDo(Map& map)
 {
   doAction(map);
@@ -52,6 +52,8 @@ public:
   AddRemoveNodesCommand(Action action, const std::map<Node*, std::vector<Node*>>& nodes);
   ~AddRemoveNodesCommand() override;
 
+  size_t memoryUsage() const override;
+
 private:
   static std::string makeName(Action action);
 
@@ -22,6 +22,7 @@
 #include <QDateTime>
 
 #include "Notifier.h"
+#include "Trace.h"
 #include "mdl/Command.h"
 #include "mdl/TransactionScope.h"
 #include "mdl/UndoableCommand.h"
@@ -31,6 +32,7 @@
 #include "kd/vector_utils.h"
 
 #include <algorithm>
+#include <numeric>
 
 namespace tb::mdl
 {
@@ -107,6 +109,17 @@ private:
     return true;
   }
 
+  size_t memoryUsage() const override
+  {
+    return std::accumulate(
+      m_commands.begin(),
+      m_commands.end(),
+      size_t(0),
+      [](const auto total, const auto& command) {
+        return total + command->memoryUsage();
+      });
+  }
+
   bool doCollateWith(UndoableCommand& other) override
   {
     if (auto* transactionCommand = dynamic_cast<TransactionCommand*>(&other))
@@ -204,6 +217,20 @@ const std::string* CommandProcessor::redoCommandName() const
   return canRedo() ? &m_redoStack.back()->name() : nullptr;
 }
 
+size_t CommandProcessor::memoryUsage() const
+{
+  const auto sumMemoryUsage = [](const auto& commands) {
+    return std::accumulate(
+      commands.begin(),
+      commands.end(),
+      size_t(0),
+      [](const auto total, const auto& command) {
+        return total + command->memoryUsage();
+      });
+  };
+  return sumMemoryUsage(m_undoStack) + sumMemoryUsage(m_redoStack);
+}
+
 void CommandProcessor::startTransaction(std::string name, const TransactionScope scope)
 {
   m_transactionStack.emplace_back(std::move(name), scope);
@@ -237,6 +264,13 @@ bool CommandProcessor::isCurrentDocumentStateObservable() const
               == TransactionScope::LongRunning;
 }
 
+bool CommandProcessor::isBatching() const
+{
+  return m_commandDepth > 0 || std::ranges::any_of(m_transactionStack, [](const auto& t) {
+           return t.scope == TransactionScope::Oneshot;
+         });
+}
+
 bool CommandProcessor::execute(std::unique_ptr<Command> command)
 {
   const auto result = executeCommand(*command);
@@ -308,8 +342,14 @@ CommandProcessor::SubmitAndStoreResult CommandProcessor::executeAndStoreCommand(
 
 bool CommandProcessor::executeCommand(Command& command)
 {
+  const auto trace = TraceScope{"CommandProcessor::execute", command.name()};
   notifyCommandIfNotType<TransactionCommand>(commandDoNotifier, command);
-  const auto result = command.performDo(m_map);
+  const auto result = [&] {
+    const auto executing = kdl::inc_temp{m_commandDepth};
+    return command.performDo(m_map);
+  }();
+  notifyIfBatchDidEnd();
+
   if (result)
   {
     notifyCommandIfNotType<TransactionCommand>(commandDoneNotifier, command);
@@ -327,8 +367,14 @@ bool CommandProcessor::executeCommand(Command& command)
 
 bool CommandProcessor::undoCommand(UndoableCommand& command)
 {
+  const auto trace = TraceScope{"CommandProcessor::undo", command.name()};
   notifyCommandIfNotType<TransactionCommand>(commandUndoNotifier, command);
-  const auto result = command.performUndo(m_map);
+  const auto result = [&] {
+    const auto undoing = kdl::inc_temp{m_commandDepth};
+    return command.performUndo(m_map);
+  }();
+  notifyIfBatchDidEnd();
+
   if (result)
   {
     notifyCommandIfNotType<TransactionCommand>(commandUndoneNotifier, command);
@@ -340,6 +386,14 @@ bool CommandProcessor::undoCommand(UndoableCommand& command)
   return result;
 }
 
+void CommandProcessor::notifyIfBatchDidEnd()
+{
+  if (!isBatching())
+  {
+    batchDidEndNotifier();
+  }
+}
+
 bool CommandProcessor::storeCommand(
   std::unique_ptr<UndoableCommand> command, const bool collate)
 {
@@ -377,6 +431,10 @@ void CommandProcessor::createAndStoreTransaction()
   contract_pre(!m_transactionStack.empty());
 
   auto transaction = kdl::vec_pop_back(m_transactionStack);
+
+  // a rolled back transaction may still have changed the document
+  notifyIfBatchDidEnd();
+
   if (!transaction.commands.empty())
   {
     if (transaction.name.empty())
@@ -90,6 +90,11 @@ private:
    */
   std::vector<TransactionState> m_transactionStack;
 
+  /**
+   * The number of commands that are currently being executed or undone.
+   */
+  size_t m_commandDepth = 0;
+
   struct SubmitAndStoreResult;
 
 public:
@@ -144,6 +149,17 @@ public:
    */
   Notifier<const std::string&, bool> transactionUndoneNotifier;
 
+  /**
+   * Notifies observers when a batch of changes has ended. A batch ends whenever a command
+   * has been executed or undone and no one shot transaction is executing, or when the
+   * outermost one shot transaction is committed.
+   *
+   * Observers that only need to react to the accumulated effect of a user action can
+   * collect changes while `isBatching` returns true and process them when this
+   * notification is sent.
+   */
+  Notifier<> batchDidEndNotifier;
+
   /**
    * Indicates whether command collation is enabled.
    */
@@ -175,6 +191,12 @@ public:
    * no command can be redone.
    */
   const std::string* redoCommandName() const;
+
+  /**
+   * Returns an estimate of the number of bytes of memory held by the commands on the undo
+   * and redo stacks.
+   */
+  size_t memoryUsage() const;
   /**
    * Starts a new transaction. If a transaction is currently executing, then the newly
    * started transaction becomes a nested transaction and will be added as a command to
@@ -216,6 +238,12 @@ public:
    */
   bool isCurrentDocumentStateObservable() const;
 
+  /**
+   * Indicates whether changes are currently being batched, that is, whether a command is
+   * being executed or undone or a one shot transaction is executing.
+   */
+  bool isBatching() const;
+
   /**
    * Executes the given command by calling its `performDo` method without storing it for
    * later undo. If the command is executed successfully, both the undo and the redo
@@ -311,6 +339,11 @@ private:
    */
   bool undoCommand(UndoableCommand& command);
 
+  /**
+   * Triggers a `batchDidEnd` notification unless changes are still being batched.
+   */
+  void notifyIfBatchDidEnd();
+
   /**
    * Stores the given command or collates it with the topmost command on the undo stack.
    *
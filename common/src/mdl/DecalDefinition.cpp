@@ -19,6 +19,7 @@
 
 #include "DecalDefinition.h"
 
+#include "el/CompiledExpression.h"
 #include "el/EvaluationContext.h"
 #include "el/Expression.h"
 #include "el/Types.h"
@@ -65,16 +66,19 @@ kdl_reflect_impl(DecalSpecification);
 
 DecalDefinition::DecalDefinition()
   : m_expression{el::LiteralExpression{el::Value::Undefined}}
+  , m_compiledExpression{m_expression.compile()}
 {
 }
 
 DecalDefinition::DecalDefinition(const FileLocation& location)
   : m_expression{el::LiteralExpression{el::Value::Undefined}, location}
+  , m_compiledExpression{m_expression.compile()}
 {
 }
 
 DecalDefinition::DecalDefinition(el::ExpressionNode expression)
   : m_expression{std::move(expression)}
+  , m_compiledExpression{m_expression.compile()}
 {
 }
 
@@ -85,6 +89,7 @@ void DecalDefinition::append(const DecalDefinition& other)
   auto cases =
     std::vector<el::ExpressionNode>{std::move(m_expression), other.m_expression};
   m_expression = el::ExpressionNode{el::SwitchExpression{std::move(cases)}, location};
+  m_compiledExpression = m_expression.compile();
 }
 
 Result<DecalSpecification> DecalDefinition::decalSpecification(
@@ -92,7 +97,7 @@ Result<DecalSpecification> DecalDefinition::decalSpecification(
 {
   return el::withEvaluationContext(
     [&](auto& context) {
-      return convertToDecal(context, m_expression.evaluate(context));
+      return convertToDecal(context, m_compiledExpression.evaluate(context));
     },
     variableStore);
 }
@@ -25,9 +25,10 @@
 
 #include "kd/contracts.h"
 
-#include <algorithm>
+#include <ranges>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tb::mdl
@@ -38,19 +39,23 @@ EntityDefinitionManager::~EntityDefinitionManager()
   clear();
 }
 
-void EntityDefinitionManager::setDefinitions(std::vector<EntityDefinition> newDefinitions)
+std::vector<EntityDefinition> EntityDefinitionManager::setDefinitions(
+  std::vector<EntityDefinition> newDefinitions)
 {
   clearGroups();
 
-  m_definitions = std::move(newDefinitions);
+  auto previousDefinitions = std::exchange(m_definitions, std::move(newDefinitions));
 
   updateIndices();
   updateGroups();
+
+  return previousDefinitions;
 }
 
 void EntityDefinitionManager::clear()
 {
   m_definitions.clear();
+  m_definitionsByName.clear();
   clearGroups();
 }
 
@@ -65,15 +70,8 @@ const EntityDefinition* EntityDefinitionManager::definition(
 const EntityDefinition* EntityDefinitionManager::definition(
   const std::string_view classname) const
 {
-  if (const auto it = std::ranges::find_if(
-        m_definitions,
-        [&](const auto& definition) { return definition.name == classname; });
-      it != m_definitions.end())
-  {
-    return &*it;
-  }
-
-  return nullptr;
+  const auto it = m_definitionsByName.find(classname);
+  return it != m_definitionsByName.end() ? it->second : nullptr;
 }
 
 std::vector<const EntityDefinition*> EntityDefinitionManager::definitions(
@@ -95,9 +93,13 @@ const std::vector<EntityDefinitionGroup>& EntityDefinitionManager::groups() cons
 
 void EntityDefinitionManager::updateIndices()
 {
+  m_definitionsByName.clear();
   for (size_t i = 0; i < m_definitions.size(); ++i)
   {
     m_definitions[i].index = i + 1;
+
+    // if a name is defined more than once, the first definition wins
+    m_definitionsByName.emplace(m_definitions[i].name, &m_definitions[i]);
   }
 }
 
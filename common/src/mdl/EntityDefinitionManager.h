@@ -23,6 +23,7 @@
 #include "mdl/EntityDefinitionGroup.h"
 
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace tb::mdl
@@ -35,12 +36,20 @@ class EntityDefinitionManager
 {
 private:
   std::vector<EntityDefinition> m_definitions;
+  std::unordered_map<std::string_view, const EntityDefinition*> m_definitionsByName;
   std::vector<EntityDefinitionGroup> m_groups;
 
 public:
   ~EntityDefinitionManager();
 
-  void setDefinitions(std::vector<EntityDefinition> newDefinitions);
+  /**
+   * Replaces the definitions and returns the previous definitions.
+   *
+   * Entities may still refer to the previous definitions, so the caller must keep them
+   * alive until it has updated these entities.
+   */
+  std::vector<EntityDefinition> setDefinitions(
+    std::vector<EntityDefinition> newDefinitions);
   void clear();
 
   const EntityDefinition* definition(const EntityNodeBase* node) const;
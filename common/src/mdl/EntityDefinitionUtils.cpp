@@ -21,6 +21,9 @@
 
 #include "mdl/EntityProperties.h"
 
+#include <string_view>
+#include <unordered_map>
+
 namespace tb::mdl
 {
 namespace
@@ -112,6 +115,24 @@ void addOrConvertOriginProperties(EntityDefinition& entityDefinition)
   }
 }
 
+auto getDefinitionsByName(const std::vector<EntityDefinition>& entityDefinitions)
+{
+  auto result = std::unordered_map<std::string_view, const EntityDefinition*>{};
+  for (const auto& entityDefinition : entityDefinitions)
+  {
+    result.emplace(entityDefinition.name, &entityDefinition);
+  }
+  return result;
+}
+
+bool haveSameContents(const EntityDefinition& lhs, const EntityDefinition& rhs)
+{
+  return lhs.name == rhs.name && lhs.color == rhs.color
+         && lhs.description == rhs.description
+         && lhs.propertyDefinitions == rhs.propertyDefinitions
+         && lhs.pointEntityDefinition == rhs.pointEntityDefinition;
+}
+
 } // namespace
 
 std::vector<const PropertyDefinition*> getLinkSourcePropertyDefinitions(
@@ -181,4 +202,32 @@ void addOrConvertOriginProperties(std::vector<EntityDefinition>& entityDefinitio
   }
 }
 
+std::unordered_set<std::string> getChangedEntityDefinitionNames(
+  const std::vector<EntityDefinition>& oldDefinitions,
+  const std::vector<EntityDefinition>& newDefinitions)
+{
+  const auto oldDefinitionsByName = getDefinitionsByName(oldDefinitions);
+  const auto newDefinitionsByName = getDefinitionsByName(newDefinitions);
+
+  auto result = std::unordered_set<std::string>{};
+  for (const auto& [name, oldDefinition] : oldDefinitionsByName)
+  {
+    const auto it = newDefinitionsByName.find(name);
+    if (it == newDefinitionsByName.end() || !haveSameContents(*oldDefinition, *it->second))
+    {
+      result.emplace(name);
+    }
+  }
+
+  for (const auto& [name, newDefinition] : newDefinitionsByName)
+  {
+    if (!oldDefinitionsByName.contains(name))
+    {
+      result.emplace(name);
+    }
+  }
+
+  return result;
+}
+
 } // namespace tb::mdl
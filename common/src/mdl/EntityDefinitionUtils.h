@@ -26,6 +26,8 @@
 
 #include <algorithm>
 #include <ranges>
+#include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
@@ -91,4 +93,15 @@ void addOrSetDefaultEntityLinkProperties(
  */
 void addOrConvertOriginProperties(std::vector<EntityDefinition>& entityDefinitions);
 
+/**
+ * Returns the names of the entity definitions that were added, removed or changed when
+ * replacing the given old definitions with the given new definitions.
+ *
+ * Definitions are matched by name. If a name is defined more than once, only its first
+ * definition is considered. The index of a definition is not part of its contents.
+ */
+std::unordered_set<std::string> getChangedEntityDefinitionNames(
+  const std::vector<EntityDefinition>& oldDefinitions,
+  const std::vector<EntityDefinition>& newDefinitions);
+
 } // namespace tb::mdl
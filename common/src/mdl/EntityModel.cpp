@@ -32,12 +32,13 @@
 
 #include "vm/bbox.h"
 #include "vm/bbox_io.h" // IWYU pragma: keep
-#include "vm/intersection.h"
 
 #include <format>
 
 #include <algorithm>
 #include <string>
+#include <type_traits>
+#include <variant>
 
 namespace tb::mdl
 {
@@ -89,7 +90,6 @@ EntityModelFrame::EntityModelFrame(
   : m_index{index}
   , m_name{std::move(name)}
   , m_bounds{bounds}
-  , m_spacialTree{16.0f}
 {
 }
 
@@ -120,26 +120,75 @@ const vm::bbox3f& EntityModelFrame::bounds() const
 
 std::optional<float> EntityModelFrame::intersect(const vm::ray3f& ray) const
 {
-  auto closestDistance = std::optional<float>{};
-
-  const auto candidates = m_spacialTree.find_intersectors(ray);
-  for (const auto triNum : candidates)
+  if (!m_spacialTreeBuilt)
   {
-    const auto& p1 = m_tris[triNum * 3 + 0];
-    const auto& p2 = m_tris[triNum * 3 + 1];
-    const auto& p3 = m_tris[triNum * 3 + 2];
-    closestDistance =
-      vm::safe_min(closestDistance, vm::intersect_ray_triangle(ray, p1, p2, p3));
+    buildSpacialTree();
   }
 
-  return closestDistance;
+  return m_spacialTree.intersect(ray);
+}
+
+void EntityModelFrame::addMesh(const EntityModelMesh& mesh)
+{
+  m_meshes.push_back(&mesh);
+  m_spacialTreeBuilt = false;
 }
 
-void EntityModelFrame::addToSpacialTree(
+void EntityModelFrame::removeMesh(const EntityModelMesh& mesh)
+{
+  std::erase(m_meshes, &mesh);
+  m_spacialTreeBuilt = false;
+}
+
+// EntityModelData::Mesh
+
+/**
+ * The mesh associated with a frame and a surface.
+ */
+class EntityModelMesh
+{
+protected:
+  kdl_reflect_inline_empty(EntityModelMesh);
+
+public:
+  virtual ~EntityModelMesh() = default;
+
+  /**
+   * Returns the vertices of this mesh.
+   */
+  virtual const std::vector<EntityModelVertex>& vertices() const = 0;
+
+  /**
+   * Calls the given function for every primitive of this mesh.
+   *
+   * @param function the function to call
+   */
+  virtual void forEachPrimitive(
+    const std::function<void(const Material*, render::PrimType, size_t, size_t)>&
+      function) const = 0;
+
+  /**
+   * Returns a renderer that renders this mesh with the given material.
+   *
+   * @param skin the material to use when rendering the mesh
+   * @return the renderer
+   */
+  virtual std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
+    const Material* skin) const = 0;
+};
+
+namespace
+{
+
+/**
+ * Appends the triangles of the given primitives to the given list of triangle points.
+ */
+void addTriangles(
   const std::vector<EntityModelVertex>& vertices,
   const render::PrimType primType,
   const size_t index,
-  const size_t count)
+  const size_t count,
+  std::vector<vm::vec3f>& tris)
 {
   switch (primType)
   {
@@ -151,23 +200,15 @@ void EntityModelFrame::addToSpacialTree(
   case render::PrimType::Triangles: {
     contract_assert(count % 3 == 0);
 
-    m_tris.reserve(m_tris.size() + count);
+    tris.reserve(tris.size() + count);
     for (size_t i = 0; i < count; i += 3)
     {
-      auto bounds = vm::bbox3f::builder{};
       const auto& p1 = render::getVertexComponent<0>(vertices[index + i + 0]);
       const auto& p2 = render::getVertexComponent<0>(vertices[index + i + 1]);
       const auto& p3 = render::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
-      m_tris.push_back(p1);
-      m_tris.push_back(p2);
-      m_tris.push_back(p3);
-
-      m_spacialTree.insert(bounds.bounds(), triIndex);
+      tris.push_back(p1);
+      tris.push_back(p2);
+      tris.push_back(p3);
     }
     break;
   }
@@ -175,23 +216,16 @@ void EntityModelFrame::addToSpacialTree(
   case render::PrimType::TriangleFan: {
     contract_assert(count > 2);
 
-    m_tris.reserve(m_tris.size() + (count - 2) * 3);
+    tris.reserve(tris.size() + (count - 2) * 3);
 
     const auto& p1 = render::getVertexComponent<0>(vertices[index]);
     for (size_t i = 1; i < count - 1; ++i)
     {
-      auto bounds = vm::bbox3f::builder{};
       const auto& p2 = render::getVertexComponent<0>(vertices[index + i]);
       const auto& p3 = render::getVertexComponent<0>(vertices[index + i + 1]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
-      m_tris.push_back(p1);
-      m_tris.push_back(p2);
-      m_tris.push_back(p3);
-      m_spacialTree.insert(bounds.bounds(), triIndex);
+      tris.push_back(p1);
+      tris.push_back(p2);
+      tris.push_back(p3);
     }
     break;
   }
@@ -200,31 +234,24 @@ void EntityModelFrame::addToSpacialTree(
   case render::PrimType::TriangleStrip: {
     contract_assert(count > 2);
 
-    m_tris.reserve(m_tris.size() + (count - 2) * 3);
+    tris.reserve(tris.size() + (count - 2) * 3);
     for (size_t i = 0; i < count - 2; ++i)
     {
-      auto bounds = vm::bbox3f::builder{};
       const auto& p1 = render::getVertexComponent<0>(vertices[index + i + 0]);
       const auto& p2 = render::getVertexComponent<0>(vertices[index + i + 1]);
       const auto& p3 = render::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
       if (i % 2 == 0)
       {
-        m_tris.push_back(p1);
-        m_tris.push_back(p2);
-        m_tris.push_back(p3);
+        tris.push_back(p1);
+        tris.push_back(p2);
+        tris.push_back(p3);
       }
       else
       {
-        m_tris.push_back(p1);
-        m_tris.push_back(p3);
-        m_tris.push_back(p2);
+        tris.push_back(p1);
+        tris.push_back(p3);
+        tris.push_back(p2);
       }
-      m_spacialTree.insert(bounds.bounds(), triIndex);
     }
     break;
   }
@@ -232,68 +259,15 @@ void EntityModelFrame::addToSpacialTree(
   }
 }
 
-// EntityModelData::Mesh
-
-/**
- * The mesh associated with a frame and a surface.
- */
-class EntityModelMesh
-{
-protected:
-  std::vector<EntityModelVertex> m_vertices;
-
-  kdl_reflect_inline_empty(EntityModelMesh);
-
-  /**
-   * Creates a new frame mesh that uses the given vertices.
-   *
-   * @param vertices the vertices
-   */
-  explicit EntityModelMesh(std::vector<EntityModelVertex> vertices)
-    : m_vertices{std::move(vertices)}
-  {
-  }
-
-public:
-  virtual ~EntityModelMesh() = default;
-
-public:
-  /**
-   * Returns a renderer that renders this mesh with the given material.
-   *
-   * @param skin the material to use when rendering the mesh
-   * @return the renderer
-   */
-  std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
-    const Material* skin) const
-  {
-    const auto vertexArray = render::VertexArray::ref(m_vertices);
-    return doBuildRenderer(skin, vertexArray);
-  }
-
-private:
-  /**
-   * Creates and returns the actual mesh renderer
-   *
-   * @param skin the skin to use when rendering the mesh
-   * @param vertices the vertices associated with this mesh
-   * @return the renderer
-   */
-  virtual std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildRenderer(
-    const Material* skin, const render::VertexArray& vertices) const = 0;
-};
-
 // EntityModelData::IndexedMesh
 
-namespace
-{
-
 /**
  * A model frame mesh for indexed rendering. Stores vertices and vertex indices.
  */
 class EntityModelIndexedMesh : public EntityModelMesh
 {
 private:
+  std::vector<EntityModelVertex> m_vertices;
   render::IndexRangeMap m_indices;
 
   kdl_reflect_inline_empty(EntityModelIndexedMesh);
@@ -302,29 +276,34 @@ public:
   /**
    * Creates a new frame mesh with the given vertices and indices.
    *
-   * @param frame the frame to which this mesh belongs
    * @param vertices the vertices
    * @param indices the indices
    */
   EntityModelIndexedMesh(
-    EntityModelFrame& frame,
-    std::vector<EntityModelVertex> vertices,
-    render::IndexRangeMap indices)
-    : EntityModelMesh{std::move(vertices)}
+    std::vector<EntityModelVertex> vertices, render::IndexRangeMap indices)
+    : m_vertices{std::move(vertices)}
     , m_indices{std::move(indices)}
+  {
+  }
+
+  const std::vector<EntityModelVertex>& vertices() const override { return m_vertices; }
+
+  void forEachPrimitive(
+    const std::function<void(const Material*, render::PrimType, size_t, size_t)>&
+      function) const override
   {
     m_indices.forEachPrimitive(
       [&](const render::PrimType primType, const size_t index, const size_t count) {
-        frame.addToSpacialTree(m_vertices, primType, index, count);
+        function(nullptr, primType, index, count);
       });
   }
 
-private:
-  std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildRenderer(
-    const Material* skin, const render::VertexArray& vertices) const override
+  std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
+    const Material* skin) const override
   {
+    const auto vertexArray = render::VertexArray::ref(m_vertices);
     const render::MaterialIndexRangeMap indices(skin, m_indices);
-    return std::make_unique<render::MaterialIndexRangeRenderer>(vertices, indices);
+    return std::make_unique<render::MaterialIndexRangeRenderer>(vertexArray, indices);
   }
 };
 
@@ -337,6 +316,7 @@ private:
 class EntityModelMaterialMesh : public EntityModelMesh
 {
 private:
+  std::vector<EntityModelVertex> m_vertices;
   render::MaterialIndexRangeMap m_indices;
 
   kdl_reflect_inline_empty(EntityModelMaterialMesh);
@@ -345,36 +325,121 @@ public:
   /**
    * Creates a new frame mesh with the given vertices and per material indices.
    *
-   * @param frame the frame to which this mesh belongs
    * @param vertices the vertices
    * @param indices the per material indices
    */
   EntityModelMaterialMesh(
-    EntityModelFrame& frame,
-    std::vector<EntityModelVertex> vertices,
-    render::MaterialIndexRangeMap indices)
-    : EntityModelMesh{std::move(vertices)}
+    std::vector<EntityModelVertex> vertices, render::MaterialIndexRangeMap indices)
+    : m_vertices{std::move(vertices)}
     , m_indices{std::move(indices)}
   {
-    m_indices.forEachPrimitive([&](
-                                 const Material* /* material */,
-                                 const render::PrimType primType,
-                                 const size_t index,
-                                 const size_t count) {
-      frame.addToSpacialTree(m_vertices, primType, index, count);
-    });
+  }
+
+  const std::vector<EntityModelVertex>& vertices() const override { return m_vertices; }
+
+  void forEachPrimitive(
+    const std::function<void(const Material*, render::PrimType, size_t, size_t)>&
+      function) const override
+  {
+    m_indices.forEachPrimitive(function);
+  }
+
+  std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
+    const Material* /* skin */) const override
+  {
+    const auto vertexArray = render::VertexArray::ref(m_vertices);
+    return std::make_unique<render::MaterialIndexRangeRenderer>(vertexArray, m_indices);
+  }
+};
+
+// EntityModelDeferredMesh
+
+/**
+ * A model frame mesh that is decoded when it is first accessed.
+ */
+class EntityModelDeferredMesh : public EntityModelMesh
+{
+private:
+  mutable DecodeEntityModelMesh m_decodeMesh;
+  mutable std::unique_ptr<EntityModelMesh> m_mesh;
+
+  kdl_reflect_inline_empty(EntityModelDeferredMesh);
+
+public:
+  explicit EntityModelDeferredMesh(DecodeEntityModelMesh decodeMesh)
+    : m_decodeMesh{std::move(decodeMesh)}
+  {
+  }
+
+  const std::vector<EntityModelVertex>& vertices() const override
+  {
+    return mesh().vertices();
+  }
+
+  void forEachPrimitive(
+    const std::function<void(const Material*, render::PrimType, size_t, size_t)>&
+      function) const override
+  {
+    mesh().forEachPrimitive(function);
+  }
+
+  std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
+    const Material* skin) const override
+  {
+    return mesh().buildRenderer(skin);
   }
 
 private:
-  std::unique_ptr<render::MaterialIndexRangeRenderer> doBuildRenderer(
-    const Material* /* skin */, const render::VertexArray& vertices) const override
+  const EntityModelMesh& mesh() const
   {
-    return std::make_unique<render::MaterialIndexRangeRenderer>(vertices, m_indices);
+    if (!m_mesh)
+    {
+      auto meshData = m_decodeMesh();
+      m_decodeMesh = nullptr;
+
+      m_mesh = std::visit(
+        [&](auto& indices) -> std::unique_ptr<EntityModelMesh> {
+          using Indices = std::decay_t<decltype(indices)>;
+          if constexpr (std::is_same_v<Indices, render::IndexRangeMap>)
+          {
+            return std::make_unique<EntityModelIndexedMesh>(
+              std::move(meshData.vertices), std::move(indices));
+          }
+          else
+          {
+            return std::make_unique<EntityModelMaterialMesh>(
+              std::move(meshData.vertices), std::move(indices));
+          }
+        },
+        meshData.indices);
+    }
+    return *m_mesh;
   }
 };
 
 } // namespace
 
+// EntityModelFrame
+
+void EntityModelFrame::buildSpacialTree() const
+{
+  auto tris = std::vector<vm::vec3f>{};
+  for (const auto* mesh : m_meshes)
+  {
+    const auto& vertices = mesh->vertices();
+    mesh->forEachPrimitive([&](
+                             const Material* /* material */,
+                             const render::PrimType primType,
+                             const size_t index,
+                             const size_t count) {
+      addTriangles(vertices, primType, index, count, tris);
+    });
+  }
+
+  m_spacialTree = triangle_bvh<float>{tris};
+  m_spacialTreeBuilt = true;
+}
+
 // EntityModelSurface
 
 kdl_reflect_impl(EntityModelSurface);
@@ -420,10 +485,9 @@ void EntityModelSurface::addMesh(
   std::vector<EntityModelVertex> vertices,
   render::IndexRangeMap indices)
 {
-  contract_pre(frame.index() < frameCount());
-
-  m_meshes[frame.index()] = std::make_unique<EntityModelIndexedMesh>(
-    frame, std::move(vertices), std::move(indices));
+  setMesh(
+    frame,
+    std::make_unique<EntityModelIndexedMesh>(std::move(vertices), std::move(indices)));
 }
 
 void EntityModelSurface::addMesh(
@@ -431,10 +495,15 @@ void EntityModelSurface::addMesh(
   std::vector<EntityModelVertex> vertices,
   render::MaterialIndexRangeMap indices)
 {
-  contract_pre(frame.index() < frameCount());
+  setMesh(
+    frame,
+    std::make_unique<EntityModelMaterialMesh>(std::move(vertices), std::move(indices)));
+}
 
-  m_meshes[frame.index()] = std::make_unique<EntityModelMaterialMesh>(
-    frame, std::move(vertices), std::move(indices));
+void EntityModelSurface::addMesh(
+  EntityModelFrame& frame, DecodeEntityModelMesh decodeMesh)
+{
+  setMesh(frame, std::make_unique<EntityModelDeferredMesh>(std::move(decodeMesh)));
 }
 
 void EntityModelSurface::setSkins(std::vector<Material> skins)
@@ -462,6 +531,27 @@ const Material* EntityModelSurface::skin(const size_t index) const
   return m_skins->materialByIndex(index);
 }
 
+const std::vector<EntityModelVertex>* EntityModelSurface::vertices(
+  const size_t frameIndex) const
+{
+  contract_pre(frameIndex < frameCount());
+
+  return m_meshes[frameIndex] ? &m_meshes[frameIndex]->vertices() : nullptr;
+}
+
+void EntityModelSurface::forEachPrimitive(
+  const size_t frameIndex,
+  const std::function<void(const Material*, render::PrimType, size_t, size_t)>& function)
+  const
+{
+  contract_pre(frameIndex < frameCount());
+
+  if (m_meshes[frameIndex])
+  {
+    m_meshes[frameIndex]->forEachPrimitive(function);
+  }
+}
+
 std::unique_ptr<render::MaterialIndexRangeRenderer> EntityModelSurface::buildRenderer(
   const size_t skinIndex, const size_t frameIndex) const
 {
@@ -472,6 +562,21 @@ std::unique_ptr<render::MaterialIndexRangeRenderer> EntityModelSurface::buildRen
                               : nullptr;
 }
 
+void EntityModelSurface::setMesh(
+  EntityModelFrame& frame, std::unique_ptr<EntityModelMesh> mesh)
+{
+  contract_pre(frame.index() < frameCount());
+
+  auto& frameMesh = m_meshes[frame.index()];
+  if (frameMesh)
+  {
+    frame.removeMesh(*frameMesh);
+  }
+
+  frameMesh = std::move(mesh);
+  frame.addMesh(*frameMesh);
+}
+
 // EntityModelData
 
 kdl_reflect_impl(EntityModelData);
@@ -21,27 +21,26 @@ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 
 #include "mdl/EntityModelDataResource.h"
 #include "mdl/EntityModel_Forward.h"
-#include "octree.h"
+#include "render/IndexRangeMap.h"
+#include "render/MaterialIndexRangeMap.h"
+#include "triangle_bvh.h"
 
 #include "kd/reflection_decl.h"
 
 #include "vm/bbox.h"
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace tb
 {
-template <typename T, typename U>
-class octree;
-
 namespace render
 {
 enum class PrimType;
-class IndexRangeMap;
-class MaterialIndexRangeMap;
 class MaterialIndexRangeRenderer;
 class MaterialRenderer;
 } // namespace render
@@ -81,9 +80,12 @@ enum class Orientation
 
 std::ostream& operator<<(std::ostream& lhs, Orientation rhs);
 
+class EntityModelMesh;
+
 /**
- * One frame of the model. Since frames are loaded on demand, each frame has two possible
- * states: loaded and unloaded. These states are modeled as subclasses of this class.
+ * One frame of the model. The meshes of a frame may be decoded on demand, so the bounds
+ * of each frame are computed when the model is loaded, while the data used for hit
+ * testing is only collected when the frame is first intersected with a ray.
  */
 class EntityModelFrame
 {
@@ -92,15 +94,16 @@ private:
   std::string m_name;
   vm::bbox3f m_bounds;
   size_t m_skinOffset = 0;
+  std::vector<const EntityModelMesh*> m_meshes;
 
-  // For hit testing
-  std::vector<vm::vec3f> m_tris;
-  using TriNum = size_t;
-  using SpacialTree = octree<float, TriNum>;
-  SpacialTree m_spacialTree;
+  // For hit testing, built on demand
+  mutable triangle_bvh<float> m_spacialTree;
+  mutable bool m_spacialTreeBuilt = false;
 
   kdl_reflect_decl(EntityModelFrame, m_index, m_name, m_bounds, m_skinOffset);
 
+  friend class EntityModelSurface;
+
 public:
   /**
    * Creates a new frame with the given index.
@@ -143,29 +146,35 @@ public:
   /**
    * Intersects this frame with the given ray and returns the point of intersection.
    *
+   * The first call decodes the meshes of this frame if necessary and builds the spacial
+   * tree used for hit testing.
+   *
    * @param ray the ray to intersect
    * @return the distance to the point of intersection or nullopt if the given ray does
    * not intersect this frame
    */
   std::optional<float> intersect(const vm::ray3f& ray) const;
 
-  /**
-   * Adds the given primitives to the spacial tree for this frame.
-   *
-   * @param vertices the vertices
-   * @param primType the primitive type
-   * @param index the index of the first primitive's first vertex in the given vertex
-   * array
-   * @param count the number of vertices that make up the primitive(s)
-   */
-  void addToSpacialTree(
-    const std::vector<EntityModelVertex>& vertices,
-    render::PrimType primType,
-    size_t index,
-    size_t count);
+private:
+  void addMesh(const EntityModelMesh& mesh);
+  void removeMesh(const EntityModelMesh& mesh);
+
+  void buildSpacialTree() const;
 };
 
-class EntityModelMesh;
+/**
+ * The vertices and indices of a mesh.
+ */
+struct EntityModelMeshData
+{
+  std::vector<EntityModelVertex> vertices;
+  std::variant<render::IndexRangeMap, render::MaterialIndexRangeMap> indices;
+};
+
+/**
+ * Decodes a mesh when it is first needed.
+ */
+using DecodeEntityModelMesh = std::function<EntityModelMeshData()>;
 
 /**
  * A model surface represents an individual part of a model. MDL and MD2 models use only
@@ -238,6 +247,21 @@ public:
     std::vector<EntityModelVertex> vertices,
     render::MaterialIndexRangeMap indices);
 
+  /**
+   * Adds a new mesh to this surface that is decoded by the given function when it is
+   * first needed, e.g. when the frame is rendered or intersected with a ray. Since most
+   * frames of an animated model are never shown in the editor, this avoids holding all
+   * decoded frames in memory.
+   *
+   * The given function is called at most once and must not refer to this surface or to
+   * the given frame, since both may be moved before the mesh is decoded. Materials
+   * referenced by the decoded indices must be skins of this surface.
+   *
+   * @param frame the frame which the mesh belongs to
+   * @param decodeMesh the function that decodes the mesh
+   */
+  void addMesh(EntityModelFrame& frame, DecodeEntityModelMesh decodeMesh);
+
   /**
    * Sets the given materials as skins to this surface.
    *
@@ -276,8 +300,32 @@ public:
    */
   const Material* skin(size_t index) const;
 
+  /**
+   * Returns the vertices of the mesh for the given frame. Decodes the mesh if necessary.
+   *
+   * @param frameIndex the index of the frame
+   * @return the vertices, or null if this surface has no mesh for the given frame
+   */
+  const std::vector<EntityModelVertex>* vertices(size_t frameIndex) const;
+
+  /**
+   * Calls the given function for every primitive of the mesh for the given frame. If the
+   * mesh uses per material indices, the material of each primitive is passed to the
+   * function, otherwise the material is null. Decodes the mesh if necessary.
+   *
+   * @param frameIndex the index of the frame
+   * @param function the function to call
+   */
+  void forEachPrimitive(
+    size_t frameIndex,
+    const std::function<void(const Material*, render::PrimType, size_t, size_t)>&
+      function) const;
+
   std::unique_ptr<render::MaterialIndexRangeRenderer> buildRenderer(
     size_t skinIndex, size_t frameIndex) const;
+
+private:
+  void setMesh(EntityModelFrame& frame, std::unique_ptr<EntityModelMesh> mesh);
 };
 
 /**
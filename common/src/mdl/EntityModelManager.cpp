@@ -20,6 +20,8 @@
 #include "EntityModelManager.h"
 
 #include "Logger.h"
+#include "io/AssimpLoader.h"
+#include "io/EntityModelCache.h"
 #include "io/LoadEntityModel.h"
 #include "io/LoadMaterialCollections.h"
 #include "io/LoadShaders.h"
@@ -34,18 +36,37 @@
 #include "kd/ranges/to.h"
 #include "kd/result.h"
 
+#include <cstdint>
+
 namespace tb::mdl
 {
+namespace
+{
+
+// The entity model cache is pruned to this size whenever a map is opened
+constexpr auto MaxEntityModelCacheSize = std::uintmax_t{512} * 1024 * 1024;
+
+} // namespace
+
 EntityModelManager::EntityModelManager(
   const GameInfo& gameInfo,
   const fs::FileSystem& gameFileSystem,
+  std::optional<std::filesystem::path> cacheDirectory,
   CreateEntityModelDataResource createResource,
+  kdl::task_manager& taskManager,
   Logger& logger)
   : m_gameInfo{gameInfo}
   , m_gameFileSystem{gameFileSystem}
+  , m_cacheDirectory{std::move(cacheDirectory)}
+  , m_assimpTexturePathCache{std::make_shared<io::AssimpTexturePathCache>()}
   , m_createResource{std::move(createResource)}
+  , m_taskManager{taskManager}
   , m_logger{logger}
 {
+  if (m_cacheDirectory)
+  {
+    io::pruneEntityModelCache(*m_cacheDirectory, MaxEntityModelCacheSize);
+  }
 }
 
 EntityModelManager::~EntityModelManager()
@@ -58,6 +79,7 @@ void EntityModelManager::clear()
   m_renderers.clear();
   m_models.clear();
   m_rendererMismatches.clear();
+  m_assimpTexturePathCache->clear();
 
   m_unpreparedRenderers.clear();
 
@@ -197,7 +219,10 @@ Result<EntityModel> EntityModelManager::loadModel(
     materialConfig,
     modelPath,
     loadMaterial,
+    m_cacheDirectory,
+    m_assimpTexturePathCache,
     m_createResource,
+    m_taskManager,
     m_logger);
 }
 
@@ -27,6 +27,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -45,6 +46,11 @@ namespace fs
 class FileSystem;
 }
 
+namespace io
+{
+class AssimpTexturePathCache;
+}
+
 namespace render
 {
 class MaterialRenderer;
@@ -67,7 +73,14 @@ private:
   const GameInfo& m_gameInfo;
   const fs::FileSystem& m_gameFileSystem;
 
+  // If set, decoded models are cached in this directory across sessions
+  std::optional<std::filesystem::path> m_cacheDirectory;
+
+  // Shared by all Assimp models so that their texture paths are only resolved once
+  std::shared_ptr<io::AssimpTexturePathCache> m_assimpTexturePathCache;
+
   CreateEntityModelDataResource m_createResource;
+  kdl::task_manager& m_taskManager;
   Logger& m_logger;
 
   // Cache Quake 3 shaders to use when loading models
@@ -85,7 +98,9 @@ public:
   EntityModelManager(
     const GameInfo& gameInfo,
     const fs::FileSystem& gameFilesystem,
+    std::optional<std::filesystem::path> cacheDirectory,
     CreateEntityModelDataResource createResource,
+    kdl::task_manager& taskManager,
     Logger& logger);
   ~EntityModelManager();
 
@@ -116,6 +116,11 @@ void EntityNodeBase::setDefinition(const EntityDefinition* definition)
   m_entity.setDefinition(definition);
 }
 
+void EntityNodeBase::replaceDefinition(const EntityDefinition* definition)
+{
+  m_entity.setDefinition(definition);
+}
+
 EntityNodeBase::NotifyPropertyChange::NotifyPropertyChange(EntityNodeBase& node)
   : m_nodeChange{node}
   , m_node{node}
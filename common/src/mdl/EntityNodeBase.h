@@ -56,6 +56,13 @@ public: // entity access
 public: // definition
   void setDefinition(const EntityDefinition* definition);
 
+  /**
+   * Replaces the definition of this node with the given definition, which must have the
+   * same contents, e.g. after the definitions were reloaded. Since nothing that depends on
+   * the definition changes, nobody is notified.
+   */
+  void replaceDefinition(const EntityDefinition* definition);
+
 private: // property management internals
   class NotifyPropertyChange
   {
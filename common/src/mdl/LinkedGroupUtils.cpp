@@ -19,6 +19,7 @@
 
 #include "LinkedGroupUtils.h"
 
+#include "Trace.h"
 #include "Uuid.h"
 #include "mdl/ModelUtils.h"
 #include "mdl/Node.h"
@@ -35,6 +36,7 @@
 #include "kd/task_manager.h"
 
 #include <algorithm>
+#include <format>
 #include <string_view>
 #include <unordered_map>
 
@@ -272,6 +274,9 @@ Result<std::vector<std::unique_ptr<Node>>> cloneAndTransformChildren(
 {
   auto nodesToClone = collectDescendants(std::vector{&node});
 
+  const auto trace = TraceScope{
+    "cloneAndTransformChildren", std::format("{} nodes", nodesToClone.size())};
+
   using TransformResult = Result<std::pair<const Node*, NodeContents>>;
 
   // In parallel, produce pairs { node pointer, transformed contents } from the nodes in
@@ -729,6 +734,25 @@ void resetLinkIds(const std::vector<GroupNode*>& groupNodes)
   }
 }
 
+void resetLinkIdsOfNonGroupedNodes(const std::map<Node*, std::vector<Node*>>& nodes)
+{
+  for (const auto& [parent, children] : nodes)
+  {
+    Node::visitAll(
+      children,
+      kdl::overload(
+        [](const WorldNode*) {},
+        [](const LayerNode*) {},
+        [](const GroupNode*) {},
+        [](auto&& thisLambda, EntityNode* entityNode) {
+          entityNode->setLinkId(generateUuid());
+          entityNode->visitChildren(thisLambda);
+        },
+        [](BrushNode* brushNode) { brushNode->setLinkId(generateUuid()); },
+        [](PatchNode* patchNode) { patchNode->setLinkId(generateUuid()); }));
+  }
+}
+
 Result<std::unordered_map<Node*, std::string>> copyAndReturnLinkIds(
   const GroupNode& sourceGroupNode, const std::vector<GroupNode*>& targetGroupNodes)
 {
@@ -32,6 +32,7 @@
 #include "kd/overload.h"
 #include "kd/vector_utils.h"
 
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -149,6 +150,12 @@ std::vector<Error> initializeLinkIds(const std::vector<Node*>& nodes);
  */
 void resetLinkIds(const std::vector<GroupNode*>& groupNodes);
 
+/**
+ * Reset the link IDs of the given nodes and their descendants except for group nodes and
+ * their descendants.
+ */
+void resetLinkIdsOfNonGroupedNodes(const std::map<Node*, std::vector<Node*>>& nodes);
+
 Result<std::unordered_map<Node*, std::string>> copyAndReturnLinkIds(
   const GroupNode& sourceGroupNode, const std::vector<GroupNode*>& targetGroupNodes);
 
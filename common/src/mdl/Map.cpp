@@ -21,10 +21,13 @@
 
 #include "Logger.h"
 #include "PreferenceManager.h"
+#include "Preferences.h"
 #include "SimpleParserStatus.h"
+#include "Trace.h"
 #include "fs/DiskIO.h"
 #include "fs/PathInfo.h"
 #include "io/GameConfigParser.h"
+#include "io/GlbSerializer.h"
 #include "io/LoadEntityDefinitions.h"
 #include "io/LoadMaterialCollections.h"
 #include "io/MapHeader.h"
@@ -77,6 +80,8 @@
 #include "mdl/MixedBrushContentsValidator.h"
 #include "mdl/ModelUtils.h"
 #include "mdl/Node.h"
+#include "mdl/NodeChangeCollector.h"
+#include "mdl/NodeChanges.h"
 #include "mdl/NodeIndex.h"
 #include "mdl/NodeQueries.h"
 #include "mdl/NonIntegerVerticesValidator.h"
@@ -110,6 +115,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <memory>
+#include <optional>
 #include <ranges>
 #include <string>
 #include <vector>
@@ -214,12 +220,7 @@ Result<std::unique_ptr<WorldNode>> createWorldNode(
   auto worldEntity = Entity{};
   if (!config.forceEmptyNewMap)
   {
-    if (
-      format == MapFormat::Valve || format == MapFormat::Quake2_Valve
-      || format == MapFormat::Quake3_Valve)
-    {
-      worldEntity.addOrUpdateProperty(EntityPropertyKeys::ValveVersion, "220");
-    }
+    setValveVersion(worldEntity, format);
 
     if (config.materialConfig.property)
     {
@@ -526,7 +527,11 @@ Map::Map(
   , m_entityModelManager{std::make_unique<EntityModelManager>(
       m_gameInfo,
       *m_gameFileSystem,
+      pref(Preferences::CacheEntityModels)
+        ? std::optional{io::SystemPaths::userDataDirectory() / "cache" / "models"}
+        : std::nullopt,
       makeCreateResource<EntityModelDataResource>(*m_resourceManager),
+      m_taskManager,
       logger)}
   , m_materialManager{std::make_unique<MaterialManager>(
       makeCreateResource<TextureResource>(*m_resourceManager), logger)}
@@ -543,6 +548,7 @@ Map::Map(
   , m_currentMaterialName{BrushFaceAttributes::NoMaterialName}
   , m_repeatStack{std::make_unique<RepeatStack>()}
   , m_commandProcessor{std::make_unique<CommandProcessor>(*this)}
+  , m_nodeChangeCollector{std::make_unique<NodeChangeCollector>()}
   , m_path{std::move(path)}
   , m_selection{*this}
 {
@@ -592,6 +598,7 @@ Result<std::unique_ptr<Map>> Map::loadMap(
     return Error{"Path must be absolute"};
   }
 
+  const auto trace = TraceScope{"Map::loadMap", path.string()};
   logger.info() << "Loading document from " << path;
 
   return loadWorldNode(
@@ -647,6 +654,11 @@ const MaterialManager& Map::materialManager() const
   return *m_materialManager;
 }
 
+const ResourceManager& Map::resourceManager() const
+{
+  return *m_resourceManager;
+}
+
 TagManager& Map::tagManager()
 {
   return *m_tagManager;
@@ -834,6 +846,18 @@ Result<void> Map::exportAs(const io::ExportOptions& options) const
           writer.setExporting(true);
           writer.writeMap(m_taskManager);
         });
+      },
+      [&](const io::GltfExportOptions& gltfOptions) {
+        return fs::Disk::withOutputStream(
+          gltfOptions.exportPath, std::ios::out | std::ios::binary, [&](auto& stream) {
+            auto serializer = std::make_unique<io::GlbSerializer>(stream, gltfOptions);
+            const auto& glbSerializer = *serializer;
+
+            auto writer = io::NodeWriter{*m_worldNode, std::move(serializer)};
+            writer.setExporting(true);
+            writer.writeMap(m_taskManager);
+            return glbSerializer.result();
+          });
       }),
     options);
 }
@@ -1086,7 +1110,7 @@ void Map::clearAssets()
   clearMaterials();
 }
 
-void Map::loadEntityDefinitions()
+std::vector<EntityDefinition> Map::readEntityDefinitions()
 {
   if (const auto spec = entityDefinitionFile(*this))
   {
@@ -1097,33 +1121,101 @@ void Map::loadEntityDefinitions()
     const auto& defaultColor = gameConfig.entityConfig.defaultColor;
     auto status = SimpleParserStatus{logger()};
 
-    io::loadEntityDefinitions(path, defaultColor, status)
-      | kdl::transform([&](auto entityDefinitions) {
-          logger().info() << std::format(
-            "Loaded entity definition file {}", path.filename().string());
+    return io::loadEntityDefinitions(path, defaultColor, status)
+           | kdl::transform([&](auto entityDefinitions) {
+               logger().info() << std::format(
+                 "Loaded entity definition file {}", path.filename().string());
+
+               addOrSetDefaultEntityLinkProperties(entityDefinitions);
+               addOrConvertOriginProperties(entityDefinitions);
+
+               return entityDefinitions;
+             })
+           | kdl::transform_error([&](auto e) {
+               switch (spec->type)
+               {
+               case EntityDefinitionFileSpec::Type::Builtin:
+                 logger().error() << "Could not load builtin entity definition file '"
+                                  << spec->path << "': " << e.msg;
+                 break;
+               case EntityDefinitionFileSpec::Type::External:
+                 logger().error() << "Could not load external entity definition file '"
+                                  << spec->path << "': " << e.msg;
+                 break;
+               }
+               return std::vector<EntityDefinition>{};
+             })
+           | kdl::value();
+  }
 
-          addOrSetDefaultEntityLinkProperties(entityDefinitions);
-          addOrConvertOriginProperties(entityDefinitions);
+  return {};
+}
 
-          entityDefinitionManager().setDefinitions(std::move(entityDefinitions));
-        })
-      | kdl::transform_error([&](auto e) {
-          switch (spec->type)
-          {
-          case EntityDefinitionFileSpec::Type::Builtin:
-            logger().error() << "Could not load builtin entity definition file '"
-                             << spec->path << "': " << e.msg;
-            break;
-          case EntityDefinitionFileSpec::Type::External:
-            logger().error() << "Could not load external entity definition file '"
-                             << spec->path << "': " << e.msg;
-            break;
-          }
-        });
-  }
-  else
+void Map::loadEntityDefinitions()
+{
+  m_entityDefinitionManager->setDefinitions(readEntityDefinitions());
+}
+
+void Map::updateEntityDefinitions()
+{
+  auto entityDefinitions = readEntityDefinitions();
+  const auto changedNames = getChangedEntityDefinitionNames(
+    m_entityDefinitionManager->definitions(), entityDefinitions);
+
+  auto changedNodes = std::vector<Node*>{};
+  auto unchangedNodes = std::vector<EntityNodeBase*>{};
+  auto unchangedEntityNodes = std::vector<Node*>{};
+
+  const auto collectNode = [&](auto* node) {
+    if (changedNames.contains(node->entity().classname()))
+    {
+      changedNodes.push_back(node);
+      return true;
+    }
+    unchangedNodes.push_back(node);
+    return false;
+  };
+
+  m_worldNode->accept(kdl::overload(
+    [&](auto&& thisLambda, WorldNode* worldNode) {
+      collectNode(worldNode);
+      worldNode->visitChildren(thisLambda);
+    },
+    [](auto&& thisLambda, LayerNode* layerNode) { layerNode->visitChildren(thisLambda); },
+    [](auto&& thisLambda, GroupNode* groupNode) { groupNode->visitChildren(thisLambda); },
+    [&](EntityNode* entityNode) {
+      if (!collectNode(entityNode))
+      {
+        unchangedEntityNodes.push_back(entityNode);
+      }
+    },
+    [](BrushNode*) {},
+    [](PatchNode*) {}));
+
+  // The changed nodes refer to the previous definitions until nodesDidChange sets their
+  // new definitions, so the previous definitions must outlive the notification.
+  auto previousDefinitions = std::vector<EntityDefinition>{};
   {
-    entityDefinitionManager().clear();
+    const auto notifyNodes = NotifyBeforeAndAfter{
+      !changedNodes.empty(),
+      nodesWillChangeNotifier,
+      nodesDidChangeNotifier,
+      changedNodes};
+
+    // The model files may have changed, too, and reloading the entity definitions is how
+    // the user picks them up, so all models are reloaded.
+    unsetEntityModels();
+    m_entityModelManager->clear();
+
+    previousDefinitions =
+      m_entityDefinitionManager->setDefinitions(std::move(entityDefinitions));
+
+    for (auto* node : unchangedNodes)
+    {
+      node->replaceDefinition(m_entityDefinitionManager->definition(node));
+    }
+
+    setEntityModels(unchangedEntityNodes);
   }
 }
 
@@ -1299,11 +1391,6 @@ void Map::initializeEntityLinks()
   addEntityLinks({&worldNode()}, true);
 }
 
-void Map::clearEntityLinks()
-{
-  m_entityLinkManager->clear();
-}
-
 void Map::addEntityLinks(const std::vector<Node*>& nodes, const bool recurse)
 {
   for (auto* node : nodes)
@@ -1523,6 +1610,10 @@ void Map::connectObservers()
   m_notifierConnection += nodesWereRemovedNotifier.connect(this, &Map::nodesWereRemoved);
   m_notifierConnection += nodesWillChangeNotifier.connect(this, &Map::nodesWillChange);
   m_notifierConnection += nodesDidChangeNotifier.connect(this, &Map::nodesDidChange);
+  m_notifierConnection +=
+    nodeVisibilityDidChangeNotifier.connect(this, &Map::nodeVisibilityDidChange);
+  m_notifierConnection +=
+    nodeLockingDidChangeNotifier.connect(this, &Map::nodeLockingDidChange);
 
   m_notifierConnection +=
     selectionDidChangeNotifier.connect(this, &Map::selectionDidChange);
@@ -1534,8 +1625,6 @@ void Map::connectObservers()
   m_notifierConnection += materialCollectionsDidChangeNotifier.connect(
     this, &Map::materialCollectionsDidChange);
 
-  m_notifierConnection +=
-    entityDefinitionsWillChangeNotifier.connect(this, &Map::entityDefinitionsWillChange);
   m_notifierConnection +=
     entityDefinitionsDidChangeNotifier.connect(this, &Map::entityDefinitionsDidChange);
 
@@ -1550,6 +1639,9 @@ void Map::connectObservers()
 
   m_notifierConnection +=
     resourcesWereProcessedNotifier.connect(this, &Map::resourcesWereProcessed);
+
+  m_notifierConnection +=
+    m_commandProcessor->batchDidEndNotifier.connect(this, &Map::batchDidEnd);
 }
 
 namespace
@@ -1620,6 +1712,9 @@ void Map::nodesWereAdded(const std::vector<Node*>& nodes)
 
   m_selection.update(computeSelectionChangeForAddedNodes(nodes));
   m_cachedSelectionBounds = std::nullopt;
+
+  m_nodeChangeCollector->nodesWereAdded(nodes);
+  notifyCoalescedNodeChanges();
 }
 
 void Map::nodesWillBeRemoved(const std::vector<Node*>& nodes)
@@ -1637,6 +1732,9 @@ void Map::nodesWereRemoved(const std::vector<Node*>& nodes)
 
   m_selection.update(computeSelectionChangeForRemovedNodes(nodes));
   m_cachedSelectionBounds = std::nullopt;
+
+  m_nodeChangeCollector->nodesWereRemoved(nodes);
+  notifyCoalescedNodeChanges();
 }
 
 void Map::nodesWillChange(const std::vector<Node*>& nodes)
@@ -1656,6 +1754,21 @@ void Map::nodesDidChange(const std::vector<Node*>& nodes)
 
   m_selection.invalidate();
   m_cachedSelectionBounds = std::nullopt;
+
+  m_nodeChangeCollector->nodesDidChange(nodes);
+  notifyCoalescedNodeChanges();
+}
+
+void Map::nodeVisibilityDidChange(const std::vector<Node*>& nodes)
+{
+  m_nodeChangeCollector->nodeVisibilityDidChange(nodes);
+  notifyCoalescedNodeChanges();
+}
+
+void Map::nodeLockingDidChange(const std::vector<Node*>& nodes)
+{
+  m_nodeChangeCollector->nodeLockingDidChange(nodes);
+  notifyCoalescedNodeChanges();
 }
 
 void Map::brushFacesDidChange(const std::vector<BrushFaceHandle>& brushFaces)
@@ -1681,6 +1794,9 @@ void Map::selectionDidChange(const SelectionChange& selectionChange)
   m_repeatStack->clearOnNextPush();
   m_selection.update(selectionChange);
   m_cachedSelectionBounds = std::nullopt;
+
+  m_nodeChangeCollector->selectionDidChange(selectionChange);
+  notifyCoalescedNodeChanges();
 }
 
 void Map::materialCollectionsWillChange()
@@ -1695,19 +1811,9 @@ void Map::materialCollectionsDidChange()
   updateAllFaceTags();
 }
 
-void Map::entityDefinitionsWillChange()
-{
-  clearEntityDefinitions();
-  clearEntityModels();
-  clearEntityLinks();
-}
-
 void Map::entityDefinitionsDidChange()
 {
-  loadEntityDefinitions();
-  setEntityDefinitions();
-  setEntityModels();
-  initializeEntityLinks();
+  updateEntityDefinitions();
 }
 
 void Map::modsWillChange()
@@ -1739,4 +1845,17 @@ void Map::preferenceDidChange(const std::filesystem::path& path)
   }
 }
 
+void Map::batchDidEnd()
+{
+  notifyCoalescedNodeChanges();
+}
+
+void Map::notifyCoalescedNodeChanges()
+{
+  if (!m_commandProcessor->isBatching() && !m_nodeChangeCollector->empty())
+  {
+    coalescedNodeChangesNotifier(m_nodeChangeCollector->release());
+  }
+}
+
 } // namespace tb::mdl
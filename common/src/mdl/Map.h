@@ -70,6 +70,7 @@ class Issue;
 class LayerNode;
 class MaterialManager;
 class Node;
+class NodeChangeCollector;
 class NodeIndex;
 class PickResult;
 class PointTrace;
@@ -82,7 +83,9 @@ class UVCoordSystemSnapshot;
 class VertexHandleManager;
 class WorldNode;
 
+struct EntityDefinition;
 struct GameInfo;
+struct NodeChanges;
 struct ProcessContext;
 struct SelectionChange;
 struct SoftMapBounds;
@@ -131,6 +134,12 @@ private:
 
   std::unique_ptr<CommandProcessor> m_commandProcessor;
 
+  /*
+   * Collects node changes while the command processor is batching so that they can be
+   * delivered to coalescedNodeChangesNotifier once per batch.
+   */
+  std::unique_ptr<NodeChangeCollector> m_nodeChangeCollector;
+
   std::filesystem::path m_path = DefaultDocumentName;
   size_t m_lastSaveModificationCount = 0;
   size_t m_modificationCount = 0;
@@ -157,6 +166,13 @@ public: // notification
   Notifier<const std::vector<Node*>&> nodesWillChangeNotifier;
   Notifier<const std::vector<Node*>&> nodesDidChangeNotifier;
 
+  /*
+   * Notifies observers of the accumulated node and selection changes once per batch of
+   * commands, see CommandProcessor::batchDidEndNotifier. Changes that happen outside of
+   * a batch are delivered immediately.
+   */
+  Notifier<const NodeChanges&> coalescedNodeChangesNotifier;
+
   Notifier<const std::vector<Node*>&> nodeVisibilityDidChangeNotifier;
   Notifier<const std::vector<Node*>&> nodeLockingDidChangeNotifier;
 
@@ -225,6 +241,8 @@ public: // misc
   MaterialManager& materialManager();
   const MaterialManager& materialManager() const;
 
+  const ResourceManager& resourceManager() const;
+
   TagManager& tagManager();
   const TagManager& tagManager() const;
 
@@ -327,7 +345,9 @@ private: // Asset management
   void loadAssets();
   void clearAssets();
 
+  std::vector<EntityDefinition> readEntityDefinitions();
   void loadEntityDefinitions();
+  void updateEntityDefinitions();
   void clearEntityDefinitions();
 
   void reloadMaterials();
@@ -364,7 +384,6 @@ private: // index management
 
 private: // entity link management
   void initializeEntityLinks();
-  void clearEntityLinks();
   void addEntityLinks(const std::vector<Node*>& nodes, bool recurse);
   void removeEntityLinks(const std::vector<Node*>& nodes, bool recurse);
 
@@ -409,17 +428,20 @@ private: // observers
   void nodesWereRemoved(const std::vector<Node*>& nodes);
   void nodesWillChange(const std::vector<Node*>& nodes);
   void nodesDidChange(const std::vector<Node*>& nodes);
+  void nodeVisibilityDidChange(const std::vector<Node*>& nodes);
+  void nodeLockingDidChange(const std::vector<Node*>& nodes);
   void brushFacesDidChange(const std::vector<BrushFaceHandle>& brushFaces);
   void resourcesWereProcessed(const std::vector<ResourceId>&);
   void selectionWillChange();
   void selectionDidChange(const SelectionChange& selectionChange);
   void materialCollectionsWillChange();
   void materialCollectionsDidChange();
-  void entityDefinitionsWillChange();
   void entityDefinitionsDidChange();
   void modsWillChange();
   void modsDidChange();
   void preferenceDidChange(const std::filesystem::path& path);
+  void batchDidEnd();
+  void notifyCoalescedNodeChanges();
 };
 
 } // namespace mdl
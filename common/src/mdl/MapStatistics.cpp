@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapStatistics.h"
+
+#include "mdl/BrushNode.h"
+#include "mdl/CommandProcessor.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/Map.h"
+#include "mdl/Material.h"
+#include "mdl/MaterialManager.h"
+#include "mdl/PatchNode.h"
+#include "mdl/ResourceManager.h"
+#include "mdl/Texture.h"
+#include "mdl/WorldNode.h"
+
+#include "kd/overload.h"
+#include "kd/reflection_impl.h"
+
+namespace tb::mdl
+{
+
+kdl_reflect_impl(MapStatistics);
+
+MapStatistics computeMapStatistics(const Map& map)
+{
+  auto result = MapStatistics{};
+
+  map.worldNode().accept(kdl::overload(
+    [](auto&& thisLambda, const WorldNode* worldNode) {
+      worldNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const LayerNode* layerNode) {
+      ++result.layerCount;
+      layerNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const GroupNode* groupNode) {
+      ++result.groupCount;
+      groupNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const EntityNode* entityNode) {
+      ++result.entityCount;
+      entityNode->visitChildren(thisLambda);
+    },
+    [&](const BrushNode* brushNode) {
+      ++result.brushCount;
+      result.brushFaceCount += brushNode->brush().faceCount();
+    },
+    [&](const PatchNode*) { ++result.patchCount; }));
+
+  result.undoMemoryUsage = map.commandProcessor().memoryUsage();
+
+  for (const auto* material : map.materialManager().materials())
+  {
+    if (const auto* texture = material->texture())
+    {
+      result.textureMemoryUsage += texture->uploadedSize();
+    }
+  }
+
+  result.pendingResourceCount = map.resourceManager().pendingResourceCount();
+
+  return result;
+}
+
+} // namespace tb::mdl
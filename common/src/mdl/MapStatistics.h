@@ -0,0 +1,65 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "kd/reflection_decl.h"
+
+#include <cstddef>
+
+namespace tb::mdl
+{
+class Map;
+
+struct MapStatistics
+{
+  size_t layerCount = 0;
+  size_t groupCount = 0;
+  size_t entityCount = 0;
+  size_t brushCount = 0;
+  size_t brushFaceCount = 0;
+  size_t patchCount = 0;
+
+  // an estimate of the memory held by the undo and redo stacks, in bytes
+  size_t undoMemoryUsage = 0;
+  // the video memory used by the textures of the materials, in bytes
+  size_t textureMemoryUsage = 0;
+  // the number of resources that are waiting to be loaded or uploaded
+  size_t pendingResourceCount = 0;
+
+  kdl_reflect_decl(
+    MapStatistics,
+    layerCount,
+    groupCount,
+    entityCount,
+    brushCount,
+    brushFaceCount,
+    patchCount,
+    undoMemoryUsage,
+    textureMemoryUsage,
+    pendingResourceCount);
+};
+
+/**
+ * Collects the node counts and resource usage of the given map. This visits every node of
+ * the map, so it should not be called more often than necessary.
+ */
+MapStatistics computeMapStatistics(const Map& map);
+
+} // namespace tb::mdl
@@ -161,9 +161,7 @@ void reloadMaterialCollections(Map& map)
 
 void reloadEntityDefinitions(Map& map)
 {
-  const auto nodes = std::vector<Node*>{&map.worldNode()};
-  const auto notifyNodes =
-    NotifyBeforeAndAfter{map.nodesWillChangeNotifier, map.nodesDidChangeNotifier, nodes};
+  // the map only notifies about the entities whose definitions have changed
   const auto notifyEntityDefinitions = NotifyBeforeAndAfter{
     map.entityDefinitionsWillChangeNotifier, map.entityDefinitionsDidChangeNotifier};
 
@@ -23,12 +23,18 @@
 #include "SimpleParserStatus.h"
 #include "Uuid.h"
 #include "io/BrushFaceReader.h"
+#include "io/ChunkedOutputStream.h"
+#include "io/MapFileSerializer.h"
 #include "io/NodeReader.h"
 #include "io/NodeWriter.h"
+#include "mdl/BezierPatch.h"
+#include "mdl/Brush.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushFaceHandle.h"
 #include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
 #include "mdl/EntityNode.h"
+#include "mdl/EntityProperties.h"
 #include "mdl/GroupNode.h"
 #include "mdl/LayerNode.h"
 #include "mdl/LinkedGroupUtils.h"
@@ -44,11 +50,14 @@
 #include "mdl/WorldNode.h"
 
 #include "kd/contracts.h"
+#include "kd/overload.h"
 #include "kd/ranges/to.h"
 #include "kd/vector_utils.h"
 
 #include <algorithm>
+#include <memory>
 #include <ranges>
+#include <unordered_map>
 
 namespace tb::mdl
 {
@@ -240,6 +249,107 @@ bool pasteNodes(Map& map, const std::vector<Node*>& nodes)
   return true;
 }
 
+// estimated lengths used to pre-size the clipboard buffer
+constexpr auto EstimatedNodeLength = size_t(64);
+
+size_t estimateSerializedLength(const std::vector<Node*>& nodes)
+{
+  auto length = size_t(0);
+  Node::visitAll(
+    nodes,
+    kdl::overload(
+      [&](auto&& thisLambda, const WorldNode* world) {
+        world->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const LayerNode* layer) {
+        length += EstimatedNodeLength;
+        layer->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const GroupNode* group) {
+        length += EstimatedNodeLength;
+        group->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const EntityNode* entityNode) {
+        length += EstimatedNodeLength;
+        for (const auto& property : entityNode->entity().properties())
+        {
+          length += property.key().size() + property.value().size() + 6;
+        }
+        entityNode->visitChildren(thisLambda);
+      },
+      [&](const BrushNode* brushNode) {
+        length += EstimatedNodeLength
+                  + brushNode->brush().faceCount()
+                      * io::MapFileSerializer::EstimatedFaceLength;
+      },
+      [&](const PatchNode* patchNode) {
+        length += EstimatedNodeLength
+                  + patchNode->patch().controlPoints().size()
+                      * io::MapFileSerializer::EstimatedPatchPointLength;
+      }));
+  return length;
+}
+
+/**
+ * Drops the references of the given node and its descendants to materials, entity
+ * definitions and entity models.
+ */
+void releaseAssets(Node& node)
+{
+  node.accept(kdl::overload(
+    [](auto&& thisLambda, WorldNode* worldNode) {
+      worldNode->setDefinition(nullptr);
+      worldNode->visitChildren(thisLambda);
+    },
+    [](auto&& thisLambda, LayerNode* layerNode) { layerNode->visitChildren(thisLambda); },
+    [](auto&& thisLambda, GroupNode* groupNode) { groupNode->visitChildren(thisLambda); },
+    [](auto&& thisLambda, EntityNode* entityNode) {
+      entityNode->setDefinition(nullptr);
+      entityNode->setModel(nullptr);
+      entityNode->visitChildren(thisLambda);
+    },
+    [](BrushNode* brushNode) {
+      for (size_t i = 0u; i < brushNode->brush().faceCount(); ++i)
+      {
+        brushNode->setFaceMaterial(i, nullptr);
+      }
+    },
+    [](PatchNode* patchNode) { patchNode->setMaterial(nullptr); }));
+}
+
+/**
+ * Cloning a group doesn't retain its persistent ID, but pasting must, just like parsing
+ * a pasted group does. Redundant IDs are reset when the nodes are pasted.
+ */
+void copyPersistentGroupIds(const Node& original, Node& clone)
+{
+  const auto* originalGroupNode = dynamic_cast<const GroupNode*>(&original);
+  auto* cloneGroupNode = dynamic_cast<GroupNode*>(&clone);
+  if (originalGroupNode && cloneGroupNode)
+  {
+    if (const auto persistentId = originalGroupNode->persistentId())
+    {
+      cloneGroupNode->setPersistentId(*persistentId);
+    }
+  }
+
+  const auto& originalChildren = original.children();
+  const auto& cloneChildren = clone.children();
+  contract_assert(originalChildren.size() == cloneChildren.size());
+
+  for (size_t i = 0; i < originalChildren.size(); ++i)
+  {
+    copyPersistentGroupIds(*originalChildren[i], *cloneChildren[i]);
+  }
+}
+
+Node* cloneWithPersistentGroupIds(const Node& node, const vm::bbox3d& worldBounds)
+{
+  auto* clone = node.cloneRecursively(worldBounds);
+  copyPersistentGroupIds(node, *clone);
+  return clone;
+}
+
 bool pasteBrushFaces(Map& map, const std::vector<BrushFace>& faces)
 {
   contract_pre(!faces.empty());
@@ -250,31 +360,118 @@ bool pasteBrushFaces(Map& map, const std::vector<BrushFace>& faces)
 
 } // namespace
 
+CopiedNodes::CopiedNodes(
+  std::unique_ptr<WorldNode> worldNode,
+  std::vector<std::unique_ptr<Node>> nodes,
+  std::vector<Node*> selectedNodes)
+  : m_worldNode{std::move(worldNode)}
+  , m_nodes{std::move(nodes)}
+  , m_selectedNodes{std::move(selectedNodes)}
+{
+  contract_pre(m_worldNode != nullptr);
+}
+
+CopiedNodes::~CopiedNodes() = default;
+
+CopiedNodes::CopiedNodes(CopiedNodes&&) noexcept = default;
+
+CopiedNodes& CopiedNodes::operator=(CopiedNodes&&) noexcept = default;
+
+MapFormat CopiedNodes::mapFormat() const
+{
+  return m_worldNode->mapFormat();
+}
+
+std::string CopiedNodes::serialize(kdl::task_manager& taskManager) const
+{
+  auto stream = io::ChunkedOutputStream{estimateSerializedLength(m_selectedNodes)};
+  auto writer = io::NodeWriter{*m_worldNode, stream};
+  writer.writeNodes(m_selectedNodes, taskManager);
+  return std::move(stream).str();
+}
+
+std::vector<Node*> CopiedNodes::clone(const vm::bbox3d& worldBounds) const
+{
+  return m_nodes | std::views::transform([&](const auto& node) {
+           return cloneWithPersistentGroupIds(*node, worldBounds);
+         })
+         | kdl::ranges::to<std::vector>();
+}
+
 std::string serializeSelectedNodes(Map& map)
 {
-  auto stream = std::stringstream{};
+  const auto& nodes = map.selection().nodes;
+
+  auto stream = io::ChunkedOutputStream{estimateSerializedLength(nodes)};
   auto writer = io::NodeWriter{map.worldNode(), stream};
-  writer.writeNodes(map.selection().nodes, map.taskManager());
-  return stream.str();
+  writer.writeNodes(nodes, map.taskManager());
+  return std::move(stream).str();
 }
 
 std::string serializeSelectedBrushFaces(Map& map)
 {
-  auto stream = std::stringstream{};
+  const auto& faceHandles = map.selection().brushFaces;
+
+  auto stream = io::ChunkedOutputStream{
+    faceHandles.size() * io::MapFileSerializer::EstimatedFaceLength};
   auto writer = io::NodeWriter{map.worldNode(), stream};
   writer.writeBrushFaces(
-    map.selection().brushFaces | std::views::transform([](const auto& h) {
-      return h.face();
-    }) | kdl::ranges::to<std::vector>(),
+    faceHandles | std::views::transform([](const auto& h) { return h.face(); })
+      | kdl::ranges::to<std::vector>(),
     map.taskManager());
-  return stream.str();
+  return std::move(stream).str();
+}
+
+CopiedNodes copySelectedNodes(Map& map)
+{
+  const auto& worldNode = map.worldNode();
+  const auto& worldBounds = map.worldBounds();
+
+  auto worldNodeCopy = std::make_unique<WorldNode>(
+    worldNode.entityPropertyConfig(), worldNode.entity(), worldNode.mapFormat());
+  releaseAssets(*worldNodeCopy);
+
+  auto nodes = std::vector<std::unique_ptr<Node>>{};
+  auto selectedNodes = std::vector<Node*>{};
+  auto entityCopies = std::unordered_map<const Node*, Node*>{};
+
+  for (const auto* node : map.selection().nodes)
+  {
+    auto* nodeCopy = cloneWithPersistentGroupIds(*node, worldBounds);
+    selectedNodes.push_back(nodeCopy);
+
+    if (const auto* entityNode = dynamic_cast<const EntityNode*>(node->parent()))
+    {
+      // a brush of a brush entity is copied together with its entity
+      auto [it, inserted] = entityCopies.try_emplace(entityNode, nullptr);
+      if (inserted)
+      {
+        it->second = entityNode->clone(worldBounds);
+        nodes.emplace_back(it->second);
+      }
+      it->second->addChild(nodeCopy);
+    }
+    else
+    {
+      nodes.emplace_back(nodeCopy);
+    }
+  }
+
+  for (const auto& node : nodes)
+  {
+    releaseAssets(*node);
+  }
+
+  return CopiedNodes{
+    std::move(worldNodeCopy), std::move(nodes), std::move(selectedNodes)};
 }
 
 PasteType paste(Map& map, const std::string& str)
 {
   auto parserStatus = SimpleParserStatus{map.logger()};
 
-  // Try parsing as entities, then as brushes, in all compatible formats
+  // Parse as entities or brushes in the detected format, or if detection fails, try
+  // entities, then brushes in all compatible formats. Brush faces are rejected early.
   return io::NodeReader::read(
            str,
            map.worldNode().mapFormat(),
@@ -307,4 +504,17 @@ PasteType paste(Map& map, const std::string& str)
          | kdl::value();
 }
 
+PasteType paste(Map& map, const CopiedNodes& copiedNodes)
+{
+  if (copiedNodes.mapFormat() != map.worldNode().mapFormat())
+  {
+    return paste(map, copiedNodes.serialize(map.taskManager()));
+  }
+
+  const auto nodes = copiedNodes.clone(map.worldBounds());
+  resetLinkIdsOfNonGroupedNodes({{parentForNodes(map), nodes}});
+
+  return pasteNodes(map, nodes) ? PasteType::Node : PasteType::Failed;
+}
+
 } // namespace tb::mdl
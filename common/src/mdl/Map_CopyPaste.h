@@ -19,18 +19,80 @@
 
 #pragma once
 
+#include "vm/bbox.h"
+
+#include <memory>
 #include <string>
+#include <vector>
+
+namespace kdl
+{
+class task_manager;
+}
 
 namespace tb::mdl
 {
 class Map;
+class Node;
+class WorldNode;
 
+enum class MapFormat;
 enum class PasteType;
 
+/**
+ * Deep copies of the nodes that were selected in a map.
+ *
+ * Pasting the copies into a map of the same format clones them directly instead of
+ * parsing their serialized text. The copies don't reference any materials, entity
+ * definitions or entity models, so they remain valid when the map they were copied from
+ * is closed.
+ */
+class CopiedNodes
+{
+private:
+  // an empty copy of the world node that provides the format and the worldspawn
+  // properties for serialization
+  std::unique_ptr<WorldNode> m_worldNode;
+  std::vector<std::unique_ptr<Node>> m_nodes;
+  // the copies of the selected nodes, a copied brush can be a child of a copied entity
+  std::vector<Node*> m_selectedNodes;
+
+public:
+  CopiedNodes(
+    std::unique_ptr<WorldNode> worldNode,
+    std::vector<std::unique_ptr<Node>> nodes,
+    std::vector<Node*> selectedNodes);
+  ~CopiedNodes();
+
+  CopiedNodes(CopiedNodes&&) noexcept;
+  CopiedNodes& operator=(CopiedNodes&&) noexcept;
+
+  MapFormat mapFormat() const;
+
+  /**
+   * Returns the same text that serializeSelectedNodes returned when the nodes were
+   * copied.
+   */
+  std::string serialize(kdl::task_manager& taskManager) const;
+
+  /**
+   * Returns new clones of the copied nodes. The caller takes ownership.
+   */
+  std::vector<Node*> clone(const vm::bbox3d& worldBounds) const;
+};
+
 std::string serializeSelectedNodes(Map& map);
 std::string serializeSelectedBrushFaces(Map& map);
 
+CopiedNodes copySelectedNodes(Map& map);
+
 PasteType paste(Map& map, const std::string& str);
 
+/**
+ * Pastes clones of the given nodes. Falls back to pasting their serialized text if the
+ * given map has a different format than the map they were copied from.
+ */
+PasteType paste(Map& map, const CopiedNodes& copiedNodes);
+
 
 } // namespace tb::mdl
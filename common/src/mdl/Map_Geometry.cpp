@@ -22,6 +22,7 @@
 #include "Logger.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Trace.h"
 #include "mdl/AddRemoveNodesCommand.h"
 #include "mdl/ApplyAndSwap.h"
 #include "mdl/Brush.h"
@@ -499,6 +500,7 @@ bool transformSelection(
       }};
     });
 
+  const auto trace = TraceScope{"transformSelection", commandName};
   const auto success = map.taskManager().run_tasks_and_wait(tasks) | kdl::fold
                        | kdl::transform([&](auto nodesToUpdate) {
                            return updateNodeContents(
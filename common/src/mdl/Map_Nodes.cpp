@@ -112,25 +112,6 @@ bool shouldCloneParentWhenCloningNode(const Node* node)
     [](const PatchNode*) { return false; }));
 }
 
-void resetLinkIdsOfNonGroupedNodes(const std::map<Node*, std::vector<Node*>>& nodes)
-{
-  for (const auto& [parent, children] : nodes)
-  {
-    Node::visitAll(
-      children,
-      kdl::overload(
-        [](const WorldNode*) {},
-        [](const LayerNode*) {},
-        [](const GroupNode*) {},
-        [](auto&& thisLambda, EntityNode* entityNode) {
-          entityNode->setLinkId(generateUuid());
-          entityNode->visitChildren(thisLambda);
-        },
-        [](BrushNode* brushNode) { brushNode->setLinkId(generateUuid()); },
-        [](PatchNode* patchNode) { patchNode->setLinkId(generateUuid()); }));
-  }
-}
-
 bool checkReparenting(const std::map<Node*, std::vector<Node*>>& nodesToAdd)
 {
   for (const auto& [newParent, children] : nodesToAdd)
@@ -26,6 +26,7 @@
 #include "mdl/EntityModelManager.h"
 #include "mdl/GameInfo.h"
 #include "mdl/Map.h"
+#include "mdl/MapFormat.h"
 #include "mdl/Map_Nodes.h"
 #include "mdl/Transaction.h"
 #include "mdl/WorldNode.h"
@@ -149,4 +150,16 @@ std::string defaultMod(const Map& map)
   return map.gameInfo().gameConfig.fileSystemConfig.searchPath.string();
 }
 
+void setValveVersion(Entity& worldEntity, const MapFormat format)
+{
+  if (isParallelUVCoordSystem(format))
+  {
+    worldEntity.addOrUpdateProperty(EntityPropertyKeys::ValveVersion, "220");
+  }
+  else
+  {
+    worldEntity.removeProperty(EntityPropertyKeys::ValveVersion);
+  }
+}
+
 } // namespace tb::mdl
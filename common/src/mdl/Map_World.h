@@ -29,6 +29,7 @@ namespace tb::mdl
 {
 class Entity;
 class Map;
+enum class MapFormat;
 
 SoftMapBounds softMapBounds(const Map& map);
 void setSoftMapBounds(Map& map, const SoftMapBounds& bounds);
@@ -40,4 +41,10 @@ std::vector<std::string> enabledMods(const Map& map);
 void setEnabledMods(Map& map, const std::vector<std::string>& mods);
 std::string defaultMod(const Map& map);
 
+/**
+ * Adds the Valve map version property to the given world entity if the given format uses
+ * parallel UV coordinates, and removes it otherwise.
+ */
+void setValveVersion(Entity& worldEntity, MapFormat format);
+
 } // namespace tb::mdl
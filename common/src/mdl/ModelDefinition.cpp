@@ -19,6 +19,7 @@
 
 #include "ModelDefinition.h"
 
+#include "el/CompiledExpression.h"
 #include "el/EvaluationContext.h"
 #include "el/Exceptions.h"
 #include "el/Expression.h"
@@ -26,6 +27,7 @@
 #include "el/Value.h"
 #include "el/VariableStore.h"
 
+#include "kd/hash_utils.h"
 #include "kd/path_utils.h"
 #include "kd/reflection_impl.h"
 #include "kd/string_compare.h"
@@ -34,6 +36,9 @@
 #include "vm/scalar.h"
 #include "vm/vec_io.h"
 
+#include <mutex>
+#include <unordered_map>
+
 namespace tb::mdl
 {
 namespace
@@ -139,20 +144,72 @@ std::optional<vm::vec3d> convertToScale(
   return scaleValue(context, value);
 }
 
+struct ModelSpecificationCacheKey
+{
+  el::CompiledExpression::Slots variableValues;
+  size_t hash;
+
+  friend bool operator==(
+    const ModelSpecificationCacheKey& lhs, const ModelSpecificationCacheKey& rhs)
+  {
+    return lhs.hash == rhs.hash && lhs.variableValues == rhs.variableValues;
+  }
+};
+
+struct ModelSpecificationCacheKeyHash
+{
+  size_t operator()(const ModelSpecificationCacheKey& key) const { return key.hash; }
+};
+
+ModelSpecificationCacheKey makeModelSpecificationCacheKey(
+  el::EvaluationContext& context, el::CompiledExpression::Slots variableValues)
+{
+  auto hash = size_t(0);
+  for (const auto& value : variableValues)
+  {
+    // std::hash<el::Value> hashes the identity of a value, not its contents
+    const auto valueHash = value.type() == el::ValueType::String
+                             ? kdl::hash(value.stringValue(context))
+                             : kdl::hash(value.asString());
+    hash = kdl::combine_hash(hash, valueHash);
+  }
+  return {std::move(variableValues), hash};
+}
+
+// Evaluating the model expression for many distinct variable values may grow the cache
+// without bound, so it is cleared once it reaches this size.
+constexpr auto MaxModelSpecificationCacheSize = size_t(4096);
+
 } // namespace
 
+struct ModelDefinition::ModelSpecificationCache
+{
+  std::mutex mutex;
+  std::unordered_map<
+    ModelSpecificationCacheKey,
+    ModelSpecification,
+    ModelSpecificationCacheKeyHash>
+    entries;
+};
+
 ModelDefinition::ModelDefinition()
   : m_expression{el::LiteralExpression{el::Value::Undefined}}
+  , m_compiledExpression{m_expression.compile()}
+  , m_modelSpecificationCache{std::make_shared<ModelSpecificationCache>()}
 {
 }
 
 ModelDefinition::ModelDefinition(const FileLocation& location)
   : m_expression{el::LiteralExpression{el::Value::Undefined}, location}
+  , m_compiledExpression{m_expression.compile()}
+  , m_modelSpecificationCache{std::make_shared<ModelSpecificationCache>()}
 {
 }
 
 ModelDefinition::ModelDefinition(el::ExpressionNode expression)
   : m_expression{std::move(expression)}
+  , m_compiledExpression{m_expression.compile()}
+  , m_modelSpecificationCache{std::make_shared<ModelSpecificationCache>()}
 {
 }
 
@@ -162,6 +219,8 @@ void ModelDefinition::append(ModelDefinition other)
 
   auto cases = std::vector{std::move(m_expression), std::move(other.m_expression)};
   m_expression = el::ExpressionNode{el::SwitchExpression{std::move(cases)}, location};
+  m_compiledExpression = m_expression.compile();
+  m_modelSpecificationCache = std::make_shared<ModelSpecificationCache>();
 }
 
 Result<ModelSpecification> ModelDefinition::modelSpecification(
@@ -169,7 +228,28 @@ Result<ModelSpecification> ModelDefinition::modelSpecification(
 {
   return el::withEvaluationContext(
     [&](auto& context) {
-      return convertToModel(context, m_expression.evaluate(context));
+      auto key = makeModelSpecificationCacheKey(
+        context, m_compiledExpression.variableValues(context));
+
+      auto& cache = *m_modelSpecificationCache;
+      {
+        const auto lock = std::lock_guard{cache.mutex};
+        if (const auto it = cache.entries.find(key); it != cache.entries.end())
+        {
+          return it->second;
+        }
+      }
+
+      auto modelSpecification = convertToModel(
+        context, m_compiledExpression.evaluate(context, key.variableValues));
+
+      const auto lock = std::lock_guard{cache.mutex};
+      if (cache.entries.size() >= MaxModelSpecificationCacheSize)
+      {
+        cache.entries.clear();
+      }
+      cache.entries.emplace(std::move(key), modelSpecification);
+      return modelSpecification;
     },
     variableStore);
 }
@@ -187,7 +267,7 @@ Result<vm::vec3d> ModelDefinition::scale(
 {
   return el::withEvaluationContext(
     [&](auto& context) {
-      const auto value = m_expression.evaluate(context);
+      const auto value = m_compiledExpression.evaluate(context);
 
       switch (value.type())
       {
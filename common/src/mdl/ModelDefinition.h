@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Result.h"
+#include "el/CompiledExpression.h"
 #include "el/Expression.h"
 #include "mdl/ModelSpecification.h"
 
@@ -27,6 +28,7 @@
 
 #include "vm/vec.h"
 
+#include <memory>
 #include <optional>
 
 namespace tb
@@ -47,7 +49,17 @@ constexpr auto Scale = "scale";
 class ModelDefinition
 {
 private:
+  struct ModelSpecificationCache;
+
   el::ExpressionNode m_expression;
+  el::CompiledExpression m_compiledExpression;
+
+  /**
+   * Caches model specifications by the values of the variables the model expression
+   * refers to. Entities that agree on these values share the same model specification,
+   * so it is evaluated only once per distinct combination.
+   */
+  std::shared_ptr<ModelSpecificationCache> m_modelSpecificationCache;
 
 public:
   ModelDefinition();
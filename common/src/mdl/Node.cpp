@@ -824,6 +824,11 @@ std::vector<const Issue*> Node::issues(const std::vector<const Validator*>& vali
          | kdl::ranges::to<std::vector>();
 }
 
+IssueType Node::hiddenIssues() const
+{
+  return m_hiddenIssues;
+}
+
 bool Node::issueHidden(const IssueType type) const
 {
   return (type & m_hiddenIssues) != 0;
@@ -853,10 +858,23 @@ void Node::validateIssues(const std::vector<const Validator*>& validators)
   }
 }
 
-void Node::invalidateIssues() const
+void Node::invalidateIssues()
+{
+  if (m_issuesValid)
+  {
+    m_issues.clear();
+    m_issuesValid = false;
+    issuesWereInvalidated(this);
+  }
+}
+
+void Node::issuesWereInvalidated(Node* node)
 {
-  m_issues.clear();
-  m_issuesValid = false;
+  doIssuesWereInvalidated(node);
+  if (m_parent)
+  {
+    m_parent->issuesWereInvalidated(node);
+  }
 }
 
 const EntityPropertyConfig& Node::entityPropertyConfig() const
@@ -901,6 +919,8 @@ void Node::doChildDidChange(Node* /* node */) {}
 void Node::doDescendantWillChange(Node* /* node */) {}
 void Node::doDescendantDidChange(Node* /* node */) {}
 
+void Node::doIssuesWereInvalidated(Node* /* node */) {}
+
 const EntityPropertyConfig& Node::doGetEntityPropertyConfig() const
 {
   if (m_parent)
@@ -351,14 +351,23 @@ public: // file position
 public: // issue management
   std::vector<const Issue*> issues(const std::vector<const Validator*>& validators);
 
+  /**
+   * Returns the types of the issues of this node that are hidden as a bit mask.
+   */
+  IssueType hiddenIssues() const;
   bool issueHidden(IssueType type) const;
   void setIssueHidden(IssueType type, bool hidden);
 
 public: // should only be called from this and from the world
-  void invalidateIssues() const;
+  /**
+   * Discards the issues of this node. If they had been validated, this node and its
+   * ancestors are notified so that observers of the issues can update.
+   */
+  void invalidateIssues();
 
 private:
   void validateIssues(const std::vector<const Validator*>& validators);
+  void issuesWereInvalidated(Node* node);
 
 public: // visitors
   /**
@@ -528,6 +537,8 @@ private: // subclassing interface
   virtual void doDescendantWillChange(Node* node);
   virtual void doDescendantDidChange(Node* node);
 
+  virtual void doIssuesWereInvalidated(Node* node);
+
   virtual bool doSelectable() const = 0;
 
   virtual void doPick(
@@ -0,0 +1,200 @@
+/*
+ Copyright (C) 2026 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeChangeCollector.h"
+
+#include "mdl/BrushNode.h"
+#include "mdl/NodeChanges.h"
+#include "mdl/NodeQueries.h"
+#include "mdl/SelectionChange.h"
+
+#include "kd/vector_utils.h"
+
+#include <utility>
+
+namespace tb::mdl
+{
+
+bool NodeChangeCollector::NodeSet::insert(Node* node)
+{
+  if (members.insert(node).second)
+  {
+    nodes.push_back(node);
+    return true;
+  }
+  return false;
+}
+
+bool NodeChangeCollector::NodeSet::erase(Node* node)
+{
+  return members.erase(node) > 0;
+}
+
+bool NodeChangeCollector::NodeSet::contains(Node* node) const
+{
+  return members.contains(node);
+}
+
+bool NodeChangeCollector::NodeSet::empty() const
+{
+  return members.empty();
+}
+
+std::vector<Node*> NodeChangeCollector::NodeSet::release()
+{
+  auto result = std::vector<Node*>{};
+  result.reserve(members.size());
+
+  // a node that was erased and inserted again occurs more than once in nodes, but we only
+  // want to report it once
+  for (auto* node : nodes)
+  {
+    if (members.erase(node) > 0)
+    {
+      result.push_back(node);
+    }
+  }
+
+  nodes.clear();
+  return result;
+}
+
+bool NodeChangeCollector::empty() const
+{
+  return m_addedNodes.empty() && m_removedNodes.empty() && m_changedNodes.empty()
+         && m_visibilityChangedNodes.empty() && m_lockingChangedNodes.empty()
+         && m_selectedNodes.empty() && m_deselectedNodes.empty()
+         && m_selectedBrushFaces.empty() && m_deselectedBrushFaces.empty();
+}
+
+void NodeChangeCollector::nodesWereAdded(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    // a node that was removed and added again is reported as added
+    m_removedNodes.erase(node);
+    m_addedNodes.insert(node);
+  }
+}
+
+void NodeChangeCollector::nodesWereRemoved(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    // observers never learned about nodes that were added in this batch
+    if (!m_addedNodes.erase(node))
+    {
+      m_removedNodes.insert(node);
+    }
+  }
+
+  // The removed nodes and their descendants may be deleted before the changes are
+  // released, so we must forget about all pending changes concerning them.
+  const auto removedNodes = collectNodesAndDescendants(nodes);
+  for (auto* node : removedNodes)
+  {
+    m_addedNodes.erase(node);
+    m_changedNodes.erase(node);
+    m_visibilityChangedNodes.erase(node);
+    m_lockingChangedNodes.erase(node);
+    m_selectedNodes.erase(node);
+    m_deselectedNodes.erase(node);
+  }
+
+  if (!m_selectedBrushFaces.empty() || !m_deselectedBrushFaces.empty())
+  {
+    const auto removedNodeSet =
+      std::unordered_set<Node*>{removedNodes.begin(), removedNodes.end()};
+    const auto isRemoved = [&](const auto& handle) {
+      return removedNodeSet.contains(handle.node());
+    };
+    std::erase_if(m_selectedBrushFaces, isRemoved);
+    std::erase_if(m_deselectedBrushFaces, isRemoved);
+  }
+}
+
+void NodeChangeCollector::nodesDidChange(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    // added nodes will be reported in their final state anyway
+    if (!m_addedNodes.contains(node))
+    {
+      m_changedNodes.insert(node);
+    }
+  }
+}
+
+void NodeChangeCollector::nodeVisibilityDidChange(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    m_visibilityChangedNodes.insert(node);
+  }
+}
+
+void NodeChangeCollector::nodeLockingDidChange(const std::vector<Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    m_lockingChangedNodes.insert(node);
+  }
+}
+
+void NodeChangeCollector::selectionDidChange(const SelectionChange& selectionChange)
+{
+  for (auto* node : selectionChange.selectedNodes)
+  {
+    m_selectedNodes.insert(node);
+  }
+  for (auto* node : selectionChange.deselectedNodes)
+  {
+    m_deselectedNodes.insert(node);
+  }
+  m_selectedBrushFaces.insert(
+    m_selectedBrushFaces.end(),
+    selectionChange.selectedBrushFaces.begin(),
+    selectionChange.selectedBrushFaces.end());
+  m_deselectedBrushFaces.insert(
+    m_deselectedBrushFaces.end(),
+    selectionChange.deselectedBrushFaces.begin(),
+    selectionChange.deselectedBrushFaces.end());
+}
+
+NodeChanges NodeChangeCollector::release()
+{
+  return NodeChanges{
+    .addedNodes = m_addedNodes.release(),
+    .removedNodes = m_removedNodes.release(),
+    .changedNodes = m_changedNodes.release(),
+    .visibilityChangedNodes = m_visibilityChangedNodes.release(),
+    .lockingChangedNodes = m_lockingChangedNodes.release(),
+    .selectionChange =
+      SelectionChange{
+        .selectedNodes = m_selectedNodes.release(),
+        .deselectedNodes = m_deselectedNodes.release(),
+        .selectedBrushFaces =
+          kdl::vec_sort_and_remove_duplicates(std::exchange(m_selectedBrushFaces, {})),
+        .deselectedBrushFaces =
+          kdl::vec_sort_and_remove_duplicates(std::exchange(m_deselectedBrushFaces, {})),
+      },
+  };
+}
+
+} // namespace tb::mdl
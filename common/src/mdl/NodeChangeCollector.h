@@ -0,0 +1,86 @@
+/*
+ Copyright (C) 2026 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/BrushFaceHandle.h"
+
+#include <unordered_set>
+#include <vector>
+
+namespace tb::mdl
+{
+class Node;
+struct NodeChanges;
+struct SelectionChange;
+
+/**
+ * Accumulates node notifications into a deduplicated set of changes.
+ *
+ * Nodes that are added and then removed again cancel each other out. Nodes that are
+ * removed and then added again are reported as added. Removing a node also discards all
+ * pending changes to that node and its descendants, so the collector never hands out
+ * nodes that were deleted while changes were being collected.
+ */
+class NodeChangeCollector
+{
+private:
+  /**
+   * An insertion ordered set of nodes. Erased nodes are only removed from the member set
+   * and are skipped when the nodes are released.
+   */
+  struct NodeSet
+  {
+    std::vector<Node*> nodes;
+    std::unordered_set<Node*> members;
+
+    bool insert(Node* node);
+    bool erase(Node* node);
+    bool contains(Node* node) const;
+    bool empty() const;
+    std::vector<Node*> release();
+  };
+
+  NodeSet m_addedNodes;
+  NodeSet m_removedNodes;
+  NodeSet m_changedNodes;
+  NodeSet m_visibilityChangedNodes;
+  NodeSet m_lockingChangedNodes;
+  NodeSet m_selectedNodes;
+  NodeSet m_deselectedNodes;
+  std::vector<BrushFaceHandle> m_selectedBrushFaces;
+  std::vector<BrushFaceHandle> m_deselectedBrushFaces;
+
+public:
+  bool empty() const;
+
+  void nodesWereAdded(const std::vector<Node*>& nodes);
+  void nodesWereRemoved(const std::vector<Node*>& nodes);
+  void nodesDidChange(const std::vector<Node*>& nodes);
+  void nodeVisibilityDidChange(const std::vector<Node*>& nodes);
+  void nodeLockingDidChange(const std::vector<Node*>& nodes);
+  void selectionDidChange(const SelectionChange& selectionChange);
+
+  /**
+   * Returns the collected changes and resets this collector.
+   */
+  NodeChanges release();
+};
+
+} // namespace tb::mdl
@@ -0,0 +1,39 @@
+/*
+ Copyright (C) 2026 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeChanges.h"
+
+#include "kd/reflection_impl.h"
+
+namespace tb::mdl
+{
+
+bool NodeChanges::empty() const
+{
+  return addedNodes.empty() && removedNodes.empty() && changedNodes.empty()
+         && visibilityChangedNodes.empty() && lockingChangedNodes.empty()
+         && selectionChange.selectedNodes.empty()
+         && selectionChange.deselectedNodes.empty()
+         && selectionChange.selectedBrushFaces.empty()
+         && selectionChange.deselectedBrushFaces.empty();
+}
+
+kdl_reflect_impl(NodeChanges);
+
+} // namespace tb::mdl
@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2026 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/SelectionChange.h"
+
+#include "kd/reflection_decl.h"
+
+#include <vector>
+
+namespace tb::mdl
+{
+class Node;
+
+/**
+ * The accumulated effect of all node notifications that were sent while a batch of
+ * commands was executing.
+ *
+ * Added nodes were not known to observers before, removed nodes were known to observers
+ * and are no longer part of the map. Changed nodes and nodes whose visibility, locking or
+ * selection state changed are part of the map both before and after the batch. A node is
+ * contained in at most one of the added, removed and changed collections.
+ */
+struct NodeChanges
+{
+  std::vector<Node*> addedNodes;
+  std::vector<Node*> removedNodes;
+  std::vector<Node*> changedNodes;
+  std::vector<Node*> visibilityChangedNodes;
+  std::vector<Node*> lockingChangedNodes;
+  SelectionChange selectionChange;
+
+  bool empty() const;
+
+  kdl_reflect_decl(
+    NodeChanges,
+    addedNodes,
+    removedNodes,
+    changedNodes,
+    visibilityChangedNodes,
+    lockingChangedNodes,
+    selectionChange);
+};
+
+} // namespace tb::mdl
@@ -20,11 +20,53 @@
 #include "NodeContents.h"
 
 #include "mdl/BrushFace.h"
+#include "mdl/BrushGeometry.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
 
 #include "kd/overload.h"
 
+#include <numeric>
+
 namespace tb::mdl
 {
+namespace
+{
+
+size_t memoryUsage(const Entity& entity)
+{
+  const auto& properties = entity.properties();
+  return std::accumulate(
+    properties.begin(),
+    properties.end(),
+    sizeof(Entity),
+    [](const auto total, const auto& property) {
+      return total + sizeof(EntityProperty) + property.key().capacity()
+             + property.value().capacity();
+    });
+}
+
+size_t memoryUsage(const Brush& brush)
+{
+  // every edge of the geometry consists of two half edges
+  return sizeof(Brush)
+         + brush.faceCount() * (sizeof(BrushFace) + sizeof(BrushFaceGeometry))
+         + brush.vertexCount() * sizeof(BrushVertex)
+         + brush.edgeCount() * (sizeof(BrushEdge) + 2 * sizeof(BrushHalfEdge));
+}
+
+size_t memoryUsage(const BezierPatch& patch)
+{
+  return sizeof(BezierPatch)
+         + patch.controlPoints().size() * sizeof(BezierPatch::Point);
+}
+
+} // namespace
 
 NodeContents::NodeContents(
   std::variant<Layer, Group, Entity, Brush, BezierPatch> contents)
@@ -55,4 +97,39 @@ std::variant<Layer, Group, Entity, Brush, BezierPatch>& NodeContents::get()
   return m_contents;
 }
 
+size_t memoryUsage(const NodeContents& nodeContents)
+{
+  return std::visit(
+    kdl::overload(
+      [](const Layer&) { return sizeof(Layer); },
+      [](const Group&) { return sizeof(Group); },
+      [](const auto& object) { return memoryUsage(object); }),
+    nodeContents.get());
+}
+
+size_t memoryUsage(const Node& node)
+{
+  auto result = size_t(0);
+  node.accept(kdl::overload(
+    [&](auto&& thisLambda, const WorldNode* worldNode) {
+      result += memoryUsage(worldNode->entity());
+      worldNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const LayerNode* layerNode) {
+      result += sizeof(Layer);
+      layerNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const GroupNode* groupNode) {
+      result += sizeof(Group);
+      groupNode->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const EntityNode* entityNode) {
+      result += memoryUsage(entityNode->entity());
+      entityNode->visitChildren(thisLambda);
+    },
+    [&](const BrushNode* brushNode) { result += memoryUsage(brushNode->brush()); },
+    [&](const PatchNode* patchNode) { result += memoryUsage(patchNode->patch()); }));
+  return result;
+}
+
 } // namespace tb::mdl
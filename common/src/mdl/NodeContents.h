@@ -29,6 +29,7 @@
 
 namespace tb::mdl
 {
+class Node;
 
 class NodeContents
 {
@@ -46,4 +47,15 @@ public:
   std::variant<Layer, Group, Entity, Brush, BezierPatch>& get();
 };
 
+/**
+ * Returns an estimate of the number of bytes of memory used by the given node contents.
+ */
+size_t memoryUsage(const NodeContents& nodeContents);
+
+/**
+ * Returns an estimate of the number of bytes of memory used by the contents of the given
+ * node and its descendants.
+ */
+size_t memoryUsage(const Node& node);
+
 } // namespace tb::mdl
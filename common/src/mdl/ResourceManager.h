@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Trace.h"
 #include "mdl/Resource.h"
 
 #include "kd/ranges/to.h"
@@ -26,6 +27,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <format>
 #include <memory>
 #include <ranges>
 #include <vector>
@@ -95,6 +97,13 @@ public:
     });
   }
 
+  size_t pendingResourceCount() const
+  {
+    return size_t(std::ranges::count_if(m_resources, [](const auto& resourceWrapper) {
+      return resourceWrapper->needsProcessing();
+    }));
+  }
+
   std::vector<const ResourceWrapperBase*> resources() const
   {
     return m_resources | std::views::transform([](const auto& resourceWrapper) {
@@ -115,6 +124,9 @@ public:
     const ProcessContext& processContext,
     std::optional<std::chrono::milliseconds> timeout = std::nullopt)
   {
+    const auto trace = TraceScope{
+      "ResourceManager::process", std::format("{} resources", m_resources.size())};
+
     const auto checkTimeout =
       timeout ? std::function{[timeout_ = *timeout,
                                startTime = std::chrono::steady_clock::now()]() {
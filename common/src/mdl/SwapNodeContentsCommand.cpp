@@ -29,6 +29,7 @@
 
 #include "kd/ranges/to.h"
 
+#include <numeric>
 #include <ranges>
 
 namespace tb::mdl
@@ -164,4 +165,15 @@ bool SwapNodeContentsCommand::doCollateWith(UndoableCommand& command)
   return false;
 }
 
+size_t SwapNodeContentsCommand::memoryUsage() const
+{
+  return std::accumulate(
+    m_nodes.begin(),
+    m_nodes.end(),
+    UpdateLinkedGroupsCommandBase::memoryUsage(),
+    [](const auto total, const auto& pair) {
+      return total + mdl::memoryUsage(pair.second);
+    });
+}
+
 } // namespace tb::mdl
@@ -28,6 +28,8 @@
 
 #include "vm/vec_io.h" // IWYU pragma: keep
 
+#include <numeric>
+
 namespace tb::mdl
 {
 
@@ -140,6 +142,27 @@ auto uploadTexture(
   return textureId;
 }
 
+size_t uploadSize(const TextureMask mask, const std::vector<TextureBuffer>& buffers)
+{
+  if (buffers.empty())
+  {
+    return 0;
+  }
+
+  if (mask == TextureMask::On)
+  {
+    return buffers.front().size();
+  }
+
+  const auto size = std::accumulate(
+    buffers.begin(), buffers.end(), size_t(0), [](const auto total, const auto& buffer) {
+      return total + buffer.size();
+    });
+
+  // mipmaps generated by the driver add about a third of the size of the first level
+  return buffers.size() == 1 ? size + size / 3 : size;
+}
+
 void dropTexture(GLuint textureId)
 {
   glAssert(glDeleteTextures(1, &textureId));
@@ -273,6 +296,12 @@ bool Texture::isReady() const
   return std::holds_alternative<TextureReadyState>(m_state);
 }
 
+size_t Texture::uploadedSize() const
+{
+  const auto* readyState = std::get_if<TextureReadyState>(&m_state);
+  return readyState ? readyState->size : 0;
+}
+
 bool Texture::activate(const int minFilter, const int magFilter) const
 {
   return std::visit(
@@ -303,12 +332,15 @@ void Texture::upload(const bool glContextAvailable)
   m_state = std::visit(
     kdl::overload(
       [&](const TextureLoadedState& textureLoadedState) -> TextureState {
-        const auto textureId =
-          glContextAvailable
-            ? uploadTexture(
-                m_format, m_mask, textureLoadedState.buffers, m_width, m_height)
-            : 0;
-        return TextureReadyState{textureId};
+        if (!glContextAvailable)
+        {
+          return TextureReadyState{0, 0};
+        }
+
+        const auto& buffers = textureLoadedState.buffers;
+        return TextureReadyState{
+          uploadTexture(m_format, m_mask, buffers, m_width, m_height),
+          uploadSize(m_mask, buffers)};
       },
       [](TextureReadyState textureReadyState) -> TextureState {
         return textureReadyState;
@@ -70,8 +70,10 @@ struct TextureLoadedState
 struct TextureReadyState
 {
   GLuint textureId;
+  // the number of bytes uploaded to video memory
+  size_t size;
 
-  kdl_reflect_decl(TextureReadyState, textureId);
+  kdl_reflect_decl(TextureReadyState, textureId, size);
 };
 
 struct TextureDroppedState
@@ -149,6 +151,12 @@ public:
 
   bool isReady() const;
 
+  /**
+   * Returns the number of bytes that this texture occupies in video memory, or 0 if it
+   * has not been uploaded.
+   */
+  size_t uploadedSize() const;
+
   bool activate(int minFilter, int magFilter) const;
   bool deactivate() const;
 
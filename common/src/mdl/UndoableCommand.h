@@ -43,6 +43,12 @@ public:
 
   virtual bool collateWith(UndoableCommand& command);
 
+  /**
+   * Returns an estimate of the number of bytes of memory that this command holds to undo
+   * or redo its changes.
+   */
+  virtual size_t memoryUsage() const;
+
 protected:
   virtual bool doPerformUndo(Map& map) = 0;
 
@@ -48,6 +48,8 @@ public:
 
   bool collateWith(UndoableCommand& command) override;
 
+  size_t memoryUsage() const override;
+
 private:
   deleteCopyAndMove(UpdateLinkedGroupsCommandBase);
 };
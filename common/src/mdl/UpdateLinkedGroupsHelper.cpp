@@ -23,6 +23,7 @@
 #include "mdl/LinkedGroupUtils.h"
 #include "mdl/Map.h"
 #include "mdl/ModelUtils.h"
+#include "mdl/NodeContents.h"
 
 #include "kd/overload.h"
 #include "kd/ranges/as_rvalue_view.h"
@@ -194,6 +195,25 @@ Result<UpdateLinkedGroupsHelper::LinkedGroupUpdates> UpdateLinkedGroupsHelper::
            });
 }
 
+size_t UpdateLinkedGroupsHelper::memoryUsage() const
+{
+  return std::visit(
+    kdl::overload(
+      [](const ChangedLinkedGroups&) { return size_t(0); },
+      [](const LinkedGroupUpdates& linkedGroupUpdates) {
+        auto result = size_t(0);
+        for (const auto& [groupNode, children] : linkedGroupUpdates)
+        {
+          for (const auto& child : children)
+          {
+            result += mdl::memoryUsage(*child);
+          }
+        }
+        return result;
+      }),
+    m_state);
+}
+
 void UpdateLinkedGroupsHelper::doApplyOrUndoLinkedGroupUpdates(Map& map)
 {
   std::visit(
@@ -66,6 +66,12 @@ public:
   void undoLinkedGroupUpdates(Map& map);
   void collateWith(UpdateLinkedGroupsHelper& other);
 
+  /**
+   * Returns an estimate of the number of bytes of memory used by the replaced linked
+   * group children that this helper holds.
+   */
+  size_t memoryUsage() const;
+
 private:
   Result<void> computeLinkedGroupUpdates(Map& map);
   static Result<LinkedGroupUpdates> computeLinkedGroupUpdates(
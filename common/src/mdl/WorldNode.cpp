@@ -241,6 +241,14 @@ void WorldNode::rebuildNodeTree()
   }
 }
 
+std::vector<Node*> WorldNode::takeNodesWithInvalidatedIssues()
+{
+  auto result = std::vector<Node*>{
+    m_nodesWithInvalidatedIssues.begin(), m_nodesWithInvalidatedIssues.end()};
+  m_nodesWithInvalidatedIssues.clear();
+  return result;
+}
+
 void WorldNode::invalidateAllIssues()
 {
   accept([](auto&& thisLambda, Node* node) {
@@ -402,6 +410,20 @@ void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */)
   }
 }
 
+void WorldNode::doDescendantWasRemoved(
+  Node* /* oldParent */, Node* node, const size_t /* depth */)
+{
+  // The issues of the removed nodes were invalidated when they were detached, but they
+  // are no longer part of this world.
+  if (!m_nodesWithInvalidatedIssues.empty())
+  {
+    node->accept([&](auto&& thisLambda, Node* descendant) {
+      m_nodesWithInvalidatedIssues.erase(descendant);
+      descendant->visitChildren(thisLambda);
+    });
+  }
+}
+
 void WorldNode::doDescendantPhysicalBoundsDidChange(Node* node)
 {
   if (m_updateNodeTree)
@@ -416,6 +438,11 @@ void WorldNode::doDescendantPhysicalBoundsDidChange(Node* node)
   }
 }
 
+void WorldNode::doIssuesWereInvalidated(Node* node)
+{
+  m_nodesWithInvalidatedIssues.insert(node);
+}
+
 bool WorldNode::doSelectable() const
 {
   return false;
@@ -28,6 +28,7 @@
 #include "octree.h"
 
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 namespace tb::mdl
@@ -52,6 +53,8 @@ private:
 
   IdType m_nextPersistentId = 1;
 
+  std::unordered_set<Node*> m_nodesWithInvalidatedIssues;
+
 public:
   WorldNode(
     EntityPropertyConfig entityPropertyConfig, Entity entity, MapFormat mapFormat);
@@ -129,6 +132,14 @@ public: // node tree bulk updating
   void enableNodeTreeUpdates();
   void rebuildNodeTree();
 
+public: // issue tracking
+  /**
+   * Returns the nodes of this world whose validated issues were invalidated since this
+   * function was last called. Nodes that were removed from this world in the meantime
+   * are omitted.
+   */
+  std::vector<Node*> takeNodesWithInvalidatedIssues();
+
 private:
   void invalidateAllIssues();
 
@@ -145,7 +156,9 @@ private: // implement Node interface
 
   void doDescendantWasAdded(Node* node, size_t depth) override;
   void doDescendantWillBeRemoved(Node* node, size_t depth) override;
+  void doDescendantWasRemoved(Node* oldParent, Node* node, size_t depth) override;
   void doDescendantPhysicalBoundsDidChange(Node* node) override;
+  void doIssuesWereInvalidated(Node* node) override;
 
   bool doSelectable() const override;
   void doPick(
@@ -19,6 +19,7 @@
 
 #include "BrushRenderer.h"
 
+#include "Trace.h"
 #include "mdl/Brush.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
@@ -33,6 +34,7 @@
 #include "kd/contracts.h"
 
 #include <cstring>
+#include <format>
 #include <vector>
 
 namespace tb::render
@@ -395,6 +397,9 @@ void BrushRenderer::validate(const LightPreview* lightPreview)
 {
   contract_pre(!valid());
 
+  const auto trace = TraceScope{
+    "BrushRenderer::validate", std::format("{} brushes", m_invalidBrushes.size())};
+
   for (auto* brushNode : m_invalidBrushes)
   {
     validateBrush(*brushNode, lightPreview);
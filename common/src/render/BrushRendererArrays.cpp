@@ -100,6 +100,7 @@ void IndexHolder::render(const PrimType primType, const size_t offset, size_t co
   const auto* renderOffset =
     reinterpret_cast<GLvoid*>(m_vbo->offset() + sizeof(Index) * offset);
 
+  glCountDrawCall();
   glAssert(glDrawElements(toGL(primType), renderCount, glType<Index>(), renderOffset));
 }
 
@@ -29,7 +29,9 @@
 
 #include "kd/contracts.h"
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace tb::render
@@ -337,6 +339,55 @@ public:
   }
 };
 
+/**
+ * A vertex buffer in which blocks of vertices can be allocated and freed individually.
+ * The buffer grows as needed. Freed blocks are not cleared, so only the vertices of
+ * allocated blocks must be rendered.
+ */
+template <typename V>
+class VertexBlockArray
+{
+private:
+  VertexHolder<V> m_vertexHolder;
+  AllocationTracker m_allocationTracker;
+
+public:
+  /**
+   * Allocates a block of the given number of vertices.
+   *
+   * Returns the block, which must be passed to free() later, and a pointer where the
+   * caller should write `vertexCount` vertices.
+   */
+  std::pair<AllocationTracker::Block*, V*> allocate(const size_t vertexCount)
+  {
+    auto* block = m_allocationTracker.allocate(vertexCount);
+    if (block == nullptr)
+    {
+      const auto newSize = std::max(
+        2 * m_allocationTracker.capacity(), m_allocationTracker.capacity() + vertexCount);
+      m_allocationTracker.expand(newSize);
+      m_vertexHolder.resize(newSize);
+
+      block = m_allocationTracker.allocate(vertexCount);
+      contract_assert(block != nullptr);
+    }
+
+    auto* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
+    return {block, dest};
+  }
+
+  void free(AllocationTracker::Block* block) { m_allocationTracker.free(block); }
+
+  bool empty() const { return !m_allocationTracker.hasAllocations(); }
+  size_t capacity() const { return m_allocationTracker.capacity(); }
+
+  bool setupVertices() { return m_vertexHolder.setupVertices(); }
+  void cleanupVertices() { m_vertexHolder.cleanupVertices(); }
+
+  bool prepared() const { return m_vertexHolder.prepared(); }
+  void prepare(VboManager& vboManager) { m_vertexHolder.prepare(vboManager); }
+};
+
 /**
  * Same as BrushIndexArray but for vertices instead of indices.
  * The only difference is deleteVerticesWithKey() doesn't need to zero out
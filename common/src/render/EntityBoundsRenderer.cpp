@@ -0,0 +1,364 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityBoundsRenderer.h"
+
+#include "render/ActiveShader.h"
+#include "render/Camera.h"
+#include "render/GL.h"
+#include "render/PrimType.h"
+#include "render/RenderBatch.h"
+#include "render/RenderContext.h"
+#include "render/Shaders.h"
+
+#include "kd/contracts.h"
+
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace tb::render
+{
+namespace
+{
+
+const auto UnitBounds = vm::bbox3f{vm::vec3f{0, 0, 0}, vm::vec3f{1, 1, 1}};
+
+constexpr auto EdgeVerticesPerSlot = size_t(8);
+constexpr auto FaceVerticesPerSlot = size_t(24);
+
+struct Corner
+{
+  vm::vec3f selector;
+  vm::vec3f normal;
+};
+
+// the index of the given corner of the unit box among its eight corners
+GLuint cornerIndex(const vm::vec3f& selector)
+{
+  return GLuint(selector.x()) | (GLuint(selector.y()) << 1) | (GLuint(selector.z()) << 2);
+}
+
+std::vector<Corner> makeEdgeCorners()
+{
+  auto corners = std::vector<Corner>{};
+  corners.reserve(EdgeVerticesPerSlot);
+  for (GLuint i = 0; i < EdgeVerticesPerSlot; ++i)
+  {
+    const auto selector =
+      vm::vec3f{float(i & 1), float((i >> 1) & 1), float((i >> 2) & 1)};
+    corners.push_back({selector, vm::vec3f{0, 0, 0}});
+  }
+  return corners;
+}
+
+std::vector<Corner> makeFaceCorners()
+{
+  auto corners = std::vector<Corner>{};
+  corners.reserve(FaceVerticesPerSlot);
+  UnitBounds.for_each_face([&](
+                             const auto& v1,
+                             const auto& v2,
+                             const auto& v3,
+                             const auto& v4,
+                             const auto& n) {
+    corners.push_back({v1, n});
+    corners.push_back({v2, n});
+    corners.push_back({v3, n});
+    corners.push_back({v4, n});
+  });
+  return corners;
+}
+
+using Indices = std::array<GLuint, EntityBoundsArray::IndicesPerSlot>;
+
+Indices makeEdgeIndices()
+{
+  auto indices = Indices{};
+  auto i = size_t(0);
+  UnitBounds.for_each_edge([&](const auto& v1, const auto& v2) {
+    indices[i++] = cornerIndex(v1);
+    indices[i++] = cornerIndex(v2);
+  });
+  return indices;
+}
+
+Indices makeFaceIndices()
+{
+  auto indices = Indices{};
+  for (GLuint i = 0; i < indices.size(); ++i)
+  {
+    indices[i] = i;
+  }
+  return indices;
+}
+
+const std::vector<Corner>& corners(const EntityBoundsShape shape)
+{
+  static const auto edgeCorners = makeEdgeCorners();
+  static const auto faceCorners = makeFaceCorners();
+  return shape == EntityBoundsShape::Edges ? edgeCorners : faceCorners;
+}
+
+// the indices of the vertices of the first slot
+const Indices& indices(const EntityBoundsShape shape)
+{
+  static const auto edgeIndices = makeEdgeIndices();
+  static const auto faceIndices = makeFaceIndices();
+  return shape == EntityBoundsShape::Edges ? edgeIndices : faceIndices;
+}
+
+PrimType primType(const EntityBoundsShape shape)
+{
+  return shape == EntityBoundsShape::Edges ? PrimType::Lines : PrimType::Quads;
+}
+
+vm::vec3f selectCorner(const vm::bbox3f& bounds, const vm::vec3f& selector)
+{
+  return vm::vec3f{
+    selector.x() == 0.0f ? bounds.min.x() : bounds.max.x(),
+    selector.y() == 0.0f ? bounds.min.y() : bounds.max.y(),
+    selector.z() == 0.0f ? bounds.min.z() : bounds.max.z(),
+  };
+}
+
+} // namespace
+
+EntityBoundsArray::EntityBoundsArray(const EntityBoundsShape shape)
+  : m_shape{shape}
+{
+}
+
+size_t EntityBoundsArray::add(const vm::bbox3f& bounds, const Color& color)
+{
+  if (m_freeSlots.empty())
+  {
+    grow();
+  }
+
+  const auto slot = m_freeSlots.back();
+  m_freeSlots.pop_back();
+
+  writeVertices(slot, bounds, color);
+  writeIndices(slot);
+  return slot;
+}
+
+void EntityBoundsArray::update(
+  const size_t slot, const vm::bbox3f& bounds, const Color& color)
+{
+  contract_pre(slot < m_slotCount);
+
+  writeVertices(slot, bounds, color);
+}
+
+void EntityBoundsArray::remove(const size_t slot)
+{
+  contract_pre(slot < m_slotCount);
+
+  m_indexHolder.zeroRange(slot * IndicesPerSlot, IndicesPerSlot);
+  m_freeSlots.push_back(slot);
+}
+
+size_t EntityBoundsArray::size() const
+{
+  return m_slotCount - m_freeSlots.size();
+}
+
+size_t EntityBoundsArray::capacity() const
+{
+  return m_slotCount;
+}
+
+size_t EntityBoundsArray::verticesPerSlot() const
+{
+  return m_shape == EntityBoundsShape::Edges ? EdgeVerticesPerSlot : FaceVerticesPerSlot;
+}
+
+bool EntityBoundsArray::empty() const
+{
+  return size() == 0;
+}
+
+bool EntityBoundsArray::prepared() const
+{
+  return m_vertexHolder.prepared() && m_indexHolder.prepared();
+}
+
+void EntityBoundsArray::prepare(VboManager& vboManager)
+{
+  m_vertexHolder.prepare(vboManager);
+  m_indexHolder.prepare(vboManager);
+}
+
+void EntityBoundsArray::render()
+{
+  if (!empty() && m_vertexHolder.setupVertices())
+  {
+    m_indexHolder.bindBlock();
+    m_indexHolder.render(primType(m_shape), 0, m_slotCount * IndicesPerSlot);
+    m_indexHolder.unbindBlock();
+    m_vertexHolder.cleanupVertices();
+  }
+}
+
+void EntityBoundsArray::grow()
+{
+  const auto oldSlotCount = m_slotCount;
+  const auto newSlotCount = std::max(size_t(64), 2 * oldSlotCount);
+
+  // the new indices are zero, so the new slots are degenerate until they are used
+  m_vertexHolder.resize(newSlotCount * verticesPerSlot());
+  m_indexHolder.resize(newSlotCount * IndicesPerSlot);
+  m_slotCount = newSlotCount;
+
+  // hand out the lowest free slots first
+  for (size_t slot = newSlotCount; slot > oldSlotCount; --slot)
+  {
+    m_freeSlots.push_back(slot - 1);
+  }
+}
+
+void EntityBoundsArray::writeVertices(
+  const size_t slot, const vm::bbox3f& bounds, const Color& color)
+{
+  const auto vertexColor = color.to<RgbaF>().toVec();
+
+  auto* vertices = m_vertexHolder.getPointerToWriteElementsTo(
+    slot * verticesPerSlot(), verticesPerSlot());
+  for (const auto& corner : corners(m_shape))
+  {
+    *vertices++ =
+      Vertex{selectCorner(bounds, corner.selector), corner.normal, vertexColor};
+  }
+}
+
+void EntityBoundsArray::writeIndices(const size_t slot)
+{
+  const auto firstVertex = GLuint(slot * verticesPerSlot());
+
+  auto* slotIndices =
+    m_indexHolder.getPointerToWriteElementsTo(slot * IndicesPerSlot, IndicesPerSlot);
+  for (const auto index : indices(m_shape))
+  {
+    *slotIndices++ = firstVertex + index;
+  }
+}
+
+// EntityBoundsEdgeRenderer::Render
+
+EntityBoundsEdgeRenderer::Render::Render(
+  const EdgeRenderer::Params& params, std::shared_ptr<EntityBoundsArray> array)
+  : RenderBase{params}
+  , m_array{std::move(array)}
+{
+}
+
+void EntityBoundsEdgeRenderer::Render::doPrepareVertices(VboManager& vboManager)
+{
+  m_array->prepare(vboManager);
+}
+
+void EntityBoundsEdgeRenderer::Render::doRender(RenderContext& renderContext)
+{
+  if (!m_array->empty())
+  {
+    renderEdges(renderContext);
+  }
+}
+
+void EntityBoundsEdgeRenderer::Render::doRenderVertices(RenderContext&)
+{
+  m_array->render();
+}
+
+// EntityBoundsEdgeRenderer
+
+EntityBoundsEdgeRenderer::EntityBoundsEdgeRenderer() = default;
+
+EntityBoundsEdgeRenderer::EntityBoundsEdgeRenderer(
+  std::shared_ptr<EntityBoundsArray> array)
+  : m_array{std::move(array)}
+{
+}
+
+void EntityBoundsEdgeRenderer::doRender(
+  RenderBatch& renderBatch, const EdgeRenderer::Params& params)
+{
+  if (m_array)
+  {
+    renderBatch.addOneShot(new Render{params, m_array});
+  }
+}
+
+// EntitySolidBoundsRenderer
+
+EntitySolidBoundsRenderer::EntitySolidBoundsRenderer() = default;
+
+EntitySolidBoundsRenderer::EntitySolidBoundsRenderer(
+  std::shared_ptr<EntityBoundsArray> array)
+  : m_array{std::move(array)}
+{
+}
+
+void EntitySolidBoundsRenderer::setUseColor(const bool useColor)
+{
+  m_useColor = useColor;
+}
+
+void EntitySolidBoundsRenderer::setColor(const Color& color)
+{
+  m_color = color;
+}
+
+void EntitySolidBoundsRenderer::setApplyTinting(const bool applyTinting)
+{
+  m_applyTinting = applyTinting;
+}
+
+void EntitySolidBoundsRenderer::setTintColor(const Color& tintColor)
+{
+  m_tintColor = tintColor;
+}
+
+void EntitySolidBoundsRenderer::doPrepareVertices(VboManager& vboManager)
+{
+  if (m_array)
+  {
+    m_array->prepare(vboManager);
+  }
+}
+
+void EntitySolidBoundsRenderer::doRender(RenderContext& context)
+{
+  if (m_array && !m_array->empty())
+  {
+    auto shader = ActiveShader{context.shaderManager(), Shaders::TriangleShader};
+    shader.set("ApplyTinting", m_applyTinting);
+    shader.set("TintColor", m_tintColor);
+    shader.set("UseColor", m_useColor);
+    shader.set("Color", m_color);
+    shader.set("CameraPosition", context.camera().position());
+    m_array->render();
+  }
+}
+
+} // namespace tb::render
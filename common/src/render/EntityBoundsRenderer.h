@@ -0,0 +1,177 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Color.h"
+#include "Macros.h"
+#include "render/BrushRendererArrays.h"
+#include "render/EdgeRenderer.h"
+#include "render/GLVertexType.h"
+#include "render/Renderable.h"
+
+#include "vm/bbox.h"
+
+#include <memory>
+#include <vector>
+
+namespace tb::render
+{
+class RenderBatch;
+class RenderContext;
+class VboManager;
+
+enum class EntityBoundsShape
+{
+  Edges,
+  Faces,
+};
+
+/**
+ * Stores the bounds of many entities in a single vertex buffer so that the bounds of an
+ * individual entity can be changed without rebuilding the buffer.
+ *
+ * Every entity occupies a slot of a fixed number of vertices and indices. The edges of a
+ * box share its eight corners, while its faces need four vertices each because every
+ * face has its own normal. Changing the bounds or color of an entity only rewrites and
+ * uploads the vertices of its slot.
+ *
+ * Slots of removed entities are reused. Their indices are zeroed so that they form
+ * degenerate primitives, like the indices of removed brushes.
+ */
+class EntityBoundsArray
+{
+public:
+  using Vertex = GLVertexTypes::P3NC4::Vertex;
+
+  static constexpr size_t IndicesPerSlot = 24;
+
+private:
+  EntityBoundsShape m_shape;
+  VertexHolder<Vertex> m_vertexHolder;
+  IndexHolder m_indexHolder;
+  size_t m_slotCount = 0;
+  std::vector<size_t> m_freeSlots;
+
+public:
+  explicit EntityBoundsArray(EntityBoundsShape shape);
+
+  /**
+   * Adds the given bounds and returns the slot that holds them.
+   */
+  size_t add(const vm::bbox3f& bounds, const Color& color);
+
+  /**
+   * Replaces the bounds and color stored in the given slot.
+   */
+  void update(size_t slot, const vm::bbox3f& bounds, const Color& color);
+
+  /**
+   * Frees the given slot so that it can be reused by a later call to add().
+   */
+  void remove(size_t slot);
+
+  /**
+   * Returns the number of slots in use.
+   */
+  size_t size() const;
+
+  /**
+   * Returns the number of slots, including free slots.
+   */
+  size_t capacity() const;
+
+  /**
+   * Returns the number of vertices that each slot occupies.
+   */
+  size_t verticesPerSlot() const;
+
+  bool empty() const;
+
+  bool prepared() const;
+  void prepare(VboManager& vboManager);
+  void render();
+
+private:
+  void grow();
+  void writeVertices(size_t slot, const vm::bbox3f& bounds, const Color& color);
+  void writeIndices(size_t slot);
+
+  deleteCopyAndMove(EntityBoundsArray);
+};
+
+/**
+ * Renders the edges stored in an entity bounds array.
+ */
+class EntityBoundsEdgeRenderer : public EdgeRenderer
+{
+private:
+  class Render : public RenderBase, public DirectRenderable
+  {
+  private:
+    std::shared_ptr<EntityBoundsArray> m_array;
+
+  public:
+    Render(const Params& params, std::shared_ptr<EntityBoundsArray> array);
+
+  private:
+    void doPrepareVertices(VboManager& vboManager) override;
+    void doRender(RenderContext& renderContext) override;
+    void doRenderVertices(RenderContext& renderContext) override;
+  };
+
+private:
+  std::shared_ptr<EntityBoundsArray> m_array;
+
+public:
+  EntityBoundsEdgeRenderer();
+  explicit EntityBoundsEdgeRenderer(std::shared_ptr<EntityBoundsArray> array);
+
+private:
+  void doRender(RenderBatch& renderBatch, const EdgeRenderer::Params& params) override;
+};
+
+/**
+ * Renders the faces stored in an entity bounds array as shaded quads.
+ */
+class EntitySolidBoundsRenderer : public DirectRenderable
+{
+private:
+  std::shared_ptr<EntityBoundsArray> m_array;
+
+  bool m_useColor = false;
+  Color m_color;
+  bool m_applyTinting = false;
+  Color m_tintColor;
+
+public:
+  EntitySolidBoundsRenderer();
+  explicit EntitySolidBoundsRenderer(std::shared_ptr<EntityBoundsArray> array);
+
+  void setUseColor(bool useColor);
+  void setColor(const Color& color);
+  void setApplyTinting(bool applyTinting);
+  void setTintColor(const Color& tintColor);
+
+private:
+  void doPrepareVertices(VboManager& vboManager) override;
+  void doRender(RenderContext& renderContext) override;
+};
+
+} // namespace tb::render
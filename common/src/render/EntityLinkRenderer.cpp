@@ -40,6 +40,7 @@
 #include <cassert>
 #include <ranges>
 #include <unordered_set>
+#include <vector>
 
 namespace tb::render
 {
@@ -75,38 +76,6 @@ void addLink(
     vm::vec3f{targetNode.linkTargetAnchor()}, targetColor.to<RgbaF>().toVec());
 }
 
-struct CollectAllLinksVisitor
-{
-  const mdl::EntityLinkManager& entityLinkManager;
-  const mdl::EditorContext& editorContext;
-  Color defaultColor;
-  Color selectedColor;
-
-  void visit(
-    const mdl::EntityNodeBase& node, std::vector<LinkRenderer::LineVertex>& linkVertices)
-  {
-    if (editorContext.visible(node))
-    {
-      addLinks(node, entityLinkManager.linksFrom(node), linkVertices);
-    }
-  }
-
-  void addLinks(
-    const mdl::EntityNodeBase& sourceNode,
-    const mdl::EntityLinkManager::LinkEndsForPropertyKey& entityLinks,
-    std::vector<LinkRenderer::LineVertex>& linkVertices)
-  {
-    for (const auto& linkEnd : getLinkEnds(entityLinks))
-    {
-      const auto& targetNode = *linkEnd.node;
-      if (editorContext.visible(targetNode))
-      {
-        addLink(sourceNode, targetNode, defaultColor, selectedColor, linkVertices);
-      }
-    }
-  }
-};
-
 struct CollectTransitiveSelectedLinksVisitor
 {
   const mdl::EntityLinkManager& entityLinkManager;
@@ -232,31 +201,6 @@ auto collectSelectedLinks(const mdl::Selection& selection, Visitor visitor)
   return links;
 }
 
-auto getAllLinks(
-  const mdl::Map& map, const Color& defaultColor, const Color& selectedColor)
-{
-  auto links = std::vector<LinkRenderer::LineVertex>{};
-
-  auto visitor = CollectAllLinksVisitor{
-    map.entityLinkManager(), map.editorContext(), defaultColor, selectedColor};
-
-  map.worldNode().accept(kdl::overload(
-    [](auto&& thisLambda, const mdl::WorldNode* worldNode) {
-      worldNode->visitChildren(thisLambda);
-    },
-    [](auto&& thisLambda, const mdl::LayerNode* layerNode) {
-      layerNode->visitChildren(thisLambda);
-    },
-    [](auto&& thisLambda, const mdl::GroupNode* groupNode) {
-      groupNode->visitChildren(thisLambda);
-    },
-    [&](const mdl::EntityNode* entityNode) { visitor.visit(*entityNode, links); },
-    [](const mdl::BrushNode*) {},
-    [](const mdl::PatchNode*) {}));
-
-  return links;
-}
-
 auto getTransitiveSelectedLinks(
   const mdl::Map& map, const Color& defaultColor, const Color& selectedColor)
 {
@@ -276,10 +220,6 @@ auto getDirectSelectedLinks(
 auto getLinks(const mdl::Map& map, const Color& defaultColor, const Color& selectedColor)
 {
   const auto entityLinkMode = pref(Preferences::EntityLinkMode);
-  if (entityLinkMode == Preferences::entityLinkModeAll())
-  {
-    return getAllLinks(map, defaultColor, selectedColor);
-  }
   if (entityLinkMode == Preferences::entityLinkModeTransitive())
   {
     return getTransitiveSelectedLinks(map, defaultColor, selectedColor);
@@ -317,9 +257,239 @@ void EntityLinkRenderer::setSelectedColor(const Color& selectedColor)
   }
 }
 
+void EntityLinkRenderer::invalidateNodes(const std::vector<mdl::Node*>& nodes)
+{
+  for (auto* node : nodes)
+  {
+    node->accept(kdl::overload(
+      [&](const mdl::WorldNode* worldNode) { invalidateEntity(*worldNode); },
+      [](const mdl::LayerNode*) {},
+      [](const mdl::GroupNode*) {},
+      [&](const mdl::EntityNode* entityNode) { invalidateEntity(*entityNode); },
+      [](auto&& thisLambda, const mdl::BrushNode* brushNode) {
+        brushNode->visitParent(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::PatchNode* patchNode) {
+        patchNode->visitParent(thisLambda);
+      }));
+  }
+}
+
+void EntityLinkRenderer::invalidateNodesRecursive(const std::vector<mdl::Node*>& nodes)
+{
+  invalidateNodes(nodes);
+
+  // only descend into the given nodes, their containing entities were invalidated above
+  for (auto* node : nodes)
+  {
+    node->accept(kdl::overload(
+      [](auto&& thisLambda, const mdl::WorldNode* worldNode) {
+        worldNode->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::LayerNode* layerNode) {
+        layerNode->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::GroupNode* groupNode) {
+        groupNode->visitChildren(thisLambda);
+      },
+      [&](const mdl::EntityNode* entityNode) { invalidateEntity(*entityNode); },
+      [](const mdl::BrushNode*) {},
+      [](const mdl::PatchNode*) {}));
+  }
+}
+
+void EntityLinkRenderer::removeNodes(const std::vector<mdl::Node*>& nodes)
+{
+  if (!m_showAllLinks)
+  {
+    m_linksChanged = true;
+    return;
+  }
+
+  auto removedEntityNodes = std::vector<const mdl::EntityNodeBase*>{};
+  for (auto* node : nodes)
+  {
+    node->accept(kdl::overload(
+      [&](auto&& thisLambda, const mdl::WorldNode* worldNode) {
+        removedEntityNodes.push_back(worldNode);
+        worldNode->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::LayerNode* layerNode) {
+        layerNode->visitChildren(thisLambda);
+      },
+      [](auto&& thisLambda, const mdl::GroupNode* groupNode) {
+        groupNode->visitChildren(thisLambda);
+      },
+      [&](const mdl::EntityNode* entityNode) {
+        removedEntityNodes.push_back(entityNode);
+      },
+      [](const mdl::BrushNode*) {},
+      [](const mdl::PatchNode*) {}));
+  }
+
+  // the sources of links to removed entities must be updated
+  for (const auto* entityNode : removedEntityNodes)
+  {
+    if (const auto it = m_linkSources.find(entityNode); it != m_linkSources.end())
+    {
+      m_invalidEntities.insert(it->second.begin(), it->second.end());
+    }
+    forgetLinksFrom(*entityNode);
+  }
+
+  // removed entities must not be accessed anymore
+  for (const auto* entityNode : removedEntityNodes)
+  {
+    m_linkSources.erase(entityNode);
+    m_invalidEntities.erase(entityNode);
+  }
+}
+
+void EntityLinkRenderer::collectLinks()
+{
+  m_linkTargets.clear();
+  m_linkSources.clear();
+  m_invalidEntities.clear();
+  m_linksChanged = false;
+
+  m_showAllLinks = pref(Preferences::EntityLinkMode) == Preferences::entityLinkModeAll();
+  if (!m_showAllLinks)
+  {
+    setLinks(this, getLinks());
+    return;
+  }
+
+  // store the links of each entity separately so that they can be updated and culled
+  // individually
+  m_map.worldNode().accept(kdl::overload(
+    [](auto&& thisLambda, const mdl::WorldNode* worldNode) {
+      worldNode->visitChildren(thisLambda);
+    },
+    [](auto&& thisLambda, const mdl::LayerNode* layerNode) {
+      layerNode->visitChildren(thisLambda);
+    },
+    [](auto&& thisLambda, const mdl::GroupNode* groupNode) {
+      groupNode->visitChildren(thisLambda);
+    },
+    [&](const mdl::EntityNode* entityNode) { updateLinksFrom(*entityNode); },
+    [](const mdl::BrushNode*) {},
+    [](const mdl::PatchNode*) {}));
+}
+
+void EntityLinkRenderer::updateLinks()
+{
+  if (!m_showAllLinks)
+  {
+    if (m_linksChanged)
+    {
+      clearLinks();
+      setLinks(this, getLinks());
+      m_linksChanged = false;
+    }
+    return;
+  }
+
+  if (m_invalidEntities.empty())
+  {
+    return;
+  }
+
+  // a changed entity affects its own links and all links pointing to it, including
+  // links that were removed by the change
+  const auto& entityLinkManager = m_map.entityLinkManager();
+  auto sourceNodes = std::unordered_set<const mdl::EntityNodeBase*>{};
+  for (const auto* entityNode : m_invalidEntities)
+  {
+    sourceNodes.insert(entityNode);
+    if (const auto it = m_linkSources.find(entityNode); it != m_linkSources.end())
+    {
+      sourceNodes.insert(it->second.begin(), it->second.end());
+    }
+    for (const auto& linkEnd : getLinkEnds(entityLinkManager.linksTo(*entityNode)))
+    {
+      sourceNodes.insert(linkEnd.node);
+    }
+  }
+  m_invalidEntities.clear();
+
+  for (const auto* sourceNode : sourceNodes)
+  {
+    updateLinksFrom(*sourceNode);
+  }
+}
+
 std::vector<LinkRenderer::LineVertex> EntityLinkRenderer::getLinks()
 {
   return render::getLinks(m_map, m_defaultColor, m_selectedColor);
 }
 
+void EntityLinkRenderer::invalidateEntity(const mdl::EntityNodeBase& entityNode)
+{
+  if (m_showAllLinks)
+  {
+    m_invalidEntities.insert(&entityNode);
+  }
+  else
+  {
+    m_linksChanged = true;
+  }
+}
+
+void EntityLinkRenderer::updateLinksFrom(const mdl::EntityNodeBase& sourceNode)
+{
+  forgetLinksFrom(sourceNode);
+
+  // only entity nodes are link sources, the world node can only be a link target
+  const auto& editorContext = m_map.editorContext();
+  if (
+    dynamic_cast<const mdl::EntityNode*>(&sourceNode) == nullptr
+    || !editorContext.visible(sourceNode))
+  {
+    return;
+  }
+
+  auto links = std::vector<LinkRenderer::LineVertex>{};
+  auto targetNodes = std::vector<const mdl::EntityNodeBase*>{};
+
+  const auto& entityLinkManager = m_map.entityLinkManager();
+  for (const auto& linkEnd : getLinkEnds(entityLinkManager.linksFrom(sourceNode)))
+  {
+    const auto& targetNode = *linkEnd.node;
+    if (editorContext.visible(targetNode))
+    {
+      addLink(sourceNode, targetNode, m_defaultColor, m_selectedColor, links);
+      targetNodes.push_back(&targetNode);
+      m_linkSources[&targetNode].insert(&sourceNode);
+    }
+  }
+
+  if (!targetNodes.empty())
+  {
+    m_linkTargets[&sourceNode] = std::move(targetNodes);
+    setLinks(&sourceNode, links);
+  }
+}
+
+void EntityLinkRenderer::forgetLinksFrom(const mdl::EntityNodeBase& sourceNode)
+{
+  if (const auto it = m_linkTargets.find(&sourceNode); it != m_linkTargets.end())
+  {
+    for (const auto* targetNode : it->second)
+    {
+      if (const auto sourcesIt = m_linkSources.find(targetNode);
+          sourcesIt != m_linkSources.end())
+      {
+        sourcesIt->second.erase(&sourceNode);
+        if (sourcesIt->second.empty())
+        {
+          m_linkSources.erase(sourcesIt);
+        }
+      }
+    }
+    m_linkTargets.erase(it);
+  }
+
+  removeLinks(&sourceNode);
+}
+
 } // namespace tb::render
@@ -23,14 +23,18 @@
 #include "Macros.h"
 #include "render/LinkRenderer.h"
 
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace tb
 {
 namespace mdl
 {
+class EntityNodeBase;
 class Map;
-}
+class Node;
+} // namespace mdl
 
 namespace render
 {
@@ -42,15 +46,57 @@ class EntityLinkRenderer : public LinkRenderer
   Color m_defaultColor = RgbaF{0.5f, 1.0f, 0.5f, 1.0f};
   Color m_selectedColor = RgbaF{1.0f, 0.0f, 0.0f, 1.0f};
 
+  /**
+   * Whether all links are shown. In this mode, the links are stored per source entity
+   * and only the links of changed entities are updated. The other modes only show the
+   * links of the selection, which are collected again whenever anything changes.
+   */
+  bool m_showAllLinks = false;
+
+  // the targets of the stored links of each source entity, and the reverse mapping
+  std::unordered_map<const mdl::EntityNodeBase*, std::vector<const mdl::EntityNodeBase*>>
+    m_linkTargets;
+  std::unordered_map<
+    const mdl::EntityNodeBase*,
+    std::unordered_set<const mdl::EntityNodeBase*>>
+    m_linkSources;
+
+  std::unordered_set<const mdl::EntityNodeBase*> m_invalidEntities;
+  bool m_linksChanged = false;
+
 public:
   explicit EntityLinkRenderer(mdl::Map& map);
 
   void setDefaultColor(const Color& color);
   void setSelectedColor(const Color& color);
 
+  /**
+   * Updates the links from and to the given entities and the entities containing the
+   * given brushes and patches before the links are rendered next.
+   */
+  void invalidateNodes(const std::vector<mdl::Node*>& nodes);
+
+  /**
+   * Like invalidateNodes(), but also updates the links of all entities contained in the
+   * given nodes.
+   */
+  void invalidateNodesRecursive(const std::vector<mdl::Node*>& nodes);
+
+  /**
+   * Removes the links from and to the entities contained in the given nodes, which are
+   * being removed from the map. Must be called while the given nodes are still alive.
+   */
+  void removeNodes(const std::vector<mdl::Node*>& nodes);
+
 private:
+  void collectLinks() override;
+  void updateLinks() override;
   std::vector<LinkRenderer::LineVertex> getLinks() override;
 
+  void invalidateEntity(const mdl::EntityNodeBase& entityNode);
+  void updateLinksFrom(const mdl::EntityNodeBase& sourceNode);
+  void forgetLinksFrom(const mdl::EntityNodeBase& sourceNode);
+
   deleteCopy(EntityLinkRenderer);
 };
 
@@ -26,8 +26,6 @@
 #include "mdl/EntityModelManager.h"
 #include "mdl/EntityNode.h"
 #include "render/Camera.h"
-#include "render/GLVertexType.h"
-#include "render/PrimType.h"
 #include "render/RenderBatch.h"
 #include "render/RenderContext.h"
 #include "render/RenderService.h"
@@ -78,6 +76,7 @@ EntityRenderer::EntityRenderer(
   , m_editorContext{editorContext}
   , m_modelRenderer{logger, m_entityModelManager, m_editorContext}
 {
+  resetBounds();
 }
 
 void EntityRenderer::invalidate()
@@ -89,9 +88,7 @@ void EntityRenderer::invalidate()
 void EntityRenderer::clear()
 {
   m_entities.clear();
-  m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer();
-  m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer();
-  m_solidBoundsRenderer = TriangleRenderer();
+  resetBounds();
   m_modelRenderer.clear();
 }
 
@@ -105,7 +102,7 @@ void EntityRenderer::addEntity(const mdl::EntityNode* entity)
   if (m_entities.insert(entity).second)
   {
     m_modelRenderer.addEntity(entity);
-    invalidateBounds();
+    invalidateBounds(entity);
   }
 }
 
@@ -115,14 +112,14 @@ void EntityRenderer::removeEntity(const mdl::EntityNode* entity)
   {
     m_entities.erase(it);
     m_modelRenderer.removeEntity(entity);
-    invalidateBounds();
+    removeBounds(entity);
   }
 }
 
 void EntityRenderer::invalidateEntity(const mdl::EntityNode* entity)
 {
   m_modelRenderer.updateEntity(entity);
-  invalidateBounds();
+  invalidateBounds(entity);
 }
 
 void EntityRenderer::invalidateEntityModels(
@@ -176,7 +173,12 @@ void EntityRenderer::setOverrideBoundsColor(const bool overrideBoundsColor)
 
 void EntityRenderer::setBoundsColor(const Color& boundsColor)
 {
-  m_boundsColor = boundsColor;
+  // the bounds of entities without a definition store this color
+  if (boundsColor.to<RgbaF>().toVec() != m_boundsColor.to<RgbaF>().toVec())
+  {
+    m_boundsColor = boundsColor;
+    invalidateBounds();
+  }
 }
 
 void EntityRenderer::setShowOccludedBounds(const bool showOccludedBounds)
@@ -217,10 +219,7 @@ void EntityRenderer::render(RenderContext& renderContext, RenderBatch& renderBat
 
 void EntityRenderer::renderBounds(RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  if (!m_boundsValid)
-  {
-    validateBounds();
-  }
+  validateBounds();
 
   if (renderContext.showPointEntityBounds())
   {
@@ -264,6 +263,8 @@ void EntityRenderer::renderBrushEntityWireframeBounds(RenderBatch& renderBatch)
 
 void EntityRenderer::renderSolidBounds(RenderBatch& renderBatch)
 {
+  m_solidBoundsRenderer.setUseColor(m_overrideBoundsColor);
+  m_solidBoundsRenderer.setColor(m_boundsColor);
   m_solidBoundsRenderer.setApplyTinting(m_tint);
   m_solidBoundsRenderer.setTintColor(m_tintColor);
   renderBatch.add(&m_solidBoundsRenderer);
@@ -383,140 +384,138 @@ std::vector<vm::vec3f> EntityRenderer::arrowHead(
   };
 }
 
-void EntityRenderer::invalidateBounds()
+void EntityRenderer::resetBounds()
 {
+  m_pointEntityWireframeBounds =
+    std::make_shared<EntityBoundsArray>(EntityBoundsShape::Edges);
+  m_brushEntityWireframeBounds =
+    std::make_shared<EntityBoundsArray>(EntityBoundsShape::Edges);
+  m_solidBounds = std::make_shared<EntityBoundsArray>(EntityBoundsShape::Faces);
+  m_boundsSlots.clear();
+  m_invalidBounds.clear();
+
+  m_pointEntityWireframeBoundsRenderer =
+    EntityBoundsEdgeRenderer{m_pointEntityWireframeBounds};
+  m_brushEntityWireframeBoundsRenderer =
+    EntityBoundsEdgeRenderer{m_brushEntityWireframeBounds};
+  m_solidBoundsRenderer = EntitySolidBoundsRenderer{m_solidBounds};
+
   m_boundsValid = false;
 }
 
-namespace
+void EntityRenderer::invalidateBounds()
 {
+  m_boundsValid = false;
+  m_invalidBounds.clear();
+}
 
-auto makeWireFrameBoundsVertexBuilder(std::vector<GLVertexTypes::P3::Vertex>& vertices)
+void EntityRenderer::invalidateBounds(const mdl::EntityNode* entityNode)
 {
-  return [&](const vm::vec3d& v1, const vm::vec3d& v2) {
-    vertices.emplace_back(vm::vec3f{v1});
-    vertices.emplace_back(vm::vec3f{v2});
-  };
+  if (m_boundsValid)
+  {
+    m_invalidBounds.insert(entityNode);
+  }
 }
 
-auto makeColoredWireFrameBoundsVertexBuilder(
-  std::vector<GLVertexTypes::P3C4::Vertex>& vertices, const Color& color)
+void EntityRenderer::validateBounds()
 {
-  return [&](const vm::vec3d& v1, const vm::vec3d& v2) {
-    vertices.emplace_back(vm::vec3f{v1}, color.to<RgbaF>().toVec());
-    vertices.emplace_back(vm::vec3f{v2}, color.to<RgbaF>().toVec());
-  };
+  if (!m_boundsValid)
+  {
+    for (const auto* entityNode : m_entities)
+    {
+      updateBounds(entityNode);
+    }
+    m_boundsValid = true;
+  }
+  else
+  {
+    for (const auto* entityNode : m_invalidBounds)
+    {
+      updateBounds(entityNode);
+    }
+  }
+  m_invalidBounds.clear();
 }
 
-auto makeColoredSolidBoundsVertexBuilder(
-  std::vector<GLVertexTypes::P3NC4::Vertex>& vertices, const Color& color)
+namespace
 {
-  return [&](
-           const vm::vec3d& v1,
-           const vm::vec3d& v2,
-           const vm::vec3d& v3,
-           const vm::vec3d& v4,
-           const vm::vec3d& n) {
-    vertices.emplace_back(vm::vec3f{v1}, vm::vec3f{n}, color.to<RgbaF>().toVec());
-    vertices.emplace_back(vm::vec3f{v2}, vm::vec3f{n}, color.to<RgbaF>().toVec());
-    vertices.emplace_back(vm::vec3f{v3}, vm::vec3f{n}, color.to<RgbaF>().toVec());
-    vertices.emplace_back(vm::vec3f{v4}, vm::vec3f{n}, color.to<RgbaF>().toVec());
-  };
+
+void updateBoundsSlot(
+  EntityBoundsArray& array,
+  std::optional<size_t>& slot,
+  const bool show,
+  const vm::bbox3f& bounds,
+  const Color& color)
+{
+  if (show)
+  {
+    if (slot)
+    {
+      array.update(*slot, bounds, color);
+    }
+    else
+    {
+      slot = array.add(bounds, color);
+    }
+  }
+  else if (slot)
+  {
+    array.remove(*slot);
+    slot = std::nullopt;
+  }
 }
 
 } // namespace
 
-void EntityRenderer::validateBounds()
+void EntityRenderer::updateBounds(const mdl::EntityNode* entityNode)
 {
-  auto solidVertices = std::vector<GLVertexTypes::P3NC4::Vertex>{};
-  solidVertices.reserve(36 * m_entities.size());
+  auto& slots = m_boundsSlots[entityNode];
 
-  if (m_overrideBoundsColor)
-  {
-    using Vertex = GLVertexTypes::P3::Vertex;
-    auto pointEntityWireframeVertices = std::vector<Vertex>{};
-    auto brushEntityWireframeVertices = std::vector<Vertex>{};
+  const auto visible = m_editorContext.visible(*entityNode);
+  const auto pointEntity = !entityNode->hasChildren();
+  const auto hasModel =
+    entityNode->entity().model() && entityNode->entity().model()->data();
 
-    pointEntityWireframeVertices.reserve(24 * m_entities.size());
-    brushEntityWireframeVertices.reserve(24 * m_entities.size());
+  const auto bounds = vm::bbox3f{entityNode->logicalBounds()};
+  const auto& color = boundsColor(entityNode);
 
-    for (const auto* entityNode : m_entities)
-    {
-      if (m_editorContext.visible(*entityNode))
-      {
-        const auto pointEntity = !entityNode->hasChildren();
-        if (pointEntity)
-        {
-          entityNode->logicalBounds().for_each_edge(
-            makeWireFrameBoundsVertexBuilder(pointEntityWireframeVertices));
+  updateBoundsSlot(
+    *m_pointEntityWireframeBounds,
+    slots.pointEntityWireframe,
+    visible && pointEntity,
+    bounds,
+    color);
+  updateBoundsSlot(
+    *m_brushEntityWireframeBounds,
+    slots.brushEntityWireframe,
+    visible && !pointEntity,
+    bounds,
+    color);
+  updateBoundsSlot(
+    *m_solidBounds, slots.solid, visible && pointEntity && !hasModel, bounds, color);
+}
 
-          const auto hasModel =
-            entityNode->entity().model() && entityNode->entity().model()->data();
-          if (!hasModel)
-          {
-            entityNode->logicalBounds().for_each_face(
-              makeColoredSolidBoundsVertexBuilder(solidVertices, m_boundsColor));
-          }
-        }
-        else
-        {
-          entityNode->logicalBounds().for_each_edge(
-            makeWireFrameBoundsVertexBuilder(brushEntityWireframeVertices));
-        }
-      }
-    }
+void EntityRenderer::removeBounds(const mdl::EntityNode* entityNode)
+{
+  m_invalidBounds.erase(entityNode);
 
-    m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer{
-      VertexArray::move(std::move(pointEntityWireframeVertices)), PrimType::Lines};
-    m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer{
-      VertexArray::move(std::move(brushEntityWireframeVertices)), PrimType::Lines};
-  }
-  else
+  if (auto it = m_boundsSlots.find(entityNode); it != m_boundsSlots.end())
   {
-    using Vertex = GLVertexTypes::P3C4::Vertex;
-    auto pointEntityWireframeVertices = std::vector<Vertex>{};
-    auto brushEntityWireframeVertices = std::vector<Vertex>{};
-
-    pointEntityWireframeVertices.reserve(24 * m_entities.size());
-    brushEntityWireframeVertices.reserve(24 * m_entities.size());
-
-    for (auto* entityNode : m_entities)
+    const auto& slots = it->second;
+    if (slots.pointEntityWireframe)
     {
-      if (m_editorContext.visible(*entityNode))
-      {
-        const auto isPointEntity = !entityNode->hasChildren();
-        if (isPointEntity)
-        {
-          entityNode->logicalBounds().for_each_edge(
-            makeColoredWireFrameBoundsVertexBuilder(
-              pointEntityWireframeVertices, boundsColor(entityNode)));
-
-          const auto hasModel =
-            entityNode->entity().model() && entityNode->entity().model()->data();
-          if (!hasModel)
-          {
-            entityNode->logicalBounds().for_each_face(makeColoredSolidBoundsVertexBuilder(
-              solidVertices, boundsColor(entityNode)));
-          }
-        }
-        else
-        {
-          entityNode->logicalBounds().for_each_edge(
-            makeColoredWireFrameBoundsVertexBuilder(
-              brushEntityWireframeVertices, boundsColor(entityNode)));
-        }
-      }
+      m_pointEntityWireframeBounds->remove(*slots.pointEntityWireframe);
     }
-
-    m_pointEntityWireframeBoundsRenderer = DirectEdgeRenderer(
-      VertexArray::move(std::move(pointEntityWireframeVertices)), PrimType::Lines);
-    m_brushEntityWireframeBoundsRenderer = DirectEdgeRenderer(
-      VertexArray::move(std::move(brushEntityWireframeVertices)), PrimType::Lines);
+    if (slots.brushEntityWireframe)
+    {
+      m_brushEntityWireframeBounds->remove(*slots.brushEntityWireframe);
+    }
+    if (slots.solid)
+    {
+      m_solidBounds->remove(*slots.solid);
+    }
+    m_boundsSlots.erase(it);
   }
-
-  m_solidBoundsRenderer =
-    TriangleRenderer{VertexArray::move(std::move(solidVertices)), PrimType::Quads};
-  m_boundsValid = true;
 }
 
 AttrString EntityRenderer::entityString(const mdl::EntityNode* entityNode) const
@@ -20,13 +20,15 @@
 #pragma once
 
 #include "Color.h"
-#include "render/EdgeRenderer.h"
+#include "render/EntityBoundsRenderer.h"
 #include "render/EntityModelRenderer.h"
 #include "render/Renderable.h"
-#include "render/TriangleRenderer.h"
 
 #include "kd/vector_set.h"
 
+#include <memory>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace tb
@@ -52,12 +54,25 @@ private:
   const mdl::EditorContext& m_editorContext;
   kdl::vector_set<const mdl::EntityNode*> m_entities;
 
-  DirectEdgeRenderer m_pointEntityWireframeBoundsRenderer;
-  DirectEdgeRenderer m_brushEntityWireframeBoundsRenderer;
+  struct BoundsSlots
+  {
+    std::optional<size_t> pointEntityWireframe;
+    std::optional<size_t> brushEntityWireframe;
+    std::optional<size_t> solid;
+  };
+
+  std::shared_ptr<EntityBoundsArray> m_pointEntityWireframeBounds;
+  std::shared_ptr<EntityBoundsArray> m_brushEntityWireframeBounds;
+  std::shared_ptr<EntityBoundsArray> m_solidBounds;
+  std::unordered_map<const mdl::EntityNode*, BoundsSlots> m_boundsSlots;
+
+  EntityBoundsEdgeRenderer m_pointEntityWireframeBoundsRenderer;
+  EntityBoundsEdgeRenderer m_brushEntityWireframeBoundsRenderer;
+  EntitySolidBoundsRenderer m_solidBoundsRenderer;
 
-  TriangleRenderer m_solidBoundsRenderer;
   EntityModelRenderer m_modelRenderer;
   bool m_boundsValid = false;
+  kdl::vector_set<const mdl::EntityNode*> m_invalidBounds;
 
   bool m_showOverlays = true;
   Color m_overlayTextColor;
@@ -142,8 +157,12 @@ private:
   void renderAngles(RenderContext& renderContext, RenderBatch& renderBatch);
   std::vector<vm::vec3f> arrowHead(float length, float width) const;
 
+  void resetBounds();
   void invalidateBounds();
+  void invalidateBounds(const mdl::EntityNode* entityNode);
   void validateBounds();
+  void updateBounds(const mdl::EntityNode* entityNode);
+  void removeBounds(const mdl::EntityNode* entityNode);
 
   AttrString entityString(const mdl::EntityNode* entityNode) const;
   const Color& boundsColor(const mdl::EntityNode* entityNode) const;
@@ -23,11 +23,47 @@
 
 #include <format>
 
+#include <numeric>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 
 namespace tb
 {
+namespace
+{
+
+// draw calls are only ever issued on the main thread
+size_t currentFrameDrawCallCount = 0;
+auto lastFrameDrawCallCounts = std::unordered_map<const void*, size_t>{};
+
+} // namespace
+
+void glCountDrawCall()
+{
+  ++currentFrameDrawCallCount;
+}
+
+void glFinishFrame(const void* view)
+{
+  lastFrameDrawCallCounts[view] = currentFrameDrawCallCount;
+  currentFrameDrawCallCount = 0;
+}
+
+void glDiscardFrame(const void* view)
+{
+  lastFrameDrawCallCounts.erase(view);
+}
+
+size_t glLastFrameDrawCallCount()
+{
+  return std::accumulate(
+    lastFrameDrawCallCounts.begin(),
+    lastFrameDrawCallCounts.end(),
+    size_t(0),
+    [](const auto total, const auto& pair) { return total + pair.second; });
+}
+
 void glCheckError(const std::string& msg)
 {
   const GLenum error = glGetError();
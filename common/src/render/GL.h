@@ -36,6 +36,29 @@ std::string glGetErrorMessage(GLenum code);
 GLenum glGetEnum(const std::string& name);
 std::string glGetEnumName(GLenum _enum);
 
+/**
+ * Counts a draw call. Must be called whenever a draw call is issued so that the number of
+ * draw calls per frame can be reported.
+ */
+void glCountDrawCall();
+
+/**
+ * Ends the current frame of the given view. The draw calls counted since the previous
+ * frame of any view ended become the draw calls of the last frame of the given view.
+ */
+void glFinishFrame(const void* view);
+
+/**
+ * Discards the last frame of the given view. Must be called when the view is destroyed.
+ */
+void glDiscardFrame(const void* view);
+
+/**
+ * Returns the number of draw calls issued by the last finished frames of all views, i.e.
+ * the number of draw calls needed to render every view once.
+ */
+size_t glLastFrameDrawCallCount();
+
 // #define GL_DEBUG 1
 // #define GL_LOG 1
 
@@ -120,6 +120,7 @@ private:
   private:
     void doRender(PrimType primType, size_t offset, size_t count) const override
     {
+      glCountDrawCall();
       glAssert(glDrawElements(
         toGL(primType),
         static_cast<GLsizei>(count),
@@ -28,74 +28,27 @@
 
 #include "kd/contracts.h"
 
-namespace tb::render
-{
-
-LinkRenderer::LinkRenderer() = default;
-
-void LinkRenderer::render(RenderContext&, RenderBatch& renderBatch)
-{
-  renderBatch.add(this);
-}
-
-void LinkRenderer::invalidate()
-{
-  m_valid = false;
-}
+#include "vm/plane.h"
+#include "vm/vec.h"
 
-void LinkRenderer::doPrepareVertices(VboManager& vboManager)
-{
-  if (!m_valid)
-  {
-    validate();
+#include <algorithm>
+#include <array>
+#include <ranges>
 
-    m_lines.prepare(vboManager);
-    m_arrows.prepare(vboManager);
-  }
-}
-
-void LinkRenderer::doRender(RenderContext& renderContext)
+namespace tb::render
 {
-  contract_pre(m_valid);
-
-  renderLines(renderContext);
-  renderArrows(renderContext);
-}
-
-void LinkRenderer::renderLines(RenderContext& renderContext)
+namespace
 {
-  auto shader = ActiveShader{renderContext.shaderManager(), Shaders::LinkLineShader};
-  shader.set("CameraPosition", renderContext.camera().position());
-  shader.set("IsOrtho", renderContext.camera().orthographicProjection());
-  shader.set("MaxDistance", 6000.0f);
-
-  glAssert(glDisable(GL_DEPTH_TEST));
-  shader.set("Alpha", 0.4f);
-  m_lines.render(PrimType::Lines);
 
-  glAssert(glEnable(GL_DEPTH_TEST));
-  shader.set("Alpha", 1.0f);
-  m_lines.render(PrimType::Lines);
-}
-
-void LinkRenderer::renderArrows(RenderContext& renderContext)
-{
-  auto shader = ActiveShader{renderContext.shaderManager(), Shaders::LinkArrowShader};
-  shader.set("CameraPosition", renderContext.camera().position());
-  shader.set("IsOrtho", renderContext.camera().orthographicProjection());
-  shader.set("MaxDistance", 6000.0f);
-  shader.set("Zoom", renderContext.camera().zoom());
+constexpr auto MaxDistance = 6000.0f;
 
-  glAssert(glDisable(GL_DEPTH_TEST));
-  shader.set("Alpha", 0.4f);
-  m_arrows.render(PrimType::Lines);
+// the link shaders fade links out completely at this distance from a perspective camera
+constexpr auto FadeOutDistance = MaxDistance * 3.75f;
 
-  glAssert(glEnable(GL_DEPTH_TEST));
-  shader.set("Alpha", 1.0f);
-  m_arrows.render(PrimType::Lines);
-}
+// arrows are scaled up to four times their size of 9 units
+constexpr auto MaxArrowSize = 36.0f;
 
-static void addArrow(
+void addArrow(
   std::vector<LinkRenderer::ArrowVertex>& arrows,
   const vm::vec4f& color,
   const vm::vec3f& arrowPosition,
@@ -108,7 +61,7 @@ static void addArrow(
   arrows.emplace_back(vm::vec3f{0, -3, 0}, color, arrowPosition, lineDir);
 }
 
-static std::vector<LinkRenderer::ArrowVertex> getArrows(
+std::vector<LinkRenderer::ArrowVertex> getArrows(
   const std::vector<LinkRenderer::LineVertex>& links)
 {
   contract_pre((links.size() % 2) == 0);
@@ -152,15 +105,243 @@ static std::vector<LinkRenderer::ArrowVertex> getArrows(
   return arrows;
 }
 
-void LinkRenderer::validate()
+vm::bbox3f getBounds(const std::vector<LinkRenderer::LineVertex>& links)
+{
+  auto builder = vm::bbox3f::builder{};
+  for (const auto& vertex : links)
+  {
+    builder.add(getVertexComponent<0>(vertex));
+  }
+  return builder.bounds().expand(MaxArrowSize);
+}
+
+template <typename Vertex>
+AllocationTracker::Block* addVertices(
+  VertexBlockArray<Vertex>& array, const std::vector<Vertex>& vertices)
+{
+  auto [block, dest] = array.allocate(vertices.size());
+  std::ranges::copy(vertices, dest);
+  return block;
+}
+
+/**
+ * Indicates whether the given bounds are entirely above the given plane.
+ */
+bool isAbove(const vm::bbox3f& bounds, const vm::plane3f& plane)
+{
+  // the corner of the bounds that is farthest below the plane
+  const auto corner = vm::vec3f{
+    plane.normal.x() >= 0.0f ? bounds.min.x() : bounds.max.x(),
+    plane.normal.y() >= 0.0f ? bounds.min.y() : bounds.max.y(),
+    plane.normal.z() >= 0.0f ? bounds.min.z() : bounds.max.z(),
+  };
+  return plane.point_distance(corner) > 0.0f;
+}
+
+bool isVisible(
+  const vm::bbox3f& bounds,
+  const Camera& camera,
+  const std::array<vm::plane3f, 4>& frustumPlanes)
+{
+  if (camera.perspectiveProjection())
+  {
+    const auto& position = camera.position();
+    const auto closestPoint = vm::max(bounds.min, vm::min(position, bounds.max));
+    if (vm::squared_distance(position, closestPoint) >= FadeOutDistance * FadeOutDistance)
+    {
+      return false;
+    }
+  }
+
+  return std::ranges::none_of(
+    frustumPlanes, [&](const auto& plane) { return isAbove(bounds, plane); });
+}
+
+void multiDrawArrays(
+  const PrimType primType,
+  const std::vector<GLint>& firsts,
+  const std::vector<GLsizei>& counts)
+{
+  glCountDrawCall();
+  glAssert(glMultiDrawArrays(
+    toGL(primType), firsts.data(), counts.data(), static_cast<GLsizei>(firsts.size())));
+}
+
+} // namespace
+
+LinkRenderer::LinkRenderer() = default;
+
+LinkRenderer::~LinkRenderer() = default;
+
+void LinkRenderer::render(RenderContext&, RenderBatch& renderBatch)
+{
+  renderBatch.add(this);
+}
+
+void LinkRenderer::invalidate()
+{
+  m_valid = false;
+}
+
+void LinkRenderer::setLinks(const void* key, const std::vector<LineVertex>& links)
 {
-  auto links = getLinks();
-  auto arrows = getArrows(links);
+  removeLinks(key);
 
-  m_lines = VertexArray::move(std::move(links));
-  m_arrows = VertexArray::move(std::move(arrows));
+  if (!links.empty())
+  {
+    const auto arrows = getArrows(links);
+    m_linkBlocks[key] = LinkBlocks{
+      addVertices(m_lines, links),
+      addVertices(m_arrows, arrows),
+      getBounds(links),
+    };
+  }
+}
+
+void LinkRenderer::removeLinks(const void* key)
+{
+  if (const auto it = m_linkBlocks.find(key); it != m_linkBlocks.end())
+  {
+    m_lines.free(it->second.lines);
+    m_arrows.free(it->second.arrows);
+    m_linkBlocks.erase(it);
+  }
+}
+
+void LinkRenderer::clearLinks()
+{
+  for (const auto& [key, linkBlocks] : m_linkBlocks)
+  {
+    m_lines.free(linkBlocks.lines);
+    m_arrows.free(linkBlocks.arrows);
+  }
+  m_linkBlocks.clear();
+}
+
+template <typename F>
+void LinkRenderer::visitVisibleLinks(const Camera& camera, const F& f) const
+{
+  auto frustumPlanes = std::array<vm::plane3f, 4>{};
+  camera.frustumPlanes(
+    frustumPlanes[0], frustumPlanes[1], frustumPlanes[2], frustumPlanes[3]);
+
+  for (const auto& [key, linkBlocks] : m_linkBlocks)
+  {
+    if (isVisible(linkBlocks.bounds, camera, frustumPlanes))
+    {
+      f(key, linkBlocks);
+    }
+  }
+}
+
+void LinkRenderer::prepareLinks()
+{
+  if (!m_valid)
+  {
+    validate();
+  }
+  else
+  {
+    updateLinks();
+  }
+}
+
+std::vector<const void*> LinkRenderer::visibleLinks(const Camera& camera) const
+{
+  auto keys = std::vector<const void*>{};
+  visitVisibleLinks(camera, [&](const auto* key, const auto&) { keys.push_back(key); });
+  return keys;
+}
+
+void LinkRenderer::doPrepareVertices(VboManager& vboManager)
+{
+  prepareLinks();
+
+  m_lines.prepare(vboManager);
+  m_arrows.prepare(vboManager);
+}
+
+void LinkRenderer::doRender(RenderContext& renderContext)
+{
+  contract_pre(m_valid);
+
+  const auto addDrawRange = [](auto& drawRanges, const auto* block) {
+    drawRanges.firsts.push_back(static_cast<GLint>(block->pos));
+    drawRanges.counts.push_back(static_cast<GLsizei>(block->size));
+  };
+
+  auto lineRanges = DrawRanges{};
+  auto arrowRanges = DrawRanges{};
+  visitVisibleLinks(renderContext.camera(), [&](const auto*, const auto& linkBlocks) {
+    addDrawRange(lineRanges, linkBlocks.lines);
+    addDrawRange(arrowRanges, linkBlocks.arrows);
+  });
+
+  if (!lineRanges.firsts.empty())
+  {
+    renderLines(renderContext, lineRanges);
+    renderArrows(renderContext, arrowRanges);
+  }
+}
+
+void LinkRenderer::renderLines(
+  RenderContext& renderContext, const DrawRanges& drawRanges)
+{
+  auto shader = ActiveShader{renderContext.shaderManager(), Shaders::LinkLineShader};
+  shader.set("CameraPosition", renderContext.camera().position());
+  shader.set("IsOrtho", renderContext.camera().orthographicProjection());
+  shader.set("MaxDistance", MaxDistance);
+
+  if (m_lines.setupVertices())
+  {
+    glAssert(glDisable(GL_DEPTH_TEST));
+    shader.set("Alpha", 0.4f);
+    multiDrawArrays(PrimType::Lines, drawRanges.firsts, drawRanges.counts);
+
+    glAssert(glEnable(GL_DEPTH_TEST));
+    shader.set("Alpha", 1.0f);
+    multiDrawArrays(PrimType::Lines, drawRanges.firsts, drawRanges.counts);
+
+    m_lines.cleanupVertices();
+  }
+}
+
+void LinkRenderer::renderArrows(
+  RenderContext& renderContext, const DrawRanges& drawRanges)
+{
+  auto shader = ActiveShader{renderContext.shaderManager(), Shaders::LinkArrowShader};
+  shader.set("CameraPosition", renderContext.camera().position());
+  shader.set("IsOrtho", renderContext.camera().orthographicProjection());
+  shader.set("MaxDistance", MaxDistance);
+  shader.set("Zoom", renderContext.camera().zoom());
+
+  if (m_arrows.setupVertices())
+  {
+    glAssert(glDisable(GL_DEPTH_TEST));
+    shader.set("Alpha", 0.4f);
+    multiDrawArrays(PrimType::Lines, drawRanges.firsts, drawRanges.counts);
+
+    glAssert(glEnable(GL_DEPTH_TEST));
+    shader.set("Alpha", 1.0f);
+    multiDrawArrays(PrimType::Lines, drawRanges.firsts, drawRanges.counts);
+
+    m_arrows.cleanupVertices();
+  }
+}
+
+void LinkRenderer::validate()
+{
+  clearLinks();
+  collectLinks();
 
   m_valid = true;
 }
 
+void LinkRenderer::collectLinks()
+{
+  setLinks(this, getLinks());
+}
+
+void LinkRenderer::updateLinks() {}
+
 } // namespace tb::render
@@ -19,12 +19,21 @@
 
 #pragma once
 
+#include "Macros.h"
+#include "render/AllocationTracker.h"
+#include "render/BrushRendererArrays.h"
 #include "render/GLVertexType.h"
 #include "render/Renderable.h"
-#include "render/VertexArray.h"
+
+#include "vm/bbox.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace tb::render
 {
+class Camera;
 class RenderContext;
 class RenderBatch;
 class VboManager;
@@ -51,26 +60,82 @@ public:
     GLVertexAttributeUser<LineDirName, GL_FLOAT, 3, false>>::Vertex; // direction the
                                                                      // arrow is pointing
 private:
-  VertexArray m_lines;
-  VertexArray m_arrows;
+  struct LinkBlocks
+  {
+    AllocationTracker::Block* lines = nullptr;
+    AllocationTracker::Block* arrows = nullptr;
+    vm::bbox3f bounds;
+  };
+
+  struct DrawRanges
+  {
+    std::vector<GLint> firsts;
+    std::vector<GLsizei> counts;
+  };
+
+  VertexBlockArray<LineVertex> m_lines;
+  VertexBlockArray<ArrowVertex> m_arrows;
+  std::unordered_map<const void*, LinkBlocks> m_linkBlocks;
 
   bool m_valid = false;
 
 public:
   LinkRenderer();
+  ~LinkRenderer() override;
 
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
+
+  /**
+   * Causes all links to be collected again before they are rendered next.
+   */
   void invalidate();
 
+  /**
+   * Collects the links if this renderer was invalidated, and updates the links that have
+   * changed otherwise. Called before the links are rendered.
+   */
+  void prepareLinks();
+
+  /**
+   * Returns the keys of the stored links that are not culled for the given camera.
+   */
+  std::vector<const void*> visibleLinks(const Camera& camera) const;
+
+protected:
+  /**
+   * Replaces the links stored under the given key.
+   *
+   * The links of a key are culled together, so they should be close to each other.
+   */
+  void setLinks(const void* key, const std::vector<LineVertex>& links);
+  void removeLinks(const void* key);
+  void clearLinks();
+
 private:
   void doPrepareVertices(VboManager& vboManager) override;
   void doRender(RenderContext& renderContext) override;
 
-  void renderLines(RenderContext& renderContext);
-  void renderArrows(RenderContext& renderContext);
+  void renderLines(RenderContext& renderContext, const DrawRanges& drawRanges);
+  void renderArrows(RenderContext& renderContext, const DrawRanges& drawRanges);
 
   void validate();
 
+  template <typename F>
+  void visitVisibleLinks(const Camera& camera, const F& f) const;
+
+  /**
+   * Stores all links using setLinks(). Called after the renderer was invalidated.
+   *
+   * By default, the links returned by getLinks() are stored under a single key.
+   */
+  virtual void collectLinks();
+
+  /**
+   * Updates the stored links that have changed since they were collected. Called before
+   * the links are rendered if the renderer is still valid.
+   */
+  virtual void updateLinks();
+
   virtual std::vector<LinkRenderer::LineVertex> getLinks() = 0;
 
   deleteCopy(LinkRenderer);
@@ -33,6 +33,7 @@
 #include "mdl/Map.h"
 #include "mdl/MaterialManager.h"
 #include "mdl/Node.h"
+#include "mdl/NodeChanges.h"
 #include "mdl/NodeQueries.h"
 #include "mdl/PatchNode.h"
 #include "mdl/SelectionChange.h"
@@ -646,22 +647,12 @@ void MapRenderer::reloadEntityModels()
 
 void MapRenderer::connectObservers()
 {
-  m_notifierConnection +=
-    m_map.nodesWereAddedNotifier.connect(this, &MapRenderer::nodesWereAdded);
-  m_notifierConnection +=
-    m_map.nodesWereRemovedNotifier.connect(this, &MapRenderer::nodesWereRemoved);
-  m_notifierConnection +=
-    m_map.nodesDidChangeNotifier.connect(this, &MapRenderer::nodesDidChange);
-  m_notifierConnection += m_map.nodeVisibilityDidChangeNotifier.connect(
-    this, &MapRenderer::nodeVisibilityDidChange);
-  m_notifierConnection +=
-    m_map.nodeLockingDidChangeNotifier.connect(this, &MapRenderer::nodeLockingDidChange);
+  m_notifierConnection += m_map.coalescedNodeChangesNotifier.connect(
+    this, &MapRenderer::coalescedNodeChanges);
   m_notifierConnection +=
     m_map.groupWasOpenedNotifier.connect(this, &MapRenderer::groupWasOpened);
   m_notifierConnection +=
     m_map.groupWasClosedNotifier.connect(this, &MapRenderer::groupWasClosed);
-  m_notifierConnection +=
-    m_map.selectionDidChangeNotifier.connect(this, &MapRenderer::selectionDidChange);
   m_notifierConnection += m_map.resourcesWereProcessedNotifier.connect(
     this, &MapRenderer::resourcesWereProcessed);
   m_notifierConnection += m_map.materialCollectionsWillChangeNotifier.connect(
@@ -678,6 +669,26 @@ void MapRenderer::connectObservers()
     prefs.preferenceDidChangeNotifier.connect(this, &MapRenderer::preferenceDidChange);
 }
 
+void MapRenderer::coalescedNodeChanges(const mdl::NodeChanges& nodeChanges)
+{
+  nodesWereRemoved(nodeChanges.removedNodes);
+  nodesWereAdded(nodeChanges.addedNodes);
+  nodesDidChange(nodeChanges.changedNodes);
+  nodeVisibilityDidChange(nodeChanges.visibilityChangedNodes);
+  nodeLockingDidChange(nodeChanges.lockingChangedNodes);
+  selectionDidChange(nodeChanges.selectionChange);
+
+  m_entityLinkRenderer->removeNodes(nodeChanges.removedNodes);
+  m_entityLinkRenderer->invalidateNodesRecursive(nodeChanges.addedNodes);
+  m_entityLinkRenderer->invalidateNodes(nodeChanges.changedNodes);
+  m_entityLinkRenderer->invalidateNodesRecursive(nodeChanges.visibilityChangedNodes);
+  m_entityLinkRenderer->invalidateNodesRecursive(
+    nodeChanges.selectionChange.selectedNodes);
+  m_entityLinkRenderer->invalidateNodesRecursive(
+    nodeChanges.selectionChange.deselectedNodes);
+  invalidateGroupLinkRenderer();
+}
+
 void MapRenderer::nodesWereAdded(const std::vector<mdl::Node*>& nodes)
 {
   for (auto* node : nodes)
@@ -686,8 +697,6 @@ void MapRenderer::nodesWereAdded(const std::vector<mdl::Node*>& nodes)
     // ourselves.
     updateAndInvalidateNodeRecursive(*node);
   }
-  invalidateGroupLinkRenderer();
-  invalidateEntityLinkRenderer();
 }
 
 void MapRenderer::nodesWereRemoved(const std::vector<mdl::Node*>& nodes)
@@ -698,8 +707,6 @@ void MapRenderer::nodesWereRemoved(const std::vector<mdl::Node*>& nodes)
     // ourselves. Otherwise deleting a group doesn't delete the brushes within.
     removeNodeRecursive(*node);
   }
-  invalidateGroupLinkRenderer();
-  invalidateEntityLinkRenderer();
 }
 
 void MapRenderer::nodesDidChange(const std::vector<mdl::Node*>& nodes)
@@ -728,8 +735,6 @@ void MapRenderer::nodesDidChange(const std::vector<mdl::Node*>& nodes)
     // change.
     updateAndInvalidateNode(*node);
   }
-  invalidateEntityLinkRenderer();
-  invalidateGroupLinkRenderer();
 }
 
 void MapRenderer::nodeVisibilityDidChange(const std::vector<mdl::Node*>& nodes)
@@ -738,7 +743,6 @@ void MapRenderer::nodeVisibilityDidChange(const std::vector<mdl::Node*>& nodes)
   {
     updateAndInvalidateNodeRecursive(*node);
   }
-  invalidateEntityLinkRenderer();
 }
 
 void MapRenderer::nodeLockingDidChange(const std::vector<mdl::Node*>& nodes)
@@ -747,7 +751,6 @@ void MapRenderer::nodeLockingDidChange(const std::vector<mdl::Node*>& nodes)
   {
     updateAndInvalidateNodeRecursive(*node);
   }
-  invalidateEntityLinkRenderer();
 }
 
 void MapRenderer::groupWasOpened()
@@ -782,9 +785,6 @@ void MapRenderer::selectionDidChange(const mdl::SelectionChange& selectionChange
   {
     updateAndInvalidateNodeRecursive(*node);
   }
-
-  invalidateEntityLinkRenderer();
-  invalidateGroupLinkRenderer();
 }
 
 void MapRenderer::resourcesWereProcessed(const std::vector<mdl::ResourceId>& resourceIds)
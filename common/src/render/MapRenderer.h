@@ -38,6 +38,7 @@ class LayerNode;
 class Map;
 class Node;
 class ResourceId;
+struct NodeChanges;
 struct SelectionChange;
 } // namespace mdl
 
@@ -120,6 +121,7 @@ private:
 private: // notification
   void connectObservers();
 
+  void coalescedNodeChanges(const mdl::NodeChanges& nodeChanges);
   void nodesWereAdded(const std::vector<mdl::Node*>& nodes);
   void nodesWereRemoved(const std::vector<mdl::Node*>& nodes);
   void nodesDidChange(const std::vector<mdl::Node*>& nodes);
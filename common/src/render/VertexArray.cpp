@@ -96,12 +96,14 @@ void VertexArray::render(const PrimType primType, const GLint index, const GLsiz
   {
     if (setup())
     {
+      glCountDrawCall();
       glAssert(glDrawArrays(toGL(primType), index, count));
       cleanup();
     }
   }
   else
   {
+    glCountDrawCall();
     glAssert(glDrawArrays(toGL(primType), index, count));
   }
 }
@@ -120,6 +122,7 @@ void VertexArray::render(
     {
       const auto* indexArray = indices.data();
       const auto* countArray = counts.data();
+      glCountDrawCall();
       glAssert(glMultiDrawArrays(toGL(primType), indexArray, countArray, primCount));
       cleanup();
     }
@@ -128,6 +131,7 @@ void VertexArray::render(
   {
     const auto* indexArray = indices.data();
     const auto* countArray = counts.data();
+    glCountDrawCall();
     glAssert(glMultiDrawArrays(toGL(primType), indexArray, countArray, primCount));
   }
 }
@@ -142,6 +146,7 @@ void VertexArray::render(
     if (setup())
     {
       const auto* indexArray = indices.data();
+      glCountDrawCall();
       glAssert(glDrawElements(toGL(primType), count, GL_UNSIGNED_INT, indexArray));
       cleanup();
     }
@@ -149,6 +154,7 @@ void VertexArray::render(
   else
   {
     const auto* indexArray = indices.data();
+    glCountDrawCall();
     glAssert(glDrawElements(toGL(primType), count, GL_UNSIGNED_INT, indexArray));
   }
 }
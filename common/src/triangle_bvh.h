@@ -0,0 +1,352 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/bbox.h"
+#include "vm/constants.h"
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+namespace tb
+{
+
+/**
+ * A bounding volume hierarchy over a fixed set of triangles that allows for quick ray
+ * intersection queries.
+ *
+ * The hierarchy is stored in a flat array of nodes in depth first order, so the left
+ * child of an inner node immediately follows it. The triangles of each leaf are stored in
+ * packets of packet_size triangles with one array per coordinate so that a ray is tested
+ * against all triangles of a packet at once in loops that the compiler can vectorize.
+ *
+ * @tparam T the floating point type
+ */
+template <typename T>
+class triangle_bvh
+{
+public:
+  static constexpr size_t packet_size = 4;
+
+private:
+  static constexpr size_t max_leaf_size = 2 * packet_size;
+  static constexpr size_t max_depth = 64;
+
+  using vec3 = vm::vec<T, 3>;
+  using lane = std::array<T, packet_size>;
+
+  struct node
+  {
+    vm::bbox<T, 3> bounds;
+    // the index of the first packet of a leaf or of the right child of an inner node
+    uint32_t index;
+    // the number of packets of a leaf, or 0 for an inner node
+    uint32_t packet_count;
+  };
+
+  struct packet
+  {
+    // the first point of each triangle and the two edges starting there, unused lanes
+    // contain degenerate triangles
+    std::array<lane, 3> p;
+    std::array<lane, 3> e1;
+    std::array<lane, 3> e2;
+  };
+
+  std::vector<node> m_nodes;
+  std::vector<packet> m_packets;
+
+public:
+  triangle_bvh() = default;
+
+  /**
+   * Builds a hierarchy over the given triangles. Each three consecutive points form a
+   * triangle.
+   */
+  explicit triangle_bvh(const std::vector<vec3>& points)
+  {
+    const auto triangle_count = points.size() / 3;
+    if (triangle_count == 0)
+    {
+      return;
+    }
+
+    auto centers = std::vector<vec3>{};
+    centers.reserve(triangle_count);
+    for (size_t i = 0; i < triangle_count; ++i)
+    {
+      centers.push_back((points[3 * i] + points[3 * i + 1] + points[3 * i + 2]) / T(3));
+    }
+
+    auto triangles = std::vector<size_t>(triangle_count);
+    std::iota(triangles.begin(), triangles.end(), size_t(0));
+
+    m_nodes.reserve(2 * (triangle_count / packet_size) + 1);
+    m_packets.reserve(triangle_count / packet_size + 1);
+    build(points, centers, triangles, 0, triangle_count);
+  }
+
+  /**
+   * Indicates whether this hierarchy contains no triangles.
+   */
+  bool empty() const { return m_nodes.empty(); }
+
+  /**
+   * Returns the distance from the origin of the given ray to the closest triangle it
+   * hits, or nullopt if it hits none. Triangles behind the origin of the ray are ignored.
+   */
+  std::optional<T> intersect(const vm::ray<T, 3>& ray) const
+  {
+    if (m_nodes.empty())
+    {
+      return std::nullopt;
+    }
+
+    constexpr auto no_hit = std::numeric_limits<T>::infinity();
+    auto closest = no_hit;
+
+    struct entry
+    {
+      uint32_t index;
+      T distance;
+    };
+
+    auto stack = std::array<entry, max_depth>{};
+    auto stack_size = size_t(0);
+
+    if (const auto distance = intersect_bounds(ray, m_nodes.front().bounds);
+        distance < no_hit)
+    {
+      stack[stack_size++] = {0, distance};
+    }
+
+    while (stack_size > 0)
+    {
+      const auto [index, distance] = stack[--stack_size];
+      if (distance >= closest)
+      {
+        continue;
+      }
+
+      const auto& current = m_nodes[index];
+      if (current.packet_count > 0)
+      {
+        for (size_t i = 0; i < current.packet_count; ++i)
+        {
+          closest = std::min(closest, intersect_packet(ray, m_packets[current.index + i]));
+        }
+      }
+      else
+      {
+        const auto left = index + 1;
+        const auto right = current.index;
+        const auto left_distance = intersect_bounds(ray, m_nodes[left].bounds);
+        const auto right_distance = intersect_bounds(ray, m_nodes[right].bounds);
+
+        // push the farther child first so that the nearer child is visited first
+        const auto left_first = left_distance <= right_distance;
+        const auto near = left_first ? entry{left, left_distance}
+                                     : entry{right, right_distance};
+        const auto far = left_first ? entry{right, right_distance}
+                                    : entry{left, left_distance};
+
+        if (far.distance < closest)
+        {
+          stack[stack_size++] = far;
+        }
+        if (near.distance < closest)
+        {
+          stack[stack_size++] = near;
+        }
+      }
+    }
+
+    return closest < no_hit ? std::optional{closest} : std::nullopt;
+  }
+
+private:
+  void build(
+    const std::vector<vec3>& points,
+    const std::vector<vec3>& centers,
+    std::vector<size_t>& triangles,
+    const size_t begin,
+    const size_t end)
+  {
+    auto bounds = typename vm::bbox<T, 3>::builder{};
+    auto center_bounds = typename vm::bbox<T, 3>::builder{};
+    for (size_t i = begin; i < end; ++i)
+    {
+      const auto triangle = triangles[i];
+      bounds.add(points[3 * triangle]);
+      bounds.add(points[3 * triangle + 1]);
+      bounds.add(points[3 * triangle + 2]);
+      center_bounds.add(centers[triangle]);
+    }
+
+    // allow for the tolerance of the triangle test at the faces of the bounds
+    const auto node_index = m_nodes.size();
+    m_nodes.push_back({bounds.bounds().expand(vm::constants<T>::almost_zero()), 0, 0});
+
+    const auto count = end - begin;
+    if (count <= max_leaf_size)
+    {
+      m_nodes[node_index].index = uint32_t(m_packets.size());
+      m_nodes[node_index].packet_count =
+        uint32_t((count + packet_size - 1) / packet_size);
+      add_packets(points, triangles, begin, end);
+      return;
+    }
+
+    // split at the median of the triangle centers along the longest axis
+    const auto size = center_bounds.bounds().size();
+    const auto axis = size.x() >= size.y() && size.x() >= size.z() ? size_t(0)
+                      : size.y() >= size.z()                       ? size_t(1)
+                                                                   : size_t(2);
+
+    const auto mid = begin + count / 2;
+    std::nth_element(
+      triangles.begin() + std::ptrdiff_t(begin),
+      triangles.begin() + std::ptrdiff_t(mid),
+      triangles.begin() + std::ptrdiff_t(end),
+      [&](const auto lhs, const auto rhs) {
+        return centers[lhs][axis] < centers[rhs][axis];
+      });
+
+    build(points, centers, triangles, begin, mid);
+    m_nodes[node_index].index = uint32_t(m_nodes.size());
+    build(points, centers, triangles, mid, end);
+  }
+
+  void add_packets(
+    const std::vector<vec3>& points,
+    const std::vector<size_t>& triangles,
+    const size_t begin,
+    const size_t end)
+  {
+    for (size_t i = begin; i < end; i += packet_size)
+    {
+      auto& current = m_packets.emplace_back();
+      for (size_t j = 0; j < packet_size && i + j < end; ++j)
+      {
+        const auto triangle = triangles[i + j];
+        const auto& p1 = points[3 * triangle];
+        const auto e1 = points[3 * triangle + 1] - p1;
+        const auto e2 = points[3 * triangle + 2] - p1;
+        for (size_t c = 0; c < 3; ++c)
+        {
+          current.p[c][j] = p1[c];
+          current.e1[c][j] = e1[c];
+          current.e2[c][j] = e2[c];
+        }
+      }
+    }
+  }
+
+  /**
+   * Returns the distance at which the given ray enters the given bounds, 0 if its origin
+   * is inside of the bounds, or infinity if the ray misses the bounds.
+   */
+  static T intersect_bounds(const vm::ray<T, 3>& ray, const vm::bbox<T, 3>& bounds)
+  {
+    constexpr auto no_hit = std::numeric_limits<T>::infinity();
+
+    auto near = T(0);
+    auto far = no_hit;
+    for (size_t i = 0; i < 3; ++i)
+    {
+      const auto origin = ray.origin[i];
+      const auto direction = ray.direction[i];
+      if (direction == T(0))
+      {
+        if (origin < bounds.min[i] || origin > bounds.max[i])
+        {
+          return no_hit;
+        }
+        continue;
+      }
+
+      const auto t1 = (bounds.min[i] - origin) / direction;
+      const auto t2 = (bounds.max[i] - origin) / direction;
+      near = std::max(near, std::min(t1, t2));
+      far = std::min(far, std::max(t1, t2));
+    }
+
+    return near <= far ? near : no_hit;
+  }
+
+  /**
+   * Returns the distance to the closest triangle of the given packet that the given ray
+   * hits, or infinity if it hits none.
+   *
+   * This is the test implemented by vm::intersect_ray_triangle, written so that every
+   * lane of the packet is processed without branches.
+   */
+  static T intersect_packet(const vm::ray<T, 3>& ray, const packet& packet)
+  {
+    constexpr auto no_hit = std::numeric_limits<T>::infinity();
+    constexpr auto epsilon = vm::constants<T>::almost_zero();
+
+    const auto ox = ray.origin.x(), oy = ray.origin.y(), oz = ray.origin.z();
+    const auto dx = ray.direction.x(), dy = ray.direction.y(), dz = ray.direction.z();
+
+    auto distances = lane{};
+    for (size_t j = 0; j < packet_size; ++j)
+    {
+      const auto e1x = packet.e1[0][j], e1y = packet.e1[1][j], e1z = packet.e1[2][j];
+      const auto e2x = packet.e2[0][j], e2y = packet.e2[1][j], e2z = packet.e2[2][j];
+
+      // p = d x e2, a = p . e1
+      const auto px = dy * e2z - dz * e2y;
+      const auto py = dz * e2x - dx * e2z;
+      const auto pz = dx * e2y - dy * e2x;
+      const auto a = px * e1x + py * e1y + pz * e1z;
+
+      // t = o - p1, q = t x e1
+      const auto tx = ox - packet.p[0][j];
+      const auto ty = oy - packet.p[1][j];
+      const auto tz = oz - packet.p[2][j];
+      const auto qx = ty * e1z - tz * e1y;
+      const auto qy = tz * e1x - tx * e1z;
+      const auto qz = tx * e1y - ty * e1x;
+
+      const auto valid = std::abs(a) > epsilon;
+      const auto inv_a = T(1) / (valid ? a : T(1));
+      const auto distance = (qx * e2x + qy * e2y + qz * e2z) * inv_a;
+      const auto v = (px * tx + py * ty + pz * tz) * inv_a;
+      const auto w = (qx * dx + qy * dy + qz * dz) * inv_a;
+
+      const auto hit = valid && distance >= T(0) && v >= -epsilon && w >= -epsilon
+                       && v + w - T(1) <= epsilon;
+      distances[j] = hit ? distance : no_hit;
+    }
+
+    return *std::min_element(distances.begin(), distances.end());
+  }
+};
+
+} // namespace tb
@@ -1077,6 +1077,17 @@ void ActionManager::createFileMenu()
     [](auto& context) { context.frame().exportDocumentAsObj(); },
     [](const auto& context) { return context.hasDocument(); },
   }));
+  exportMenu.addItem(addAction(Action{
+    "Menu/File/Export/Binary glTF...",
+    QObject::tr("Binary glTF..."),
+    ActionContext::Any,
+    QKeySequence{},
+    [](auto& context) { context.frame().exportDocumentAsGlb(); },
+    [](const auto& context) { return context.hasDocument(); },
+    std::nullopt,
+    QObject::tr("Exports the brushes and patches of the current map to a binary glTF "
+                "file. Layers marked Omit From Export will be omitted."),
+  }));
   exportMenu.addItem(addAction(Action{
     "Menu/File/Export/Map...",
     QObject::tr("Map..."),
@@ -2231,6 +2242,17 @@ void ActionManager::createHelpMenu()
     },
     [](const auto&) { return true; },
   }));
+  helpMenu.addItem(addAction(Action{
+    "Menu/Help/Save Trace...",
+    QObject::tr("Save Trace..."),
+    ActionContext::Any,
+    QKeySequence{},
+    [](auto&) {
+      auto& app = TrenchBroomApp::instance();
+      app.saveTrace();
+    },
+    [](const auto&) { return true; },
+  }));
   helpMenu.addItem(addAction(Action{
     "Menu/File/About BrumSchtick",
     QObject::tr("About BrümSchtick"),
@@ -22,6 +22,8 @@
 #include "kd/contracts.h"
 
 #include <algorithm>
+#include <functional>
+#include <iterator>
 
 namespace tb::ui
 {
@@ -210,26 +212,16 @@ const std::vector<LayoutCell>& LayoutRow::cells() const
   return m_cells;
 }
 
+std::vector<LayoutCell>& LayoutRow::cells()
+{
+  return m_cells;
+}
+
 const LayoutCell* LayoutRow::cellAt(const float x, const float y) const
 {
-  for (size_t i = 0; i < m_cells.size(); ++i)
-  {
-    const auto& cell = m_cells[i];
-    const auto& cellBounds = cell.cellBounds();
-    if (x > cellBounds.right())
-    {
-      continue;
-    }
-    if (x < cellBounds.left())
-    {
-      return nullptr;
-    }
-    if (cell.hitTest(x, y))
-    {
-      return &cell;
-    }
-  }
-  return nullptr;
+  const auto it = std::ranges::partition_point(
+    m_cells, [&](const auto& cell) { return x > cell.cellBounds().right(); });
+  return it != m_cells.end() && it->hitTest(x, y) ? &*it : nullptr;
 }
 
 bool LayoutRow::intersectsY(const float y, const float height) const
@@ -446,42 +438,34 @@ const std::vector<LayoutRow>& LayoutGroup::rows() const
   return m_rows;
 }
 
-size_t LayoutGroup::indexOfRowAt(const float y) const
+std::vector<LayoutRow>& LayoutGroup::rows()
 {
-  for (size_t i = 0; i < m_rows.size(); ++i)
-  {
-    const auto& row = m_rows[i];
-    const auto& rowBounds = row.bounds();
-    if (y < rowBounds.bottom())
-    {
-      return i;
-    }
-  }
+  return m_rows;
+}
 
-  return m_rows.size();
+std::span<const LayoutRow> LayoutGroup::rowsIntersectingY(
+  const float y, const float height) const
+{
+  const auto first = std::ranges::partition_point(
+    m_rows, [&](const auto& row) { return row.bounds().bottom() < y; });
+  const auto last = std::partition_point(first, m_rows.end(), [&](const auto& row) {
+    return row.bounds().top() <= y + height;
+  });
+  return {first, last};
 }
 
-const LayoutCell* LayoutGroup::cellAt(const float x, const float y) const
+size_t LayoutGroup::indexOfRowAt(const float y) const
 {
-  for (size_t i = 0; i < m_rows.size(); ++i)
-  {
-    const auto& row = m_rows[i];
-    const auto& rowBounds = row.bounds();
-    if (y > rowBounds.bottom())
-    {
-      continue;
-    }
-    if (y < rowBounds.top())
-    {
-      return nullptr;
-    }
-    if (const auto* cell = row.cellAt(x, y))
-    {
-      return cell;
-    }
-  }
+  const auto it = std::ranges::partition_point(
+    m_rows, [&](const auto& row) { return y >= row.bounds().bottom(); });
+  return size_t(std::distance(m_rows.begin(), it));
+}
 
-  return nullptr;
+const LayoutCell* LayoutGroup::cellAt(const float x, const float y) const
+{
+  const auto it = std::ranges::partition_point(
+    m_rows, [&](const auto& row) { return y > row.bounds().bottom(); });
+  return it != m_rows.end() && y >= it->bounds().top() ? it->cellAt(x, y) : nullptr;
 }
 
 bool LayoutGroup::hitTest(const float x, const float y) const
@@ -560,6 +544,26 @@ void LayoutGroup::addItem(
     m_contentBounds.height + (newRowHeight - oldRowHeight)};
 }
 
+void LayoutGroup::truncateRows(const size_t rowCount)
+{
+  if (rowCount < m_rows.size())
+  {
+    m_rows.erase(m_rows.begin() + std::ptrdiff_t(rowCount), m_rows.end());
+    m_contentBounds = LayoutBounds{
+      m_contentBounds.left(),
+      m_contentBounds.top(),
+      m_contentBounds.width,
+      m_rows.empty() ? 0.0f : m_rows.back().bounds().bottom() - m_contentBounds.top()};
+  }
+}
+
+bool CellLayout::Entry::hasSameLayout(const Entry& other) const
+{
+  return isGroup == other.isGroup && title == other.title && itemWidth == other.itemWidth
+         && itemHeight == other.itemHeight && titleWidth == other.titleWidth
+         && titleHeight == other.titleHeight;
+}
+
 CellLayout::CellLayout(const size_t maxCellsPerRow)
   : m_maxCellsPerRow{maxCellsPerRow}
 {
@@ -833,10 +837,108 @@ const LayoutCell* CellLayout::cellAt(const float x, const float y)
 
 void CellLayout::addGroup(std::string title, const float titleHeight)
 {
+  addEntry(Entry{true, std::any{}, std::move(title), 0.0f, 0.0f, 0.0f, titleHeight});
+}
+
+void CellLayout::addItem(
+  std::any item,
+  std::string title,
+  const float itemWidth,
+  const float itemHeight,
+  const float titleWidth,
+  const float titleHeight)
+{
+  addEntry(Entry{
+    false,
+    std::move(item),
+    std::move(title),
+    itemWidth,
+    itemHeight,
+    titleWidth,
+    titleHeight});
+}
+
+void CellLayout::clear()
+{
+  m_entries.clear();
+  m_groups.clear();
+  m_groupEntries.clear();
+  invalidate();
+}
+
+void CellLayout::beginUpdate()
+{
+  contract_pre(!m_pendingEntries);
+
+  m_pendingEntries = std::vector<Entry>{};
+  m_pendingEntries->reserve(m_entries.size());
+}
+
+void CellLayout::endUpdate()
+{
+  contract_pre(m_pendingEntries);
+
+  auto entries = std::move(*m_pendingEntries);
+  m_pendingEntries = std::nullopt;
+
   if (!m_valid)
   {
-    validate();
+    m_entries = std::move(entries);
+    return;
+  }
+
+  const auto firstChanged =
+    std::ranges::mismatch(entries, m_entries, [](const auto& lhs, const auto& rhs) {
+      return lhs.hasSameLayout(rhs);
+    }).in1;
+  const auto firstChangedIndex = size_t(std::distance(entries.begin(), firstChanged));
+
+  replaceItems(entries, firstChangedIndex);
+
+  const auto unchanged =
+    firstChangedIndex == entries.size() && entries.size() == m_entries.size();
+  m_entries = std::move(entries);
+
+  if (!unchanged)
+  {
+    layoutEntries(truncate(firstChangedIndex));
+  }
+}
+
+void CellLayout::validate()
+{
+  if (m_width <= 0.0f)
+  {
+    return;
+  }
+
+  m_height = 2.0f * m_outerMargin;
+  m_valid = true;
+  m_groups.clear();
+  m_groupEntries.clear();
+
+  layoutEntries(0);
+}
+
+void CellLayout::layoutEntries(const size_t firstEntryIndex)
+{
+  for (size_t i = firstEntryIndex; i < m_entries.size(); ++i)
+  {
+    const auto& entry = m_entries[i];
+    if (entry.isGroup)
+    {
+      layoutGroup(entry, i);
+    }
+    else
+    {
+      layoutItem(entry, i);
+    }
   }
+}
+
+void CellLayout::layoutGroup(const Entry& entry, const size_t entryIndex)
+{
+  const auto heightBefore = m_height;
 
   auto y = 0.0f;
   if (!m_groups.empty())
@@ -846,13 +948,13 @@ void CellLayout::addGroup(std::string title, const float titleHeight)
   }
 
   m_groups.emplace_back(
-    std::move(title),
+    entry.title,
     m_outerMargin,
     y,
     m_cellMargin,
     m_titleMargin,
     m_rowMargin,
-    titleHeight,
+    entry.titleHeight,
     m_width - 2.0f * m_outerMargin,
     m_maxCellsPerRow,
     m_maxUpScale,
@@ -860,24 +962,16 @@ void CellLayout::addGroup(std::string title, const float titleHeight)
     m_maxCellWidth,
     m_minCellHeight,
     m_maxCellHeight);
+  m_groupEntries.push_back({entryIndex, heightBefore, m_height, {}});
   m_height += m_groups.back().bounds().height;
 }
 
-void CellLayout::addItem(
-  std::any item,
-  std::string title,
-  const float itemWidth,
-  const float itemHeight,
-  const float titleWidth,
-  const float titleHeight)
+void CellLayout::layoutItem(const Entry& entry, const size_t entryIndex)
 {
-  if (!m_valid)
-  {
-    validate();
-  }
-
   if (m_groups.empty())
   {
+    const auto heightBefore = m_height;
+
     m_groups.emplace_back(
       m_outerMargin,
       m_outerMargin,
@@ -891,64 +985,107 @@ void CellLayout::addItem(
       m_maxCellWidth,
       m_minCellHeight,
       m_maxCellHeight);
-    m_height += titleHeight;
-    if (titleHeight > 0.0f)
+    m_height += entry.titleHeight;
+    if (entry.titleHeight > 0.0f)
     {
       m_height += m_rowMargin;
     }
+    m_groupEntries.push_back({entryIndex, heightBefore, m_height, {}});
   }
 
-  const auto oldGroupHeight = m_groups.back().bounds().height;
-  m_groups.back().addItem(
-    std::move(item), std::move(title), itemWidth, itemHeight, titleWidth, titleHeight);
-  const auto newGroupHeight = m_groups.back().bounds().height;
+  auto& group = m_groups.back();
+  const auto oldRowCount = group.rows().size();
+  const auto oldGroupHeight = group.bounds().height;
+  group.addItem(
+    entry.item,
+    entry.title,
+    entry.itemWidth,
+    entry.itemHeight,
+    entry.titleWidth,
+    entry.titleHeight);
+  const auto newGroupHeight = group.bounds().height;
+
+  if (group.rows().size() > oldRowCount)
+  {
+    m_groupEntries.back().rowEntryIndices.push_back(entryIndex);
+  }
 
   m_height += (newGroupHeight - oldGroupHeight);
 }
 
-void CellLayout::clear()
-{
-  m_groups.clear();
-  invalidate();
-}
-
-void CellLayout::validate()
+void CellLayout::addEntry(Entry entry)
 {
-  if (m_width <= 0.0f)
+  if (m_pendingEntries)
   {
+    m_pendingEntries->push_back(std::move(entry));
     return;
   }
 
-  m_height = 2.0f * m_outerMargin;
-  m_valid = true;
-  if (!m_groups.empty())
+  m_entries.push_back(std::move(entry));
+  if (m_valid)
   {
-    auto copy = m_groups;
-    m_groups.clear();
+    layoutEntries(m_entries.size() - 1);
+  }
+}
 
-    for (auto& group : copy)
+void CellLayout::replaceItems(const std::vector<Entry>& entries, const size_t entryCount)
+{
+  auto entryIndex = size_t(0);
+  for (auto& group : m_groups)
+  {
+    for (auto& row : group.rows())
     {
-      addGroup(group.title(), group.titleBounds().height);
-      for (const auto& row : group.rows())
+      for (auto& cell : row.cells())
       {
-        for (const auto& cell : row.cells())
+        while (entryIndex < entryCount && entries[entryIndex].isGroup)
         {
-          const auto& itemBounds = cell.itemBounds();
-          const auto& titleBounds = cell.titleBounds();
-          const auto scale = cell.scale();
-          const auto itemWidth = itemBounds.width / scale;
-          const auto itemHeight = itemBounds.height / scale;
-          addItem(
-            cell.item(),
-            cell.title(),
-            itemWidth,
-            itemHeight,
-            titleBounds.width,
-            titleBounds.height);
+          ++entryIndex;
         }
+        if (entryIndex == entryCount)
+        {
+          return;
+        }
+        cell.item() = entries[entryIndex++].item;
       }
     }
   }
 }
 
+size_t CellLayout::truncate(const size_t entryIndex)
+{
+  const auto groupIt = std::ranges::upper_bound(
+    m_groupEntries, entryIndex, std::less{}, &GroupEntries::entryIndex);
+  if (groupIt == m_groupEntries.begin())
+  {
+    return 0;
+  }
+
+  const auto groupIndex = size_t(std::distance(m_groupEntries.begin(), groupIt)) - 1;
+  auto& groupEntries = m_groupEntries[groupIndex];
+  auto& rowEntryIndices = groupEntries.rowEntryIndices;
+
+  // the number of rows that start at or before the given entry
+  const auto rowCount = size_t(std::distance(
+    rowEntryIndices.begin(), std::ranges::upper_bound(rowEntryIndices, entryIndex)));
+
+  if (rowCount <= 1)
+  {
+    // lay out the entire group again
+    const auto firstEntryIndex = groupEntries.entryIndex;
+    m_height = groupEntries.heightBefore;
+    m_groups.erase(m_groups.begin() + std::ptrdiff_t(groupIndex), m_groups.end());
+    m_groupEntries.erase(groupIt - 1, m_groupEntries.end());
+    return firstEntryIndex;
+  }
+
+  // keep the rows before the row containing the given entry
+  const auto firstEntryIndex = rowEntryIndices[rowCount - 1];
+  rowEntryIndices.resize(rowCount - 1);
+  m_groups[groupIndex].truncateRows(rowCount - 1);
+  m_height = groupEntries.baseHeight + m_groups[groupIndex].bounds().height;
+  m_groups.erase(m_groups.begin() + std::ptrdiff_t(groupIndex) + 1, m_groups.end());
+  m_groupEntries.erase(groupIt, m_groupEntries.end());
+  return firstEntryIndex;
+}
+
 } // namespace tb::ui
@@ -20,6 +20,8 @@
 #pragma once
 
 #include <any>
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -141,6 +143,7 @@ public:
   const LayoutBounds& bounds() const;
 
   const std::vector<LayoutCell>& cells() const;
+  std::vector<LayoutCell>& cells();
   const LayoutCell* cellAt(float x, float y) const;
 
   bool intersectsY(float y, float height) const;
@@ -216,6 +219,14 @@ public:
   LayoutBounds bounds() const;
 
   const std::vector<LayoutRow>& rows() const;
+  std::vector<LayoutRow>& rows();
+
+  /**
+   * Returns the rows that intersect the given vertical range. Since the rows are sorted
+   * by their position, they are found by binary search.
+   */
+  std::span<const LayoutRow> rowsIntersectingY(float y, float height) const;
+
   size_t indexOfRowAt(float y) const;
   const LayoutCell* cellAt(float x, float y) const;
 
@@ -229,8 +240,22 @@ public:
     float itemHeight,
     float titleWidth,
     float titleHeight);
+
+  /**
+   * Removes all rows starting at the given index.
+   */
+  void truncateRows(size_t rowCount);
 };
 
+/**
+ * Arranges items in rows of cells, optionally partitioned into groups with titles.
+ *
+ * The layout remembers the groups and items added to it, so that it can be recomputed
+ * when its width or margins change. The contents can be replaced incrementally by
+ * calling beginUpdate, adding all groups and items again, and calling endUpdate. Only the
+ * rows starting with the first cell whose size changed are laid out again, and the items
+ * of the other cells are replaced in place.
+ */
 class CellLayout
 {
 private:
@@ -247,7 +272,36 @@ private:
   float m_minCellHeight = 100.0f;
   float m_maxCellHeight = 100.0f;
 
+  struct Entry
+  {
+    bool isGroup;
+    std::any item;
+    std::string title;
+    float itemWidth;
+    float itemHeight;
+    float titleWidth;
+    float titleHeight;
+
+    bool hasSameLayout(const Entry& other) const;
+  };
+
+  struct GroupEntries
+  {
+    // the index of the entry that started the group
+    size_t entryIndex;
+    // the height of the layout before the group was added
+    float heightBefore;
+    // the height of the layout without the group's bounds
+    float baseHeight;
+    // the index of the first entry of each row
+    std::vector<size_t> rowEntryIndices;
+  };
+
+  std::vector<Entry> m_entries;
+  std::optional<std::vector<Entry>> m_pendingEntries;
+
   std::vector<LayoutGroup> m_groups;
+  std::vector<GroupEntries> m_groupEntries;
   bool m_valid = false;
   float m_height = 0.0f;
 
@@ -305,8 +359,23 @@ public:
 
   void clear();
 
+  /**
+   * Starts replacing the contents of this layout. The groups and items added until
+   * endUpdate is called replace the current contents.
+   */
+  void beginUpdate();
+  void endUpdate();
+
 private:
   void validate();
+
+  void layoutEntries(size_t firstEntryIndex);
+  void layoutGroup(const Entry& entry, size_t entryIndex);
+  void layoutItem(const Entry& entry, size_t entryIndex);
+
+  void addEntry(Entry entry);
+  void replaceItems(const std::vector<Entry>& entries, size_t entryCount);
+  size_t truncate(size_t entryIndex);
 };
 
 } // namespace tb::ui
@@ -74,8 +74,9 @@ void CellView::reloadLayout()
 {
   initLayout(); // always initialize the layout when reloading
 
-  m_layout.clear();
+  m_layout.beginUpdate();
   doReloadLayout(m_layout);
+  m_layout.endUpdate();
   updateScrollBar();
 
   m_valid = true;
@@ -474,34 +475,30 @@ auto collectStringVertices(
           std::end(vertices), std::begin(titleVertices), std::end(titleVertices));
       }
 
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
-          {
-            const auto& title = cell.title();
-            const auto bounds = cell.titleBounds();
-            const auto fontDescriptor =
-              fontManager.selectFontSize(defaultFont, title, bounds.width, 6);
-            const auto& font = fontManager.font(fontDescriptor);
-            const auto size = font.measure(title);
-
-            const auto x =
-              bounds.left() + std::max((bounds.width - size.x()) / 2.0f, 0.0f);
-
-            // y is relative to top, but OpenGL coords are relative to bottom, so invert
-            const auto yOffset = vm::vec2f{x, y + height - bounds.bottom()};
-
-            const auto quads = font.quads(title, false, yOffset);
-            const auto vertices = TextVertex::toList(kdl::views::zip(
-              quads | kdl::views::stride(2),
-              quads | std::views::drop(1) | kdl::views::stride(2),
-              kdl::views::repeat(textColor.to<RgbaF>().toVec())));
-
-            stringVertices[fontDescriptor] =
-              kdl::vec_concat(std::move(stringVertices[fontDescriptor]), vertices);
-          }
+          const auto& title = cell.title();
+          const auto bounds = cell.titleBounds();
+          const auto fontDescriptor =
+            fontManager.selectFontSize(defaultFont, title, bounds.width, 6);
+          const auto& font = fontManager.font(fontDescriptor);
+          const auto size = font.measure(title);
+
+          const auto x = bounds.left() + std::max((bounds.width - size.x()) / 2.0f, 0.0f);
+
+          // y is relative to top, but OpenGL coords are relative to bottom, so invert
+          const auto yOffset = vm::vec2f{x, y + height - bounds.bottom()};
+
+          const auto quads = font.quads(title, false, yOffset);
+          const auto vertices = TextVertex::toList(kdl::views::zip(
+            quads | kdl::views::stride(2),
+            quads | std::views::drop(1) | kdl::views::stride(2),
+            kdl::views::repeat(textColor.to<RgbaF>().toVec())));
+
+          stringVertices[fontDescriptor] =
+            kdl::vec_concat(std::move(stringVertices[fontDescriptor]), vertices);
         }
       }
     }
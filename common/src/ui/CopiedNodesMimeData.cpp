@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CopiedNodesMimeData.h"
+
+#include "mdl/Map.h"
+#include "ui/QtUtils.h"
+
+#include "kd/task_manager.h"
+
+namespace tb::ui
+{
+namespace
+{
+const auto TextMimeType = QStringLiteral("text/plain");
+}
+
+CopiedNodesMimeData::CopiedNodesMimeData(
+  const mdl::Map& map, mdl::CopiedNodes copiedNodes)
+  : m_map{&map}
+  , m_encoding{map.encoding()}
+  , m_copiedNodes{std::move(copiedNodes)}
+{
+}
+
+bool CopiedNodesMimeData::isCopiedFrom(const mdl::Map& map) const
+{
+  return m_map == &map;
+}
+
+const mdl::CopiedNodes& CopiedNodesMimeData::copiedNodes() const
+{
+  return m_copiedNodes;
+}
+
+bool CopiedNodesMimeData::hasFormat(const QString& mimeType) const
+{
+  return mimeType == TextMimeType;
+}
+
+QStringList CopiedNodesMimeData::formats() const
+{
+  return {TextMimeType};
+}
+
+QVariant CopiedNodesMimeData::retrieveData(
+  const QString& mimeType, const QMetaType type) const
+{
+  if (mimeType != TextMimeType)
+  {
+    return QMimeData::retrieveData(mimeType, type);
+  }
+
+  if (!m_text)
+  {
+    // the map may already be closed, so its task manager cannot be used
+    auto taskManager = kdl::task_manager{};
+    m_text = mapStringToUnicode(m_encoding, m_copiedNodes.serialize(taskManager));
+  }
+  return *m_text;
+}
+
+} // namespace tb::ui
@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QMimeData>
+
+#include "mdl/MapTextEncoding.h"
+#include "mdl/Map_CopyPaste.h"
+
+#include <optional>
+
+namespace tb
+{
+namespace mdl
+{
+class Map;
+}
+
+namespace ui
+{
+
+/**
+ * Clipboard contents for nodes copied from a map.
+ *
+ * Pasting into the map that the nodes were copied from clones them directly. Their text
+ * is only serialized when it is requested, e.g. when pasting into another map or another
+ * application.
+ */
+class CopiedNodesMimeData : public QMimeData
+{
+  Q_OBJECT
+private:
+  // only used to check whether a paste goes into the same map, never dereferenced
+  const mdl::Map* m_map;
+  mdl::MapTextEncoding m_encoding;
+  mdl::CopiedNodes m_copiedNodes;
+  mutable std::optional<QString> m_text;
+
+public:
+  CopiedNodesMimeData(const mdl::Map& map, mdl::CopiedNodes copiedNodes);
+
+  bool isCopiedFrom(const mdl::Map& map) const;
+  const mdl::CopiedNodes& copiedNodes() const;
+
+  bool hasFormat(const QString& mimeType) const override;
+  QStringList formats() const override;
+
+protected:
+  QVariant retrieveData(const QString& mimeType, QMetaType type) const override;
+};
+
+} // namespace ui
+} // namespace tb
@@ -328,26 +328,23 @@ void EntityBrowserView::renderBounds(Layout& layout, const float y, const float
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
+          const auto& definition = cellData(cell).entityDefinition;
+          const auto& pointEntityDefinition = *definition.pointEntityDefinition;
+          auto* modelRenderer = cellData(cell).modelRenderer;
+
+          if (modelRenderer == nullptr)
           {
-            const auto& definition = cellData(cell).entityDefinition;
-            const auto& pointEntityDefinition = *definition.pointEntityDefinition;
-            auto* modelRenderer = cellData(cell).modelRenderer;
-
-            if (modelRenderer == nullptr)
-            {
-              const auto itemTrans = itemTransformation(cell, y, height);
-              const auto& color = definition.color;
-              vm::bbox3f{pointEntityDefinition.bounds}.for_each_edge(
-                [&](const vm::vec3f& v1, const vm::vec3f& v2) {
-                  vertices.emplace_back(itemTrans * v1, color.to<RgbaF>().toVec());
-                  vertices.emplace_back(itemTrans * v2, color.to<RgbaF>().toVec());
-                });
-            }
+            const auto itemTrans = itemTransformation(cell, y, height);
+            const auto& color = definition.color;
+            vm::bbox3f{pointEntityDefinition.bounds}.for_each_edge(
+              [&](const vm::vec3f& v1, const vm::vec3f& v2) {
+                vertices.emplace_back(itemTrans * v1, color.to<RgbaF>().toVec());
+                vertices.emplace_back(itemTrans * v2, color.to<RgbaF>().toVec());
+              });
           }
         }
       }
@@ -387,27 +384,23 @@ void EntityBrowserView::renderModels(
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
+          if (auto* modelRenderer = cellData(cell).modelRenderer)
           {
-            if (auto* modelRenderer = cellData(cell).modelRenderer)
-            {
-              shader.set(
-                "Orientation", static_cast<int>(cellData(cell).modelOrientation));
+            shader.set("Orientation", static_cast<int>(cellData(cell).modelOrientation));
 
-              const auto itemTrans = itemTransformation(cell, y, height);
-              shader.set("ModelMatrix", itemTrans);
+            const auto itemTrans = itemTransformation(cell, y, height);
+            shader.set("ModelMatrix", itemTrans);
 
-              const auto multMatrix =
-                render::MultiplyModelMatrix{transformation, itemTrans};
+            const auto multMatrix =
+              render::MultiplyModelMatrix{transformation, itemTrans};
 
-              auto renderFunc = render::DefaultMaterialRenderFunc{
-                pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter)};
-              modelRenderer->render(renderFunc);
-            }
+            auto renderFunc = render::DefaultMaterialRenderFunc{
+              pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter)};
+            modelRenderer->render(renderFunc);
           }
         }
       }
@@ -46,17 +46,19 @@
 #include "ui/QtUtils.h"
 
 #include "kd/contracts.h"
-#include "kd/range_utils.h"
+#include "kd/hash_utils.h"
 #include "kd/reflection_impl.h"
 #include "kd/string_utils.h"
+#include "kd/vector_utils.h"
 
 #include <format>
 
 #include <algorithm>
 #include <iterator>
-#include <map>
 #include <optional>
+#include <ranges>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -292,7 +294,7 @@ std::vector<std::string> allKeys(
   const bool showDefaultRows,
   const bool showProtectedProperties)
 {
-  auto result = kdl::vector_set<std::string>{};
+  auto result = std::unordered_set<std::string>{};
   for (const auto* node : nodes)
   {
     // Add explicitly set properties
@@ -323,64 +325,138 @@ std::vector<std::string> allKeys(
     }
   }
 
-  return result.release_data();
+  return kdl::vec_sort(std::vector<std::string>{result.begin(), result.end()});
+}
+
+bool hasKey(
+  const std::vector<mdl::EntityNodeBase*>& nodes,
+  const std::string& key,
+  const bool showDefaultRows,
+  const bool showProtectedProperties)
+{
+  return std::ranges::any_of(nodes, [&](const auto* node) {
+    const auto& entity = node->entity();
+    return entity.property(key)
+           || (showDefaultRows && mdl::propertyDefinition(node, key))
+           || (showProtectedProperties
+               && kdl::vec_contains(entity.protectedProperties(), key));
+  });
 }
 
-auto makeIdToPropertyRowMap(const std::vector<PropertyRow>& rows)
+const std::string* findPropertyValue(
+  const std::vector<mdl::EntityProperty>& properties, const std::string& key)
 {
-  return rows
-         | std::views::transform([](const auto& row) {
-             return std::pair{PropertyRowId{row.key, row.propertyIndex}, row};
-           })
-         | kdl::ranges::to<std::map>();
+  const auto it = std::ranges::find_if(
+    properties, [&](const auto& property) { return property.hasKey(key); });
+  return it != properties.end() ? &it->value() : nullptr;
+}
+
+/**
+ * Returns the keys of the properties whose values differ between the given old
+ * properties and the given entity, or nullopt if the change can affect the rows of
+ * properties that weren't changed.
+ */
+std::optional<std::vector<std::string>> changedPropertyKeys(
+  const std::vector<mdl::EntityProperty>& oldProperties,
+  const std::vector<std::string>& oldProtectedProperties,
+  const mdl::EntityDefinition* oldDefinition,
+  const mdl::Entity& entity)
+{
+  if (
+    oldDefinition != entity.definition()
+    || oldProtectedProperties != entity.protectedProperties())
+  {
+    return std::nullopt;
+  }
+
+  auto result = std::vector<std::string>{};
+  const auto addIfChanged = [&](const auto& key) {
+    const auto* oldValue = findPropertyValue(oldProperties, key);
+    const auto* newValue = entity.property(key);
+    if (
+      (oldValue == nullptr) != (newValue == nullptr)
+      || (oldValue && *oldValue != *newValue))
+    {
+      result.push_back(key);
+    }
+  };
+
+  for (const auto& property : oldProperties)
+  {
+    addIfChanged(property.key());
+  }
+  for (const auto& property : entity.properties())
+  {
+    addIfChanged(property.key());
+  }
+
+  // the classname determines whether other properties are mutable
+  if (kdl::vec_contains(result, mdl::EntityPropertyKeys::Classname))
+  {
+    return std::nullopt;
+  }
+
+  return result;
 }
 
 struct PropertyRowDiff
 {
-  std::vector<PropertyRowId> removed;
-  std::vector<PropertyRowId> added;
-  std::vector<PropertyRowId> updated;
-  std::vector<PropertyRowId> unchanged;
+  // indices of the old rows, in ascending order
+  std::vector<size_t> removed;
+  // indices of the new rows, sorted by their row IDs
+  std::vector<size_t> added;
+  // pairs of old and new row indices
+  std::vector<std::pair<size_t, size_t>> updated;
 };
 
-PropertyRowDiff comparePropertyMaps(
-  const std::map<PropertyRowId, PropertyRow>& oldRows,
-  const std::map<PropertyRowId, PropertyRow>& newRows)
+PropertyRowId rowIdForRow(const PropertyRow& row)
+{
+  return {row.key, row.propertyIndex};
+}
+
+PropertyRowDiff comparePropertyRows(
+  const std::vector<PropertyRow>& oldRows, const std::vector<PropertyRow>& newRows)
 {
+  auto newRowIndices = std::unordered_map<PropertyRowId, size_t>{};
+  newRowIndices.reserve(newRows.size());
+  for (size_t i = 0; i < newRows.size(); ++i)
+  {
+    newRowIndices.emplace(rowIdForRow(newRows[i]), i);
+  }
+
   auto result = PropertyRowDiff{};
-  result.removed.reserve(oldRows.size());
-  result.added.reserve(newRows.size());
-  result.updated.reserve(newRows.size());
-  result.unchanged.reserve(newRows.size());
+  auto oldRowIds = std::unordered_set<PropertyRowId>{};
+  oldRowIds.reserve(oldRows.size());
 
-  for (const auto& [key, value] : oldRows)
+  for (size_t i = 0; i < oldRows.size(); ++i)
   {
-    if (auto it = newRows.find(key); it != std::end(newRows))
+    auto rowId = rowIdForRow(oldRows[i]);
+    if (const auto it = newRowIndices.find(rowId); it != newRowIndices.end())
     {
-      if (it->second == value)
-      {
-        result.unchanged.push_back(key);
-      }
-      else
+      if (newRows[it->second] != oldRows[i])
       {
-        result.updated.push_back(key);
+        result.updated.emplace_back(i, it->second);
       }
     }
     else
     {
-      result.removed.push_back(key);
+      result.removed.push_back(i);
     }
+    oldRowIds.insert(std::move(rowId));
   }
 
-  for (const auto& [key, value] : newRows)
+  for (size_t i = 0; i < newRows.size(); ++i)
   {
-    unused(value);
-    if (oldRows.find(key) == std::end(oldRows))
+    if (!oldRowIds.contains(rowIdForRow(newRows[i])))
     {
-      result.added.push_back(key);
+      result.added.push_back(i);
     }
   }
 
+  std::ranges::sort(result.added, [&](const auto lhs, const auto rhs) {
+    return rowIdForRow(newRows[lhs]) < rowIdForRow(newRows[rhs]);
+  });
+
   return result;
 }
 
@@ -651,6 +727,17 @@ std::string newPropertyKeyForEntityNodes(const std::vector<mdl::EntityNodeBase*>
 
 kdl_reflect_impl(PropertyRow);
 
+} // namespace tb::ui
+
+std::size_t std::hash<tb::ui::PropertyRowId>::operator()(
+  const tb::ui::PropertyRowId& rowId) const noexcept
+{
+  return kdl::hash(rowId.key, rowId.propertyIndex);
+}
+
+namespace tb::ui
+{
+
 // EntityPropertyModel
 
 EntityPropertyModel::EntityPropertyModel(MapDocument& document, QObject* parent)
@@ -659,6 +746,7 @@ EntityPropertyModel::EntityPropertyModel(MapDocument& document, QObject* parent)
   , m_shouldShowProtectedProperties{false}
   , m_document{document}
 {
+  connectObservers();
   updateFromMap();
 }
 
@@ -674,6 +762,7 @@ void EntityPropertyModel::setShowDefaultRows(const bool showDefaultRows)
     return;
   }
   m_showDefaultRows = showDefaultRows;
+  invalidateEntityNodes();
   updateFromMap();
 }
 
@@ -793,10 +882,25 @@ void EntityPropertyModel::updateFromMap()
 {
   MODEL_LOG(qDebug() << "updateFromMapDocument");
 
-  const auto entityNodes = m_document.map().selection().allEntities();
-  auto rows = rowsForEntityNodes(entityNodes, m_showDefaultRows, true);
+  const auto& entityNodes = m_document.map().selection().allEntities();
+  if (entityNodes.size() > 1 && entityNodes == m_entityNodes)
+  {
+    if (auto rows = rowsForChangedEntityNodes())
+    {
+      m_changedEntityNodes.clear();
+      setRows(std::move(*rows));
+      return;
+    }
+  }
+
+  m_entityNodes = entityNodes;
+  m_entityNodeSet = std::unordered_set<const mdl::Node*>(
+    m_entityNodes.begin(), m_entityNodes.end());
+  m_changedEntityNodes.clear();
+
+  auto rows = rowsForEntityNodes(m_entityNodes, m_showDefaultRows, true);
   setRows(std::move(rows));
-  m_shouldShowProtectedProperties = computeShouldShowProtectedProperties(entityNodes);
+  m_shouldShowProtectedProperties = computeShouldShowProtectedProperties(m_entityNodes);
 }
 
 int EntityPropertyModel::rowCount(const QModelIndex& parent) const
@@ -1094,6 +1198,82 @@ bool EntityPropertyModel::canRemove(const int rowIndexInt)
   return row.keyMutable && row.valueMutable;
 }
 
+void EntityPropertyModel::connectObservers()
+{
+  m_notifierConnection += m_document.documentWasLoadedNotifier.connect(
+    this, &EntityPropertyModel::invalidateEntityNodes);
+  m_notifierConnection += m_document.entityDefinitionsDidChangeNotifier.connect(
+    this, &EntityPropertyModel::invalidateEntityNodes);
+  m_notifierConnection += m_document.nodesWillChangeNotifier.connect(
+    this, &EntityPropertyModel::nodesWillChange);
+
+  // adding or removing nodes can reparent the selected entities, which changes whether
+  // their properties are protectable
+  m_notifierConnection += m_document.nodesWereAddedNotifier.connect(
+    [&](const auto&) { invalidateEntityNodes(); });
+  m_notifierConnection += m_document.nodesWereRemovedNotifier.connect(
+    [&](const auto&) { invalidateEntityNodes(); });
+}
+
+void EntityPropertyModel::nodesWillChange(const std::vector<mdl::Node*>& nodes)
+{
+  for (const auto* node : nodes)
+  {
+    if (m_entityNodeSet.contains(node))
+    {
+      // EntityNodeBase derives from Node only, so a static cast is safe here
+      const auto* entityNode = static_cast<const mdl::EntityNodeBase*>(node);
+      if (!m_changedEntityNodes.contains(entityNode))
+      {
+        const auto& entity = entityNode->entity();
+        m_changedEntityNodes.emplace(
+          entityNode,
+          EntityState{
+            entity.properties(), entity.protectedProperties(), entity.definition()});
+      }
+    }
+  }
+}
+
+void EntityPropertyModel::invalidateEntityNodes()
+{
+  m_entityNodes.clear();
+  m_entityNodeSet.clear();
+  m_changedEntityNodes.clear();
+}
+
+std::optional<std::vector<PropertyRow>> EntityPropertyModel::rowsForChangedEntityNodes()
+  const
+{
+  auto changedKeys = std::unordered_set<std::string>{};
+  for (const auto& [entityNode, oldState] : m_changedEntityNodes)
+  {
+    const auto keys = changedPropertyKeys(
+      oldState.properties,
+      oldState.protectedProperties,
+      oldState.definition,
+      entityNode->entity());
+    if (!keys)
+    {
+      return std::nullopt;
+    }
+    changedKeys.insert(keys->begin(), keys->end());
+  }
+
+  auto result = m_rows;
+  std::erase_if(result, [&](const auto& row) { return changedKeys.contains(row.key); });
+
+  for (const auto& key : changedKeys)
+  {
+    if (hasKey(m_entityNodes, key, m_showDefaultRows, true))
+    {
+      result.push_back(makeRow(key, m_entityNodes));
+    }
+  }
+
+  return result;
+}
+
 std::vector<std::string> EntityPropertyModel::propertyKeys(
   const int row, const int count) const
 {
@@ -1109,17 +1289,14 @@ std::vector<std::string> EntityPropertyModel::propertyKeys(
 
 void EntityPropertyModel::setRows(std::vector<PropertyRow> newRows)
 {
-  const auto oldRowMap = makeIdToPropertyRowMap(m_rows);
-  const auto newRowMap = makeIdToPropertyRowMap(newRows);
+  const auto diff = comparePropertyRows(m_rows, newRows);
 
-  if (newRowMap == oldRowMap)
+  if (diff.removed.empty() && diff.added.empty() && diff.updated.empty())
   {
     MODEL_LOG(qDebug() << "EntityPropertyModel::setRows: no change");
     return;
   }
 
-  const auto diff = comparePropertyMaps(oldRowMap, newRowMap);
-
   // If exactly one row was changed we can tell Qt the row was edited instead. This allows
   // the selection/current index to be preserved, whereas removing the row would
   // invalidate the current index.
@@ -1129,22 +1306,19 @@ void EntityPropertyModel::setRows(std::vector<PropertyRow> newRows)
 
   if (diff.removed.size() == 1 && diff.added.size() == 1 && diff.updated.empty())
   {
-    const auto& oldDeletion = oldRowMap.at(diff.removed[0]);
-    const auto& newAddition = newRowMap.at(diff.added[0]);
+    const auto oldIndex = diff.removed.front();
+    const auto newIndex = diff.added.front();
 
     MODEL_LOG(
       qDebug() << "EntityPropertyModel::setRows: one row changed: "
-               << mapStringToUnicode(m_map.encoding(), oldDeletion.key) << " -> "
-               << mapStringToUnicode(m_map.encoding(), newAddition.key));
-
-    const auto oldIndex = kdl::index_of(m_rows, oldDeletion);
-    contract_assert(oldIndex != std::nullopt);
+               << QString::fromStdString(m_rows[oldIndex].key) << " -> "
+               << QString::fromStdString(newRows[newIndex].key));
 
-    m_rows.at(*oldIndex) = newAddition;
+    m_rows[oldIndex] = std::move(newRows[newIndex]);
 
     // Notify Qt
-    const auto topLeft = index(static_cast<int>(*oldIndex), 0);
-    const auto bottomRight = index(static_cast<int>(*oldIndex), NumColumns - 1);
+    const auto topLeft = index(static_cast<int>(oldIndex), 0);
+    const auto bottomRight = index(static_cast<int>(oldIndex), NumColumns - 1);
     emit dataChanged(topLeft, bottomRight);
     return;
   }
@@ -1154,21 +1328,17 @@ void EntityPropertyModel::setRows(std::vector<PropertyRow> newRows)
   MODEL_LOG(
     qDebug() << "EntityPropertyModel::setRows: " << diff.updated.size()
              << " common keys");
-  for (const auto& key : diff.updated)
+  for (const auto& [oldIndex, newIndex] : diff.updated)
   {
-    const auto& oldRow = oldRowMap.at(key);
-    const auto& newRow = newRowMap.at(key);
-    const auto oldIndex = kdl::index_of(m_rows, oldRow);
-
     MODEL_LOG(
-      qDebug() << "   updating row " << *oldIndex << "(" << QString::fromStdString(key)
-               << ")");
+      qDebug() << "   updating row " << oldIndex << "("
+               << QString::fromStdString(m_rows[oldIndex].key) << ")");
 
-    m_rows.at(*oldIndex) = newRow;
+    m_rows[oldIndex] = std::move(newRows[newIndex]);
 
     // Notify Qt
-    const auto topLeft = index(static_cast<int>(*oldIndex), 0);
-    const auto bottomRight = index(static_cast<int>(*oldIndex), NumColumns - 1);
+    const auto topLeft = index(static_cast<int>(oldIndex), 0);
+    const auto bottomRight = index(static_cast<int>(oldIndex), NumColumns - 1);
     emit dataChanged(topLeft, bottomRight);
   }
 
@@ -1184,29 +1354,25 @@ void EntityPropertyModel::setRows(std::vector<PropertyRow> newRows)
     contract_assert(lastNewRow >= firstNewRow);
 
     beginInsertRows(QModelIndex(), firstNewRow, lastNewRow);
-    for (const auto& key : diff.added)
+    for (const auto newIndex : diff.added)
     {
-      const auto& row = newRowMap.at(key);
-      m_rows.push_back(row);
+      m_rows.push_back(std::move(newRows[newIndex]));
     }
     endInsertRows();
   }
 
-  // Deletions
+  // Deletions, starting with the last row so that the remaining indices stay valid
   if (!diff.removed.empty())
   {
     MODEL_LOG(
       qDebug() << "EntityPropertyModel::setRows: deleting " << diff.removed.size()
                << " rows");
 
-    for (const auto& key : diff.removed)
+    for (const auto oldIndex : diff.removed | std::views::reverse)
     {
-      const auto& row = oldRowMap.at(key);
-      const auto index = kdl::index_of(m_rows, row);
-      contract_assert(index);
-
-      beginRemoveRows(QModelIndex{}, static_cast<int>(*index), static_cast<int>(*index));
-      m_rows.erase(std::next(m_rows.begin(), static_cast<int>(*index)));
+      const auto row = static_cast<int>(oldIndex);
+      beginRemoveRows(QModelIndex{}, row, row);
+      m_rows.erase(std::next(m_rows.begin(), static_cast<std::ptrdiff_t>(oldIndex)));
       endRemoveRows();
     }
   }
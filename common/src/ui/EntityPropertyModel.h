@@ -21,12 +21,16 @@
 
 #include <QAbstractTableModel>
 
+#include "NotifierConnection.h"
+#include "mdl/EntityProperties.h"
+
 #include "kd/reflection_decl.h"
 
 #include <iosfwd>
-#include <map>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class QObject;
@@ -35,7 +39,9 @@ namespace tb
 {
 namespace mdl
 {
+struct EntityDefinition;
 class EntityNodeBase;
+class Node;
 } // namespace mdl
 
 namespace ui
@@ -128,6 +134,18 @@ struct PropertyRowId
 
 bool operator<(const PropertyRowId& lhs, const PropertyRowId& rhs);
 
+} // namespace ui
+} // namespace tb
+
+template <>
+struct std::hash<tb::ui::PropertyRowId>
+{
+  std::size_t operator()(const tb::ui::PropertyRowId& rowId) const noexcept;
+};
+
+namespace tb::ui
+{
+
 /**
  * Model for the QTableView.
  *
@@ -145,6 +163,11 @@ bool operator<(const PropertyRowId& lhs, const PropertyRowId& rhs);
  *
  * The order of m_rows is not significant; it's expected that there is a sort proxy model
  * used on top of this model.
+ *
+ * If more than one entity is selected and the selection hasn't changed since the rows
+ * were last built, only the rows for the properties that were changed are merged again.
+ * For this, the model records the properties of every selected entity node before it
+ * changes.
  */
 class EntityPropertyModel : public QAbstractTableModel
 {
@@ -156,11 +179,27 @@ public:
   static const int NumColumns = 3;
 
 private:
+  struct EntityState
+  {
+    std::vector<mdl::EntityProperty> properties;
+    std::vector<std::string> protectedProperties;
+    const mdl::EntityDefinition* definition;
+  };
+
   std::vector<PropertyRow> m_rows;
   bool m_showDefaultRows;
   bool m_shouldShowProtectedProperties;
   MapDocument& m_document;
 
+  // the entity nodes that the rows were built for, empty if the rows must be rebuilt
+  std::vector<mdl::EntityNodeBase*> m_entityNodes;
+  std::unordered_set<const mdl::Node*> m_entityNodeSet;
+
+  // the state of the entity nodes that changed since the rows were built
+  std::unordered_map<const mdl::EntityNodeBase*, EntityState> m_changedEntityNodes;
+
+  NotifierConnection m_notifierConnection;
+
 public:
   explicit EntityPropertyModel(MapDocument& document, QObject* parent = nullptr);
 
@@ -190,6 +229,12 @@ public: // QAbstractTableModel overrides
   QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
 private: // helpers
+  void connectObservers();
+  void nodesWillChange(const std::vector<mdl::Node*>& nodes);
+  void invalidateEntityNodes();
+
+  std::optional<std::vector<PropertyRow>> rowsForChangedEntityNodes() const;
+
   std::vector<std::string> propertyKeys(int row, int count) const;
 
   void setRows(std::vector<PropertyRow> newRows);
@@ -214,5 +259,4 @@ public: // EntityPropertyGrid helpers
   bool lessThan(size_t rowIndexA, size_t rowIndexB) const;
 };
 
-} // namespace ui
-} // namespace tb
+} // namespace tb::ui
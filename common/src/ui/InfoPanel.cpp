@@ -26,13 +26,15 @@
 
 #include "ui/Console.h"
 #include "ui/IssueBrowser.h"
+#include "ui/PerformanceCounters.h"
 #include "ui/QtUtils.h"
 #include "ui/TabBook.h"
 
 namespace tb::ui
 {
 
-InfoPanel::InfoPanel(MapDocument& document, QWidget* parent)
+InfoPanel::InfoPanel(
+  MapDocument& document, GLContextManager& contextManager, QWidget* parent)
   : QWidget{parent}
 {
   m_tabBook = new TabBook{};
@@ -40,9 +42,11 @@ InfoPanel::InfoPanel(MapDocument& document, QWidget* parent)
 
   m_console = new Console{};
   m_issueBrowser = new IssueBrowser{document};
+  m_performanceCounters = new PerformanceCounters{document, contextManager};
 
   m_tabBook->addPage(m_console, tr("Console"));
   m_tabBook->addPage(m_issueBrowser, tr("Issues"));
+  m_tabBook->addPage(m_performanceCounters, tr("Performance"));
 
   auto* sizer = new QVBoxLayout{};
   sizer->setContentsMargins(0, 0, 0, 0);
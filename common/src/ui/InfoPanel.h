@@ -28,8 +28,10 @@ class Logger;
 namespace ui
 {
 class Console;
+class GLContextManager;
 class IssueBrowser;
 class MapDocument;
+class PerformanceCounters;
 class TabBook;
 
 class InfoPanel : public QWidget
@@ -39,9 +41,11 @@ private:
   TabBook* m_tabBook = nullptr;
   Console* m_console = nullptr;
   IssueBrowser* m_issueBrowser = nullptr;
+  PerformanceCounters* m_performanceCounters = nullptr;
 
 public:
-  explicit InfoPanel(MapDocument& document, QWidget* parent = nullptr);
+  InfoPanel(
+    MapDocument& document, GLContextManager& contextManager, QWidget* parent = nullptr);
   ~InfoPanel() override;
 
   Console* console() const;
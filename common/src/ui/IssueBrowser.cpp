@@ -74,11 +74,9 @@ QWidget* IssueBrowser::createTabBarPage(QWidget* parent)
 void IssueBrowser::connectObservers()
 {
   m_notifierConnection +=
-    m_document.documentWasLoadedNotifier.connect(this, &IssueBrowser::documentDidChange);
+    m_document.documentWasLoadedNotifier.connect(this, &IssueBrowser::documentWasLoaded);
   m_notifierConnection +=
     m_document.documentWasSavedNotifier.connect(this, &IssueBrowser::documentWasSaved);
-  m_notifierConnection +=
-    m_document.documentDidChangeNotifier.connect(this, &IssueBrowser::documentDidChange);
 }
 
 void IssueBrowser::documentWasSaved()
@@ -86,7 +84,7 @@ void IssueBrowser::documentWasSaved()
   m_view->update();
 }
 
-void IssueBrowser::documentDidChange()
+void IssueBrowser::documentWasLoaded()
 {
   reload();
 }
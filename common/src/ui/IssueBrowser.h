@@ -62,8 +62,8 @@ public:
 
 private:
   void connectObservers();
+  void documentWasLoaded();
   void documentWasSaved();
-  void documentDidChange();
   void issueIgnoreChanged(mdl::Issue* issue);
 
   void reload();
@@ -23,8 +23,10 @@
 #include <QHeaderView>
 #include <QItemSelectionModel>
 #include <QMenu>
+#include <QSignalBlocker>
 #include <QTableView>
 
+#include "Trace.h"
 #include "mdl/BrushNode.h"
 #include "mdl/EntityNode.h"
 #include "mdl/GroupNode.h"
@@ -46,7 +48,9 @@
 
 #include <format>
 
+#include <algorithm>
 #include <chrono> // IWYU pragma: keep
+#include <iterator>
 #include <vector>
 
 namespace tb::ui
@@ -61,6 +65,7 @@ IssueBrowserView::IssueBrowserView(MapDocument& document, QWidget* parent)
 {
   createGui();
   bindEvents();
+  connectObservers();
 }
 
 void IssueBrowserView::createGui()
@@ -136,20 +141,17 @@ void IssueBrowserView::updateSelection()
 
 void IssueBrowserView::updateIssues()
 {
+  const auto trace = TraceScope{"IssueBrowserView::updateIssues"};
+
   auto& map = m_document.map();
   const auto validators = map.worldNode().registeredValidators();
 
+  // all issues are collected again, so the pending changes can be discarded
+  map.worldNode().takeNodesWithInvalidatedIssues();
+
   auto issues = std::vector<const mdl::Issue*>{};
   const auto collectIssues = [&](auto* node) {
-    for (auto* issue : node->issues(validators))
-    {
-      if (
-        m_showHiddenIssues
-        || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0))
-      {
-        issues.push_back(issue);
-      }
-    }
+    issues = kdl::vec_concat(std::move(issues), visibleIssues(*node, validators));
   };
 
   map.worldNode().accept(kdl::overload(
@@ -172,10 +174,53 @@ void IssueBrowserView::updateIssues()
     [&](mdl::BrushNode* brushNode) { collectIssues(brushNode); },
     [&](mdl::PatchNode* patchNode) { collectIssues(patchNode); }));
 
-  issues = kdl::vec_sort(std::move(issues), [](const auto* lhs, const auto* rhs) {
-    return lhs->seqId() > rhs->seqId();
-  });
-  m_tableModel->setIssues(std::move(issues));
+  m_tableModel->setIssues(issues);
+}
+
+/**
+ * Replaces the rows of the given changed nodes and removes the rows of the nodes that
+ * were removed from the map.
+ */
+void IssueBrowserView::updateChangedIssues(std::vector<mdl::Node*> changedNodes)
+{
+  changedNodes = kdl::vec_sort_and_remove_duplicates(std::move(changedNodes));
+
+  const auto trace = TraceScope{
+    "IssueBrowserView::updateChangedIssues",
+    std::format("{} nodes", changedNodes.size())};
+
+  auto staleNodes = m_removedNodes;
+  staleNodes.insert(changedNodes.begin(), changedNodes.end());
+
+  // removing selected rows must not change the selection in the map
+  const auto blockSelection = QSignalBlocker{m_tableView->selectionModel()};
+  m_tableModel->removeIssues(staleNodes);
+
+  const auto validators = m_document.map().worldNode().registeredValidators();
+
+  auto issues = std::vector<const mdl::Issue*>{};
+  for (auto* node : changedNodes)
+  {
+    issues = kdl::vec_concat(std::move(issues), visibleIssues(*node, validators));
+  }
+  m_tableModel->addIssues(issues);
+}
+
+std::vector<const mdl::Issue*> IssueBrowserView::visibleIssues(
+  mdl::Node& node, const std::vector<const mdl::Validator*>& validators) const
+{
+  const auto hiddenIssueTypes =
+    m_showHiddenIssues ? 0 : m_hiddenIssueTypes | node.hiddenIssues();
+
+  auto result = std::vector<const mdl::Issue*>{};
+  for (const auto* issue : node.issues(validators))
+  {
+    if ((issue->type() & hiddenIssueTypes) == 0)
+    {
+      result.push_back(issue);
+    }
+  }
+  return result;
 }
 
 void IssueBrowserView::applyQuickFix(const mdl::IssueQuickFix& quickFix)
@@ -203,7 +248,7 @@ std::vector<const mdl::Issue*> IssueBrowserView::collectIssues(
     if (index.isValid())
     {
       const auto row = static_cast<size_t>(index.row());
-      result.insert(m_tableModel->issues().at(row));
+      result.insert(m_tableModel->issue(row));
     }
   }
   return result.release_data();
@@ -224,7 +269,7 @@ std::vector<const mdl::IssueQuickFix*> IssueBrowserView::collectQuickFixes(
     {
       continue;
     }
-    const auto* issue = m_tableModel->issues().at(static_cast<size_t>(index.row()));
+    const auto* issue = m_tableModel->issue(static_cast<size_t>(index.row()));
     issueTypes &= issue->type();
   }
 
@@ -244,12 +289,15 @@ mdl::IssueType IssueBrowserView::issueTypeMask() const
 void IssueBrowserView::setIssueVisibility(const bool show)
 {
   auto& map = m_document.map();
+
+  auto changedNodes = std::vector<mdl::Node*>{};
   for (const auto* issue : collectIssues(getSelection()))
   {
     map.setIssueHidden(*issue, !show);
+    changedNodes.push_back(&issue->node());
   }
 
-  invalidate();
+  updateChangedIssues(std::move(changedNodes));
 }
 
 QList<QModelIndex> IssueBrowserView::getSelection() const
@@ -279,6 +327,74 @@ void IssueBrowserView::bindEvents()
     &IssueBrowserView::validate);
 }
 
+void IssueBrowserView::connectObservers()
+{
+  m_notifierConnection += m_document.documentDidChangeNotifier.connect(
+    this, &IssueBrowserView::updateInvalidatedIssues);
+
+  // issues are also invalidated outside of transactions, e.g. when materials, entity
+  // definitions or mods are reloaded
+  m_notifierConnection += m_document.resourcesWereProcessedNotifier.connect(
+    this, &IssueBrowserView::resourcesWereProcessed);
+  m_notifierConnection += m_document.materialCollectionsDidChangeNotifier.connect(
+    this, &IssueBrowserView::updateInvalidatedIssues);
+  m_notifierConnection += m_document.entityDefinitionsDidChangeNotifier.connect(
+    this, &IssueBrowserView::updateInvalidatedIssues);
+  m_notifierConnection += m_document.modsDidChangeNotifier.connect(
+    this, &IssueBrowserView::updateInvalidatedIssues);
+
+  m_notifierConnection += m_document.nodesWereAddedNotifier.connect(
+    this, &IssueBrowserView::nodesWereAdded);
+  m_notifierConnection += m_document.nodesWereRemovedNotifier.connect(
+    this, &IssueBrowserView::nodesWereRemoved);
+}
+
+void IssueBrowserView::updateInvalidatedIssues()
+{
+  auto changedNodes = m_document.map().worldNode().takeNodesWithInvalidatedIssues();
+  if (m_valid)
+  {
+    changedNodes.insert(changedNodes.end(), m_addedNodes.begin(), m_addedNodes.end());
+    updateChangedIssues(std::move(changedNodes));
+  }
+
+  m_addedNodes.clear();
+  m_removedNodes.clear();
+}
+
+void IssueBrowserView::resourcesWereProcessed(const std::vector<mdl::ResourceId>&)
+{
+  updateInvalidatedIssues();
+}
+
+void IssueBrowserView::nodesWereAdded(const std::vector<mdl::Node*>& nodes)
+{
+  // The nodes passed in don't include their descendants. Added nodes are collected
+  // here because their issues haven't been validated yet.
+  for (auto* node : nodes)
+  {
+    node->accept([&](auto&& thisLambda, mdl::Node* descendant) {
+      m_removedNodes.erase(descendant);
+      m_addedNodes.insert(descendant);
+      descendant->visitChildren(thisLambda);
+    });
+  }
+}
+
+void IssueBrowserView::nodesWereRemoved(const std::vector<mdl::Node*>& nodes)
+{
+  // The removed nodes may be deleted before the issues are updated, so only their
+  // addresses are kept.
+  for (auto* node : nodes)
+  {
+    node->accept([&](auto&& thisLambda, mdl::Node* descendant) {
+      m_addedNodes.erase(descendant);
+      m_removedNodes.insert(descendant);
+      descendant->visitChildren(thisLambda);
+    });
+  }
+}
+
 void IssueBrowserView::itemRightClicked(const QPoint& pos)
 {
   const auto selectedIndexes = m_tableView->selectionModel()->selectedIndexes();
@@ -355,21 +471,99 @@ IssueBrowserModel::IssueBrowserModel(QObject* parent)
 {
 }
 
-void IssueBrowserModel::setIssues(std::vector<const mdl::Issue*> issues)
+void IssueBrowserModel::setIssues(const std::vector<const mdl::Issue*>& issues)
 {
   beginResetModel();
-  m_issues = std::move(issues);
+  m_rows = makeIssueRows(issues);
   endResetModel();
 }
 
-const std::vector<const mdl::Issue*>& IssueBrowserModel::issues()
+void IssueBrowserModel::addIssues(const std::vector<const mdl::Issue*>& issues)
 {
-  return m_issues;
+  const auto newRows = makeIssueRows(issues);
+
+  // insert each run of new rows that precede the same existing row at once
+  auto first = newRows.begin();
+  while (first != newRows.end())
+  {
+    const auto next = std::ranges::partition_point(
+      m_rows, [&](const auto& row) { return row.seqId > first->seqId; });
+    const auto last = next != m_rows.end()
+                        ? std::find_if(
+                            first,
+                            newRows.end(),
+                            [&](const auto& row) { return row.seqId < next->seqId; })
+                        : newRows.end();
+
+    const auto index = std::distance(m_rows.begin(), next);
+    const auto count = std::distance(first, last);
+
+    beginInsertRows(
+      QModelIndex{}, static_cast<int>(index), static_cast<int>(index + count - 1));
+    m_rows.insert(next, first, last);
+    endInsertRows();
+
+    first = last;
+  }
+}
+
+void IssueBrowserModel::removeIssues(const std::unordered_set<const mdl::Node*>& nodes)
+{
+  if (nodes.empty())
+  {
+    return;
+  }
+
+  // remove each run of rows starting with the last one so that the indices of the
+  // remaining runs stay valid
+  auto last = m_rows.size();
+  while (last > 0)
+  {
+    if (!nodes.contains(m_rows[last - 1].node))
+    {
+      --last;
+      continue;
+    }
+
+    auto first = last - 1;
+    while (first > 0 && nodes.contains(m_rows[first - 1].node))
+    {
+      --first;
+    }
+
+    beginRemoveRows(QModelIndex{}, static_cast<int>(first), static_cast<int>(last - 1));
+    m_rows.erase(
+      std::next(m_rows.begin(), static_cast<std::ptrdiff_t>(first)),
+      std::next(m_rows.begin(), static_cast<std::ptrdiff_t>(last)));
+    endRemoveRows();
+
+    last = first;
+  }
+}
+
+const mdl::Issue* IssueBrowserModel::issue(const size_t row) const
+{
+  return m_rows.at(row).issue;
+}
+
+std::vector<IssueBrowserModel::IssueRow> IssueBrowserModel::makeIssueRows(
+  const std::vector<const mdl::Issue*>& issues)
+{
+  auto result = std::vector<IssueRow>{};
+  result.reserve(issues.size());
+  for (const auto* issue : issues)
+  {
+    result.push_back({issue, &issue->node(), issue->seqId()});
+  }
+
+  std::ranges::sort(
+    result, [](const auto& lhs, const auto& rhs) { return lhs.seqId > rhs.seqId; });
+  return result;
 }
 
 int IssueBrowserModel::rowCount(const QModelIndex& parent) const
 {
-  return parent.isValid() ? 0 : static_cast<int>(m_issues.size());
+  return parent.isValid() ? 0 : static_cast<int>(m_rows.size());
 }
 
 int IssueBrowserModel::columnCount(const QModelIndex& parent) const
@@ -381,13 +575,13 @@ QVariant IssueBrowserModel::data(const QModelIndex& index, const int role) const
 {
   if (
     !index.isValid() || index.row() < 0
-    || index.row() >= static_cast<int>(m_issues.size()) || index.column() < 0
+    || index.row() >= static_cast<int>(m_rows.size()) || index.column() < 0
     || index.column() >= 2)
   {
     return QVariant{};
   }
 
-  const auto* issue = m_issues.at(static_cast<size_t>(index.row()));
+  const auto* issue = m_rows.at(static_cast<size_t>(index.row())).issue;
 
   if (role == Qt::DisplayRole)
   {
@@ -22,8 +22,10 @@
 #include <QAbstractItemModel>
 #include <QWidget>
 
+#include "NotifierConnection.h"
 #include "mdl/IssueType.h"
 
+#include <unordered_set>
 #include <vector>
 
 class QWidget;
@@ -35,6 +37,9 @@ namespace mdl
 {
 class Issue;
 class IssueQuickFix;
+class Node;
+class ResourceId;
+class Validator;
 } // namespace mdl
 
 namespace ui
@@ -54,11 +59,17 @@ private:
 
   bool m_valid = false;
 
+  // the nodes that were added or removed since the issues were last updated
+  std::unordered_set<mdl::Node*> m_addedNodes;
+  std::unordered_set<const mdl::Node*> m_removedNodes;
+
   QTableView* m_tableView = nullptr;
   IssueBrowserModel* m_tableModel = nullptr;
 
   SignalDelayer* m_validateSignalDelayer = nullptr;
 
+  NotifierConnection m_notifierConnection;
+
 public:
   explicit IssueBrowserView(MapDocument& document, QWidget* parent = nullptr);
 
@@ -74,6 +85,10 @@ public:
 
 private:
   void updateIssues();
+  void updateChangedIssues(std::vector<mdl::Node*> changedNodes);
+
+  std::vector<const mdl::Issue*> visibleIssues(
+    mdl::Node& node, const std::vector<const mdl::Validator*>& validators) const;
 
   std::vector<const mdl::Issue*> collectIssues(const QList<QModelIndex>& indices) const;
   std::vector<const mdl::IssueQuickFix*> collectQuickFixes(
@@ -85,6 +100,12 @@ private:
   QList<QModelIndex> getSelection() const;
   void updateSelection();
   void bindEvents();
+  void connectObservers();
+
+  void updateInvalidatedIssues();
+  void resourcesWereProcessed(const std::vector<mdl::ResourceId>& resourceIds);
+  void nodesWereAdded(const std::vector<mdl::Node*>& nodes);
+  void nodesWereRemoved(const std::vector<mdl::Node*>& nodes);
 
   void itemRightClicked(const QPoint& pos);
   void itemSelectionChanged();
@@ -99,20 +120,46 @@ public slots:
 };
 
 /**
- * Trivial QAbstractTableModel subclass, when the issues list changes,
- * it just refreshes the entire list with beginResetModel()/endResetModel().
+ * Table model for the issue browser. The rows are sorted by descending issue sequence
+ * IDs so that the most recently found issues come first.
+ *
+ * When the issues of some nodes change, the rows of these nodes are removed and their
+ * new issues are inserted in place instead of resetting the entire model.
  */
 class IssueBrowserModel : public QAbstractTableModel
 {
   Q_OBJECT
 private:
-  std::vector<const mdl::Issue*> m_issues;
+  struct IssueRow
+  {
+    const mdl::Issue* issue;
+    const mdl::Node* node;
+    size_t seqId;
+  };
+
+  std::vector<IssueRow> m_rows;
 
 public:
   explicit IssueBrowserModel(QObject* parent);
 
-  void setIssues(std::vector<const mdl::Issue*> issues);
-  const std::vector<const mdl::Issue*>& issues();
+  void setIssues(const std::vector<const mdl::Issue*>& issues);
+
+  /**
+   * Inserts the given issues at the rows given by their sequence IDs.
+   */
+  void addIssues(const std::vector<const mdl::Issue*>& issues);
+
+  /**
+   * Removes the rows of the issues of the given nodes. The issues themselves are not
+   * accessed, so they may already have been deleted.
+   */
+  void removeIssues(const std::unordered_set<const mdl::Node*>& nodes);
+
+  const mdl::Issue* issue(size_t row) const;
+
+private:
+  static std::vector<IssueRow> makeIssueRows(
+    const std::vector<const mdl::Issue*>& issues);
 
 public: // QAbstractTableModel overrides
   int rowCount(const QModelIndex& parent) const override;
@@ -84,6 +84,7 @@
 #include "ui/ColorButton.h"
 #include "ui/CompilationDialog.h"
 #include "ui/CompilationVariables.h"
+#include "ui/CopiedNodesMimeData.h"
 #include "ui/CrashReporter.h"
 #include "ui/EdgeTool.h"
 #include "ui/FaceInspector.h"
@@ -112,6 +113,7 @@
 #include "kd/const_overload.h"
 #include "kd/contracts.h"
 #include "kd/overload.h"
+#include "kd/path_utils.h"
 #include "kd/ranges/to.h"
 #include "kd/string_format.h"
 #include "kd/string_utils.h"
@@ -388,7 +390,7 @@ void MapFrame::createGui()
   m_vSplitter->setChildrenCollapsible(false);
   m_vSplitter->setObjectName("MapFrame_VerticalSplitterSplitter");
 
-  m_infoPanel = new InfoPanel{document()};
+  m_infoPanel = new InfoPanel{document(), *m_contextManager};
   m_infoPanel->setObjectName("MapFrame_InfoPanel");
   m_console = m_infoPanel->console();
 
@@ -1292,6 +1294,25 @@ bool MapFrame::exportDocumentAsObj()
   return true;
 }
 
+bool MapFrame::exportDocumentAsGlb()
+{
+  const auto& map = m_document->map();
+  const auto glbPath = kdl::path_replace_extension(map.path(), ".glb");
+
+  const auto newFileName = QFileDialog::getSaveFileName(
+    this,
+    tr("Export Binary glTF file"),
+    io::pathAsQPath(glbPath),
+    "Binary glTF files (*.glb)");
+  if (newFileName.isEmpty())
+  {
+    return false;
+  }
+
+  const auto options = io::GltfExportOptions{io::pathFromQString(newFileName)};
+  return exportDocument(options);
+}
+
 bool MapFrame::exportDocumentAsMap()
 {
   const auto& map = m_document->map();
@@ -1559,12 +1580,19 @@ void MapFrame::copyToClipboard()
 {
   auto& map = m_document->map();
   const auto& selection = map.selection();
-  const auto str = selection.hasNodes()        ? serializeSelectedNodes(map)
-                   : selection.hasBrushFaces() ? serializeSelectedBrushFaces(map)
-                                               : std::string{};
 
   auto* clipboard = QApplication::clipboard();
-  clipboard->setText(mapStringToUnicode(map.encoding(), str));
+  if (selection.hasNodes())
+  {
+    // the text is only serialized when it is requested
+    clipboard->setMimeData(new CopiedNodesMimeData{map, copySelectedNodes(map)});
+  }
+  else
+  {
+    const auto str = selection.hasBrushFaces() ? serializeSelectedBrushFaces(map)
+                                               : std::string{};
+    clipboard->setText(mapStringToUnicode(map.encoding(), str));
+  }
 }
 
 bool MapFrame::canCutSelection() const
@@ -1633,7 +1661,16 @@ void MapFrame::pasteAtOriginalPosition()
 
 mdl::PasteType MapFrame::paste()
 {
+  auto& map = m_document->map();
   auto* clipboard = QApplication::clipboard();
+
+  if (const auto* copiedNodesData =
+        qobject_cast<const CopiedNodesMimeData*>(clipboard->mimeData());
+      copiedNodesData && copiedNodesData->isCopiedFrom(map))
+  {
+    return mdl::paste(map, copiedNodesData->copiedNodes());
+  }
+
   const auto qtext = clipboard->text();
 
   if (qtext.isEmpty())
@@ -1642,7 +1679,6 @@ mdl::PasteType MapFrame::paste()
     return mdl::PasteType::Failed;
   }
 
-  auto& map = m_document->map();
   return mdl::paste(map, mapStringFromUnicode(map.encoding(), qtext));
 }
 
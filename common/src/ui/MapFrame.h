@@ -210,6 +210,7 @@ public:
   bool saveDocumentAs();
   void revertDocument();
   bool exportDocumentAsObj();
+  bool exportDocumentAsGlb();
   bool exportDocumentAsMap();
   bool exportDocument(const io::ExportOptions& options);
 
@@ -30,6 +30,7 @@
 #include "Logger.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Trace.h"
 #include "mdl/BrushFace.h"
 #include "mdl/BrushNode.h"
 #include "mdl/EditorContext.h"
@@ -942,6 +943,8 @@ bool MapViewBase::shouldRenderFocusIndicator() const
 
 void MapViewBase::renderContents()
 {
+  const auto trace = TraceScope{"MapViewBase::render"};
+
   preRender();
 
   const auto& fontPath = pref(Preferences::RendererFontPath());
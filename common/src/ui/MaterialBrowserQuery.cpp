@@ -0,0 +1,178 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MaterialBrowserQuery.h"
+
+#include "Macros.h"
+#include "mdl/Material.h"
+#include "mdl/MaterialCollection.h"
+
+#include "kd/ranges/to.h"
+#include "kd/string_format.h"
+
+#include <algorithm>
+#include <ranges>
+
+namespace tb::ui
+{
+namespace
+{
+
+// how many materials are filtered between checks for a stop request
+constexpr auto StopCheckInterval = size_t(1024);
+
+bool matches(
+  const MaterialBrowserSnapshot& snapshot,
+  const size_t index,
+  const MaterialBrowserQuery& query)
+{
+  if (query.hideUnused && snapshot.usageCounts[index] == 0)
+  {
+    return false;
+  }
+
+  const auto& entry = snapshot.materials->entries[index];
+  return query.filterPatterns.empty()
+         || std::ranges::any_of(query.filterPatterns, [&](const auto& pattern) {
+              return entry.lowercaseName.find(pattern) != std::string::npos;
+            });
+}
+
+void sortEntries(
+  const MaterialBrowserSnapshot& snapshot,
+  std::vector<size_t>& indices,
+  const MaterialSortOrder sortOrder)
+{
+  const auto& entries = snapshot.materials->entries;
+  const auto& usageCounts = snapshot.usageCounts;
+
+  const auto compareNames = [&](const auto lhs, const auto rhs) {
+    return entries[lhs].lowercaseName < entries[rhs].lowercaseName;
+  };
+
+  switch (sortOrder)
+  {
+  case MaterialSortOrder::Name:
+    std::ranges::sort(indices, compareNames);
+    break;
+  case MaterialSortOrder::Usage:
+    std::ranges::sort(indices, [&](const auto lhs, const auto rhs) {
+      return usageCounts[lhs] < usageCounts[rhs]   ? false
+             : usageCounts[lhs] > usageCounts[rhs] ? true
+                                                   : compareNames(lhs, rhs);
+    });
+    break;
+    switchDefault();
+  }
+}
+
+std::vector<size_t> currentUsageCounts(
+  const std::vector<MaterialBrowserSnapshot::Entry>& entries)
+{
+  return entries
+         | std::views::transform([](const auto& entry) {
+             return entry.material->usageCount();
+           })
+         | kdl::ranges::to<std::vector>();
+}
+
+} // namespace
+
+std::shared_ptr<const MaterialBrowserSnapshot> makeMaterialBrowserSnapshot(
+  std::vector<const mdl::MaterialCollection*> collections)
+{
+  auto materials = std::make_shared<MaterialBrowserSnapshot::Materials>();
+
+  auto materialCount = size_t(0);
+  for (const auto* collection : collections)
+  {
+    materialCount += collection->materialCount();
+  }
+  materials->entries.reserve(materialCount);
+
+  for (size_t i = 0; i < collections.size(); ++i)
+  {
+    const auto& collection = *collections[i];
+    materials->collectionTitles.push_back(collection.path().string());
+    for (const auto& material : collection.materials())
+    {
+      materials->entries.push_back({&material, kdl::str_to_lower(material.name()), i});
+    }
+  }
+  materials->collections = std::move(collections);
+
+  auto usageCounts = currentUsageCounts(materials->entries);
+  return std::make_shared<MaterialBrowserSnapshot>(
+    MaterialBrowserSnapshot{std::move(materials), std::move(usageCounts)});
+}
+
+std::shared_ptr<const MaterialBrowserSnapshot> updateUsageCounts(
+  const MaterialBrowserSnapshot& snapshot)
+{
+  return std::make_shared<MaterialBrowserSnapshot>(MaterialBrowserSnapshot{
+    snapshot.materials, currentUsageCounts(snapshot.materials->entries)});
+}
+
+std::optional<std::vector<MaterialBrowserGroup>> runMaterialBrowserQuery(
+  const MaterialBrowserSnapshot& snapshot,
+  const MaterialBrowserQuery& query,
+  const std::stop_token stopToken)
+{
+  const auto& materials = *snapshot.materials;
+  const auto groupCount = query.group ? materials.collectionTitles.size() : size_t(1);
+  auto groupIndices = std::vector<std::vector<size_t>>(groupCount);
+
+  for (size_t i = 0; i < materials.entries.size(); ++i)
+  {
+    if (i % StopCheckInterval == 0 && stopToken.stop_requested())
+    {
+      return std::nullopt;
+    }
+
+    if (matches(snapshot, i, query))
+    {
+      groupIndices[query.group ? materials.entries[i].collectionIndex : 0].push_back(i);
+    }
+  }
+
+  auto result = std::vector<MaterialBrowserGroup>{};
+  result.reserve(groupCount);
+
+  for (size_t i = 0; i < groupCount; ++i)
+  {
+    if (stopToken.stop_requested())
+    {
+      return std::nullopt;
+    }
+
+    auto& indices = groupIndices[i];
+    sortEntries(snapshot, indices, query.sortOrder);
+
+    result.push_back(MaterialBrowserGroup{
+      query.group ? materials.collectionTitles[i] : std::string{},
+      indices | std::views::transform([&](const auto index) {
+        return materials.entries[index].material;
+      }) | kdl::ranges::to<std::vector>(),
+    });
+  }
+
+  return result;
+}
+
+} // namespace tb::ui
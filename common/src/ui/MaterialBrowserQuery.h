@@ -0,0 +1,112 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+namespace tb::mdl
+{
+class Material;
+class MaterialCollection;
+} // namespace tb::mdl
+
+namespace tb::ui
+{
+
+enum class MaterialSortOrder
+{
+  Name,
+  Usage
+};
+
+/**
+ * A copy of the data that the material browser needs to filter and sort the materials.
+ * A snapshot is immutable once created, so queries can run on a worker thread while
+ * the UI thread keeps changing the materials' usage counts.
+ *
+ * The materials are only referred to by pointer and never dereferenced by a query.
+ */
+struct MaterialBrowserSnapshot
+{
+  struct Entry
+  {
+    const mdl::Material* material;
+    std::string lowercaseName;
+    size_t collectionIndex;
+  };
+
+  /**
+   * The part of a snapshot that only changes when the collections change. It is shared by
+   * all snapshots that only differ in their usage counts.
+   */
+  struct Materials
+  {
+    std::vector<const mdl::MaterialCollection*> collections;
+    std::vector<std::string> collectionTitles;
+    std::vector<Entry> entries;
+  };
+
+  std::shared_ptr<const Materials> materials;
+  // the usage count of each entry
+  std::vector<size_t> usageCounts;
+};
+
+std::shared_ptr<const MaterialBrowserSnapshot> makeMaterialBrowserSnapshot(
+  std::vector<const mdl::MaterialCollection*> collections);
+
+/**
+ * Returns a snapshot that shares the materials of the given snapshot, but has the
+ * current usage counts of the materials.
+ */
+std::shared_ptr<const MaterialBrowserSnapshot> updateUsageCounts(
+  const MaterialBrowserSnapshot& snapshot);
+
+struct MaterialBrowserQuery
+{
+  bool group = false;
+  bool hideUnused = false;
+  MaterialSortOrder sortOrder = MaterialSortOrder::Name;
+  // lowercase patterns, a material matches if its name contains any of them
+  std::vector<std::string> filterPatterns;
+};
+
+struct MaterialBrowserGroup
+{
+  std::string title;
+  std::vector<const mdl::Material*> materials;
+};
+
+/**
+ * Filters and sorts the materials of the given snapshot. If the query groups the
+ * materials, the result contains one group per collection, otherwise it contains a
+ * single group with an empty title.
+ *
+ * Returns nullopt if a stop was requested via the given token before the query finished.
+ */
+std::optional<std::vector<MaterialBrowserGroup>> runMaterialBrowserQuery(
+  const MaterialBrowserSnapshot& snapshot,
+  const MaterialBrowserQuery& query,
+  std::stop_token stopToken = {});
+
+} // namespace tb::ui
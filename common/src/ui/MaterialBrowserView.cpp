@@ -21,6 +21,7 @@
 
 #include <QMenu>
 #include <QTextStream>
+#include <QTimer>
 
 #include "PreferenceManager.h"
 #include "Preferences.h"
@@ -33,6 +34,7 @@
 #include "mdl/MaterialManager.h"
 #include "mdl/Texture.h"
 #include "render/ActiveShader.h"
+#include "render/FontDescriptor.h"
 #include "render/FontManager.h"
 #include "render/GLVertexType.h"
 #include "render/PrimType.h"
@@ -41,37 +43,66 @@
 #include "render/Transformation.h"
 #include "render/VertexArray.h"
 #include "ui/MapDocument.h"
+#include "ui/SignalDelayer.h"
 
 #include "kd/contracts.h"
-#include "kd/ranges/to.h"
-#include "kd/string_compare.h"
+#include "kd/string_format.h"
 #include "kd/string_utils.h"
+#include "kd/task_manager.h"
 #include "kd/vector_utils.h"
 
 #include "vm/mat.h"
 #include "vm/mat_ext.h"
 #include "vm/vec.h"
 
-#include <ranges>
+#include <chrono>
+#include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace tb::ui
 {
 
+using namespace std::chrono_literals;
+
 MaterialBrowserView::MaterialBrowserView(
   QScrollBar* scrollBar, GLContextManager& contextManager, MapDocument& document)
   : CellView{contextManager, scrollBar}
   , m_document{document}
+  , m_filterTextSignalDelayer{new SignalDelayer{150ms, this}}
+  , m_pendingQueryTimer{new QTimer{this}}
 {
+  connect(
+    m_filterTextSignalDelayer,
+    &SignalDelayer::processSignal,
+    this,
+    &MaterialBrowserView::queryMaterials);
+  connect(
+    m_pendingQueryTimer,
+    &QTimer::timeout,
+    this,
+    &MaterialBrowserView::pendingQueryTimerDidFire);
+
+  m_notifierConnection += m_document.documentWasLoadedNotifier.connect(
+    this, &MaterialBrowserView::documentWasLoaded);
+  m_notifierConnection += m_document.documentDidChangeNotifier.connect(
+    this, &MaterialBrowserView::documentDidChange);
+  m_notifierConnection += m_document.materialCollectionsWillChangeNotifier.connect(
+    this, &MaterialBrowserView::materialCollectionsWillChange);
+  m_notifierConnection += m_document.materialCollectionsDidChangeNotifier.connect(
+    this, &MaterialBrowserView::materialCollectionsDidChange);
   m_notifierConnection += m_document.materialUsageCountsDidChangeNotifier.connect(
-    this, &MaterialBrowserView::reloadMaterials);
+    this, &MaterialBrowserView::materialUsageCountsDidChange);
   m_notifierConnection += m_document.resourcesWereProcessedNotifier.connect(
     this, &MaterialBrowserView::resourcesWereProcessed);
+
+  queryMaterials();
 }
 
 MaterialBrowserView::~MaterialBrowserView()
 {
+  cancelPendingQuery();
   clear();
 }
 
@@ -80,7 +111,12 @@ void MaterialBrowserView::setSortOrder(const MaterialSortOrder sortOrder)
   if (sortOrder != m_sortOrder)
   {
     m_sortOrder = sortOrder;
-    reloadMaterials();
+    if (m_sortOrder == MaterialSortOrder::Usage)
+    {
+      // the snapshot's usage counts may be outdated
+      refreshUsageCounts();
+    }
+    queryMaterials();
   }
 }
 
@@ -89,7 +125,7 @@ void MaterialBrowserView::setGroup(const bool group)
   if (group != m_group)
   {
     m_group = group;
-    reloadMaterials();
+    queryMaterials();
   }
 }
 
@@ -98,7 +134,12 @@ void MaterialBrowserView::setHideUnused(const bool hideUnused)
   if (hideUnused != m_hideUnused)
   {
     m_hideUnused = hideUnused;
-    reloadMaterials();
+    if (m_hideUnused)
+    {
+      // the snapshot's usage counts may be outdated
+      refreshUsageCounts();
+    }
+    queryMaterials();
   }
 }
 
@@ -107,7 +148,10 @@ void MaterialBrowserView::setFilterText(const std::string& filterText)
   if (filterText != m_filterText)
   {
     m_filterText = filterText;
-    reloadMaterials();
+    m_filterPatterns = kdl::str_split(kdl::str_to_lower(m_filterText), " ");
+
+    // wait for the user to stop typing
+    m_filterTextSignalDelayer->queueSignal();
   }
 }
 
@@ -127,6 +171,13 @@ void MaterialBrowserView::setSelectedMaterial(const mdl::Material* selectedMater
 
 void MaterialBrowserView::revealMaterial(const mdl::Material* material)
 {
+  if (m_pendingQuery || m_filterTextSignalDelayer->isPending())
+  {
+    // reveal the material once the materials were updated
+    m_materialToReveal = material;
+    return;
+  }
+
   scrollToCell([&](const Cell& cell) {
     const auto& cellMaterial = cellData(cell);
     return &cellMaterial == material;
@@ -138,12 +189,128 @@ void MaterialBrowserView::resourcesWereProcessed(const std::vector<mdl::Resource
   reloadMaterials();
 }
 
+void MaterialBrowserView::documentWasLoaded()
+{
+  clearMaterials();
+  queryMaterials();
+}
+
+void MaterialBrowserView::documentDidChange()
+{
+  if (!m_snapshot || m_snapshot->materials->collections != getCollections())
+  {
+    // the enabled collections have changed
+    m_snapshot.reset();
+    queryMaterials();
+  }
+}
+
+void MaterialBrowserView::materialCollectionsWillChange()
+{
+  // the materials are about to be destroyed
+  clearMaterials();
+}
+
+void MaterialBrowserView::materialCollectionsDidChange()
+{
+  queryMaterials();
+}
+
+void MaterialBrowserView::materialUsageCountsDidChange()
+{
+  if (m_hideUnused || m_sortOrder == MaterialSortOrder::Usage)
+  {
+    refreshUsageCounts();
+    queryMaterials();
+  }
+  else
+  {
+    reloadMaterials();
+  }
+}
+
 void MaterialBrowserView::reloadMaterials()
 {
   invalidate();
   update();
 }
 
+void MaterialBrowserView::refreshUsageCounts()
+{
+  if (m_snapshot)
+  {
+    m_snapshot = updateUsageCounts(*m_snapshot);
+  }
+}
+
+void MaterialBrowserView::clearMaterials()
+{
+  cancelPendingQuery();
+  m_snapshot.reset();
+  m_materials.clear();
+  m_materialToReveal = nullptr;
+  reloadMaterials();
+}
+
+void MaterialBrowserView::queryMaterials()
+{
+  cancelPendingQuery();
+
+  if (!m_snapshot)
+  {
+    m_snapshot = makeMaterialBrowserSnapshot(getCollections());
+  }
+
+  auto query = MaterialBrowserQuery{m_group, m_hideUnused, m_sortOrder, m_filterPatterns};
+  auto stopSource = std::stop_source{};
+  auto result = m_document.map().taskManager().run_task(
+    std::function{[snapshot = m_snapshot,
+                   query = std::move(query),
+                   stopToken = stopSource.get_token()]() {
+      return runMaterialBrowserQuery(*snapshot, query, stopToken);
+    }});
+
+  m_pendingQuery = PendingQuery{std::move(stopSource), std::move(result)};
+  m_pendingQueryTimer->start(10);
+}
+
+void MaterialBrowserView::cancelPendingQuery()
+{
+  if (m_pendingQuery)
+  {
+    m_pendingQuery->stopSource.request_stop();
+    m_pendingQuery = std::nullopt;
+    m_pendingQueryTimer->stop();
+  }
+}
+
+void MaterialBrowserView::pendingQueryTimerDidFire()
+{
+  if (
+    !m_pendingQuery
+    || m_pendingQuery->result.wait_for(std::chrono::seconds{0})
+         != std::future_status::ready)
+  {
+    return;
+  }
+
+  auto result = m_pendingQuery->result.get();
+  m_pendingQuery = std::nullopt;
+  m_pendingQueryTimer->stop();
+
+  if (result)
+  {
+    m_materials = std::move(*result);
+    m_materialsGrouped = m_group;
+    reloadMaterials();
+
+    if (const auto* material = std::exchange(m_materialToReveal, nullptr))
+    {
+      revealMaterial(material);
+    }
+  }
+}
+
 void MaterialBrowserView::doInitLayout(Layout& layout)
 {
   const auto scaleFactor = pref(Preferences::MaterialBrowserIconSize);
@@ -165,38 +332,36 @@ void MaterialBrowserView::doReloadLayout(Layout& layout)
 
   const auto font = render::FontDescriptor{fontPath, size_t(fontSize)};
 
-  if (m_group)
+  // material names are single lines, so all titles have the same height
+  const auto titleHeight = float(fontManager().font(font).lineHeight());
+
+  for (const auto& group : m_materials)
   {
-    for (const auto* collection : getCollections())
+    if (m_materialsGrouped)
     {
-      layout.addGroup(collection->path().string(), float(fontSize) + 2.0f);
-      addMaterialsToLayout(layout, getMaterials(*collection), font);
+      layout.addGroup(group.title, float(fontSize) + 2.0f);
     }
-  }
-  else
-  {
-    addMaterialsToLayout(layout, getMaterials(), font);
+    addMaterialsToLayout(layout, group.materials, titleHeight);
   }
 }
 
 void MaterialBrowserView::addMaterialsToLayout(
   Layout& layout,
   const std::vector<const mdl::Material*>& materials,
-  const render::FontDescriptor& font)
+  const float titleHeight)
 {
   for (const auto* material : materials)
   {
-    addMaterialToLayout(layout, *material, font);
+    addMaterialToLayout(layout, *material, titleHeight);
   }
 }
 
 void MaterialBrowserView::addMaterialToLayout(
-  Layout& layout, const mdl::Material& material, const render::FontDescriptor& font)
+  Layout& layout, const mdl::Material& material, const float titleHeight)
 {
   const auto maxCellWidth = layout.maxCellWidth();
 
   const auto materialName = std::filesystem::path{material.name()}.filename().string();
-  const auto titleHeight = fontManager().font(font).measure(materialName).y();
 
   const auto scaleFactor = pref(Preferences::MaterialBrowserIconSize);
   const auto* texture = material.texture();
@@ -228,68 +393,6 @@ std::vector<const mdl::MaterialCollection*> MaterialBrowserView::getCollections(
   return result;
 }
 
-std::vector<const mdl::Material*> MaterialBrowserView::getMaterials(
-  const mdl::MaterialCollection& collection) const
-{
-  return sortMaterials(filterMaterials(
-    collection.materials() | std::views::transform([](const auto& t) { return &t; })
-    | kdl::ranges::to<std::vector>()));
-}
-
-std::vector<const mdl::Material*> MaterialBrowserView::getMaterials() const
-{
-  auto materials = std::vector<const mdl::Material*>{};
-  for (const auto& collection : getCollections())
-  {
-    for (const auto& material : collection->materials())
-    {
-      materials.push_back(&material);
-    }
-  }
-  return sortMaterials(filterMaterials(materials));
-}
-
-std::vector<const mdl::Material*> MaterialBrowserView::filterMaterials(
-  std::vector<const mdl::Material*> materials) const
-{
-  if (m_hideUnused)
-  {
-    std::erase_if(
-      materials, [](const auto* material) { return material->usageCount() == 0; });
-  }
-  if (!m_filterText.empty())
-  {
-    std::erase_if(materials, [&](const auto* material) {
-      return std::ranges::none_of(
-        kdl::str_split(m_filterText, " "), [&](const auto& pattern) {
-          return kdl::ci::str_contains(material->name(), pattern);
-        });
-    });
-  }
-  return materials;
-}
-
-std::vector<const mdl::Material*> MaterialBrowserView::sortMaterials(
-  std::vector<const mdl::Material*> materials) const
-{
-  const auto compareNames = [](const auto& lhs, const auto& rhs) {
-    return kdl::ci::string_less{}(lhs->name(), rhs->name());
-  };
-
-  switch (m_sortOrder)
-  {
-  case MaterialSortOrder::Name:
-    return kdl::vec_sort(std::move(materials), compareNames);
-  case MaterialSortOrder::Usage:
-    return kdl::vec_sort(std::move(materials), [&](const auto* lhs, const auto* rhs) {
-      return lhs->usageCount() < rhs->usageCount()   ? false
-             : lhs->usageCount() > rhs->usageCount() ? true
-                                                     : compareNames(lhs, rhs);
-    });
-    switchDefault();
-  }
-}
-
 void MaterialBrowserView::doClear() {}
 
 void MaterialBrowserView::doRender(Layout& layout, const float y, const float height)
@@ -327,28 +430,25 @@ void MaterialBrowserView::renderBounds(Layout& layout, const float y, const floa
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
-          {
-            const auto& bounds = cell.itemBounds();
-            const auto& material = cellData(cell);
-            const auto& color = materialColor(material);
-            vertices.emplace_back(
-              vm::vec2f{bounds.left() - 2.0f, height - (bounds.top() - 2.0f - y)},
-              color.to<RgbaF>().toVec());
-            vertices.emplace_back(
-              vm::vec2f{bounds.left() - 2.0f, height - (bounds.bottom() + 2.0f - y)},
-              color.to<RgbaF>().toVec());
-            vertices.emplace_back(
-              vm::vec2f{bounds.right() + 2.0f, height - (bounds.bottom() + 2.0f - y)},
-              color.to<RgbaF>().toVec());
-            vertices.emplace_back(
-              vm::vec2f{bounds.right() + 2.0f, height - (bounds.top() - 2.0f - y)},
-              color.to<RgbaF>().toVec());
-          }
+          const auto& bounds = cell.itemBounds();
+          const auto& material = cellData(cell);
+          const auto& color = materialColor(material);
+          vertices.emplace_back(
+            vm::vec2f{bounds.left() - 2.0f, height - (bounds.top() - 2.0f - y)},
+            color.to<RgbaF>().toVec());
+          vertices.emplace_back(
+            vm::vec2f{bounds.left() - 2.0f, height - (bounds.bottom() + 2.0f - y)},
+            color.to<RgbaF>().toVec());
+          vertices.emplace_back(
+            vm::vec2f{bounds.right() + 2.0f, height - (bounds.bottom() + 2.0f - y)},
+            color.to<RgbaF>().toVec());
+          vertices.emplace_back(
+            vm::vec2f{bounds.right() + 2.0f, height - (bounds.top() - 2.0f - y)},
+            color.to<RgbaF>().toVec());
         }
       }
     }
@@ -390,30 +490,27 @@ void MaterialBrowserView::renderMaterials(
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
-          {
-            const auto& bounds = cell.itemBounds();
-            const auto& material = cellData(cell);
-
-            auto vertexArray = render::VertexArray::move(std::vector<Vertex>{
-              Vertex{{bounds.left(), height - (bounds.top() - y)}, {0, 0}},
-              Vertex{{bounds.left(), height - (bounds.bottom() - y)}, {0, 1}},
-              Vertex{{bounds.right(), height - (bounds.bottom() - y)}, {1, 1}},
-              Vertex{{bounds.right(), height - (bounds.top() - y)}, {1, 0}},
-            });
-
-            material.activate(
-              pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
-
-            vertexArray.prepare(vboManager());
-            vertexArray.render(render::PrimType::Quads);
-
-            material.deactivate();
-          }
+          const auto& bounds = cell.itemBounds();
+          const auto& material = cellData(cell);
+
+          auto vertexArray = render::VertexArray::move(std::vector<Vertex>{
+            Vertex{{bounds.left(), height - (bounds.top() - y)}, {0, 0}},
+            Vertex{{bounds.left(), height - (bounds.bottom() - y)}, {0, 1}},
+            Vertex{{bounds.right(), height - (bounds.bottom() - y)}, {1, 1}},
+            Vertex{{bounds.right(), height - (bounds.top() - y)}, {1, 0}},
+          });
+
+          material.activate(
+            pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
+
+          vertexArray.prepare(vboManager());
+          vertexArray.render(render::PrimType::Quads);
+
+          material.deactivate();
         }
       }
     }
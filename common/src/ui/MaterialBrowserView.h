@@ -20,13 +20,18 @@
 #pragma once
 
 #include "NotifierConnection.h"
-#include "render/FontDescriptor.h"
 #include "ui/CellView.h"
+#include "ui/MaterialBrowserQuery.h"
 
+#include <future>
+#include <memory>
+#include <optional>
+#include <stop_token>
 #include <string>
 #include <vector>
 
 class QScrollBar;
+class QTimer;
 
 namespace tb
 {
@@ -41,15 +46,10 @@ namespace ui
 {
 class GLContextManager;
 class MapDocument;
+class SignalDelayer;
 
 using MaterialGroupData = std::string;
 
-enum class MaterialSortOrder
-{
-  Name,
-  Usage
-};
-
 class MaterialBrowserView : public CellView
 {
   Q_OBJECT
@@ -59,7 +59,29 @@ private:
   bool m_hideUnused = false;
   MaterialSortOrder m_sortOrder = MaterialSortOrder::Name;
   std::string m_filterText;
-
+  std::vector<std::string> m_filterPatterns;
+
+  /**
+   * The materials are filtered and sorted on a worker thread using a snapshot of the
+   * material collections. The snapshot is only recreated when the collections change.
+   * When the usage counts change, only the snapshot's usage counts are refreshed, and
+   * only if the query depends on them.
+   */
+  std::shared_ptr<const MaterialBrowserSnapshot> m_snapshot;
+  std::vector<MaterialBrowserGroup> m_materials;
+  bool m_materialsGrouped = false;
+
+  struct PendingQuery
+  {
+    std::stop_source stopSource;
+    std::future<std::optional<std::vector<MaterialBrowserGroup>>> result;
+  };
+  std::optional<PendingQuery> m_pendingQuery;
+
+  SignalDelayer* m_filterTextSignalDelayer = nullptr;
+  QTimer* m_pendingQueryTimer = nullptr;
+
+  const mdl::Material* m_materialToReveal = nullptr;
   const mdl::Material* m_selectedMaterial = nullptr;
 
   NotifierConnection m_notifierConnection;
@@ -82,7 +104,18 @@ public:
 private:
   void resourcesWereProcessed(const std::vector<mdl::ResourceId>& resources);
 
+  void documentWasLoaded();
+  void documentDidChange();
+  void materialCollectionsWillChange();
+  void materialCollectionsDidChange();
+  void materialUsageCountsDidChange();
   void reloadMaterials();
+  void refreshUsageCounts();
+
+  void clearMaterials();
+  void queryMaterials();
+  void cancelPendingQuery();
+  void pendingQueryTimerDidFire();
 
   void doInitLayout(Layout& layout) override;
   void doReloadLayout(Layout& layout) override;
@@ -90,19 +123,11 @@ private:
   void addMaterialsToLayout(
     Layout& layout,
     const std::vector<const mdl::Material*>& materials,
-    const render::FontDescriptor& font);
+    float titleHeight);
   void addMaterialToLayout(
-    Layout& layout, const mdl::Material& material, const render::FontDescriptor& font);
+    Layout& layout, const mdl::Material& material, float titleHeight);
 
   std::vector<const mdl::MaterialCollection*> getCollections() const;
-  std::vector<const mdl::Material*> getMaterials(
-    const mdl::MaterialCollection& collection) const;
-  std::vector<const mdl::Material*> getMaterials() const;
-
-  std::vector<const mdl::Material*> filterMaterials(
-    std::vector<const mdl::Material*> materials) const;
-  std::vector<const mdl::Material*> sortMaterials(
-    std::vector<const mdl::Material*> materials) const;
 
   void doClear() override;
   void doRender(Layout& layout, float y, float height) override;
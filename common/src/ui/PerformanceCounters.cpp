@@ -0,0 +1,192 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PerformanceCounters.h"
+
+#include <QLabel>
+#include <QLocale>
+#include <QScrollArea>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include "mdl/Map.h"
+#include "mdl/MapStatistics.h"
+#include "render/GL.h"
+#include "render/VboManager.h"
+#include "ui/FormWithSectionsLayout.h"
+#include "ui/GLContextManager.h"
+#include "ui/MapDocument.h"
+#include "ui/ViewConstants.h"
+
+#include "kd/task_manager.h"
+
+namespace tb::ui
+{
+namespace
+{
+
+QString formatCount(const size_t count)
+{
+  return QLocale{}.toString(qulonglong(count));
+}
+
+QString formatBytes(const size_t bytes)
+{
+  return QLocale{}.formattedDataSize(qint64(bytes));
+}
+
+} // namespace
+
+PerformanceCounters::PerformanceCounters(
+  MapDocument& document, GLContextManager& contextManager, QWidget* parent)
+  : TabBookPage{parent}
+  , m_document{document}
+  , m_contextManager{contextManager}
+  , m_timer{new QTimer{this}}
+  , m_lastUpdateTime{std::chrono::steady_clock::now()}
+{
+  createGui();
+
+  connect(m_timer, &QTimer::timeout, this, [&]() {
+    if (isVisible())
+    {
+      updateCounters();
+    }
+  });
+  m_timer->start(1000);
+}
+
+void PerformanceCounters::showEvent(QShowEvent* event)
+{
+  TabBookPage::showEvent(event);
+  updateCounters();
+}
+
+void PerformanceCounters::createGui()
+{
+  const auto makeLabel = []() {
+    auto* label = new QLabel{};
+    label->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    return label;
+  };
+
+  m_layerCountLabel = makeLabel();
+  m_groupCountLabel = makeLabel();
+  m_entityCountLabel = makeLabel();
+  m_brushCountLabel = makeLabel();
+  m_brushFaceCountLabel = makeLabel();
+  m_patchCountLabel = makeLabel();
+  m_undoMemoryLabel = makeLabel();
+
+  m_pendingResourcesLabel = makeLabel();
+  m_textureMemoryLabel = makeLabel();
+
+  m_vboCountLabel = makeLabel();
+  m_vboMemoryLabel = makeLabel();
+  m_drawCallsLabel = makeLabel();
+
+  m_workerCountLabel = makeLabel();
+  m_pendingTasksLabel = makeLabel();
+  m_workerUtilizationLabel = makeLabel();
+
+  auto* layout = new FormWithSectionsLayout{};
+  layout->setContentsMargins(
+    0, LayoutConstants::MediumVMargin, 0, LayoutConstants::MediumVMargin);
+  layout->setVerticalSpacing(2);
+
+  layout->addSection(tr("Map"));
+  layout->addRow(tr("Layers"), m_layerCountLabel);
+  layout->addRow(tr("Groups"), m_groupCountLabel);
+  layout->addRow(tr("Entities"), m_entityCountLabel);
+  layout->addRow(tr("Brushes"), m_brushCountLabel);
+  layout->addRow(tr("Brush faces"), m_brushFaceCountLabel);
+  layout->addRow(tr("Patches"), m_patchCountLabel);
+  layout->addRow(tr("Undo memory"), m_undoMemoryLabel);
+
+  layout->addSection(tr("Resources"));
+  layout->addRow(tr("Pending resources"), m_pendingResourcesLabel);
+  layout->addRow(tr("Texture memory"), m_textureMemoryLabel);
+
+  layout->addSection(tr("Rendering"));
+  layout->addRow(tr("Vertex buffers"), m_vboCountLabel);
+  layout->addRow(tr("Vertex buffer memory"), m_vboMemoryLabel);
+  layout->addRow(tr("Draw calls (all views)"), m_drawCallsLabel);
+
+  layout->addSection(tr("Tasks"));
+  layout->addRow(tr("Workers"), m_workerCountLabel);
+  layout->addRow(tr("Pending tasks"), m_pendingTasksLabel);
+  layout->addRow(tr("Worker utilization"), m_workerUtilizationLabel);
+
+  auto* content = new QWidget{};
+  content->setLayout(layout);
+
+  auto* scrollArea = new QScrollArea{};
+  scrollArea->setWidget(content);
+  scrollArea->setWidgetResizable(true);
+
+  auto* sizer = new QVBoxLayout{};
+  sizer->setContentsMargins(0, 0, 0, 0);
+  sizer->addWidget(scrollArea);
+  setLayout(sizer);
+}
+
+void PerformanceCounters::updateCounters()
+{
+  auto& map = m_document.map();
+
+  const auto statistics = mdl::computeMapStatistics(map);
+  m_layerCountLabel->setText(formatCount(statistics.layerCount));
+  m_groupCountLabel->setText(formatCount(statistics.groupCount));
+  m_entityCountLabel->setText(formatCount(statistics.entityCount));
+  m_brushCountLabel->setText(formatCount(statistics.brushCount));
+  m_brushFaceCountLabel->setText(formatCount(statistics.brushFaceCount));
+  m_patchCountLabel->setText(formatCount(statistics.patchCount));
+  m_undoMemoryLabel->setText(formatBytes(statistics.undoMemoryUsage));
+
+  m_pendingResourcesLabel->setText(formatCount(statistics.pendingResourceCount));
+  m_textureMemoryLabel->setText(formatBytes(statistics.textureMemoryUsage));
+
+  const auto& vboManager = m_contextManager.vboManager();
+  m_vboCountLabel->setText(tr("%1 (peak %2)")
+                             .arg(formatCount(vboManager.currentVboCount()))
+                             .arg(formatCount(vboManager.peakVboCount())));
+  m_vboMemoryLabel->setText(formatBytes(vboManager.currentVboSize()));
+  m_drawCallsLabel->setText(formatCount(glLastFrameDrawCallCount()));
+
+  // the utilization is the share of the time since the last update that the workers
+  // spent running tasks
+  const auto taskManagerStats = map.taskManager().stats();
+  const auto now = std::chrono::steady_clock::now();
+  const auto elapsed = std::chrono::duration<double>{now - m_lastUpdateTime}
+                       * double(taskManagerStats.worker_count);
+  const auto busyTime =
+    std::chrono::duration<double>{taskManagerStats.busy_time - m_lastBusyTime};
+  const auto utilization = elapsed.count() > 0.0 ? 100.0 * busyTime / elapsed : 0.0;
+  m_lastUpdateTime = now;
+  m_lastBusyTime = taskManagerStats.busy_time;
+
+  m_workerCountLabel->setText(formatCount(taskManagerStats.worker_count));
+  m_pendingTasksLabel->setText(formatCount(taskManagerStats.pending_task_count));
+  m_workerUtilizationLabel->setText(
+    tr("%1% (%2 busy)")
+      .arg(utilization, 0, 'f', 0)
+      .arg(formatCount(taskManagerStats.busy_worker_count)));
+}
+
+} // namespace tb::ui
@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "ui/TabBook.h"
+
+#include <chrono>
+
+class QLabel;
+class QShowEvent;
+class QTimer;
+class QWidget;
+
+namespace tb::ui
+{
+class GLContextManager;
+class MapDocument;
+
+/**
+ * Shows live counters that help to diagnose performance problems: node counts, memory
+ * usage, pending resources, rendering statistics and the utilization of the task manager.
+ *
+ * The counters are refreshed periodically while the page is visible.
+ */
+class PerformanceCounters : public TabBookPage
+{
+  Q_OBJECT
+private:
+  MapDocument& m_document;
+  GLContextManager& m_contextManager;
+  QTimer* m_timer = nullptr;
+
+  QLabel* m_layerCountLabel = nullptr;
+  QLabel* m_groupCountLabel = nullptr;
+  QLabel* m_entityCountLabel = nullptr;
+  QLabel* m_brushCountLabel = nullptr;
+  QLabel* m_brushFaceCountLabel = nullptr;
+  QLabel* m_patchCountLabel = nullptr;
+  QLabel* m_undoMemoryLabel = nullptr;
+
+  QLabel* m_pendingResourcesLabel = nullptr;
+  QLabel* m_textureMemoryLabel = nullptr;
+
+  QLabel* m_vboCountLabel = nullptr;
+  QLabel* m_vboMemoryLabel = nullptr;
+  QLabel* m_drawCallsLabel = nullptr;
+
+  QLabel* m_workerCountLabel = nullptr;
+  QLabel* m_pendingTasksLabel = nullptr;
+  QLabel* m_workerUtilizationLabel = nullptr;
+
+  std::chrono::steady_clock::time_point m_lastUpdateTime;
+  std::chrono::steady_clock::duration m_lastBusyTime{};
+
+public:
+  PerformanceCounters(
+    MapDocument& document, GLContextManager& contextManager, QWidget* parent = nullptr);
+
+protected:
+  void showEvent(QShowEvent* event) override;
+
+private:
+  void createGui();
+  void updateCounters();
+};
+
+} // namespace tb::ui
@@ -582,11 +582,12 @@ void showModelessDialog(QDialog* dialog)
   dialog->activateWindow();
 }
 
-QString mapStringToUnicode(const mdl::MapTextEncoding encoding, const std::string& string)
+QString mapStringToUnicode(
+  const mdl::MapTextEncoding encoding, const std::string_view string)
 {
   const auto codec = codecForEncoding(encoding);
   auto decode = QStringDecoder{codec};
-  return decode(QByteArray::fromStdString(string));
+  return decode(QByteArrayView{string.data(), qsizetype(string.size())});
 }
 
 std::string mapStringFromUnicode(
@@ -262,7 +262,7 @@ void deleteChildWidgetsLaterAndDeleteLayout(QWidget* widget);
 
 void showModelessDialog(QDialog* dialog);
 
-QString mapStringToUnicode(mdl::MapTextEncoding encoding, const std::string& string);
+QString mapStringToUnicode(mdl::MapTextEncoding encoding, std::string_view string);
 std::string mapStringFromUnicode(mdl::MapTextEncoding encoding, const QString& string);
 
 /**
@@ -119,7 +119,10 @@ RenderView::RenderView(GLContextManager& contextManager, QWidget* parent)
   setFocusPolicy(Qt::StrongFocus); // accept focus by clicking or tab
 }
 
-RenderView::~RenderView() = default;
+RenderView::~RenderView()
+{
+  glDiscardFrame(this);
+}
 
 void RenderView::keyPressEvent(QKeyEvent* event)
 {
@@ -206,6 +209,7 @@ void RenderView::paintGL()
   }
 
   render();
+  glFinishFrame(this);
 
   // Update stats
   m_framesRendered++;
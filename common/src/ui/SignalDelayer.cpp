@@ -43,6 +43,11 @@ SignalDelayer::SignalDelayer(QObject* parent)
 {
 }
 
+bool SignalDelayer::isPending() const
+{
+  return m_timer->isActive();
+}
+
 void SignalDelayer::queueSignal()
 {
   static const QMetaMethod processSignalMetaMethod =
@@ -42,6 +42,11 @@ public:
   explicit SignalDelayer(std::chrono::milliseconds delay, QObject* parent = nullptr);
   explicit SignalDelayer(QObject* parent = nullptr);
 
+  /**
+   * Indicates whether a signal was queued and not yet emitted.
+   */
+  bool isPending() const;
+
 public slots:
   /**
    * Enqueues an action on the Qt event loop that will emit `processSignal()`.
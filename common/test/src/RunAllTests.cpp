@@ -20,6 +20,7 @@
 #define CATCH_CONFIG_RUNNER
 
 #include "Contracts.h"
+#include "Preferences.h"
 #include "TestPreferenceManager.h"
 #include "TrenchBroomApp.h"
 #include "ui/CrashReporter.h"
@@ -33,6 +34,8 @@ int main(int argc, char** argv)
   tb::setContractViolationHandler();
 
   tb::PreferenceManager::createInstance<tb::TestPreferenceManager>();
+  // don't write decoded entity models into the user's cache directory
+  tb::setPref(tb::Preferences::CacheEntityModels, false);
   tb::ui::TrenchBroomApp app(argc, argv);
 
   tb::ui::setCrashReportGUIEnabled(false);
@@ -20,12 +20,25 @@
 
 #include "Logger.h"
 #include "fs/DiskFileSystem.h"
+#include "fs/PathInfo.h"
+#include "fs/TestEnvironment.h"
 #include "io/AssimpLoader.h"
+#include "io/EntityModelCache.h"
 #include "mdl/EntityModel.h"
 
+#include "kd/result.h"
+#include "kd/task_manager.h"
+
 #include "vm/approx.h"
 #include "vm/bbox_io.h" // IWYU pragma: keep
 
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #include "catch/CatchConfig.h"
 
 #include <catch2/catch_test_macros.hpp>
@@ -33,10 +46,78 @@
 
 namespace tb::io
 {
+namespace
+{
+
+/**
+ * Forwards to another file system and records every path that is probed.
+ */
+class ProbeRecordingFileSystem : public fs::FileSystem
+{
+private:
+  const fs::FileSystem& m_fs;
+  mutable std::mutex m_mutex;
+  mutable std::vector<std::filesystem::path> m_probedPaths;
+
+public:
+  explicit ProbeRecordingFileSystem(const fs::FileSystem& fs)
+    : m_fs{fs}
+  {
+  }
+
+  std::vector<std::filesystem::path> takeProbedPaths()
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    return std::exchange(m_probedPaths, {});
+  }
+
+  Result<std::filesystem::path> makeAbsolute(
+    const std::filesystem::path& path) const override
+  {
+    return m_fs.makeAbsolute(path);
+  }
+
+  fs::PathInfo pathInfo(const std::filesystem::path& path) const override
+  {
+    addProbedPath(path);
+    return m_fs.pathInfo(path);
+  }
+
+  const fs::FileSystemMetadata* metadata(
+    const std::filesystem::path& path, const std::string& key) const override
+  {
+    return m_fs.metadata(path, key);
+  }
+
+protected:
+  Result<std::vector<std::filesystem::path>> doFind(
+    const std::filesystem::path& path,
+    const fs::TraversalMode& traversalMode) const override
+  {
+    addProbedPath(path);
+    return m_fs.find(path, traversalMode);
+  }
+
+  Result<std::shared_ptr<fs::File>> doOpenFile(
+    const std::filesystem::path& path) const override
+  {
+    return m_fs.openFile(path);
+  }
+
+private:
+  void addProbedPath(const std::filesystem::path& path) const
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    m_probedPaths.push_back(path);
+  }
+};
+
+} // namespace
 
 TEST_CASE("AssimpLoader")
 {
   auto logger = NullLogger{};
+  auto taskManager = kdl::task_manager{};
 
   SECTION("cube")
   {
@@ -45,7 +126,7 @@ TEST_CASE("AssimpLoader")
 
     SECTION("dae")
     {
-      auto loader = AssimpLoader{"cube.dae", *fs};
+      auto loader = AssimpLoader{"cube.dae", *fs, taskManager};
       auto modelData = loader.load(logger);
       REQUIRE(modelData);
 
@@ -56,7 +137,7 @@ TEST_CASE("AssimpLoader")
 
     SECTION("mdl")
     {
-      auto loader = AssimpLoader{"cube.mdl", *fs};
+      auto loader = AssimpLoader{"cube.mdl", *fs, taskManager};
 
       auto modelData = loader.load(logger);
       REQUIRE(modelData);
@@ -86,7 +167,7 @@ TEST_CASE("AssimpLoader")
       std::filesystem::current_path() / "fixture/test/io/assimp/alignment";
     auto fs = std::make_shared<fs::DiskFileSystem>(basePath);
 
-    auto loader = AssimpLoader{modelPath, *fs};
+    auto loader = AssimpLoader{modelPath, *fs, taskManager};
 
     auto modelData = loader.load(logger);
     REQUIRE(modelData);
@@ -99,4 +180,188 @@ TEST_CASE("AssimpLoader")
   }
 }
 
+TEST_CASE("AssimpTexturePathCache")
+{
+  auto env = fs::TestEnvironment{[](auto& e) {
+    e.createDirectory("models");
+    e.createDirectory("models/textures");
+    e.createFile("models/model.obj", "");
+    e.createFile("models/textures/skin.png", "");
+    e.createFile("models/other.tga", "");
+  }};
+
+  auto fs = fs::DiskFileSystem{env.dir()};
+  auto cache = AssimpTexturePathCache{};
+
+  SECTION("resolves texture paths")
+  {
+    const auto modelPath = std::filesystem::path{"models/model.obj"};
+
+    // relative to the file system root
+    CHECK(
+      cache.resolve(fs, "models/textures/skin.png", modelPath)
+      == std::filesystem::path{"models/textures/skin.png"});
+
+    // relative to the model
+    CHECK(
+      cache.resolve(fs, "textures/skin.png", modelPath)
+      == std::filesystem::path{"models/textures/skin.png"});
+
+    // a file with the same name and a different extension
+    CHECK(
+      cache.resolve(fs, "textures/skin.jpg", modelPath)
+      == std::filesystem::path{"models/textures/skin.png"});
+    CHECK(
+      cache.resolve(fs, "C:/some/path/other.bmp", modelPath)
+      == std::filesystem::path{"models/other.tga"});
+
+    CHECK(cache.resolve(fs, "missing.png", modelPath) == std::nullopt);
+    CHECK(cache.resolve(fs, "", modelPath) == std::nullopt);
+  }
+
+  SECTION("caches resolved paths until cleared")
+  {
+    const auto modelPath = std::filesystem::path{"models/model.obj"};
+
+    REQUIRE(cache.resolve(fs, "skin.bmp", modelPath) == std::nullopt);
+    REQUIRE(
+      cache.resolve(fs, "other.jpg", modelPath)
+      == std::filesystem::path{"models/other.tga"});
+
+    env.createFile("models/skin.png", "");
+    env.remove("models/other.tga");
+
+    CHECK(cache.resolve(fs, "skin.bmp", modelPath) == std::nullopt);
+    CHECK(
+      cache.resolve(fs, "other.jpg", modelPath)
+      == std::filesystem::path{"models/other.tga"});
+
+    cache.clear();
+
+    CHECK(
+      cache.resolve(fs, "skin.bmp", modelPath)
+      == std::filesystem::path{"models/skin.png"});
+    CHECK(cache.resolve(fs, "other.jpg", modelPath) == std::nullopt);
+  }
+
+  SECTION("reports skipped lookups of cached paths")
+  {
+    const auto modelPath = std::filesystem::path{"models/model.obj"};
+
+    auto lookups = std::vector<std::tuple<std::filesystem::path, fs::PathInfo>>{};
+    const auto recordLookup = [&](const auto& path, const auto& pathInfo) {
+      REQUIRE(pathInfo);
+      lookups.emplace_back(path, *pathInfo);
+    };
+
+    REQUIRE(
+      cache.resolve(fs, "textures/skin.png", modelPath, recordLookup)
+      == std::filesystem::path{"models/textures/skin.png"});
+    CHECK(lookups.empty());
+
+    CHECK(
+      cache.resolve(fs, "textures/skin.png", modelPath, recordLookup)
+      == std::filesystem::path{"models/textures/skin.png"});
+    CHECK(
+      lookups
+      == std::vector<std::tuple<std::filesystem::path, fs::PathInfo>>{
+        {"textures/skin.png", fs::PathInfo::Unknown},
+        {"models/textures/skin.png", fs::PathInfo::File},
+      });
+  }
+
+  SECTION("reports skipped directory listings")
+  {
+    const auto modelPath = std::filesystem::path{"models/model.obj"};
+
+    REQUIRE(
+      cache.resolve(fs, "other.jpg", modelPath)
+      == std::filesystem::path{"models/other.tga"});
+
+    auto listedDirectories = std::vector<std::filesystem::path>{};
+    const auto recordLookup = [&](const auto& path, const auto& pathInfo) {
+      if (!pathInfo)
+      {
+        listedDirectories.push_back(path);
+      }
+    };
+
+    // a different texture that is found in the same directory
+    REQUIRE(
+      cache.resolve(fs, "other.bmp", modelPath, recordLookup)
+      == std::filesystem::path{"models/other.tga"});
+    // the model directory joined with the empty parent path of the texture path
+    CHECK(
+      listedDirectories
+      == std::vector<std::filesystem::path>{std::filesystem::path{"models"} / ""});
+  }
+}
+
+TEST_CASE("AssimpLoader with entity model cache")
+{
+  auto logger = NullLogger{};
+  auto taskManager = kdl::task_manager{};
+
+  const auto fixturePath =
+    std::filesystem::current_path() / "fixture/test/io/assimp/cube";
+  auto env = fs::TestEnvironment{[&](auto& e) {
+    e.createDirectory("models");
+    for (const auto& path : {"models/a.dae", "models/b.dae"})
+    {
+      std::filesystem::copy_file(fixturePath / "cube.dae", e.dir() / path);
+    }
+    std::filesystem::copy_file(
+      fixturePath / "texture.png", e.dir() / "models/texture.png");
+  }};
+
+  const auto diskFs = fs::DiskFileSystem{env.dir()};
+  auto fs = ProbeRecordingFileSystem{diskFs};
+  const auto cacheDirectory = env.dir() / "cache";
+  auto texturePathCache = std::make_shared<AssimpTexturePathCache>();
+
+  auto decodeCount = 0;
+  const auto load = [&](const std::filesystem::path& modelPath) {
+    return loadCachedEntityModelData(
+      cacheDirectory,
+      fs,
+      modelPath,
+      "",
+      [&](const fs::FileSystem& decodeFs, const auto& recordDependency) {
+        ++decodeCount;
+        auto loader = AssimpLoader{
+          modelPath, decodeFs, taskManager, texturePathCache, recordDependency};
+        return loader.load(logger);
+      },
+      logger);
+  };
+
+  const auto isTexturePath = [](const auto& path) {
+    return path.filename() == "texture.png";
+  };
+
+  REQUIRE(load("models/a.dae").is_success());
+  REQUIRE(std::ranges::any_of(fs.takeProbedPaths(), isTexturePath));
+
+  REQUIRE(load("models/b.dae").is_success());
+  CHECK(std::ranges::none_of(fs.takeProbedPaths(), isTexturePath));
+  CHECK(decodeCount == 2);
+  CHECK(env.directoryContents("cache").size() == 2u);
+
+  SECTION("Uses the cache entries while the texture paths are unchanged")
+  {
+    REQUIRE(load("models/a.dae").is_success());
+    REQUIRE(load("models/b.dae").is_success());
+    CHECK(decodeCount == 2);
+  }
+
+  SECTION("Records the skipped texture path lookups as dependencies")
+  {
+    // the texture path is resolved relative to the file system root first
+    env.createFile("texture.png", env.loadFile("models/texture.png"));
+
+    REQUIRE(load("models/b.dae").is_success());
+    CHECK(decodeCount == 3);
+  }
+}
+
 } // namespace tb::io
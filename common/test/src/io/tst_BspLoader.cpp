@@ -28,6 +28,7 @@
 #include "mdl/Palette.h"
 
 #include "kd/result.h"
+#include "kd/task_manager.h"
 
 #include "catch/CatchConfig.h"
 
@@ -39,6 +40,7 @@ namespace tb::io
 TEST_CASE("BspLoaderTest.loadValidHlBsp")
 {
   auto logger = NullLogger{};
+  auto taskManager = kdl::task_manager{};
 
   const auto palettePath = "fixture/test/palette.lmp";
   auto fs = fs::DiskFileSystem{std::filesystem::current_path()};
@@ -49,7 +51,7 @@ TEST_CASE("BspLoaderTest.loadValidHlBsp")
   const auto bspFile = fs::Disk::openFile(bspPath) | kdl::value();
 
   auto reader = bspFile->reader().buffer();
-  auto loader = BspLoader("hl", reader, palette, fs);
+  auto loader = BspLoader("hl", reader, palette, fs, taskManager);
   auto bspData = loader.load(logger);
 
   REQUIRE(bspData);
@@ -65,6 +67,7 @@ TEST_CASE("BspLoaderTest.loadValidHlBsp")
 TEST_CASE("BspLoaderTest.loadInvalidBsp")
 {
   auto logger = NullLogger{};
+  auto taskManager = kdl::task_manager{};
 
   const auto palettePath = "fixture/test/palette.lmp";
   auto fs = fs::DiskFileSystem{std::filesystem::current_path()};
@@ -76,7 +79,7 @@ TEST_CASE("BspLoaderTest.loadInvalidBsp")
   const auto bspFile = fs::Disk::openFile(bspPath) | kdl::value();
 
   auto reader = bspFile->reader().buffer();
-  auto loader = BspLoader("invalid_version", reader, palette, fs);
+  auto loader = BspLoader("invalid_version", reader, palette, fs, taskManager);
   CHECK(
     loader.load(logger)
     == Result<mdl::EntityModelData>{Error{"Unsupported BSP model version: 63"}});
@@ -0,0 +1,86 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/ChunkedOutputStream.h"
+
+#include <format>
+#include <iterator>
+#include <string>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::io
+{
+
+TEST_CASE("ChunkedOutputStream")
+{
+  SECTION("Empty stream")
+  {
+    auto stream = ChunkedOutputStream{};
+    CHECK(stream.size() == 0u);
+    CHECK(std::move(stream).str() == "");
+  }
+
+  SECTION("Contents that fit into the initial capacity")
+  {
+    auto stream = ChunkedOutputStream{64};
+    stream << "some " << 12 << " text";
+
+    CHECK(stream.size() == 12u);
+
+    const auto str = std::move(stream).str();
+    CHECK(str == "some 12 text");
+    CHECK(str.capacity() >= 64u);
+  }
+
+  SECTION("Contents that exceed the initial capacity")
+  {
+    auto expected = std::string{};
+    auto stream = ChunkedOutputStream{16};
+    for (size_t i = 0; i < 2000; ++i)
+    {
+      std::format_to(std::ostreambuf_iterator<char>{stream}, "line {}\n", i);
+      expected += std::format("line {}\n", i);
+
+      if (i % 100 == 0)
+      {
+        const auto block = std::string(i * 7, char('a' + i % 26));
+        stream << block;
+        expected += block;
+      }
+    }
+
+    CHECK(stream.size() == expected.size());
+    CHECK(std::move(stream).str() == expected);
+  }
+
+  SECTION("Stream can be written to after taking its contents")
+  {
+    auto stream = ChunkedOutputStream{};
+    stream << "abc";
+    CHECK(std::move(stream).str() == "abc");
+
+    stream << "def";
+    CHECK(std::move(stream).str() == "def");
+  }
+}
+
+} // namespace tb::io
@@ -0,0 +1,181 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Logger.h"
+#include "fs/DiskFileSystem.h"
+#include "fs/DiskIO.h"
+#include "fs/Reader.h"
+#include "fs/TestEnvironment.h"
+#include "io/EntityModelCache.h"
+#include "io/MdlLoader.h"
+#include "mdl/EntityModel.h"
+#include "mdl/Material.h"
+#include "mdl/Palette.h"
+
+#include "kd/result.h"
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <fstream>
+
+namespace tb::io
+{
+namespace
+{
+
+void copyFixture(
+  const fs::TestEnvironment& env,
+  const std::filesystem::path& fixturePath,
+  const std::filesystem::path& path)
+{
+  std::filesystem::copy_file(
+    std::filesystem::current_path() / fixturePath, env.dir() / path);
+}
+
+Result<mdl::EntityModelData> loadArmor(const fs::FileSystem& fs, Logger& logger)
+{
+  const auto paletteFile = fs.openFile("palette.lmp") | kdl::value();
+  const auto palette = mdl::loadPalette(*paletteFile, "palette.lmp") | kdl::value();
+
+  const auto mdlFile = fs.openFile("armor.mdl") | kdl::value();
+  auto reader = mdlFile->reader().buffer();
+  auto loader = MdlLoader("armor", reader, palette);
+  return loader.load(logger);
+}
+
+} // namespace
+
+TEST_CASE("EntityModelCache")
+{
+  auto logger = NullLogger{};
+
+  auto env = fs::TestEnvironment{[](auto& e) {
+    e.createDirectory("game");
+    copyFixture(e, "fixture/test/palette.lmp", "game/palette.lmp");
+    copyFixture(e, "fixture/test/io/Mdl/armor.mdl", "game/armor.mdl");
+  }};
+
+  auto gameFs = fs::DiskFileSystem{env.dir() / "game"};
+
+  SECTION("writeEntityModelData and readEntityModelData")
+  {
+    const auto modelData = loadArmor(gameFs, logger) | kdl::value();
+    const auto data = writeEntityModelData(modelData) | kdl::value();
+
+    auto reader = fs::Reader::from(data.data(), data.data() + data.size());
+    const auto cachedModelData = readEntityModelData(reader) | kdl::value();
+
+    CHECK(cachedModelData.pitchType() == modelData.pitchType());
+    CHECK(cachedModelData.orientation() == modelData.orientation());
+    REQUIRE(cachedModelData.frameCount() == modelData.frameCount());
+    CHECK(cachedModelData.frames().front().name() == modelData.frames().front().name());
+    CHECK(cachedModelData.bounds(0) == modelData.bounds(0));
+
+    REQUIRE(cachedModelData.surfaceCount() == 1u);
+    const auto& surface = cachedModelData.surface(0);
+    CHECK(surface.skinCount() == 3u);
+    CHECK(surface.skin(0)->name() == modelData.surface(0).skin(0)->name());
+    CHECK(surface.vertices(0)->size() == modelData.surface(0).vertices(0)->size());
+
+    // writing the deserialized model must reproduce the same data
+    CHECK(writeEntityModelData(cachedModelData) == Result<std::string>{data});
+  }
+
+  SECTION("loadCachedEntityModelData")
+  {
+    const auto cacheDirectory = env.dir() / "cache";
+
+    auto decodeCount = 0;
+    const auto load = [&]() {
+      return loadCachedEntityModelData(
+        cacheDirectory,
+        gameFs,
+        "armor.mdl",
+        "palette.lmp",
+        [&](const fs::FileSystem& fs, const RecordEntityModelDependencyFunc&) {
+          ++decodeCount;
+          return loadArmor(fs, logger);
+        },
+        logger);
+    };
+
+    REQUIRE(load().is_success());
+    CHECK(decodeCount == 1);
+    CHECK(env.directoryContents("cache").size() == 1u);
+
+    SECTION("Uses cache entry if the model is unchanged")
+    {
+      const auto modelData = load() | kdl::value();
+      CHECK(decodeCount == 1);
+      CHECK(modelData.surface(0).skinCount() == 3u);
+    }
+
+    SECTION("Decodes model again if a dependency changed")
+    {
+      {
+        auto stream = std::fstream{
+          env.dir() / "game/palette.lmp",
+          std::ios::in | std::ios::out | std::ios::binary};
+        stream.put('\x7f');
+      }
+
+      REQUIRE(load().is_success());
+      CHECK(decodeCount == 2);
+
+      REQUIRE(load().is_success());
+      CHECK(decodeCount == 2);
+    }
+  }
+
+  SECTION("pruneEntityModelCache")
+  {
+    env.createDirectory("cache");
+    env.createFile("cache/old.bin", std::string(100, 'a'));
+    env.createFile("cache/new.bin", std::string(100, 'b'));
+
+    const auto now = std::filesystem::file_time_type::clock::now();
+    std::filesystem::last_write_time(
+      env.dir() / "cache/old.bin", now - std::chrono::hours{1});
+    std::filesystem::last_write_time(env.dir() / "cache/new.bin", now);
+
+    SECTION("Keeps all entries if they fit")
+    {
+      pruneEntityModelCache(env.dir() / "cache", 200);
+      CHECK(env.fileExists("cache/old.bin"));
+      CHECK(env.fileExists("cache/new.bin"));
+    }
+
+    SECTION("Removes least recently used entries first")
+    {
+      pruneEntityModelCache(env.dir() / "cache", 150);
+      CHECK_FALSE(env.fileExists("cache/old.bin"));
+      CHECK(env.fileExists("cache/new.bin"));
+    }
+
+    SECTION("Ignores a missing cache directory")
+    {
+      pruneEntityModelCache(env.dir() / "missing", 0);
+    }
+  }
+}
+
+} // namespace tb::io
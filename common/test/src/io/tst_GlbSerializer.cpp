@@ -0,0 +1,208 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/ExportOptions.h"
+#include "io/GlbSerializer.h"
+#include "io/NodeWriter.h"
+#include "mdl/BezierPatch.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kd/result.h"
+#include "kd/task_manager.h"
+
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+namespace tb::io
+{
+using namespace Catch::Matchers;
+
+namespace
+{
+
+struct Glb
+{
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t length = 0;
+  std::string json;
+  std::vector<char> binary;
+};
+
+uint32_t readUInt32(const std::string& data, const size_t offset)
+{
+  auto result = uint32_t(0);
+  std::memcpy(&result, data.data() + offset, sizeof(result));
+  return result;
+}
+
+Glb readGlb(const std::string& data)
+{
+  auto glb = Glb{readUInt32(data, 0), readUInt32(data, 4), readUInt32(data, 8), {}, {}};
+
+  auto offset = size_t(12);
+  while (offset < data.size())
+  {
+    const auto chunkLength = readUInt32(data, offset);
+    const auto chunkType = readUInt32(data, offset + 4);
+    const auto* chunkData = data.data() + offset + 8;
+
+    if (chunkType == 0x4E4F534A)
+    {
+      glb.json = std::string{chunkData, chunkLength};
+    }
+    else if (chunkType == 0x004E4942)
+    {
+      glb.binary = std::vector<char>{chunkData, chunkData + chunkLength};
+    }
+    offset += 8 + chunkLength;
+  }
+
+  return glb;
+}
+
+std::string exportGlb(mdl::WorldNode& map)
+{
+  auto taskManager = kdl::task_manager{};
+
+  auto stream = std::ostringstream{};
+  auto serializer =
+    std::make_unique<GlbSerializer>(stream, GltfExportOptions{"/some/export/path.glb"});
+  const auto& glbSerializer = *serializer;
+
+  auto writer = NodeWriter{map, std::move(serializer)};
+  writer.writeMap(taskManager);
+  REQUIRE(glbSerializer.result().is_success());
+
+  return stream.str();
+}
+
+} // namespace
+
+TEST_CASE("GlbSerializer")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  auto map = mdl::WorldNode{{}, {}, mdl::MapFormat::Quake3};
+
+  SECTION("Empty map")
+  {
+    const auto data = exportGlb(map);
+    const auto glb = readGlb(data);
+
+    CHECK(glb.magic == 0x46546C67);
+    CHECK(glb.version == 2u);
+    CHECK(glb.length == data.size());
+    CHECK_THAT(glb.json, ContainsSubstring(R"("scenes":[{}])"));
+    CHECK(glb.binary.empty());
+  }
+
+  SECTION("Brush")
+  {
+    auto builder = mdl::BrushBuilder{map.mapFormat(), worldBounds};
+    map.defaultLayer()->addChild(
+      new mdl::BrushNode{builder.createCube(64.0, "some_material") | kdl::value()});
+
+    const auto data = exportGlb(map);
+    const auto glb = readGlb(data);
+
+    CHECK(glb.length == data.size());
+    CHECK(glb.json.size() % 4 == 0u);
+
+    // every face has its own four vertices because their normals differ
+    const auto vertexCount = 24u;
+    const auto indexCount = 36u;
+    const auto vertexLength = vertexCount * GlbSerializer::VertexSize * sizeof(float);
+    const auto indexLength = indexCount * sizeof(uint32_t);
+
+    CHECK_THAT(glb.json, ContainsSubstring(R"("name":"some_material")"));
+    CHECK_THAT(
+      glb.json, ContainsSubstring(R"("min":[-32,-32,-32],"max":[32,32,32])"));
+    CHECK_THAT(
+      glb.json,
+      ContainsSubstring(
+        std::format(R"("buffers":[{{"byteLength":{}}}])", vertexLength + indexLength)));
+
+    REQUIRE(glb.binary.size() == vertexLength + indexLength);
+
+    auto indices = std::vector<uint32_t>(indexCount);
+    std::memcpy(indices.data(), glb.binary.data() + vertexLength, indexLength);
+    for (const auto index : indices)
+    {
+      CHECK(index < vertexCount);
+    }
+  }
+
+  SECTION("Brush and patch with different materials")
+  {
+    auto builder = mdl::BrushBuilder{map.mapFormat(), worldBounds};
+    map.defaultLayer()->addChild(
+      new mdl::BrushNode{builder.createCube(64.0, "brush_material") | kdl::value()});
+    map.defaultLayer()->addChild(new mdl::PatchNode{mdl::BezierPatch{
+      3,
+      3,
+      {{0, 0, 0},
+       {1, 0, 1},
+       {2, 0, 0},
+       {0, 1, 1},
+       {1, 1, 2},
+       {2, 1, 1},
+       {0, 2, 0},
+       {1, 2, 1},
+       {2, 2, 0}},
+      "patch_material"}});
+
+    const auto data = exportGlb(map);
+    const auto glb = readGlb(data);
+
+    CHECK(glb.length == data.size());
+    CHECK_THAT(glb.json, ContainsSubstring(R"("name":"brush_material")"));
+    CHECK_THAT(glb.json, ContainsSubstring(R"("name":"patch_material")"));
+    CHECK_THAT(
+      glb.json,
+      ContainsSubstring(R"("attributes":{"POSITION":4,"NORMAL":5,"TEXCOORD_0":6},)"
+                        R"("indices":7,"material":1)"));
+  }
+}
+
+TEST_CASE("encodeUriPath")
+{
+  CHECK(encodeUriPath("") == "");
+  CHECK(encodeUriPath("textures/base/wall_01.png") == "textures/base/wall_01.png");
+  CHECK(encodeUriPath("../textures/a-b~c.tga") == "../textures/a-b~c.tga");
+  CHECK(encodeUriPath("my textures/#1.png") == "my%20textures/%231.png");
+  CHECK(encodeUriPath("100%.png") == "100%25.png");
+  CHECK(encodeUriPath("\xc3\xa4.png") == "%C3%A4.png");
+}
+
+} // namespace tb::io
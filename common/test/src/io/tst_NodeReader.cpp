@@ -146,4 +146,149 @@ TEST_CASE("NodeReader")
   }
 }
 
+TEST_CASE("detectMapDataFormat")
+{
+  using io::MapDataFormat;
+  using io::MapDataKind;
+
+  SECTION("Brush faces")
+  {
+    const auto data = R"(
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+)";
+
+    CHECK(
+      io::detectMapDataFormat(data, MapFormat::Valve)
+      == MapDataFormat{MapDataKind::BrushFaces, MapFormat::Valve});
+    CHECK(
+      io::detectMapDataFormat(data, MapFormat::Standard)
+      == MapDataFormat{MapDataKind::BrushFaces, MapFormat::Valve});
+  }
+
+  SECTION("Entities with parallel brush faces")
+  {
+    const auto data = R"(
+// entity 0
+{
+"classname" "func_door"
+"target" "( not a face"
+// brush 0
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+}
+)";
+
+    CHECK(
+      io::detectMapDataFormat(data, MapFormat::Standard)
+      == MapDataFormat{MapDataKind::Entities, MapFormat::Valve});
+    CHECK(io::detectMapDataFormat(data, MapFormat::Hexen2) == std::nullopt);
+  }
+
+  SECTION("Brushes with paraxial brush faces")
+  {
+    const auto data = R"(
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty 0 0 0 1 1
+}
+)";
+
+    CHECK(
+      io::detectMapDataFormat(data, MapFormat::Valve)
+      == MapDataFormat{MapDataKind::Brushes, MapFormat::Standard});
+    CHECK(
+      io::detectMapDataFormat(data, MapFormat::Quake3_Valve)
+      == MapDataFormat{MapDataKind::Brushes, MapFormat::Quake3});
+  }
+
+  SECTION("Point entities")
+  {
+    const auto data = R"(
+{
+"classname" "light"
+"origin" "0 0 0"
+}
+)";
+
+    CHECK(
+      io::detectMapDataFormat(data, MapFormat::Quake2_Valve)
+      == MapDataFormat{MapDataKind::Entities, MapFormat::Quake2_Valve});
+  }
+
+  SECTION("Brush primitives")
+  {
+    const auto data = R"(
+{
+brushDef
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) ( ( 0.03125 0 0 ) ( 0 0.03125 0 ) ) tex 0 0 0
+}
+}
+)";
+
+    CHECK(
+      io::detectMapDataFormat(data, MapFormat::Quake3_Legacy)
+      == MapDataFormat{MapDataKind::Brushes, MapFormat::Quake3});
+  }
+
+  SECTION("Patches are skipped")
+  {
+    const auto data = R"(
+{
+"classname" "func_group"
+{
+patchDef2
+{
+common/caulk
+( 3 3 0 0 0 )
+(
+( ( -64 -64 4 0 0 ) ( -64 0 4 0 -2 ) ( -64 64 4 0 -4 ) )
+( ( 0 -64 4 2 0 ) ( 0 0 4 2 -2 ) ( 0 64 4 2 -4 ) )
+( ( 64 -64 4 4 0 ) ( 64 0 4 4 -2 ) ( 64 64 4 4 -4 ) )
+)
+}
+}
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1 0 0 0
+}
+}
+)";
+
+    CHECK(
+      io::detectMapDataFormat(data, MapFormat::Quake3)
+      == MapDataFormat{MapDataKind::Entities, MapFormat::Quake3_Valve});
+  }
+
+  SECTION("Only patches")
+  {
+    const auto data = R"(
+{
+patchDef2
+{
+common/caulk
+( 3 3 0 0 0 )
+(
+( ( -64 -64 4 0 0 ) ( -64 0 4 0 -2 ) ( -64 64 4 0 -4 ) )
+( ( 0 -64 4 2 0 ) ( 0 0 4 2 -2 ) ( 0 64 4 2 -4 ) )
+( ( 64 -64 4 4 0 ) ( 64 0 4 4 -2 ) ( 64 64 4 4 -4 ) )
+)
+}
+}
+)";
+
+    CHECK(
+      io::detectMapDataFormat(data, MapFormat::Quake3_Legacy)
+      == MapDataFormat{MapDataKind::Brushes, MapFormat::Quake3_Legacy});
+    CHECK(io::detectMapDataFormat(data, MapFormat::Valve) == std::nullopt);
+  }
+
+  SECTION("Ambiguous data")
+  {
+    CHECK(io::detectMapDataFormat("", MapFormat::Valve) == std::nullopt);
+    CHECK(io::detectMapDataFormat("some text", MapFormat::Valve) == std::nullopt);
+    CHECK(io::detectMapDataFormat("{ }", MapFormat::Valve) == std::nullopt);
+    CHECK(io::detectMapDataFormat("{ ( 0 0 0 )", MapFormat::Valve) == std::nullopt);
+  }
+}
+
 } // namespace tb::mdl
@@ -33,11 +33,16 @@
 #include "kd/result.h"
 #include "kd/task_manager.h"
 
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
 #include <format>
 
 #include <memory>
 #include <optional>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "catch/CatchConfig.h"
 
@@ -394,6 +399,81 @@ f  71/1/71  80/1/80  81/1/81  72/1/72
 )");
 }
 
+TEST_CASE("ObjSerializer.writeManyBrushes")
+{
+  const auto worldBounds = vm::bbox3d{8192.0};
+
+  auto taskManager = kdl::task_manager{};
+
+  auto map = mdl::WorldNode{{}, {}, mdl::MapFormat::Quake3};
+
+  // spans several blocks, the last of which is incomplete
+  const auto brushCount = 2u * ObjSerializer::BlockSize + 1u;
+  const auto brushBounds = [](const size_t i) {
+    const auto min = vm::vec3d{double(i % 32u), double(i / 32u), 0} * 128.0;
+    return vm::bbox3d{min, min + vm::vec3d{64, 64, 64}};
+  };
+
+  auto builder = mdl::BrushBuilder{map.mapFormat(), worldBounds};
+  for (size_t i = 0; i < brushCount; ++i)
+  {
+    map.defaultLayer()->addChild(new mdl::BrushNode{
+      builder.createCuboid(brushBounds(i), "some_material") | kdl::value()});
+  }
+
+  auto objStream = std::ostringstream{};
+  auto mtlStream = std::ostringstream{};
+  const auto objOptions =
+    ObjExportOptions{"/some/export/path.obj", ObjMtlPathMode::RelativeToGamePath};
+
+  auto writer = NodeWriter{
+    map,
+    std::make_unique<ObjSerializer>(
+      objStream, mtlStream, "some_file_name.mtl", objOptions)};
+  writer.writeMap(taskManager);
+
+  // every face of a brush must refer to the vertices of that brush
+  auto vertices = std::vector<vm::vec3d>{};
+  auto objectCount = size_t(0);
+  auto currentBrush = size_t(0);
+
+  auto objStr = std::istringstream{objStream.str()};
+  for (auto line = std::string{}; std::getline(objStr, line);)
+  {
+    auto lineStr = std::istringstream{line};
+    auto type = std::string{};
+    lineStr >> type;
+
+    if (type == "v")
+    {
+      auto x = 0.0, y = 0.0, z = 0.0;
+      lineStr >> x >> y >> z;
+      vertices.emplace_back(x, -z, y);
+    }
+    else if (type == "o")
+    {
+      currentBrush = objectCount++;
+    }
+    else if (type == "f")
+    {
+      for (auto vertex = std::string{}; lineStr >> vertex;)
+      {
+        const auto index = std::stoul(vertex.substr(0, vertex.find('/')));
+        REQUIRE(index > 0u);
+        REQUIRE(index <= vertices.size());
+
+        CHECK(brushBounds(currentBrush).contains(vertices[index - 1u]));
+      }
+    }
+  }
+
+  CHECK(objectCount == brushCount);
+  CHECK(vertices.size() == brushCount * 8u);
+  CHECK(mtlStream.str() == R"(newmtl some_material
+
+)");
+}
+
 TEST_CASE("ObjSerializer.writeRelativeMaterialPath")
 {
   const auto worldBounds = vm::bbox3d{8192.0};
@@ -2032,6 +2032,37 @@ common/caulk
     REQUIRE(world != nullptr);
     CHECK(world->mapFormat() == mdl::MapFormat::Standard);
   }
+
+  SECTION("Convert to target format")
+  {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) tex1 0 0 0 1 1
+( -64 -64 -16 ) ( -64 -64 -15 ) ( -63 -64 -16 ) tex2 0 0 0 1 1
+( -64 -64 -16 ) ( -63 -64 -16 ) ( -64 -63 -16 ) tex3 0 0 0 1 1
+( 64 64 16 ) ( 64 65 16 ) ( 65 64 16 ) tex4 0 0 0 1 1
+( 64 64 16 ) ( 65 64 16 ) ( 64 64 17 ) tex5 0 0 0 1 1
+( 64 64 16 ) ( 64 64 17 ) ( 64 65 16 ) tex6 0 0 0 1 1
+}
+})";
+
+    auto reader =
+      WorldReader{data, mdl::MapFormat::Standard, mdl::MapFormat::Valve, {}};
+    auto worldResult = reader.read(worldBounds, status, taskManager);
+    REQUIRE(worldResult);
+
+    const auto& world = worldResult.value();
+    REQUIRE(world != nullptr);
+    CHECK(world->mapFormat() == mdl::MapFormat::Valve);
+
+    auto* defaultLayer = world->children().front();
+    REQUIRE(defaultLayer->childCount() == 1u);
+    auto* brush = static_cast<mdl::BrushNode*>(defaultLayer->children().front());
+    CHECK(brush->brush().faces().front().attributes().materialName() == "tex1");
+    checkBrushUVCoordSystem(brush, true);
+  }
 }
 
 TEST_CASE("WorldReader (Regression)", "[regression]")
@@ -0,0 +1,289 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapGenerator.h"
+
+#include "mdl/BezierPatch.h"
+#include "mdl/Brush.h"
+#include "mdl/BrushBuilder.h"
+#include "mdl/BrushFace.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/EntityProperties.h"
+#include "mdl/Group.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kd/contracts.h"
+#include "kd/result.h"
+
+#include "vm/mat_ext.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <vector>
+
+namespace tb::mdl
+{
+namespace
+{
+
+constexpr auto CellSize = 96.0;
+constexpr auto BrushSize = 64.0;
+
+bool supportsPatches(const MapFormat mapFormat)
+{
+  return mapFormat == MapFormat::Quake3_Legacy || mapFormat == MapFormat::Quake3_Valve
+         || mapFormat == MapFormat::Quake3;
+}
+
+/**
+ * Selects indices evenly so that the fraction of selected indices approaches the given
+ * density.
+ */
+bool isSelected(const size_t index, const double density)
+{
+  return size_t(double(index + 1) * density) > size_t(double(index) * density);
+}
+
+class CellLayout
+{
+private:
+  size_t m_size;
+  vm::vec3d m_origin;
+
+public:
+  explicit CellLayout(const size_t cellCount)
+    : m_size{std::max(size_t(1), size_t(std::ceil(std::cbrt(double(cellCount)))))}
+    , m_origin{vm::vec3d::fill(-double(m_size) * CellSize / 2.0)}
+  {
+  }
+
+  vm::vec3d position(const size_t index) const
+  {
+    return m_origin
+           + vm::vec3d{
+               double(index % m_size),
+               double((index / m_size) % m_size),
+               double(index / (m_size * m_size)),
+             } * CellSize;
+  }
+};
+
+class Generator
+{
+private:
+  const MapGeneratorConfig& m_config;
+  BrushBuilder m_builder;
+  CellLayout m_layout;
+
+public:
+  explicit Generator(const MapGeneratorConfig& config)
+    : m_config{config}
+    , m_builder{config.mapFormat, config.worldBounds}
+    , m_layout{
+        config.brushCount
+        + config.linkedGroupCount * (config.linkedCopyCount + 1)
+        + (supportsPatches(config.mapFormat) ? config.patchCount : 0)}
+  {
+    contract_pre(config.faceCount >= 5);
+    contract_pre(config.materialCount > 0);
+    contract_pre(config.brushesPerEntity > 0);
+    contract_pre(config.linkedGroupCount == 0 || config.linkedGroupBrushCount > 0);
+  }
+
+  std::unique_ptr<WorldNode> generate() const
+  {
+    auto worldNode = std::make_unique<WorldNode>(
+      EntityPropertyConfig{}, Entity{}, m_config.mapFormat);
+
+    auto nodes = std::vector<Node*>{};
+    auto cell = size_t(0);
+
+    addBrushes(nodes, cell);
+    addLights(nodes);
+    addLinkedGroups(nodes, cell);
+    if (supportsPatches(m_config.mapFormat))
+    {
+      addPatches(nodes, cell);
+    }
+
+    worldNode->defaultLayer()->addChildren(nodes);
+    return worldNode;
+  }
+
+private:
+  void addBrushes(std::vector<Node*>& nodes, size_t& cell) const
+  {
+    const auto entityCount = m_config.brushCount / m_config.brushesPerEntity;
+
+    auto i = size_t(0);
+    for (size_t entity = 0; entity < entityCount; ++entity)
+    {
+      if (isSelected(entity, m_config.brushEntityDensity))
+      {
+        auto* entityNode = new EntityNode{Entity{{
+          {EntityPropertyKeys::Classname, "func_wall"},
+        }}};
+        for (size_t j = 0; j < m_config.brushesPerEntity; ++j, ++i)
+        {
+          entityNode->addChild(createBrushNode(i, cellBounds(cell++)));
+        }
+        nodes.push_back(entityNode);
+      }
+      else
+      {
+        for (size_t j = 0; j < m_config.brushesPerEntity; ++j, ++i)
+        {
+          nodes.push_back(createBrushNode(i, cellBounds(cell++)));
+        }
+      }
+    }
+
+    for (; i < m_config.brushCount; ++i)
+    {
+      nodes.push_back(createBrushNode(i, cellBounds(cell++)));
+    }
+  }
+
+  void addLights(std::vector<Node*>& nodes) const
+  {
+    for (size_t i = 0; i < m_config.brushCount; ++i)
+    {
+      if (isSelected(i, m_config.lightDensity))
+      {
+        const auto origin =
+          m_layout.position(i)
+          + vm::vec3d{BrushSize / 2.0, BrushSize / 2.0, (BrushSize + CellSize) / 2.0};
+        nodes.push_back(new EntityNode{Entity{{
+          {EntityPropertyKeys::Classname, "light"},
+          {EntityPropertyKeys::Origin,
+           std::format("{} {} {}", origin.x(), origin.y(), origin.z())},
+        }}});
+      }
+    }
+  }
+
+  void addLinkedGroups(std::vector<Node*>& nodes, size_t& cell) const
+  {
+    for (size_t i = 0; i < m_config.linkedGroupCount; ++i)
+    {
+      const auto originalPosition = m_layout.position(cell);
+      for (size_t copy = 0; copy <= m_config.linkedCopyCount; ++copy)
+      {
+        const auto position = m_layout.position(cell++);
+
+        auto group = Group{std::format("group{}", i)};
+        group.setTransformation(vm::translation_matrix(position - originalPosition));
+
+        auto* groupNode = new GroupNode{std::move(group)};
+        groupNode->setLinkId(std::format("group{}", i));
+
+        // the brushes of a linked group are stacked on top of each other in its cell
+        const auto height = BrushSize / double(m_config.linkedGroupBrushCount);
+        for (size_t j = 0; j < m_config.linkedGroupBrushCount; ++j)
+        {
+          const auto min = position + vm::vec3d{0, 0, double(j) * height};
+          auto* brushNode = createBrushNode(
+            j, vm::bbox3d{min, min + vm::vec3d{BrushSize, BrushSize, height}});
+          brushNode->setLinkId(std::format("group{}_brush{}", i, j));
+          groupNode->addChild(brushNode);
+        }
+
+        nodes.push_back(groupNode);
+      }
+    }
+  }
+
+  void addPatches(std::vector<Node*>& nodes, size_t& cell) const
+  {
+    for (size_t i = 0; i < m_config.patchCount; ++i)
+    {
+      const auto min = m_layout.position(cell++);
+      const auto point = [&](const size_t row, const size_t column) {
+        const auto x = double(column) * BrushSize / 2.0;
+        const auto y = double(row) * BrushSize / 2.0;
+        const auto z = row == 1 && column == 1 ? BrushSize / 2.0 : 0.0;
+        return BezierPatch::Point{
+          min.x() + x, min.y() + y, min.z() + z, x / BrushSize, y / BrushSize};
+      };
+
+      auto points = std::vector<BezierPatch::Point>{};
+      points.reserve(9);
+      for (size_t row = 0; row < 3; ++row)
+      {
+        for (size_t column = 0; column < 3; ++column)
+        {
+          points.push_back(point(row, column));
+        }
+      }
+
+      nodes.push_back(
+        new PatchNode{BezierPatch{3, 3, std::move(points), materialName(i)}});
+    }
+  }
+
+  vm::bbox3d cellBounds(const size_t cell) const
+  {
+    const auto min = m_layout.position(cell);
+    return vm::bbox3d{min, min + vm::vec3d::fill(BrushSize)};
+  }
+
+  BrushNode* createBrushNode(const size_t index, const vm::bbox3d& bounds) const
+  {
+    auto brush = (m_config.faceCount == 6
+                    ? m_builder.createCuboid(bounds, materialName(index))
+                    : m_builder.createCylinder(
+                        bounds,
+                        EdgeAlignedCircle{m_config.faceCount - 2},
+                        vm::axis::z,
+                        materialName(index)))
+                 | kdl::value();
+
+    // vary the materials of the faces so that a brush uses several materials
+    for (size_t i = 0; i < brush.faceCount(); ++i)
+    {
+      auto& face = brush.face(i);
+      auto attributes = face.attributes();
+      attributes.setMaterialName(materialName(index + i));
+      face.setAttributes(attributes);
+    }
+
+    return new BrushNode{std::move(brush)};
+  }
+
+  std::string materialName(const size_t index) const
+  {
+    return std::format("material{}", index % m_config.materialCount);
+  }
+};
+
+} // namespace
+
+std::unique_ptr<WorldNode> generateWorld(const MapGeneratorConfig& config)
+{
+  return Generator{config}.generate();
+}
+
+} // namespace tb::mdl
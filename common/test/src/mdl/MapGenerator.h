@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mdl/MapFormat.h"
+
+#include "vm/bbox.h"
+
+#include <memory>
+
+namespace tb::mdl
+{
+class WorldNode;
+
+/**
+ * Controls the contents of a world generated by generateWorld.
+ */
+struct MapGeneratorConfig
+{
+  MapFormat mapFormat = MapFormat::Standard;
+  vm::bbox3d worldBounds = vm::bbox3d{8192.0};
+
+  // the number of brushes outside of linked groups
+  size_t brushCount = 1000;
+  // the number of faces of each brush, 6 creates cuboids and other values create prisms
+  size_t faceCount = 6;
+  // the number of distinct materials assigned to the brush faces
+  size_t materialCount = 8;
+
+  // the number of light entities per brush
+  double lightDensity = 0.1;
+  // the fraction of brushes that belong to func_wall entities
+  double brushEntityDensity = 0.0;
+  // the number of brushes of each func_wall entity
+  size_t brushesPerEntity = 4;
+
+  // the number of linked groups, each of which has the given number of brushes and the
+  // given number of linked copies in addition to the original
+  size_t linkedGroupCount = 0;
+  size_t linkedGroupBrushCount = 4;
+  size_t linkedCopyCount = 1;
+
+  // the number of patches, which are only generated for Quake 3 map formats
+  size_t patchCount = 0;
+};
+
+/**
+ * Generates a world for scale testing according to the given config.
+ *
+ * The generated objects are laid out in a grid of cells that is centered at the origin.
+ * Each cell contains one brush, one linked group or one patch. Lights are placed above
+ * the brushes of their cells. The result only depends on the given config, so calling
+ * this function twice with the same config yields worlds that serialize identically.
+ */
+std::unique_ptr<WorldNode> generateWorld(const MapGeneratorConfig& config);
+
+} // namespace tb::mdl
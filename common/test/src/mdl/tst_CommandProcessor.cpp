@@ -648,6 +648,86 @@ TEST_CASE("CommandProcessor")
     }
   }
 
+  SECTION("batchDidEndNotifier")
+  {
+    auto batchesEnded = 0;
+    auto connection =
+      commandProcessor.batchDidEndNotifier.connect([&]() { ++batchesEnded; });
+
+    SECTION("No enclosing transaction")
+    {
+      CHECK_FALSE(commandProcessor.isBatching());
+
+      commandProcessor.executeAndStore(std::make_unique<NullCommand>("command"));
+      CHECK(batchesEnded == 1);
+
+      commandProcessor.undo();
+      CHECK(batchesEnded == 2);
+    }
+
+    SECTION("One enclosing one shot transaction")
+    {
+      commandProcessor.startTransaction("", TransactionScope::Oneshot);
+      CHECK(commandProcessor.isBatching());
+
+      commandProcessor.executeAndStore(std::make_unique<NullCommand>("command1"));
+      commandProcessor.executeAndStore(std::make_unique<NullCommand>("command2"));
+      CHECK(batchesEnded == 0);
+
+      commandProcessor.commitTransaction();
+      CHECK_FALSE(commandProcessor.isBatching());
+      CHECK(batchesEnded == 1);
+
+      commandProcessor.undo();
+      CHECK(batchesEnded == 2);
+    }
+
+    SECTION("Rolled back one shot transaction")
+    {
+      commandProcessor.startTransaction("", TransactionScope::Oneshot);
+      commandProcessor.executeAndStore(std::make_unique<NullCommand>("command"));
+      commandProcessor.rollbackTransaction();
+      CHECK(batchesEnded == 0);
+
+      commandProcessor.commitTransaction();
+      CHECK(batchesEnded == 1);
+    }
+
+    SECTION("One enclosing long running transaction")
+    {
+      commandProcessor.startTransaction("", TransactionScope::LongRunning);
+      CHECK_FALSE(commandProcessor.isBatching());
+
+      commandProcessor.executeAndStore(std::make_unique<NullCommand>("command1"));
+      CHECK(batchesEnded == 1);
+
+      commandProcessor.executeAndStore(std::make_unique<NullCommand>("command2"));
+      CHECK(batchesEnded == 2);
+
+      commandProcessor.commitTransaction();
+      CHECK(batchesEnded == 3);
+    }
+
+    SECTION("Enclosing long running transaction with nested one shot transactions")
+    {
+      commandProcessor.startTransaction("long running", TransactionScope::LongRunning);
+      commandProcessor.startTransaction("outer", TransactionScope::Oneshot);
+      commandProcessor.startTransaction("inner", TransactionScope::Oneshot);
+
+      commandProcessor.executeAndStore(std::make_unique<NullCommand>("command"));
+      CHECK(batchesEnded == 0);
+
+      commandProcessor.commitTransaction();
+      CHECK(batchesEnded == 0);
+
+      commandProcessor.commitTransaction();
+      CHECK(batchesEnded == 1);
+
+      commandProcessor.commitTransaction();
+      CHECK(batchesEnded == 2);
+    }
+  }
+
   SECTION("collateCommands")
   {
     /*
@@ -23,6 +23,10 @@
 #include "mdl/EntityProperties.h"
 #include "mdl/PropertyDefinition.h"
 
+#include <string>
+#include <unordered_set>
+#include <vector>
+
 #include "catch/CatchConfig.h"
 
 #include <catch2/catch_test_macros.hpp>
@@ -203,4 +207,30 @@ TEST_CASE("addOrConvertOriginProperties")
   CHECK(definitions == expectedDefinitions);
 }
 
+TEST_CASE("getChangedEntityDefinitionNames")
+{
+  const auto oldDefinitions = std::vector<EntityDefinition>{
+    {"unchanged", {}, "some description", {}},
+    {"changed", {}, "old description", {}},
+    {"removed", {}, "", {}},
+    {"reordered", {}, "", {}},
+  };
+
+  auto newDefinitions = std::vector<EntityDefinition>{
+    {"reordered", {}, "", {}},
+    {"unchanged", {}, "some description", {}},
+    {"changed", {}, "new description", {}},
+    {"added", {}, "", {}},
+  };
+  newDefinitions[0].index = 1;
+
+  CHECK(
+    getChangedEntityDefinitionNames(oldDefinitions, newDefinitions)
+    == std::unordered_set<std::string>{"changed", "removed", "added"});
+  CHECK(getChangedEntityDefinitionNames(oldDefinitions, oldDefinitions).empty());
+  CHECK(
+    getChangedEntityDefinitionNames({}, oldDefinitions)
+    == std::unordered_set<std::string>{"unchanged", "changed", "removed", "reordered"});
+}
+
 } // namespace tb::mdl
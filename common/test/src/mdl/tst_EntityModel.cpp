@@ -31,11 +31,14 @@
 #include "render/IndexRangeMapBuilder.h"
 #include "render/MaterialIndexRangeRenderer.h"
 
+#include "kd/task_manager.h"
+
 #include "vm/approx.h"
 #include "vm/bbox.h"
 #include "vm/intersection.h"
 
 #include <filesystem>
+#include <optional>
 
 #include "catch/CatchConfig.h"
 
@@ -80,8 +83,9 @@ TEST_CASE("EntityModel")
       throw std::runtime_error{"should not be called"};
     };
 
+    auto taskManager = kdl::task_manager{};
     auto model = io::loadEntityModelSync(
-      fs, gameInfo.gameConfig.materialConfig, path, loadMaterial, logger);
+      fs, gameInfo.gameConfig.materialConfig, path, loadMaterial, taskManager, logger);
 
     auto& frame = model.value().data()->frames().at(0);
 
@@ -159,6 +163,38 @@ TEST_CASE("EntityModel")
     CHECK(renderer1 != nullptr);
     CHECK(renderer2 != nullptr);
   }
+
+  SECTION("addMesh with deferred mesh")
+  {
+    auto modelData = EntityModelData{PitchType::Normal, Orientation::Oriented};
+    auto& frame = modelData.addFrame("test", vm::bbox3f{-1, 1});
+    auto& surface = modelData.addSurface("surface", 1);
+
+    auto decodeCount = 0;
+    surface.addMesh(frame, [&]() {
+      ++decodeCount;
+
+      auto size = render::IndexRangeMap::Size{};
+      size.inc(render::PrimType::Triangles, 1);
+
+      auto builder = render::IndexRangeMapBuilder<EntityModelVertex::Type>{3, size};
+      builder.addTriangle(
+        EntityModelVertex{{-1, -1, 0}, {0, 0}},
+        EntityModelVertex{{1, -1, 0}, {1, 0}},
+        EntityModelVertex{{0, 1, 0}, {0, 1}});
+
+      return EntityModelMeshData{builder.vertices(), builder.indices()};
+    });
+
+    CHECK(decodeCount == 0);
+
+    const auto ray = vm::ray3f{vm::vec3f{0, 0, 8}, vm::vec3f{0, 0, -1}};
+    CHECK(std::optional{8.0f} == vm::optional_approx(frame.intersect(ray)));
+    CHECK(decodeCount == 1);
+
+    CHECK(surface.vertices(0)->size() == 3u);
+    CHECK(decodeCount == 1);
+  }
 }
 
 
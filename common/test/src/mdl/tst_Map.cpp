@@ -44,9 +44,11 @@
 #include "mdl/Map_Selection.h"
 #include "mdl/Material.h"
 #include "mdl/MaterialManager.h"
+#include "mdl/NodeChanges.h"
 #include "mdl/PasteType.h"
 #include "mdl/TagMatcher.h"
 #include "mdl/TextureResource.h"
+#include "mdl/Transaction.h"
 #include "mdl/TransactionScope.h"
 #include "mdl/UpdateBrushFaceAttributes.h"
 #include "mdl/WorldNode.h"
@@ -1616,6 +1618,77 @@ TEST_CASE("Map")
     }
   }
 
+  SECTION("coalescedNodeChangesNotifier")
+  {
+    auto fixture = MapFixture{};
+    auto& map = fixture.create();
+
+    auto notifications = std::vector<NodeChanges>{};
+    auto connection = map.coalescedNodeChangesNotifier.connect(
+      [&](const NodeChanges& nodeChanges) { notifications.push_back(nodeChanges); });
+
+    auto* entityNode = new EntityNode{Entity{}};
+
+    SECTION("Changes outside of a transaction are delivered once per command")
+    {
+      addNodes(map, {{parentForNodes(map), {entityNode}}});
+      REQUIRE(notifications.size() == 1);
+      CHECK(notifications[0].addedNodes == std::vector<Node*>{entityNode});
+
+      selectNodes(map, {entityNode});
+      REQUIRE(notifications.size() == 2);
+      CHECK(
+        notifications[1].selectionChange.selectedNodes == std::vector<Node*>{entityNode});
+    }
+
+    SECTION("Changes in a transaction are delivered once when it is committed")
+    {
+      auto transaction = Transaction{map};
+      addNodes(map, {{parentForNodes(map), {entityNode}}});
+      selectNodes(map, {entityNode});
+      setEntityProperty(map, "key", "value");
+      CHECK(notifications.empty());
+
+      transaction.commit();
+      REQUIRE(notifications.size() == 1);
+      CHECK(notifications[0].addedNodes == std::vector<Node*>{entityNode});
+      CHECK(notifications[0].removedNodes.empty());
+      CHECK_FALSE(kdl::vec_contains(notifications[0].changedNodes, entityNode));
+      CHECK(
+        notifications[0].selectionChange.selectedNodes == std::vector<Node*>{entityNode});
+
+      SECTION("Undoing the transaction delivers its changes once")
+      {
+        notifications.clear();
+
+        map.undoCommand();
+        REQUIRE(notifications.size() == 1);
+        CHECK(notifications[0].addedNodes.empty());
+        CHECK(notifications[0].removedNodes == std::vector<Node*>{entityNode});
+        CHECK(notifications[0].selectionChange.selectedNodes.empty());
+      }
+    }
+
+    SECTION("Nodes that are added and removed in a transaction are not reported")
+    {
+      auto transaction = Transaction{map};
+      addNodes(map, {{parentForNodes(map), {entityNode}}});
+      removeNodes(map, {entityNode});
+      transaction.commit();
+
+      CHECK(notifications.empty());
+    }
+
+    SECTION("Cancelled transactions only deliver their net changes")
+    {
+      auto transaction = Transaction{map};
+      addNodes(map, {{parentForNodes(map), {entityNode}}});
+      transaction.cancel();
+
+      CHECK(notifications.empty());
+    }
+  }
+
   SECTION("canRepeatCommands")
   {
     auto fixture = MapFixture{};
@@ -0,0 +1,169 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestParserStatus.h"
+#include "io/NodeWriter.h"
+#include "io/WorldReader.h"
+#include "mdl/BrushNode.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GroupNode.h"
+#include "mdl/LayerNode.h"
+#include "mdl/MapGenerator.h"
+#include "mdl/PatchNode.h"
+#include "mdl/WorldNode.h"
+
+#include "kd/overload.h"
+#include "kd/result.h"
+#include "kd/task_manager.h"
+
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+namespace tb::mdl
+{
+namespace
+{
+
+struct NodeCounts
+{
+  size_t brushes = 0;
+  size_t pointEntities = 0;
+  size_t brushEntities = 0;
+  size_t groups = 0;
+  size_t patches = 0;
+  std::map<std::string, size_t> linkIds;
+
+  bool operator==(const NodeCounts&) const = default;
+};
+
+NodeCounts countNodes(const WorldNode& worldNode)
+{
+  auto result = NodeCounts{};
+  worldNode.accept(kdl::overload(
+    [](auto&& thisLambda, const WorldNode* w) { w->visitChildren(thisLambda); },
+    [](auto&& thisLambda, const LayerNode* l) { l->visitChildren(thisLambda); },
+    [&](auto&& thisLambda, const GroupNode* g) {
+      ++result.groups;
+      ++result.linkIds[g->linkId()];
+      g->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const EntityNode* e) {
+      ++(e->hasChildren() ? result.brushEntities : result.pointEntities);
+      e->visitChildren(thisLambda);
+    },
+    [&](const BrushNode*) { ++result.brushes; },
+    [&](const PatchNode*) { ++result.patches; }));
+  return result;
+}
+
+std::string writeWorld(const WorldNode& worldNode, kdl::task_manager& taskManager)
+{
+  auto stream = std::stringstream{};
+  auto writer = io::NodeWriter{worldNode, stream};
+  writer.writeMap(taskManager);
+  return stream.str();
+}
+
+} // namespace
+
+TEST_CASE("generateWorld")
+{
+  auto taskManager = kdl::task_manager{};
+
+  const auto mapFormat = GENERATE(
+    MapFormat::Standard,
+    MapFormat::Quake2,
+    MapFormat::Quake2_Valve,
+    MapFormat::Valve,
+    MapFormat::Hexen2,
+    MapFormat::Daikatana,
+    MapFormat::Quake3_Legacy,
+    MapFormat::Quake3_Valve,
+    MapFormat::Quake3);
+  const auto faceCount = GENERATE(size_t(6), size_t(8));
+
+  CAPTURE(mapFormat, faceCount);
+
+  const auto config = MapGeneratorConfig{
+    .mapFormat = mapFormat,
+    .brushCount = 100,
+    .faceCount = faceCount,
+    .materialCount = 4,
+    .lightDensity = 0.1,
+    .brushEntityDensity = 0.5,
+    .brushesPerEntity = 4,
+    .linkedGroupCount = 2,
+    .linkedGroupBrushCount = 3,
+    .linkedCopyCount = 2,
+    .patchCount = 5,
+  };
+
+  const auto worldNode = generateWorld(config);
+  const auto counts = countNodes(*worldNode);
+
+  const auto hasPatches = mapFormat == MapFormat::Quake3_Legacy
+                          || mapFormat == MapFormat::Quake3_Valve
+                          || mapFormat == MapFormat::Quake3;
+
+  CHECK(counts.brushes == 100 + 2 * 3 * 3);
+  CHECK(counts.pointEntities == 10);
+  CHECK(counts.brushEntities == 12);
+  CHECK(counts.groups == 6);
+  CHECK(counts.linkIds == std::map<std::string, size_t>{{"group0", 3}, {"group1", 3}});
+  CHECK(counts.patches == (hasPatches ? 5u : 0u));
+
+  auto brushFaceCounts = std::set<size_t>{};
+  worldNode->accept(kdl::overload(
+    [](auto&& thisLambda, const WorldNode* w) { w->visitChildren(thisLambda); },
+    [](auto&& thisLambda, const LayerNode* l) { l->visitChildren(thisLambda); },
+    [](auto&& thisLambda, const GroupNode* g) { g->visitChildren(thisLambda); },
+    [](auto&& thisLambda, const EntityNode* e) { e->visitChildren(thisLambda); },
+    [&](const BrushNode* b) { brushFaceCounts.insert(b->brush().faceCount()); },
+    [](const PatchNode*) {}));
+  CHECK(brushFaceCounts == std::set<size_t>{faceCount});
+
+  SECTION("Generated worlds are deterministic")
+  {
+    CHECK(
+      writeWorld(*generateWorld(config), taskManager)
+      == writeWorld(*worldNode, taskManager));
+  }
+
+  SECTION("Generated worlds can be read back")
+  {
+    const auto str = writeWorld(*worldNode, taskManager);
+
+    auto status = TestParserStatus{};
+    auto reader = io::WorldReader{str, mapFormat, {}};
+    const auto readWorldNode =
+      reader.read(config.worldBounds, status, taskManager) | kdl::value();
+
+    CHECK(readWorldNode->mapFormat() == mapFormat);
+    CHECK(countNodes(*readWorldNode) == counts);
+  }
+}
+
+} // namespace tb::mdl
@@ -0,0 +1,112 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestFactory.h"
+#include "mdl/BrushNode.h"
+#include "mdl/CommandProcessor.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/Map.h"
+#include "mdl/MapFixture.h"
+#include "mdl/MapStatistics.h"
+#include "mdl/Map_Geometry.h"
+#include "mdl/Map_Groups.h"
+#include "mdl/Map_Nodes.h"
+#include "mdl/Map_Selection.h"
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::mdl
+{
+
+TEST_CASE("MapStatistics")
+{
+  auto fixture = MapFixture{};
+  auto& map = fixture.create();
+
+  SECTION("Empty map")
+  {
+    const auto statistics = computeMapStatistics(map);
+    CHECK(statistics.layerCount == 1);
+    CHECK(statistics.groupCount == 0);
+    CHECK(statistics.entityCount == 0);
+    CHECK(statistics.brushCount == 0);
+    CHECK(statistics.undoMemoryUsage == 0);
+  }
+
+  SECTION("Counts nodes")
+  {
+    auto* entityNode = new EntityNode{Entity{}};
+    entityNode->addChild(createBrushNode(map));
+
+    auto* brushNode = createBrushNode(map);
+    addNodes(map, {{parentForNodes(map), {entityNode, brushNode}}});
+
+    selectNodes(map, {brushNode});
+    groupSelectedNodes(map, "group");
+
+    const auto statistics = computeMapStatistics(map);
+    CHECK(statistics.layerCount == 1);
+    CHECK(statistics.groupCount == 1);
+    CHECK(statistics.entityCount == 1);
+    CHECK(statistics.brushCount == 2);
+    CHECK(statistics.brushFaceCount == 12);
+    CHECK(statistics.patchCount == 0);
+  }
+
+  SECTION("Estimates undo memory usage")
+  {
+    auto* brushNode = createBrushNode(map);
+    addNodes(map, {{parentForNodes(map), {brushNode}}});
+    selectNodes(map, {brushNode});
+
+    const auto memoryUsageBeforeTranslation =
+      computeMapStatistics(map).undoMemoryUsage;
+
+    REQUIRE(translateSelection(map, {16, 0, 0}));
+    const auto memoryUsageAfterTranslation = computeMapStatistics(map).undoMemoryUsage;
+    CHECK(memoryUsageAfterTranslation > memoryUsageBeforeTranslation);
+
+    // the translation moves to the redo stack
+    map.undoCommand();
+    CHECK(computeMapStatistics(map).undoMemoryUsage == memoryUsageAfterTranslation);
+
+    map.commandProcessor().clear();
+    CHECK(computeMapStatistics(map).undoMemoryUsage == 0);
+  }
+
+  SECTION("Counts removed nodes held by the undo stack")
+  {
+    auto* brushNode = createBrushNode(map);
+    addNodes(map, {{parentForNodes(map), {brushNode}}});
+
+    const auto memoryUsageBeforeRemoval = computeMapStatistics(map).undoMemoryUsage;
+
+    removeNodes(map, {brushNode});
+    CHECK(computeMapStatistics(map).undoMemoryUsage > memoryUsageBeforeRemoval);
+
+    // the node is owned by the map again
+    map.undoCommand();
+    CHECK(computeMapStatistics(map).undoMemoryUsage == memoryUsageBeforeRemoval);
+  }
+}
+
+} // namespace tb::mdl
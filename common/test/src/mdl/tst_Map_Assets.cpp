@@ -18,22 +18,32 @@
  */
 
 #include "Observer.h"
+#include "TestFactory.h"
 #include "TestUtils.h"
 #include "fs/TestEnvironment.h"
 #include "mdl/BrushFace.h" // IWYU pragma: keep
 #include "mdl/BrushNode.h"
+#include "mdl/EntityDefinition.h"
+#include "mdl/EntityDefinitionManager.h"
+#include "mdl/EntityLinkManager.h"
+#include "mdl/EntityNode.h"
 #include "mdl/LayerNode.h"
 #include "mdl/Map.h"
 #include "mdl/MapFixture.h"
 #include "mdl/Map_Assets.h"
 #include "mdl/Map_Entities.h"
+#include "mdl/Map_Nodes.h"
 #include "mdl/MaterialManager.h"
+#include "mdl/TagMatcher.h"
 #include "mdl/WorldNode.h"
 
 #include <algorithm>
+#include <memory>
 #include <optional>
 #include <ranges>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "catch/CatchConfig.h"
 
@@ -340,6 +350,112 @@ TEST_CASE("Map_Assets")
     CHECK(entityDefinitionsWillChange.called);
     CHECK(entityDefinitionsDidChange.called);
   }
+
+  SECTION("reloadEntityDefinitions only updates entities whose definitions changed")
+  {
+    const auto fgdFilename = "Test.fgd";
+
+    auto env = fs::TestEnvironment{};
+    env.createFile(fgdFilename, R"x(
+@SolidClass = worldspawn : "World entity" []
+@SolidClass = func_source : "Source" [ target(target_destination) : "Target" ]
+@PointClass = info_target : "Target" [ targetname(target_source) : "Name" ]
+    )x");
+
+    auto fixtureConfig = MapFixtureConfig{};
+    fixtureConfig.gameInfo.gameConfig.smartTags = {
+      SmartTag{
+        "source",
+        {},
+        std::make_unique<EntityClassNameTagMatcher>("func_source", ""),
+      },
+    };
+
+    auto& map = fixture.create(fixtureConfig);
+    setEntityDefinitionFile(
+      map, EntityDefinitionFileSpec::makeExternal(env.dir() / fgdFilename));
+
+    auto* sourceNode = new EntityNode{Entity{{
+      {EntityPropertyKeys::Classname, "func_source"},
+      {EntityPropertyKeys::Target, "some_name"},
+    }}};
+    auto* targetNode = new EntityNode{Entity{{
+      {EntityPropertyKeys::Classname, "info_target"},
+      {EntityPropertyKeys::Targetname, "some_name"},
+    }}};
+    auto* brushNode = createBrushNode(map);
+
+    addNodes(map, {{parentForNodes(map), {sourceNode, targetNode}}});
+    addNodes(map, {{sourceNode, {brushNode}}});
+
+    const auto& tag = map.smartTag("source");
+
+    REQUIRE(sourceNode->entity().definition());
+    REQUIRE(sourceNode->entity().definition()->description == "Source");
+    REQUIRE(map.entityLinkManager().hasLink(
+      *sourceNode, *targetNode, EntityPropertyKeys::Target));
+    REQUIRE(brushNode->hasTag(tag));
+
+    auto nodesWillChange = Observer<std::vector<Node*>>{map.nodesWillChangeNotifier};
+    auto nodesDidChange = Observer<std::vector<Node*>>{map.nodesDidChangeNotifier};
+
+    SECTION("Changed entities get the new definitions")
+    {
+      env.createFile(fgdFilename, R"x(
+@SolidClass = worldspawn : "World entity" []
+@SolidClass = func_source : "Changed source" [ target(string) : "Target" ]
+@PointClass = info_target : "Target" [ targetname(target_source) : "Name" ]
+      )x");
+
+      reloadEntityDefinitions(map);
+
+      CHECK(nodesWillChange.collected == std::set<Node*>{sourceNode});
+      CHECK(nodesDidChange.collected == std::set<Node*>{sourceNode});
+
+      CHECK(
+        sourceNode->entity().definition()
+        == map.entityDefinitionManager().definition("func_source"));
+      CHECK(sourceNode->entity().definition()->description == "Changed source");
+
+      // the new definition no longer declares the link
+      CHECK(!map.entityLinkManager().hasLink(
+        *sourceNode, *targetNode, EntityPropertyKeys::Target));
+      CHECK(brushNode->hasTag(tag));
+
+      // the unchanged entity refers to the new storage of its definition
+      CHECK(
+        targetNode->entity().definition()
+        == map.entityDefinitionManager().definition("info_target"));
+      CHECK(targetNode->entity().definition()->description == "Target");
+    }
+
+    SECTION("Unchanged entities keep their definitions, links and tags")
+    {
+      env.createFile(fgdFilename, R"x(
+@SolidClass = worldspawn : "World entity" []
+@SolidClass = func_source : "Source" [ target(target_destination) : "Target" ]
+@PointClass = info_target : "Changed target" [ targetname(target_source) : "Name" ]
+      )x");
+
+      reloadEntityDefinitions(map);
+
+      CHECK(nodesWillChange.collected == std::set<Node*>{targetNode});
+      CHECK(nodesDidChange.collected == std::set<Node*>{targetNode});
+
+      CHECK(
+        sourceNode->entity().definition()
+        == map.entityDefinitionManager().definition("func_source"));
+      CHECK(sourceNode->entity().definition()->description == "Source");
+      CHECK(
+        targetNode->entity().definition()
+        == map.entityDefinitionManager().definition("info_target"));
+      CHECK(targetNode->entity().definition()->description == "Changed target");
+
+      CHECK(map.entityLinkManager().hasLink(
+        *sourceNode, *targetNode, EntityPropertyKeys::Target));
+      CHECK(brushNode->hasTag(tag));
+    }
+  }
 }
 
 } // namespace tb::mdl
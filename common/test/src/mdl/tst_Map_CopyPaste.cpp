@@ -146,6 +146,73 @@ TEST_CASE("Map_CopyPaste")
     }
   }
 
+  SECTION("copySelectedNodes")
+  {
+    auto& map = fixture.create();
+
+    auto* brushNode = createBrushNode(map);
+    auto* entityNode = new EntityNode{Entity{{{"some_key", "some_value"}}}};
+    auto* brushEntityNode = new EntityNode{Entity{{{"classname", "func_door"}}}};
+    auto* entityBrushNode = createBrushNode(map);
+    brushEntityNode->addChild(entityBrushNode);
+
+    addNodes(map, {{parentForNodes(map), {brushNode, entityNode, brushEntityNode}}});
+
+    selectNodes(map, {brushNode, entityNode, entityBrushNode});
+
+    const auto copiedNodes = copySelectedNodes(map);
+
+    SECTION("Serializing copied nodes returns the serialized selection")
+    {
+      CHECK(copiedNodes.serialize(map.taskManager()) == serializeSelectedNodes(map));
+    }
+
+    SECTION("Pasting copied nodes clones them")
+    {
+      const auto& defaultLayerNode = *map.worldNode().defaultLayer();
+      deselectAll(map);
+
+      REQUIRE(paste(map, copiedNodes) == PasteType::Node);
+      REQUIRE(defaultLayerNode.childCount() == 6u);
+
+      const auto* pastedBrushNode =
+        dynamic_cast<BrushNode*>(defaultLayerNode.children()[3]);
+      REQUIRE(pastedBrushNode != nullptr);
+      CHECK(pastedBrushNode->brush() == brushNode->brush());
+      CHECK(pastedBrushNode->linkId() != brushNode->linkId());
+
+      const auto* pastedEntityNode =
+        dynamic_cast<EntityNode*>(defaultLayerNode.children()[4]);
+      REQUIRE(pastedEntityNode != nullptr);
+      CHECK(pastedEntityNode->entity() == entityNode->entity());
+
+      const auto* pastedBrushEntityNode =
+        dynamic_cast<EntityNode*>(defaultLayerNode.children()[5]);
+      REQUIRE(pastedBrushEntityNode != nullptr);
+      CHECK(pastedBrushEntityNode->entity() == brushEntityNode->entity());
+      CHECK(pastedBrushEntityNode->childCount() == 1u);
+
+      CHECK(map.selection().nodes.size() == 4u);
+    }
+
+    SECTION("Copied nodes can be pasted after the originals were removed")
+    {
+      removeSelectedNodes(map);
+
+      REQUIRE(paste(map, copiedNodes) == PasteType::Node);
+      CHECK(map.selection().nodes.size() == 3u);
+    }
+
+    SECTION("Copied nodes are pasted as text into a map of another format")
+    {
+      auto otherFixture = MapFixture{};
+      auto& otherMap = otherFixture.create({.mapFormat = MapFormat::Valve});
+
+      REQUIRE(paste(otherMap, copiedNodes) == PasteType::Node);
+      CHECK(otherMap.worldNode().defaultLayer()->childCount() == 3u);
+    }
+  }
+
   SECTION("paste")
   {
     SECTION("Paste worldspawn with single brush in layer")
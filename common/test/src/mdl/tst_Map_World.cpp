@@ -19,8 +19,11 @@
 
 #include "fs/TestEnvironment.h"
 #include "io/SystemPaths.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityProperties.h"
 #include "mdl/Map.h"
 #include "mdl/MapFixture.h"
+#include "mdl/MapFormat.h"
 #include "mdl/Map_World.h"
 #include "mdl/WorldNode.h"
 
@@ -29,6 +32,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
+#include <tuple>
+
 namespace tb::mdl
 {
 TEST_CASE("Map_World")
@@ -236,6 +241,47 @@ TEST_CASE("Map_World")
 
     CHECK(defaultMod(map) == "id1");
   }
+
+  SECTION("setValveVersion")
+  {
+    using T = std::tuple<MapFormat, bool>;
+
+    // clang-format off
+    const auto [format, expectValveVersion] = GENERATE(values<T>({
+      {MapFormat::Standard,      false},
+      {MapFormat::Quake2,        false},
+      {MapFormat::Quake3_Legacy, false},
+      {MapFormat::Valve,         true},
+      {MapFormat::Quake2_Valve,  true},
+      {MapFormat::Quake3_Valve,  true},
+    }));
+    // clang-format on
+
+    CAPTURE(format);
+
+    auto entity = Entity{};
+    SECTION("Without existing property")
+    {
+      setValveVersion(entity, format);
+    }
+
+    SECTION("With existing property")
+    {
+      entity.addOrUpdateProperty(EntityPropertyKeys::ValveVersion, "220");
+      setValveVersion(entity, format);
+    }
+
+    const auto* valveVersion = entity.property(EntityPropertyKeys::ValveVersion);
+    if (expectValveVersion)
+    {
+      REQUIRE(valveVersion != nullptr);
+      CHECK(*valveVersion == "220");
+    }
+    else
+    {
+      CHECK(valveVersion == nullptr);
+    }
+  }
 }
 
 } // namespace tb::mdl
@@ -97,6 +97,34 @@ TEST_CASE("ModelDefinition")
       == expectedModelSpecification);
   }
 
+  SECTION("modelSpecification with changing variables")
+  {
+    const auto modelDefinition = makeModelDefinition(R"({{
+        spawnflags == 1 -> { path: "maps/b_shell0.bsp", skin: skin },
+                           { path: "maps/b_shell1.bsp", skin: skin }
+    }})");
+
+    const auto modelSpecification = [&](const int spawnflags, const int skin) {
+      return modelDefinition.modelSpecification(el::VariableTable{{
+        {"spawnflags", el::Value{spawnflags}},
+        {"skin", el::Value{skin}},
+      }});
+    };
+
+    CHECK(modelSpecification(1, 0) == ModelSpecification{"maps/b_shell0.bsp", 0, 0});
+    CHECK(modelSpecification(0, 0) == ModelSpecification{"maps/b_shell1.bsp", 0, 0});
+    CHECK(modelSpecification(1, 2) == ModelSpecification{"maps/b_shell0.bsp", 2, 0});
+    CHECK(modelSpecification(1, 0) == ModelSpecification{"maps/b_shell0.bsp", 0, 0});
+
+    const auto copy = modelDefinition;
+    CHECK(
+      copy.modelSpecification(el::VariableTable{{
+        {"spawnflags", el::Value{0}},
+        {"skin", el::Value{3}},
+      }})
+      == ModelSpecification{"maps/b_shell1.bsp", 3, 0});
+  }
+
   SECTION("defaultModelSpecification")
   {
     using T = std::tuple<std::string, ModelSpecification>;
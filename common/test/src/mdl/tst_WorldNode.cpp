@@ -326,6 +326,57 @@ TEST_CASE("WorldNodeTest.disableNodeTreeUpdates")
   CHECK(nodeTree.contains(patchNode));
 }
 
+TEST_CASE("WorldNodeTest.takeNodesWithInvalidatedIssues")
+{
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  auto* layerNode = worldNode.defaultLayer();
+  auto* entityNode = new EntityNode{Entity{}};
+  layerNode->addChild(entityNode);
+
+  const auto validators = std::vector<const Validator*>{};
+  worldNode.takeNodesWithInvalidatedIssues();
+
+  SECTION("Nodes whose issues weren't validated are omitted")
+  {
+    entityNode->invalidateIssues();
+    CHECK(worldNode.takeNodesWithInvalidatedIssues().empty());
+  }
+
+  SECTION("Nodes whose issues were invalidated are returned once")
+  {
+    entityNode->issues(validators);
+    entityNode->invalidateIssues();
+
+    CHECK(worldNode.takeNodesWithInvalidatedIssues() == std::vector<Node*>{entityNode});
+    CHECK(worldNode.takeNodesWithInvalidatedIssues().empty());
+  }
+
+  SECTION("Changing a node invalidates the issues of its ancestors")
+  {
+    worldNode.issues(validators);
+    layerNode->issues(validators);
+    entityNode->issues(validators);
+
+    entityNode->setEntity(Entity{{{"some_key", "some_value"}}});
+
+    CHECK_THAT(
+      worldNode.takeNodesWithInvalidatedIssues(),
+      UnorderedEquals(std::vector<Node*>{&worldNode, layerNode, entityNode}));
+  }
+
+  SECTION("Removed nodes are omitted")
+  {
+    entityNode->issues(validators);
+
+    layerNode->removeChild(entityNode);
+    CHECK(worldNode.takeNodesWithInvalidatedIssues().empty());
+
+    delete entityNode;
+  }
+}
+
 TEST_CASE("WorldNodeTest.persistentIdOfDefaultLayer")
 {
   auto worldNode = WorldNode{{}, {}, MapFormat::Standard};
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/BrushRendererArrays.h"
+#include "render/GLVertexType.h"
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::render
+{
+
+TEST_CASE("VertexBlockArray")
+{
+  using Vertex = GLVertexTypes::P3::Vertex;
+
+  auto array = VertexBlockArray<Vertex>{};
+  CHECK(array.empty());
+  CHECK(array.capacity() == 0u);
+
+  SECTION("allocate")
+  {
+    const auto* block1 = array.allocate(4).first;
+    const auto* block2 = array.allocate(2).first;
+
+    CHECK(block1->pos == 0u);
+    CHECK(block1->size == 4u);
+    CHECK(block2->pos == 4u);
+    CHECK(block2->size == 2u);
+
+    CHECK_FALSE(array.empty());
+    CHECK(array.capacity() >= 6u);
+    CHECK_FALSE(array.prepared());
+  }
+
+  SECTION("free reuses blocks")
+  {
+    auto* block1 = array.allocate(4).first;
+    array.allocate(4);
+    const auto capacity = array.capacity();
+
+    array.free(block1);
+
+    const auto* block3 = array.allocate(4).first;
+    CHECK(block3->pos == 0u);
+    CHECK(array.capacity() == capacity);
+  }
+
+  SECTION("free all blocks")
+  {
+    auto* block1 = array.allocate(4).first;
+    auto* block2 = array.allocate(4).first;
+
+    array.free(block2);
+    array.free(block1);
+    CHECK(array.empty());
+  }
+
+  SECTION("grows when no free block is large enough")
+  {
+    array.allocate(4);
+    const auto capacity = array.capacity();
+
+    const auto* block = array.allocate(capacity).first;
+    CHECK(block->pos >= 4u);
+    CHECK(block->size == capacity);
+    CHECK(array.capacity() >= capacity + 4);
+  }
+}
+
+} // namespace tb::render
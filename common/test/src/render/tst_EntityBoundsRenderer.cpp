@@ -0,0 +1,94 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Color.h"
+#include "render/EntityBoundsRenderer.h"
+
+#include "vm/bbox.h"
+#include "vm/vec.h"
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::render
+{
+
+TEST_CASE("EntityBoundsArray")
+{
+  const auto bounds = vm::bbox3f{vm::vec3f{-8, -8, -8}, vm::vec3f{8, 8, 8}};
+  const auto color = Color{RgbaF{1, 0, 0, 1}};
+
+  auto array = EntityBoundsArray{EntityBoundsShape::Edges};
+  CHECK(array.empty());
+  CHECK(array.capacity() == 0u);
+
+  SECTION("verticesPerSlot")
+  {
+    CHECK(array.verticesPerSlot() == 8u);
+    CHECK(EntityBoundsArray{EntityBoundsShape::Faces}.verticesPerSlot() == 24u);
+  }
+
+  SECTION("add")
+  {
+    CHECK(array.add(bounds, color) == 0u);
+    CHECK(array.add(bounds, color) == 1u);
+    CHECK(array.size() == 2u);
+    CHECK(array.capacity() >= 2u);
+    CHECK_FALSE(array.prepared());
+  }
+
+  SECTION("remove reuses slots")
+  {
+    const auto slot1 = array.add(bounds, color);
+    const auto slot2 = array.add(bounds, color);
+    const auto slot3 = array.add(bounds, color);
+
+    array.remove(slot2);
+    CHECK(array.size() == 2u);
+
+    CHECK(array.add(bounds, color) == slot2);
+    CHECK(array.size() == 3u);
+
+    array.remove(slot1);
+    array.remove(slot3);
+    array.remove(slot2);
+    CHECK(array.empty());
+  }
+
+  SECTION("grows when all slots are used")
+  {
+    const auto capacity = [&]() {
+      array.add(bounds, color);
+      return array.capacity();
+    }();
+
+    for (size_t i = 1; i < capacity; ++i)
+    {
+      array.add(bounds, color);
+    }
+    CHECK(array.capacity() == capacity);
+
+    CHECK(array.add(bounds, color) == capacity);
+    CHECK(array.capacity() > capacity);
+    CHECK(array.size() == capacity + 1);
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,194 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PreferenceManager.h"
+#include "Preferences.h"
+#include "TestFactory.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityDefinitionManager.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GroupNode.h"
+#include "mdl/Map.h"
+#include "mdl/MapFixture.h"
+#include "mdl/Map_Entities.h"
+#include "mdl/Map_Groups.h"
+#include "mdl/Map_Nodes.h"
+#include "mdl/Map_Selection.h"
+#include "render/EntityLinkRenderer.h"
+#include "render/PerspectiveCamera.h"
+
+#include "vm/vec.h"
+
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_vector.hpp>
+
+namespace tb::render
+{
+using namespace Catch::Matchers;
+
+TEST_CASE("EntityLinkRenderer")
+{
+  using namespace mdl::EntityPropertyKeys;
+
+  const auto setPref =
+    TemporarilySetPref{Preferences::EntityLinkMode, Preferences::entityLinkModeAll()};
+
+  auto fixture = mdl::MapFixture{};
+  auto& map = fixture.create();
+
+  constexpr auto sourceClassname = "source_definition";
+  constexpr auto targetClassname = "target_definition";
+
+  map.entityDefinitionManager().setDefinitions(
+    {{sourceClassname,
+      {},
+      {},
+      {
+        {Target, mdl::PropertyValueTypes::LinkSource{}, {}, {}},
+      }},
+     {targetClassname,
+      {},
+      {},
+      {
+        {Targetname, mdl::PropertyValueTypes::LinkTarget{}, {}, {}},
+      }}});
+
+  // looks at the entities from the front
+  const auto camera = PerspectiveCamera{
+    90.0f,
+    1.0f,
+    65536.0f,
+    Camera::Viewport{0, 0, 800, 600},
+    vm::vec3f{0, -512, 0},
+    vm::vec3f{0, 1, 0},
+    vm::vec3f{0, 0, 1}};
+
+  auto* sourceNode = new mdl::EntityNode{mdl::Entity{{
+    {Classname, sourceClassname},
+    {Origin, "0 0 0"},
+    {Target, "some_value"},
+  }}};
+
+  auto* targetNode = new mdl::EntityNode{mdl::Entity{{
+    {Classname, targetClassname},
+    {Origin, "64 0 0"},
+    {Targetname, "some_value"},
+  }}};
+
+  auto* brushNode = mdl::createBrushNode(map);
+
+  addNodes(map, {{parentForNodes(map), {sourceNode, targetNode, brushNode}}});
+
+  auto renderer = EntityLinkRenderer{map};
+  renderer.prepareLinks();
+  REQUIRE(renderer.visibleLinks(camera) == std::vector<const void*>{sourceNode});
+
+  SECTION("Invalidating a world brush")
+  {
+    renderer.invalidateNodes({brushNode});
+    renderer.invalidateNodesRecursive({brushNode});
+    renderer.prepareLinks();
+
+    CHECK(renderer.visibleLinks(camera) == std::vector<const void*>{sourceNode});
+  }
+
+  SECTION("Invalidating a grouped brush")
+  {
+    selectNodes(map, {brushNode});
+    auto* groupNode = groupSelectedNodes(map, "group");
+    REQUIRE(groupNode != nullptr);
+
+    renderer.invalidateNodesRecursive({groupNode});
+    renderer.invalidateNodesRecursive({brushNode});
+    renderer.prepareLinks();
+
+    CHECK(renderer.visibleLinks(camera) == std::vector<const void*>{sourceNode});
+  }
+
+  SECTION("Invalidating the world")
+  {
+    renderer.invalidateNodesRecursive({&map.worldNode()});
+    renderer.prepareLinks();
+
+    CHECK(renderer.visibleLinks(camera) == std::vector<const void*>{sourceNode});
+  }
+
+  SECTION("Changing the target removes the link")
+  {
+    selectNodes(map, {targetNode});
+    setEntityProperty(map, Targetname, "some_other_value");
+
+    renderer.invalidateNodes({targetNode});
+    renderer.prepareLinks();
+
+    CHECK(renderer.visibleLinks(camera).empty());
+  }
+
+  SECTION("Changing the source removes the link")
+  {
+    selectNodes(map, {sourceNode});
+    setEntityProperty(map, Target, "some_other_value");
+
+    renderer.invalidateNodes({sourceNode});
+    renderer.prepareLinks();
+
+    CHECK(renderer.visibleLinks(camera).empty());
+  }
+
+  SECTION("Adding a source adds its link")
+  {
+    auto* otherSourceNode = new mdl::EntityNode{mdl::Entity{{
+      {Classname, sourceClassname},
+      {Origin, "0 0 64"},
+      {Target, "some_value"},
+    }}};
+    addNodes(map, {{parentForNodes(map), {otherSourceNode}}});
+
+    renderer.invalidateNodesRecursive({otherSourceNode});
+    renderer.prepareLinks();
+
+    CHECK_THAT(
+      renderer.visibleLinks(camera),
+      UnorderedEquals(std::vector<const void*>{sourceNode, otherSourceNode}));
+  }
+
+  SECTION("Removing the source removes its link")
+  {
+    renderer.removeNodes({sourceNode});
+    removeNodes(map, {sourceNode});
+    renderer.prepareLinks();
+
+    CHECK(renderer.visibleLinks(camera).empty());
+  }
+
+  SECTION("Removing the target removes the link to it")
+  {
+    renderer.removeNodes({targetNode});
+    removeNodes(map, {targetNode});
+    renderer.prepareLinks();
+
+    CHECK(renderer.visibleLinks(camera).empty());
+  }
+}
+
+} // namespace tb::render
@@ -0,0 +1,136 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/LinkRenderer.h"
+#include "render/PerspectiveCamera.h"
+
+#include "vm/vec.h"
+
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_vector.hpp>
+
+namespace tb::render
+{
+namespace
+{
+
+class TestLinkRenderer : public LinkRenderer
+{
+public:
+  using LinkRenderer::removeLinks;
+  using LinkRenderer::setLinks;
+
+private:
+  void collectLinks() override {}
+  std::vector<LineVertex> getLinks() override { return {}; }
+};
+
+std::vector<LinkRenderer::LineVertex> makeLink(
+  const vm::vec3f& start, const vm::vec3f& end)
+{
+  const auto color = vm::vec4f{1, 0, 0, 1};
+  return {
+    LinkRenderer::LineVertex{start, color},
+    LinkRenderer::LineVertex{end, color},
+  };
+}
+
+} // namespace
+
+TEST_CASE("LinkRenderer")
+{
+  using namespace Catch::Matchers;
+
+  // looks along the positive Y axis
+  const auto camera = PerspectiveCamera{
+    90.0f,
+    1.0f,
+    65536.0f,
+    Camera::Viewport{0, 0, 800, 600},
+    vm::vec3f{0, 0, 0},
+    vm::vec3f{0, 1, 0},
+    vm::vec3f{0, 0, 1}};
+
+  const auto key1 = 1;
+  const auto key2 = 2;
+
+  auto renderer = TestLinkRenderer{};
+  renderer.prepareLinks();
+  CHECK(renderer.visibleLinks(camera).empty());
+
+  SECTION("setLinks")
+  {
+    renderer.setLinks(&key1, makeLink({0, 128, 0}, {64, 128, 0}));
+    renderer.setLinks(&key2, makeLink({0, 256, 0}, {0, 256, 64}));
+    CHECK_THAT(
+      renderer.visibleLinks(camera),
+      UnorderedEquals(std::vector<const void*>{&key1, &key2}));
+
+    SECTION("replaces the links of a key")
+    {
+      renderer.setLinks(&key1, makeLink({0, -128, 0}, {64, -128, 0}));
+      CHECK(renderer.visibleLinks(camera) == std::vector<const void*>{&key2});
+    }
+
+    SECTION("removes the links of a key if there are none")
+    {
+      renderer.setLinks(&key1, {});
+      CHECK(renderer.visibleLinks(camera) == std::vector<const void*>{&key2});
+    }
+  }
+
+  SECTION("removeLinks")
+  {
+    renderer.setLinks(&key1, makeLink({0, 128, 0}, {64, 128, 0}));
+    renderer.setLinks(&key2, makeLink({0, 256, 0}, {0, 256, 64}));
+
+    renderer.removeLinks(&key1);
+    CHECK(renderer.visibleLinks(camera) == std::vector<const void*>{&key2});
+
+    renderer.removeLinks(&key2);
+    CHECK(renderer.visibleLinks(camera).empty());
+  }
+
+  SECTION("Culls links outside of the frustum")
+  {
+    // behind the camera
+    renderer.setLinks(&key1, makeLink({0, -128, 0}, {64, -128, 0}));
+    // far to the left of the camera
+    renderer.setLinks(&key2, makeLink({-4096, 128, 0}, {-4096, 128, 64}));
+    CHECK(renderer.visibleLinks(camera).empty());
+  }
+
+  SECTION("Culls links that have faded out")
+  {
+    renderer.setLinks(&key1, makeLink({0, 30000, 0}, {64, 30000, 0}));
+    CHECK(renderer.visibleLinks(camera).empty());
+  }
+
+  SECTION("Keeps links that cross the frustum")
+  {
+    renderer.setLinks(&key1, makeLink({0, -128, 0}, {0, 128, 0}));
+    CHECK(renderer.visibleLinks(camera) == std::vector<const void*>{&key1});
+  }
+}
+
+} // namespace tb::render
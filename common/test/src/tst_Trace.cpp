@@ -0,0 +1,187 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Trace.h"
+
+#include "kd/ranges/to.h"
+#include "kd/task_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <functional>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+namespace tb
+{
+using namespace Catch::Matchers;
+
+namespace
+{
+
+std::vector<std::string> eventNames(const TraceRecorder& recorder)
+{
+  return recorder.events()
+         | std::views::transform([](const auto& event) { return event.name; })
+         | kdl::ranges::to<std::vector<std::string>>();
+}
+
+void record(TraceRecorder& recorder, const char* name, std::string args = {})
+{
+  const auto now = std::chrono::steady_clock::now();
+  recorder.record(name, std::move(args), now, now);
+}
+
+std::string writeChromeTrace(const TraceRecorder& recorder)
+{
+  auto stream = std::stringstream{};
+  recorder.writeChromeTrace(stream);
+  return stream.str();
+}
+
+} // namespace
+
+TEST_CASE("TraceRecorder")
+{
+  auto recorder = TraceRecorder{4};
+
+  SECTION("Records events in order")
+  {
+    record(recorder, "a");
+    record(recorder, "b");
+    record(recorder, "c");
+
+    CHECK(eventNames(recorder) == std::vector<std::string>{"a", "b", "c"});
+  }
+
+  SECTION("Keeps the most recent events")
+  {
+    record(recorder, "a");
+    record(recorder, "b");
+    record(recorder, "c");
+    record(recorder, "d");
+    record(recorder, "e");
+    record(recorder, "f");
+
+    CHECK(eventNames(recorder) == std::vector<std::string>{"c", "d", "e", "f"});
+  }
+
+  SECTION("Drops events while disabled")
+  {
+    record(recorder, "a");
+    recorder.setEnabled(false);
+    record(recorder, "b");
+    {
+      const auto trace = TraceScope{recorder, "scope"};
+    }
+    recorder.setEnabled(true);
+    record(recorder, "c");
+
+    CHECK(eventNames(recorder) == std::vector<std::string>{"a", "c"});
+  }
+
+  SECTION("Threads beyond the maximum share the last thread index")
+  {
+    for (size_t i = 0; i < TraceRecorder::MaxThreadCount + 4; ++i)
+    {
+      std::thread{[&]() { record(recorder, "task"); }}.join();
+    }
+
+    const auto events = recorder.events();
+    REQUIRE(events.size() == 4);
+    CHECK(std::ranges::all_of(events, [](const auto& event) {
+      return event.threadIndex == TraceRecorder::MaxThreadCount - 1;
+    }));
+    CHECK_THAT(
+      writeChromeTrace(recorder),
+      ContainsSubstring(std::format(
+        R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},)"
+        R"("args":{{"name":"Other threads"}}}})",
+        TraceRecorder::MaxThreadCount - 1)));
+  }
+
+  SECTION("TraceScope records an event when it ends")
+  {
+    {
+      const auto trace = TraceScope{recorder, "scope", "args"};
+      CHECK(recorder.events().empty());
+    }
+
+    const auto events = recorder.events();
+    REQUIRE(events.size() == 1);
+    CHECK(events.front().name == std::string{"scope"});
+    CHECK(events.front().args == "args");
+    CHECK(events.front().threadIndex == 0);
+    CHECK(events.front().begin <= events.front().end);
+  }
+
+  SECTION("writeChromeTrace")
+  {
+    recorder.setThreadName("Main thread");
+    record(recorder, "load", R"(a "quoted" path)");
+    std::thread{[&]() { record(recorder, "task"); }}.join();
+
+    const auto trace = writeChromeTrace(recorder);
+    CHECK_THAT(trace, StartsWith(R"({"displayTimeUnit":"ms","traceEvents":[)"));
+    CHECK_THAT(trace, EndsWith("]}"));
+    CHECK_THAT(
+      trace,
+      ContainsSubstring(
+        R"({"name":"thread_name","ph":"M","pid":1,"tid":0,)"
+        R"("args":{"name":"Main thread"}})"));
+    CHECK_THAT(
+      trace,
+      ContainsSubstring(
+        R"({"name":"thread_name","ph":"M","pid":1,"tid":1,)"
+        R"("args":{"name":"Thread 1"}})"));
+    CHECK_THAT(trace, ContainsSubstring(R"({"name":"load","ph":"X","pid":1,"tid":0,)"));
+    CHECK_THAT(trace, ContainsSubstring(R"("args":{"detail":"a \"quoted\" path"}})"));
+    CHECK_THAT(trace, ContainsSubstring(R"({"name":"task","ph":"X","pid":1,"tid":1,)"));
+  }
+
+  SECTION("makeTraceObserver")
+  {
+    {
+      auto taskManager = kdl::task_manager{2, makeTraceObserver(recorder)};
+      auto tasks = std::views::iota(0, 10) | std::views::transform([](int i) {
+                     return std::function{[i]() { return i; }};
+                   })
+                   | kdl::ranges::to<std::vector>();
+      taskManager.run_tasks_and_wait(tasks);
+    }
+
+    const auto names = eventNames(recorder);
+    CHECK_FALSE(names.empty());
+    CHECK(std::ranges::all_of(
+      names, [](const auto& name) { return name == "Run tasks"; }));
+    CHECK_THAT(
+      writeChromeTrace(recorder), ContainsSubstring(R"("args":{"name":"Worker )"));
+  }
+}
+
+} // namespace tb
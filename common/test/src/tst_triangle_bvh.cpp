@@ -0,0 +1,149 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "triangle_bvh.h"
+
+#include "vm/approx.h"
+#include "vm/intersection.h"
+#include "vm/ray.h"
+#include "vm/ray_io.h" // IWYU pragma: keep
+#include "vm/scalar.h"
+#include "vm/vec.h"
+
+#include <cmath>
+#include <optional>
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb
+{
+namespace
+{
+
+/**
+ * Returns the triangles of a bumpy height field with the given number of cells per side.
+ */
+std::vector<vm::vec3f> makeHeightField(const size_t cells)
+{
+  const auto height = [](const size_t x, const size_t y) {
+    return 4.0f * std::sin(float(x) * 0.7f) * std::cos(float(y) * 0.3f);
+  };
+  const auto point = [&](const size_t x, const size_t y) {
+    return vm::vec3f{float(x) * 8.0f, float(y) * 8.0f, height(x, y)};
+  };
+
+  auto points = std::vector<vm::vec3f>{};
+  for (size_t x = 0; x < cells; ++x)
+  {
+    for (size_t y = 0; y < cells; ++y)
+    {
+      points.push_back(point(x, y));
+      points.push_back(point(x + 1, y));
+      points.push_back(point(x + 1, y + 1));
+
+      points.push_back(point(x, y));
+      points.push_back(point(x + 1, y + 1));
+      points.push_back(point(x, y + 1));
+    }
+  }
+  return points;
+}
+
+std::optional<float> intersectAll(
+  const std::vector<vm::vec3f>& points, const vm::ray3f& ray)
+{
+  auto closest = std::optional<float>{};
+  for (size_t i = 0; i < points.size(); i += 3)
+  {
+    if (const auto distance =
+          vm::intersect_ray_triangle(ray, points[i], points[i + 1], points[i + 2]);
+        distance && *distance >= 0.0f)
+    {
+      closest = vm::safe_min(closest, distance);
+    }
+  }
+  return closest;
+}
+
+} // namespace
+
+TEST_CASE("triangle_bvh")
+{
+  SECTION("empty")
+  {
+    const auto bvh = triangle_bvh<float>{};
+    CHECK(bvh.empty());
+    CHECK(bvh.intersect(vm::ray3f{vm::vec3f{0, 0, 0}, vm::vec3f{1, 0, 0}}) == std::nullopt);
+  }
+
+  SECTION("single triangle")
+  {
+    const auto bvh = triangle_bvh<float>{std::vector<vm::vec3f>{
+      {-1, -1, 0},
+      {1, -1, 0},
+      {0, 1, 0},
+    }};
+    CHECK_FALSE(bvh.empty());
+
+    CHECK(
+      std::optional{4.0f}
+      == vm::optional_approx(
+        bvh.intersect(vm::ray3f{vm::vec3f{0, 0, 4}, vm::vec3f{0, 0, -1}})));
+    CHECK(
+      std::optional{4.0f}
+      == vm::optional_approx(
+        bvh.intersect(vm::ray3f{vm::vec3f{0, 0, -4}, vm::vec3f{0, 0, 1}})));
+
+    // the triangle is behind the ray
+    CHECK(bvh.intersect(vm::ray3f{vm::vec3f{0, 0, 4}, vm::vec3f{0, 0, 1}}) == std::nullopt);
+
+    // the ray passes the triangle
+    CHECK(
+      bvh.intersect(vm::ray3f{vm::vec3f{2, 0, 4}, vm::vec3f{0, 0, -1}}) == std::nullopt);
+  }
+
+  SECTION("finds the closest triangle")
+  {
+    const auto points = makeHeightField(32);
+    const auto bvh = triangle_bvh<float>{points};
+
+    for (size_t x = 0; x < 32; ++x)
+    {
+      for (size_t y = 0; y < 32; ++y)
+      {
+        const auto origin = vm::vec3f{float(x) * 7.9f + 1.0f, float(y) * 8.1f - 3.0f, 32};
+        const auto direction = vm::normalize(vm::vec3f{0.3f, -0.2f, -1.0f});
+        const auto ray = vm::ray3f{origin, direction};
+
+        CAPTURE(ray);
+        CHECK(intersectAll(points, ray) == vm::optional_approx(bvh.intersect(ray)));
+      }
+    }
+
+    // a ray from the side crosses many triangles
+    const auto sideRay =
+      vm::ray3f{vm::vec3f{-16, 100, 1}, vm::normalize(vm::vec3f{1, 0.01f, 0})};
+    CHECK(intersectAll(points, sideRay) == vm::optional_approx(bvh.intersect(sideRay)));
+  }
+}
+
+} // namespace tb
@@ -0,0 +1,231 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ui/CellLayout.h"
+
+#include <string>
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::ui
+{
+namespace
+{
+
+struct Item
+{
+  std::string name;
+  float width;
+  float height;
+};
+
+struct Group
+{
+  std::string title;
+  std::vector<Item> items;
+};
+
+CellLayout makeLayout()
+{
+  auto layout = CellLayout{};
+  layout.setWidth(300.0f);
+  layout.setCellMargin(4.0f);
+  layout.setTitleMargin(2.0f);
+  layout.setRowMargin(6.0f);
+  layout.setGroupMargin(8.0f);
+  layout.setOuterMargin(5.0f);
+  layout.setCellWidth(32.0f, 64.0f);
+  layout.setCellHeight(32.0f, 64.0f);
+  return layout;
+}
+
+void addGroups(CellLayout& layout, const std::vector<Group>& groups)
+{
+  for (const auto& group : groups)
+  {
+    layout.addGroup(group.title, 12.0f);
+    for (const auto& item : group.items)
+    {
+      layout.addItem(item.name, item.name, item.width, item.height, 20.0f, 10.0f);
+    }
+  }
+}
+
+struct CellInfo
+{
+  std::string item;
+  float x;
+  float y;
+  float width;
+  float height;
+
+  bool operator==(const CellInfo&) const = default;
+};
+
+std::vector<CellInfo> cellInfos(CellLayout& layout)
+{
+  auto result = std::vector<CellInfo>{};
+  for (const auto& group : layout.groups())
+  {
+    for (const auto& row : group.rows())
+    {
+      for (const auto& cell : row.cells())
+      {
+        const auto& bounds = cell.cellBounds();
+        result.push_back(CellInfo{
+          cell.itemAs<std::string>(), bounds.x, bounds.y, bounds.width, bounds.height});
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<Item> makeItems(const std::string& prefix, const size_t count)
+{
+  auto result = std::vector<Item>{};
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto width = float(16 + (i * 7) % 48);
+    const auto height = float(16 + (i * 5) % 48);
+    result.push_back(Item{prefix + std::to_string(i), width, height});
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("CellLayout")
+{
+  auto groups = std::vector<Group>{
+    {"a", makeItems("a", 20)},
+    {"b", makeItems("b", 15)},
+    {"c", makeItems("c", 25)},
+  };
+
+  auto layout = makeLayout();
+  addGroups(layout, groups);
+  REQUIRE(layout.height() > 0.0f);
+
+  const auto update = [&](const std::vector<Group>& newGroups) {
+    layout.beginUpdate();
+    addGroups(layout, newGroups);
+    layout.endUpdate();
+
+    auto expected = makeLayout();
+    addGroups(expected, newGroups);
+
+    CHECK(cellInfos(layout) == cellInfos(expected));
+    CHECK(layout.height() == expected.height());
+  };
+
+  SECTION("Update with the same items")
+  {
+    update(groups);
+  }
+
+  SECTION("Update replaces items without changing their size")
+  {
+    groups[1].items[3].name = "x";
+    update(groups);
+  }
+
+  SECTION("Update with a changed item")
+  {
+    groups[1].items[7].width = 60.0f;
+    update(groups);
+  }
+
+  SECTION("Update with an inserted item")
+  {
+    groups[0].items.insert(groups[0].items.begin() + 9, Item{"x", 40.0f, 60.0f});
+    update(groups);
+  }
+
+  SECTION("Update with a removed item")
+  {
+    groups[2].items.erase(groups[2].items.begin() + 20);
+    update(groups);
+  }
+
+  SECTION("Update with appended items")
+  {
+    groups[2].items.push_back(Item{"x", 30.0f, 30.0f});
+    groups.push_back(Group{"d", makeItems("d", 10)});
+    update(groups);
+  }
+
+  SECTION("Update with a removed group")
+  {
+    groups.erase(groups.begin() + 1);
+    update(groups);
+  }
+
+  SECTION("Update with no items")
+  {
+    update({});
+  }
+
+  SECTION("Update after invalidation")
+  {
+    layout.setWidth(200.0f);
+    groups[1].items[7].width = 60.0f;
+
+    layout.beginUpdate();
+    addGroups(layout, groups);
+    layout.endUpdate();
+
+    auto expected = makeLayout();
+    expected.setWidth(200.0f);
+    addGroups(expected, groups);
+
+    CHECK(cellInfos(layout) == cellInfos(expected));
+    CHECK(layout.height() == expected.height());
+  }
+
+  SECTION("rowsIntersectingY")
+  {
+    for (const auto& group : layout.groups())
+    {
+      for (const auto y : {0.0f, 50.0f, 120.0f, 300.0f})
+      {
+        auto expected = std::vector<const LayoutRow*>{};
+        for (const auto& row : group.rows())
+        {
+          if (row.intersectsY(y, 60.0f))
+          {
+            expected.push_back(&row);
+          }
+        }
+
+        auto actual = std::vector<const LayoutRow*>{};
+        for (const auto& row : group.rowsIntersectingY(y, 60.0f))
+        {
+          actual.push_back(&row);
+        }
+
+        CHECK(actual == expected);
+      }
+    }
+  }
+}
+
+} // namespace tb::ui
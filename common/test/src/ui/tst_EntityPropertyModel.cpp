@@ -19,6 +19,8 @@
 
 #include "mdl/EntityDefinitionManager.h"
 #include "mdl/Map.h"
+#include "mdl/Map_Assets.h"
+#include "mdl/Map_Entities.h"
 #include "mdl/Map_Nodes.h"
 #include "mdl/Map_Selection.h"
 #include "ui/EntityPropertyModel.h"
@@ -28,9 +30,23 @@
 #include "catch/CatchConfig.h"
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_vector.hpp>
 
 namespace tb::ui
 {
+using namespace Catch::Matchers;
+
+namespace
+{
+
+std::vector<PropertyRow> rebuildRows(MapDocument& document)
+{
+  auto model = EntityPropertyModel{document};
+  model.updateFromMap();
+  return model.rows();
+}
+
+} // namespace
 
 TEST_CASE("EntityPropertyModel")
 {
@@ -368,6 +384,120 @@ TEST_CASE("EntityPropertyModel")
             .tooltip = "No description found",
           },
         });
+
+      SECTION("after changing a property")
+      {
+        mdl::setEntityProperty(map, "some_key", "same_value");
+        model.updateFromMap();
+
+        CHECK(
+          model.rows()
+          == std::vector<PropertyRow>{
+            {
+              .key = "some_key",
+              .value = "same_value",
+              .valueState = ValueState::SingleValue,
+              .keyMutable = true,
+              .valueMutable = true,
+              .protection = PropertyProtection::NotProtectable,
+              .linkType = LinkType::None,
+              .tooltip = "No description found",
+            },
+            {
+              .key = "some_other_key",
+              .value = "yet_another_value",
+              .valueState = ValueState::SingleValueAndUnset,
+              .keyMutable = true,
+              .valueMutable = true,
+              .protection = PropertyProtection::NotProtectable,
+              .linkType = LinkType::None,
+              .tooltip = "No description found",
+            },
+          });
+      }
+
+      SECTION("after removing a property")
+      {
+        mdl::removeEntityProperty(map, "some_other_key");
+        model.updateFromMap();
+
+        CHECK(
+          model.rows()
+          == std::vector<PropertyRow>{
+            {
+              .key = "some_key",
+              .value = "multi",
+              .valueState = ValueState::MultipleValues,
+              .keyMutable = true,
+              .valueMutable = true,
+              .protection = PropertyProtection::NotProtectable,
+              .linkType = LinkType::None,
+              .tooltip = "No description found",
+            },
+          });
+      }
+
+      SECTION("after undoing a property change")
+      {
+        mdl::setEntityProperty(map, "some_key", "same_value");
+        model.updateFromMap();
+
+        map.undoCommand();
+        model.updateFromMap();
+
+        CHECK_THAT(model.rows(), UnorderedEquals(rebuildRows(document)));
+      }
+
+      SECTION("after changing the classname")
+      {
+        mdl::setEntityProperty(map, mdl::EntityPropertyKeys::Classname, "source_entity");
+        model.updateFromMap();
+
+        CHECK_THAT(model.rows(), UnorderedEquals(rebuildRows(document)));
+
+        SECTION("and undoing the change")
+        {
+          map.undoCommand();
+          model.updateFromMap();
+
+          CHECK_THAT(model.rows(), UnorderedEquals(rebuildRows(document)));
+        }
+      }
+
+      SECTION("after protecting a property")
+      {
+        mdl::setProtectedEntityProperty(map, "some_key", true);
+        model.updateFromMap();
+
+        CHECK_THAT(model.rows(), UnorderedEquals(rebuildRows(document)));
+      }
+
+      SECTION("after changing the entity definitions")
+      {
+        mdl::reloadEntityDefinitions(map);
+        model.updateFromMap();
+
+        CHECK_THAT(model.rows(), UnorderedEquals(rebuildRows(document)));
+      }
+
+      SECTION("after reparenting an entity")
+      {
+        mdl::reparentNodes(map, {{groupNode, {entityNode2}}});
+        model.updateFromMap();
+
+        CHECK_THAT(model.rows(), UnorderedEquals(rebuildRows(document)));
+      }
+
+      SECTION("after adding an entity")
+      {
+        auto* entityNode3 = new mdl::EntityNode{mdl::Entity{{
+          {"some_key", "some_value"},
+        }}};
+        mdl::addNodes(map, {{mdl::parentForNodes(map), {entityNode3}}});
+        model.updateFromMap();
+
+        CHECK_THAT(model.rows(), UnorderedEquals(rebuildRows(document)));
+      }
     }
 
     SECTION("source entity")
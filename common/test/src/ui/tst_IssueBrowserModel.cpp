@@ -0,0 +1,160 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QSignalSpy>
+
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/Issue.h"
+#include "ui/IssueBrowserView.h"
+
+#include <utility>
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::ui
+{
+namespace
+{
+
+std::vector<const mdl::Issue*> rowIssues(const IssueBrowserModel& model)
+{
+  auto result = std::vector<const mdl::Issue*>{};
+  for (int row = 0; row < model.rowCount(QModelIndex{}); ++row)
+  {
+    result.push_back(model.issue(static_cast<size_t>(row)));
+  }
+  return result;
+}
+
+std::vector<std::pair<int, int>> rowRanges(const QSignalSpy& spy)
+{
+  auto result = std::vector<std::pair<int, int>>{};
+  for (const auto& arguments : spy)
+  {
+    result.emplace_back(arguments.at(1).toInt(), arguments.at(2).toInt());
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("IssueBrowserModel")
+{
+  auto node1 = mdl::EntityNode{mdl::Entity{}};
+  auto node2 = mdl::EntityNode{mdl::Entity{}};
+  auto node3 = mdl::EntityNode{mdl::Entity{}};
+
+  // the sequence IDs increase in the order in which the issues are created
+  const auto issue1 = mdl::Issue{0, node1, "issue1"};
+  const auto issue2 = mdl::Issue{0, node1, "issue2"};
+  const auto issue3 = mdl::Issue{0, node1, "issue3"};
+  const auto issue4 = mdl::Issue{0, node2, "issue4"};
+  const auto issue5 = mdl::Issue{0, node3, "issue5"};
+
+  auto model = IssueBrowserModel{nullptr};
+
+  using T = std::vector<const mdl::Issue*>;
+  using R = std::vector<std::pair<int, int>>;
+
+  SECTION("setIssues sorts by descending sequence ID")
+  {
+    model.setIssues({&issue1, &issue3, &issue2});
+    CHECK(rowIssues(model) == T{&issue3, &issue2, &issue1});
+  }
+
+  SECTION("addIssues")
+  {
+    auto rowsInsertedSpy =
+      QSignalSpy{&model, SIGNAL(rowsInserted(const QModelIndex&, int, int))};
+
+    SECTION("Inserts each run of new rows before the same existing row at once")
+    {
+      model.setIssues({&issue1, &issue4});
+      model.addIssues({&issue2, &issue5, &issue3});
+
+      CHECK(rowIssues(model) == T{&issue5, &issue4, &issue3, &issue2, &issue1});
+      CHECK(rowRanges(rowsInsertedSpy) == R{{0, 0}, {2, 3}});
+    }
+
+    SECTION("Appends rows older than all existing rows")
+    {
+      model.setIssues({&issue4, &issue5});
+      model.addIssues({&issue1, &issue2});
+
+      CHECK(rowIssues(model) == T{&issue5, &issue4, &issue2, &issue1});
+      CHECK(rowRanges(rowsInsertedSpy) == R{{2, 3}});
+    }
+
+    SECTION("Inserts into an empty model")
+    {
+      model.addIssues({&issue1, &issue2});
+
+      CHECK(rowIssues(model) == T{&issue2, &issue1});
+      CHECK(rowRanges(rowsInsertedSpy) == R{{0, 1}});
+    }
+
+    SECTION("Does nothing if there are no issues")
+    {
+      model.setIssues({&issue1});
+      model.addIssues({});
+
+      CHECK(rowIssues(model) == T{&issue1});
+      CHECK(rowsInsertedSpy.empty());
+    }
+  }
+
+  SECTION("removeIssues")
+  {
+    model.setIssues({&issue1, &issue2, &issue3, &issue4, &issue5});
+    REQUIRE(rowIssues(model) == T{&issue5, &issue4, &issue3, &issue2, &issue1});
+
+    auto rowsRemovedSpy =
+      QSignalSpy{&model, SIGNAL(rowsRemoved(const QModelIndex&, int, int))};
+
+    SECTION("Removes each run of rows starting with the last one")
+    {
+      model.removeIssues({&node1, &node3});
+
+      CHECK(rowIssues(model) == T{&issue4});
+      CHECK(rowRanges(rowsRemovedSpy) == R{{2, 4}, {0, 0}});
+    }
+
+    SECTION("Removes the rows of a single node")
+    {
+      model.removeIssues({&node2});
+
+      CHECK(rowIssues(model) == T{&issue5, &issue3, &issue2, &issue1});
+      CHECK(rowRanges(rowsRemovedSpy) == R{{1, 1}});
+    }
+
+    SECTION("Does nothing if no nodes are given")
+    {
+      model.removeIssues({});
+
+      CHECK(rowIssues(model).size() == 5);
+      CHECK(rowsRemovedSpy.empty());
+    }
+  }
+}
+
+} // namespace tb::ui
@@ -0,0 +1,185 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mdl/Material.h"
+#include "mdl/MaterialCollection.h"
+#include "mdl/Texture.h"
+#include "mdl/TextureResource.h"
+#include "ui/MaterialBrowserQuery.h"
+
+#include <ranges>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+#include "catch/CatchConfig.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace tb::ui
+{
+namespace
+{
+
+mdl::Material makeMaterial(std::string name, const size_t usageCount = 0)
+{
+  auto material =
+    mdl::Material{std::move(name), createTextureResource(mdl::Texture{16, 16})};
+  for (size_t i = 0; i < usageCount; ++i)
+  {
+    material.incUsageCount();
+  }
+  return material;
+}
+
+std::vector<mdl::Material> makeMaterials(
+  const std::vector<std::pair<std::string, size_t>>& namesAndUsageCounts)
+{
+  auto result = std::vector<mdl::Material>{};
+  for (const auto& [name, usageCount] : namesAndUsageCounts)
+  {
+    result.push_back(makeMaterial(name, usageCount));
+  }
+  return result;
+}
+
+struct GroupNames
+{
+  std::string title;
+  std::vector<std::string> names;
+
+  bool operator==(const GroupNames&) const = default;
+};
+
+std::vector<GroupNames> groupNames(const std::vector<MaterialBrowserGroup>& groups)
+{
+  auto result = std::vector<GroupNames>{};
+  for (const auto& group : groups)
+  {
+    auto names = std::vector<std::string>{};
+    for (const auto* material : group.materials)
+    {
+      names.push_back(material->name());
+    }
+    result.push_back(GroupNames{group.title, std::move(names)});
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("MaterialBrowserQuery")
+{
+  const auto collection1 = mdl::MaterialCollection{
+    "textures/base",
+    makeMaterials({{"Wall", 2}, {"floor", 0}, {"sky", 1}}),
+  };
+  const auto collection2 = mdl::MaterialCollection{
+    "textures/extra",
+    makeMaterials({{"metal_floor", 3}, {"crate", 0}}),
+  };
+
+  const auto snapshot = makeMaterialBrowserSnapshot({&collection1, &collection2});
+  REQUIRE(snapshot->materials->entries.size() == 5);
+
+  using T = std::vector<GroupNames>;
+
+  SECTION("Sorts by name")
+  {
+    const auto query = MaterialBrowserQuery{};
+    CHECK(
+      groupNames(*runMaterialBrowserQuery(*snapshot, query))
+      == T{{"", {"crate", "floor", "metal_floor", "sky", "Wall"}}});
+  }
+
+  SECTION("Sorts by usage")
+  {
+    const auto query = MaterialBrowserQuery{false, false, MaterialSortOrder::Usage, {}};
+    CHECK(
+      groupNames(*runMaterialBrowserQuery(*snapshot, query))
+      == T{{"", {"metal_floor", "Wall", "sky", "crate", "floor"}}});
+  }
+
+  SECTION("Groups by collection")
+  {
+    const auto query = MaterialBrowserQuery{true, false, MaterialSortOrder::Name, {}};
+    CHECK(
+      groupNames(*runMaterialBrowserQuery(*snapshot, query))
+      == T{
+        {"textures/base", {"floor", "sky", "Wall"}},
+        {"textures/extra", {"crate", "metal_floor"}},
+      });
+  }
+
+  SECTION("Hides unused materials")
+  {
+    const auto query = MaterialBrowserQuery{false, true, MaterialSortOrder::Name, {}};
+    CHECK(
+      groupNames(*runMaterialBrowserQuery(*snapshot, query))
+      == T{{"", {"metal_floor", "sky", "Wall"}}});
+  }
+
+  SECTION("Filters by name")
+  {
+    const auto query =
+      MaterialBrowserQuery{false, false, MaterialSortOrder::Name, {"floor", "wa"}};
+    CHECK(
+      groupNames(*runMaterialBrowserQuery(*snapshot, query))
+      == T{{"", {"floor", "metal_floor", "Wall"}}});
+  }
+
+  SECTION("Snapshot keeps usage counts")
+  {
+    collection1.materials().front().incUsageCount();
+    collection1.materials().front().incUsageCount();
+
+    const auto query = MaterialBrowserQuery{false, false, MaterialSortOrder::Usage, {}};
+    CHECK(
+      groupNames(*runMaterialBrowserQuery(*snapshot, query))
+      == T{{"", {"metal_floor", "Wall", "sky", "crate", "floor"}}});
+  }
+
+  SECTION("Updates usage counts")
+  {
+    collection1.materials().front().incUsageCount();
+    collection1.materials().front().incUsageCount();
+
+    const auto updatedSnapshot = updateUsageCounts(*snapshot);
+    CHECK(updatedSnapshot->materials == snapshot->materials);
+    CHECK(updatedSnapshot->usageCounts == std::vector<size_t>{4, 0, 1, 3, 0});
+    CHECK(snapshot->usageCounts == std::vector<size_t>{2, 0, 1, 3, 0});
+
+    const auto query = MaterialBrowserQuery{false, false, MaterialSortOrder::Usage, {}};
+    CHECK(
+      groupNames(*runMaterialBrowserQuery(*updatedSnapshot, query))
+      == T{{"", {"Wall", "metal_floor", "sky", "crate", "floor"}}});
+  }
+
+  SECTION("Stops if requested")
+  {
+    auto stopSource = std::stop_source{};
+    stopSource.request_stop();
+
+    CHECK(
+      runMaterialBrowserQuery(*snapshot, MaterialBrowserQuery{}, stopSource.get_token())
+      == std::nullopt);
+  }
+}
+
+} // namespace tb::ui
@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "kd/task_manager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace kdl
+{
+namespace detail
+{
+
+struct parallel_for_state
+{
+  std::size_t chunk_count;
+  std::atomic<std::size_t> next_chunk = 0;
+  std::atomic<bool> failed = false;
+
+  std::mutex mutex;
+  std::condition_variable finished_cv;
+  std::size_t finished_chunk_count = 0;
+  std::exception_ptr exception;
+
+  explicit parallel_for_state(const std::size_t chunk_count_)
+    : chunk_count{chunk_count_}
+  {
+  }
+};
+
+} // namespace detail
+
+/**
+ * Calls the given function for every index in [0, count).
+ *
+ * If there are enough indices, they are split into contiguous chunks of at least
+ * min_chunk_size indices. The chunks are processed by the workers of the given task
+ * manager and by the calling thread. Returns when all indices have been processed. If
+ * the function throws, the remaining chunks are skipped and the first exception is
+ * rethrown after all chunks have finished.
+ *
+ * The calling thread processes every chunk that no worker has started yet, and then it
+ * only waits for the chunks that are being processed by workers. Therefore, this
+ * function can be called from a task that is run by the same task manager, even if all
+ * of its workers are busy.
+ *
+ * The given function must be safe to call concurrently for different indices.
+ */
+template <typename F>
+void parallel_for(
+  task_manager& task_manager,
+  const std::size_t count,
+  const std::size_t min_chunk_size,
+  const F& f)
+{
+  const auto max_chunk_count = task_manager.stats().worker_count + 1;
+  const auto chunk_count =
+    std::min(max_chunk_count, count / std::max(min_chunk_size, std::size_t(1)));
+
+  if (chunk_count <= 1)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      f(i);
+    }
+    return;
+  }
+
+  const auto chunk_size = (count + chunk_count - 1) / chunk_count;
+
+  // The state is shared with the tasks because a task may only start after this function
+  // has returned. Such a task finds no more chunks to process and never calls f.
+  const auto state = std::make_shared<detail::parallel_for_state>(chunk_count);
+  const auto process_chunks = [state, chunk_size, count, &f]() {
+    for (auto chunk = state->next_chunk++; chunk < state->chunk_count;
+         chunk = state->next_chunk++)
+    {
+      auto exception = std::exception_ptr{};
+      if (!state->failed)
+      {
+        try
+        {
+          const auto end = std::min((chunk + 1) * chunk_size, count);
+          for (auto i = chunk * chunk_size; i < end; ++i)
+          {
+            f(i);
+          }
+        }
+        catch (...)
+        {
+          exception = std::current_exception();
+          state->failed = true;
+        }
+      }
+
+      {
+        auto lock = std::lock_guard{state->mutex};
+        if (exception && !state->exception)
+        {
+          state->exception = std::move(exception);
+        }
+        ++state->finished_chunk_count;
+      }
+      state->finished_cv.notify_all();
+    }
+  };
+
+  for (std::size_t i = 1; i < chunk_count; ++i)
+  {
+    task_manager.run_task(std::function<void()>{process_chunks});
+  }
+
+  process_chunks();
+
+  auto lock = std::unique_lock{state->mutex};
+  state->finished_cv.wait(
+    lock, [&] { return state->finished_chunk_count == state->chunk_count; });
+
+  if (state->exception)
+  {
+    std::rethrow_exception(state->exception);
+  }
+}
+
+} // namespace kdl
@@ -173,6 +173,16 @@ std::string str_escape_if_necessary(
 std::string str_unescape(
   std::string_view str, std::string_view chars, char esc = EscapeChar);
 
+/**
+ * Escapes the given string so that it can be used in a JSON string literal. Quotes and
+ * backslashes are escaped with a backslash, and control characters are written as
+ * unicode escape sequences.
+ *
+ * @param str the string to escape
+ * @return the escaped string
+ */
+std::string str_escape_json(std::string_view str);
+
 /**
  * Checks whether the given string consists of only whitespace.
  *
@@ -22,6 +22,7 @@
 
 #include "kd/ranges/to.h"
 
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <future>
@@ -29,38 +30,88 @@
 #include <queue>
 #include <ranges>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 namespace kdl
 {
 
+/**
+ * Receives notifications from the worker threads of a task manager. The functions are
+ * called on the worker thread with its index.
+ */
+struct task_manager_observer
+{
+  // called before a worker runs its first task after having been idle
+  std::function<void(std::size_t worker_index)> worker_busy;
+  // called when a worker finds no more pending tasks after having run the given number
+  // of tasks since it became busy
+  std::function<void(std::size_t worker_index, std::size_t task_count)> worker_idle;
+};
+
+/**
+ * A snapshot of the state of a task manager.
+ */
+struct task_manager_stats
+{
+  std::size_t worker_count = 0;
+  // the number of tasks that are waiting for a worker
+  std::size_t pending_task_count = 0;
+  // the number of workers that are currently running a task
+  std::size_t busy_worker_count = 0;
+  // the total time that the workers have spent running tasks
+  std::chrono::steady_clock::duration busy_time{};
+};
+
 class task_manager
 {
 private:
   using pending_task = std::function<void()>;
 
+  task_manager_observer m_observer;
   std::vector<std::thread> m_workers;
 
-  std::mutex m_pending_tasks_mutex;
+  mutable std::mutex m_pending_tasks_mutex;
   std::condition_variable m_pending_tasks_cv;
   std::queue<pending_task> m_pending_tasks;
   bool m_running = true;
 
-  std::function<void()> make_worker_func();
+  std::size_t m_busy_worker_count = 0;
+  std::chrono::steady_clock::duration m_busy_time{};
+
+  std::function<void()> make_worker_func(std::size_t worker_index);
+
+  template <typename task_result>
+  static void set_promise_value(
+    std::promise<task_result>& promise, const std::function<task_result()>& task)
+  {
+    if constexpr (std::is_void_v<task_result>)
+    {
+      task();
+      promise.set_value();
+    }
+    else
+    {
+      promise.set_value(task());
+    }
+  }
 
 public:
   explicit task_manager(
-    std::size_t max_concurrent_tasks = std::thread::hardware_concurrency());
+    std::size_t max_concurrent_tasks = std::thread::hardware_concurrency(),
+    task_manager_observer observer = {});
 
   ~task_manager();
 
+  task_manager_stats stats() const;
+
   template <typename task_result>
   auto run_task(std::function<task_result()> task)
   {
     if (m_workers.empty())
     {
       auto promise = std::promise<task_result>{};
-      promise.set_value(task());
+      set_promise_value(promise, task);
       return promise.get_future();
     }
 
@@ -70,7 +121,7 @@ public:
     {
       auto lock = std::lock_guard{m_pending_tasks_mutex};
       m_pending_tasks.push([&, task_ = std::move(task), promise_ = std::move(promise)]() {
-        promise_->set_value(task_());
+        set_promise_value(*promise_, task_);
       });
     }
     m_pending_tasks_cv.notify_one();
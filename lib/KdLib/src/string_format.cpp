@@ -243,6 +243,38 @@ std::string str_unescape(
   return buffer.str();
 }
 
+std::string str_escape_json(const std::string_view str)
+{
+  auto result = std::string{};
+  result.reserve(str.size());
+  for (const auto c : str)
+  {
+    switch (c)
+    {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        constexpr auto HexDigits = std::string_view{"0123456789abcdef"};
+        result += "\\u00";
+        result += HexDigits[static_cast<unsigned char>(c) >> 4];
+        result += HexDigits[static_cast<unsigned char>(c) & 0xf];
+      }
+      else
+      {
+        result += c;
+      }
+      break;
+    }
+  }
+  return result;
+}
+
 bool str_is_blank(const std::string_view str, const std::string_view whitespace)
 {
   return str.find_first_not_of(whitespace) == std::string::npos;
@@ -20,10 +20,12 @@
 
 #include "kd/task_manager.h"
 
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <future>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <ranges>
 #include <thread>
@@ -32,12 +34,32 @@
 namespace kdl
 {
 
-std::function<void()> task_manager::make_worker_func()
+std::function<void()> task_manager::make_worker_func(const std::size_t worker_index)
 {
-  return [&] {
+  return [&, worker_index] {
+    auto task_count = std::size_t(0);
+    auto task_start = std::optional<std::chrono::steady_clock::time_point>{};
     while (true)
     {
       auto lock = std::unique_lock{m_pending_tasks_mutex};
+      if (task_start)
+      {
+        m_busy_time += std::chrono::steady_clock::now() - *task_start;
+        --m_busy_worker_count;
+        task_start = std::nullopt;
+      }
+
+      if (task_count > 0 && m_pending_tasks.empty())
+      {
+        lock.unlock();
+        if (m_observer.worker_idle)
+        {
+          m_observer.worker_idle(worker_index, task_count);
+        }
+        task_count = 0;
+        lock.lock();
+      }
+
       m_pending_tasks_cv.wait(
         lock, [&] { return !m_running || !m_pending_tasks.empty(); });
 
@@ -50,22 +72,36 @@ std::function<void()> task_manager::make_worker_func()
       {
         auto task = std::move(m_pending_tasks.front());
         m_pending_tasks.pop();
+        ++m_busy_worker_count;
+        task_start = std::chrono::steady_clock::now();
         lock.unlock();
 
+        if (task_count++ == 0 && m_observer.worker_busy)
+        {
+          m_observer.worker_busy(worker_index);
+        }
         task();
       }
     }
   };
 }
 
-task_manager::task_manager(const std::size_t max_concurrent_tasks)
+task_manager::task_manager(
+  const std::size_t max_concurrent_tasks, task_manager_observer observer)
+  : m_observer{std::move(observer)}
 {
   for (size_t i = 0; i < max_concurrent_tasks; ++i)
   {
-    m_workers.emplace_back(make_worker_func());
+    m_workers.emplace_back(make_worker_func(i));
   }
 }
 
+task_manager_stats task_manager::stats() const
+{
+  auto lock = std::lock_guard{m_pending_tasks_mutex};
+  return {m_workers.size(), m_pending_tasks.size(), m_busy_worker_count, m_busy_time};
+}
+
 task_manager::~task_manager()
 {
   {
@@ -0,0 +1,101 @@
+/*
+ Copyright 2025 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kd/parallel_for.h"
+#include "kd/task_manager.h"
+
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+namespace kdl
+{
+
+TEST_CASE("parallel_for")
+{
+  const auto worker_count = GENERATE(0u, 1u, 4u);
+  CAPTURE(worker_count);
+
+  auto tm = task_manager{worker_count};
+
+  SECTION("processes every index once")
+  {
+    const auto count = GENERATE(0u, 1u, 7u, 100u, 1000u);
+    const auto min_chunk_size = GENERATE(0u, 1u, 8u, 2000u);
+    CAPTURE(count, min_chunk_size);
+
+    auto calls = std::vector<std::atomic<int>>(count);
+    parallel_for(tm, count, min_chunk_size, [&](const auto i) { ++calls[i]; });
+
+    for (const auto& call : calls)
+    {
+      CHECK(call == 1);
+    }
+  }
+
+  SECTION("rethrows exceptions")
+  {
+    const auto throwing_index = GENERATE(0u, 500u, 999u);
+    CAPTURE(throwing_index);
+
+    auto call_count = std::atomic<int>{0};
+    CHECK_THROWS_AS(
+      parallel_for(
+        tm,
+        1000,
+        1,
+        [&](const auto i) {
+          ++call_count;
+          if (i == throwing_index)
+          {
+            throw std::runtime_error{"error"};
+          }
+        }),
+      std::runtime_error);
+    CHECK(call_count > 0);
+  }
+
+  SECTION("can be called from tasks of the same task manager")
+  {
+    // every worker runs a task that calls parallel_for, so no worker is free to process
+    // the chunks
+    auto calls = std::vector<std::atomic<int>>(worker_count * 100);
+    auto tasks = std::vector<std::function<bool()>>{};
+    for (std::size_t t = 0; t < worker_count; ++t)
+    {
+      tasks.emplace_back([&, t]() {
+        parallel_for(tm, 100, 1, [&](const auto i) { ++calls[t * 100 + i]; });
+        return true;
+      });
+    }
+    tm.run_tasks_and_wait(tasks);
+
+    for (const auto& call : calls)
+    {
+      CHECK(call == 1);
+    }
+  }
+}
+
+} // namespace kdl
@@ -147,6 +147,15 @@ TEST_CASE("string_format_test.str_unescape")
   CHECK(str_unescape("asdf\\\\\\\\", "") == "asdf\\\\");
 }
 
+TEST_CASE("string_format_test.str_escape_json")
+{
+  CHECK(str_escape_json("") == "");
+  CHECK(str_escape_json("asdf") == "asdf");
+  CHECK(str_escape_json(R"(a "quoted" string)") == R"(a \"quoted\" string)");
+  CHECK(str_escape_json(R"(c:\some\path)") == R"(c:\\some\\path)");
+  CHECK(str_escape_json("line\nbreak\t") == R"(line\u000abreak\u0009)");
+}
+
 TEST_CASE("string_format_test.str_is_blank")
 {
   CHECK(str_is_blank(""));
@@ -23,6 +23,7 @@
 #include "kd/task_manager.h"
 
 #include <memory>
+#include <mutex>
 #include <tuple>
 
 #include <catch2/catch_test_macros.hpp>
@@ -127,6 +128,73 @@ TEST_CASE("task_manager")
   }
 }
 
+TEST_CASE("task_manager observer")
+{
+  auto mutex = std::mutex{};
+  auto busy_count = std::size_t(0);
+  auto idle_count = std::size_t(0);
+  auto task_count = std::size_t(0);
+
+  {
+    auto tm = task_manager{
+      2,
+      task_manager_observer{
+        [&](std::size_t) {
+          auto lock = std::lock_guard{mutex};
+          ++busy_count;
+        },
+        [&](std::size_t, const std::size_t count) {
+          auto lock = std::lock_guard{mutex};
+          ++idle_count;
+          task_count += count;
+        },
+      }};
+
+    auto tasks = std::views::iota(0, 10) | std::views::transform([](int i) {
+                   return std::function{[i] { return i; }};
+                 })
+                 | kdl::ranges::to<std::vector>();
+    tm.run_tasks_and_wait(tasks);
+  }
+
+  CHECK(busy_count > 0);
+  CHECK(idle_count == busy_count);
+  CHECK(task_count == 10);
+}
+
+TEST_CASE("task_manager stats")
+{
+  auto tm = task_manager{1};
+  CHECK(tm.stats().worker_count == 1);
+  CHECK(tm.stats().busy_time == std::chrono::steady_clock::duration{});
+
+  auto started = std::promise<void>{};
+  auto release = std::promise<void>{};
+  auto released = release.get_future();
+
+  auto first = tm.run_task(std::function{[&] {
+    started.set_value();
+    released.wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    return 1;
+  }});
+  auto second = tm.run_task(std::function{[] { return 2; }});
+
+  started.get_future().wait();
+
+  const auto stats = tm.stats();
+  CHECK(stats.pending_task_count == 1);
+  CHECK(stats.busy_worker_count == 1);
+
+  release.set_value();
+  CHECK(first.get() == 1);
+  CHECK(second.get() == 2);
+
+  // the first task was accounted for before the worker took the second task
+  CHECK(tm.stats().pending_task_count == 0);
+  CHECK(tm.stats().busy_time >= std::chrono::milliseconds{10});
+}
+
 TEST_CASE("task_manager stress test")
 {
   auto tm = task_manager{};
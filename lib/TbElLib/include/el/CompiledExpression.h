@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "el/Expression.h"
+#include "el/Value.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tb::el
+{
+
+/**
+ * An expression that was compiled into a tree of closures by ExpressionNode::compile.
+ *
+ * Compilation folds constant subexpressions and resolves every variable to a slot. When
+ * the compiled expression is evaluated, each variable is looked up exactly once and the
+ * closures read the variable values from their slots. Unlike ExpressionNode::evaluate,
+ * evaluating a compiled expression does not record a trace of the intermediate values.
+ */
+class CompiledExpression
+{
+public:
+  using Slots = std::vector<Value>;
+  using Function = std::function<Value(EvaluationContext&, const Slots&)>;
+
+private:
+  ExpressionNode m_expression;
+  std::vector<std::string> m_variableNames;
+  std::shared_ptr<const Function> m_function;
+
+public:
+  CompiledExpression(
+    ExpressionNode expression, std::vector<std::string> variableNames, Function function);
+
+  /**
+   * Returns the optimized expression this expression was compiled from.
+   */
+  const ExpressionNode& expression() const;
+
+  /**
+   * Returns the names of the variables the expression refers to, in slot order.
+   */
+  const std::vector<std::string>& variableNames() const;
+
+  /**
+   * Looks up the values of the variables the expression refers to, in slot order.
+   *
+   * Since the expression can only depend on these values, they can serve as a key when
+   * caching evaluation results.
+   */
+  Slots variableValues(const EvaluationContext& context) const;
+
+  /**
+   * Evaluates this expression using the variables of the given context.
+   *
+   * If evaluation fails, the expression is evaluated again using
+   * ExpressionNode::evaluate so that the thrown exception refers to the source locations
+   * of the offending values.
+   */
+  Value evaluate(EvaluationContext& context) const;
+
+  /**
+   * Evaluates this expression using the given variable values, which must have been
+   * obtained by calling variableValues with the given context.
+   */
+  Value evaluate(EvaluationContext& context, const Slots& variableValues) const;
+};
+
+} // namespace tb::el
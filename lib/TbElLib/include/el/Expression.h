@@ -122,6 +122,12 @@ public:
 
   ExpressionNode optimize(EvaluationContext& context) const;
 
+  /**
+   * Optimizes this expression and compiles the result into a tree of closures with
+   * slot resolved variables. If optimization fails, the expression is compiled as is.
+   */
+  CompiledExpression compile() const;
+
   const std::optional<FileLocation>& location() const;
 
   std::string asString() const;
@@ -0,0 +1,77 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "el/CompiledExpression.h"
+
+#include "el/EvaluationContext.h"
+#include "el/Exceptions.h"
+
+namespace tb::el
+{
+
+CompiledExpression::CompiledExpression(
+  ExpressionNode expression, std::vector<std::string> variableNames, Function function)
+  : m_expression{std::move(expression)}
+  , m_variableNames{std::move(variableNames)}
+  , m_function{std::make_shared<const Function>(std::move(function))}
+{
+}
+
+const ExpressionNode& CompiledExpression::expression() const
+{
+  return m_expression;
+}
+
+const std::vector<std::string>& CompiledExpression::variableNames() const
+{
+  return m_variableNames;
+}
+
+CompiledExpression::Slots CompiledExpression::variableValues(
+  const EvaluationContext& context) const
+{
+  auto slots = Slots{};
+  slots.reserve(m_variableNames.size());
+  for (const auto& variableName : m_variableNames)
+  {
+    slots.push_back(context.variableValue(variableName));
+  }
+  return slots;
+}
+
+Value CompiledExpression::evaluate(EvaluationContext& context) const
+{
+  return evaluate(context, variableValues(context));
+}
+
+Value CompiledExpression::evaluate(
+  EvaluationContext& context, const Slots& variableValues) const
+{
+  try
+  {
+    return (*m_function)(context, variableValues);
+  }
+  catch (const Exception&)
+  {
+    // only the tree walking evaluator knows where the failing values came from
+    return m_expression.evaluate(context);
+  }
+}
+
+} // namespace tb::el
@@ -19,6 +19,7 @@
 
 #include "el/Expression.h"
 
+#include "el/CompiledExpression.h"
 #include "el/EvaluationContext.h"
 #include "el/Exceptions.h"
 #include "el/Value.h"
@@ -1321,6 +1322,167 @@ Expression optimizeExpression(
 }
 
 
+struct CompilationState
+{
+  std::vector<std::string> variableNames;
+
+  size_t slot(const std::string& variableName)
+  {
+    const auto it = std::ranges::find(variableNames, variableName);
+    if (it != variableNames.end())
+    {
+      return size_t(std::distance(variableNames.begin(), it));
+    }
+
+    variableNames.push_back(variableName);
+    return variableNames.size() - 1;
+  }
+};
+
+using CompiledFunction = CompiledExpression::Function;
+using Slots = CompiledExpression::Slots;
+
+CompiledFunction compileExpression(
+  CompilationState& state, const ExpressionNode& expressionNode);
+
+CompiledFunction compile(
+  CompilationState&, const LiteralExpression& expression, const ExpressionNode&)
+{
+  return [value = expression.value](EvaluationContext&, const Slots&) { return value; };
+}
+
+CompiledFunction compile(
+  CompilationState& state, const VariableExpression& expression, const ExpressionNode&)
+{
+  return [slot = state.slot(expression.variableName)](
+           EvaluationContext&, const Slots& slots) { return slots[slot]; };
+}
+
+CompiledFunction compile(
+  CompilationState& state, const ArrayExpression& expression, const ExpressionNode&)
+{
+  auto elements = expression.elements | std::views::transform([&](const auto& x) {
+                    return compileExpression(state, x);
+                  })
+                  | kdl::ranges::to<std::vector>();
+
+  return [elements = std::move(elements)](
+           EvaluationContext& context, const Slots& slots) {
+    auto array = ArrayType{};
+    array.reserve(elements.size());
+
+    for (const auto& element : elements)
+    {
+      auto value = element(context, slots);
+      if (value.hasType(ValueType::Range))
+      {
+        const auto& range = std::get<BoundedRange>(value.rangeValue(context));
+        array.reserve(array.size() + range.length());
+        range.forEach([&](const auto& i) { array.emplace_back(i); });
+      }
+      else
+      {
+        array.push_back(std::move(value));
+      }
+    }
+
+    return Value{std::move(array)};
+  };
+}
+
+CompiledFunction compile(
+  CompilationState& state, const MapExpression& expression, const ExpressionNode&)
+{
+  auto elements = expression.elements | std::views::transform([&](const auto& entry) {
+                    return std::pair{entry.first, compileExpression(state, entry.second)};
+                  })
+                  | kdl::ranges::to<std::vector>();
+
+  return [elements = std::move(elements)](
+           EvaluationContext& context, const Slots& slots) {
+    auto map = MapType{};
+    for (const auto& [key, element] : elements)
+    {
+      map.emplace(key, element(context, slots));
+    }
+
+    return Value{std::move(map)};
+  };
+}
+
+CompiledFunction compile(
+  CompilationState& state,
+  const UnaryExpression& expression,
+  const ExpressionNode& expressionNode)
+{
+  return [operation = expression.operation,
+          operand = compileExpression(state, expression.operand),
+          expressionNode](EvaluationContext& context, const Slots& slots) {
+    return evaluateUnaryExpression(
+      context, operation, operand(context, slots), expressionNode);
+  };
+}
+
+CompiledFunction compile(
+  CompilationState& state,
+  const BinaryExpression& expression,
+  const ExpressionNode& expressionNode)
+{
+  return [operation = expression.operation,
+          leftOperand = compileExpression(state, expression.leftOperand),
+          rightOperand = compileExpression(state, expression.rightOperand),
+          expressionNode](EvaluationContext& context, const Slots& slots) {
+    return evaluateBinaryExpression(
+      context,
+      operation,
+      [&] { return leftOperand(context, slots); },
+      [&] { return rightOperand(context, slots); },
+      expressionNode);
+  };
+}
+
+CompiledFunction compile(
+  CompilationState& state,
+  const SubscriptExpression& expression,
+  const ExpressionNode& expressionNode)
+{
+  return [leftOperand = compileExpression(state, expression.leftOperand),
+          rightOperand = compileExpression(state, expression.rightOperand),
+          expressionNode](EvaluationContext& context, const Slots& slots) {
+    return evaluateSubscript(
+      context, leftOperand(context, slots), rightOperand(context, slots), expressionNode);
+  };
+}
+
+CompiledFunction compile(
+  CompilationState& state, const SwitchExpression& expression, const ExpressionNode&)
+{
+  auto cases = expression.cases | std::views::transform([&](const auto& x) {
+                 return compileExpression(state, x);
+               })
+               | kdl::ranges::to<std::vector>();
+
+  return [cases = std::move(cases)](EvaluationContext& context, const Slots& slots) {
+    for (const auto& case_ : cases)
+    {
+      if (auto result = case_(context, slots); result != Value::Undefined)
+      {
+        return result;
+      }
+    }
+    return Value::Undefined;
+  };
+}
+
+CompiledFunction compileExpression(
+  CompilationState& state, const ExpressionNode& expressionNode)
+{
+  return expressionNode.accept([&](const auto& expression, const ExpressionNode& node) {
+    return compile(state, expression, node);
+  });
+}
+
+
 size_t precedence(const BinaryOperation operation)
 {
   switch (operation)
@@ -1432,6 +1594,19 @@ ExpressionNode ExpressionNode::optimize(EvaluationContext& context) const
     m_location};
 }
 
+CompiledExpression ExpressionNode::compile() const
+{
+  auto optimizedExpression =
+    withEvaluationContext([&](auto& context) { return this->optimize(context); })
+      .value_or(*this);
+
+  auto state = CompilationState{};
+  auto function = compileExpression(state, optimizedExpression);
+
+  return CompiledExpression{
+    std::move(optimizedExpression), std::move(state.variableNames), std::move(function)};
+}
+
 const std::optional<FileLocation>& ExpressionNode::location() const
 {
   return m_location;
@@ -18,6 +18,7 @@
  */
 
 #include "Matchers.h"
+#include "el/CompiledExpression.h"
 #include "el/ELParser.h"
 #include "el/EvaluationContext.h"
 #include "el/Exceptions.h"
@@ -1193,6 +1194,58 @@ TEST_CASE("Expression")
     }).ignore();
   }
 
+  SECTION("compile")
+  {
+    using T = std::tuple<std::string, MapType, std::vector<std::string>>;
+
+    // clang-format off
+    const auto
+    [expression,                      variables,                               expectedVariableNames] = GENERATE(values<T>({
+    {"3 + 7",                         {},                                      {}},
+    {"a",                             {{"a", Value{2.0}}},                     {"a"}},
+    {"a",                             {},                                      {"a"}},
+    {"a + a * b",                     {{"a", Value{2.0}}, {"b", Value{3.0}}},  {"a", "b"}},
+    {"[1..3, a]",                     {{"a", Value{4.0}}},                     {"a"}},
+    {"{a: 1, b: x, c: 3}",            {{"x", Value{"y"}}},                     {"x"}},
+    {"-a",                            {{"a", Value{2.0}}},                     {"a"}},
+    {"a[1]",                          {{"a", Value{"abc"}}},                   {"a"}},
+    {"false && a",                    {},                                      {}},
+    {"{{ a == 1 -> b, c }}",          {{"a", Value{1.0}}, {"b", Value{"b"}}},  {"a", "b", "c"}},
+    {"{{ a == 1 -> b, c }}",          {{"a", Value{2.0}}, {"c", Value{"c"}}},  {"a", "b", "c"}},
+    {R"({ "path": {{ spawnflags & 2 -> "a.mdl", "b.mdl" }}, "skin": skin })",
+                                      {{"spawnflags", Value{"2"}}},           {"spawnflags", "skin"}},
+    }));
+    // clang-format on
+
+    CAPTURE(expression, variables);
+
+    const auto expressionNode = ELParser::parseStrict(expression).value();
+    const auto compiledExpression = expressionNode.compile();
+
+    CHECK(compiledExpression.variableNames() == expectedVariableNames);
+    CHECK(
+      withEvaluationContext(
+        [&](auto& context) { return compiledExpression.evaluate(context); },
+        VariableTable{variables})
+      == withEvaluationContext(
+        [&](auto& context) { return expressionNode.evaluate(context); },
+        VariableTable{variables}));
+  }
+
+  SECTION("compile reports evaluation errors")
+  {
+    const auto expressionNode = ELParser::parseStrict("a * 2").value();
+    const auto compiledExpression = expressionNode.compile();
+
+    CHECK(
+      withEvaluationContext(
+        [&](auto& context) { return compiledExpression.evaluate(context); },
+        VariableTable{{{"a", Value{"x"}}}})
+      == withEvaluationContext(
+        [&](auto& context) { return expressionNode.evaluate(context); },
+        VariableTable{{{"a", Value{"x"}}}}));
+  }
+
   SECTION("accept")
   {
     CHECK(preorderVisit("1") == std::vector<std::string>{"1"});
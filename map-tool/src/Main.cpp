@@ -0,0 +1,570 @@
+/*
+ Copyright (C) 2025 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSettings>
+
+#include "Contracts.h"
+#include "Logger.h"
+#include "Macros.h"
+#include "PreferenceManager.h"
+#include "SimpleParserStatus.h"
+#include "fs/DiskIO.h"
+#include "fs/File.h"
+#include "fs/PathInfo.h"
+#include "io/ExportOptions.h"
+#include "io/MapHeader.h"
+#include "io/NodeWriter.h"
+#include "io/SystemPaths.h"
+#include "io/WorldReader.h"
+#include "mdl/BrushNode.h"
+#include "mdl/Entity.h"
+#include "mdl/EntityNode.h"
+#include "mdl/GameConfig.h"
+#include "mdl/GameInfo.h"
+#include "mdl/GameManager.h"
+#include "mdl/GroupNode.h"
+#include "mdl/Issue.h"
+#include "mdl/LayerNode.h"
+#include "mdl/Map.h"
+#include "mdl/MapFormat.h"
+#include "mdl/Map_World.h"
+#include "mdl/PatchNode.h"
+#include "mdl/Validator.h"
+#include "mdl/WorldNode.h"
+
+#include "kd/overload.h"
+#include "kd/ranges/to.h"
+#include "kd/result.h"
+#include "kd/task_manager.h"
+
+#include "vm/bbox.h"
+
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <vector>
+
+namespace tb
+{
+namespace
+{
+
+// the same bounds that the editor uses for all documents
+const auto WorldBounds = vm::bbox3d{-32768.0, 32768.0};
+
+/**
+ * Writes log messages to stderr so that stdout only contains the JSON report.
+ */
+class ConsoleLogger : public Logger
+{
+private:
+  bool m_verbose;
+
+public:
+  explicit ConsoleLogger(const bool verbose)
+    : m_verbose{verbose}
+  {
+  }
+
+private:
+  void doLog(const LogLevel level, const std::string_view message) override
+  {
+    switch (level)
+    {
+    case LogLevel::Debug:
+      if (m_verbose)
+      {
+        std::cerr << "debug: " << message << "\n";
+      }
+      break;
+    case LogLevel::Info:
+      if (m_verbose)
+      {
+        std::cerr << message << "\n";
+      }
+      break;
+    case LogLevel::Warn:
+      std::cerr << "warning: " << message << "\n";
+      break;
+    case LogLevel::Error:
+      std::cerr << "error: " << message << "\n";
+      break;
+    }
+  }
+};
+
+enum class ExportFormat
+{
+  Obj,
+  Glb,
+};
+
+struct Options
+{
+  std::optional<std::string> gameName;
+  mdl::MapFormat mapFormat = mdl::MapFormat::Unknown;
+  bool validate = false;
+  bool failOnIssues = false;
+  std::optional<mdl::MapFormat> convertFormat;
+  std::vector<ExportFormat> exportFormats;
+  std::filesystem::path outputDirectory;
+};
+
+/**
+ * Calls the given function and records its duration in milliseconds under the given
+ * name.
+ */
+template <typename F>
+auto timed(QJsonObject& timings, const QString& name, const F& function)
+{
+  const auto start = std::chrono::steady_clock::now();
+  auto result = function();
+  const auto duration = std::chrono::duration<double, std::milli>{
+    std::chrono::steady_clock::now() - start};
+  timings[name] = duration.count();
+  return result;
+}
+
+Result<std::pair<const mdl::GameInfo*, mdl::MapFormat>> detectGameAndFormat(
+  const std::filesystem::path& path,
+  const mdl::GameManager& gameManager,
+  const Options& options)
+{
+  return fs::Disk::withInputStream(path, io::readMapHeader)
+         | kdl::and_then([&](const auto& gameNameAndMapFormat) {
+             using ResultType = Result<std::pair<const mdl::GameInfo*, mdl::MapFormat>>;
+
+             const auto& [detectedGameName, detectedMapFormat] = gameNameAndMapFormat;
+             const auto gameName = options.gameName ? options.gameName : detectedGameName;
+             if (!gameName)
+             {
+               return ResultType{Error{"Could not detect game, use --game to set it"}};
+             }
+
+             const auto* gameInfo = gameManager.gameInfo(*gameName);
+             if (!gameInfo)
+             {
+               return ResultType{Error{std::format("Unknown game '{}'", *gameName)}};
+             }
+
+             const auto mapFormat = options.mapFormat != mdl::MapFormat::Unknown
+                                      ? options.mapFormat
+                                      : detectedMapFormat;
+             return ResultType{std::pair{gameInfo, mapFormat}};
+           });
+}
+
+QJsonObject countNodes(const mdl::WorldNode& worldNode)
+{
+  auto layers = 0, groups = 0, entities = 0, brushes = 0, patches = 0;
+  worldNode.accept(kdl::overload(
+    [](auto&& thisLambda, const mdl::WorldNode* node) {
+      node->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const mdl::LayerNode* node) {
+      ++layers;
+      node->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const mdl::GroupNode* node) {
+      ++groups;
+      node->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, const mdl::EntityNode* node) {
+      ++entities;
+      node->visitChildren(thisLambda);
+    },
+    [&](const mdl::BrushNode*) { ++brushes; },
+    [&](const mdl::PatchNode*) { ++patches; }));
+
+  return QJsonObject{
+    {"layers", layers},
+    {"groups", groups},
+    {"entities", entities},
+    {"brushes", brushes},
+    {"patches", patches},
+  };
+}
+
+/**
+ * Runs the validators that the editor registers on every node of the given map.
+ */
+QJsonArray validate(mdl::Map& map)
+{
+  auto& worldNode = map.worldNode();
+  const auto validators = worldNode.registeredValidators();
+
+  const auto validatorDescription = [&](const mdl::IssueType type) {
+    const auto it = std::ranges::find_if(
+      validators, [&](const auto* validator) { return validator->type() == type; });
+    return it != validators.end() ? QString::fromStdString((*it)->description())
+                                  : QString{};
+  };
+
+  auto result = QJsonArray{};
+  const auto collectIssues = [&](auto* node) {
+    for (const auto* issue : node->issues(validators))
+    {
+      result.append(QJsonObject{
+        {"line", qint64(issue->lineNumber())},
+        {"validator", validatorDescription(issue->type())},
+        {"description", QString::fromStdString(issue->description())},
+      });
+    }
+  };
+
+  worldNode.accept(kdl::overload(
+    [&](auto&& thisLambda, mdl::WorldNode* node) {
+      collectIssues(node);
+      node->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, mdl::LayerNode* node) {
+      collectIssues(node);
+      node->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, mdl::GroupNode* node) {
+      collectIssues(node);
+      node->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, mdl::EntityNode* node) {
+      collectIssues(node);
+      node->visitChildren(thisLambda);
+    },
+    [&](mdl::BrushNode* node) { collectIssues(node); },
+    [&](mdl::PatchNode* node) { collectIssues(node); }));
+
+  return result;
+}
+
+/**
+ * Parses the given map file again, converts its contents to the given format and writes
+ * the result to the given path.
+ */
+Result<void> convert(
+  const mdl::Map& map,
+  const std::filesystem::path& path,
+  const mdl::MapFormat targetMapFormat,
+  const std::filesystem::path& outputPath,
+  kdl::task_manager& taskManager,
+  Logger& logger)
+{
+  const auto& gameConfig = map.gameInfo().gameConfig;
+  const auto targetFormatName = mdl::formatName(targetMapFormat);
+  if (std::ranges::none_of(gameConfig.fileFormats, [&](const auto& formatConfig) {
+        return formatConfig.format == targetFormatName;
+      }))
+  {
+    return Error{std::format(
+      "Game '{}' does not support map format '{}'", gameConfig.name, targetFormatName)};
+  }
+
+  const auto& worldNode = map.worldNode();
+  auto parserStatus = SimpleParserStatus{logger};
+
+  return fs::Disk::openFile(path) | kdl::and_then([&](auto file) {
+           auto fileReader = file->reader().buffer();
+           auto worldReader = io::WorldReader{
+             fileReader.stringView(),
+             worldNode.mapFormat(),
+             targetMapFormat,
+             worldNode.entityPropertyConfig()};
+           return worldReader.read(map.worldBounds(), parserStatus, taskManager);
+         })
+         | kdl::and_then([&](auto convertedWorldNode) {
+             auto entity = convertedWorldNode->entity();
+             mdl::setValveVersion(entity, targetMapFormat);
+             convertedWorldNode->setEntity(std::move(entity));
+
+             return fs::Disk::withOutputStream(outputPath, [&](auto& stream) {
+               io::writeMapHeader(stream, gameConfig.name, targetMapFormat);
+
+               auto writer = io::NodeWriter{*convertedWorldNode, stream};
+               writer.setExporting(false);
+               writer.writeMap(taskManager);
+             });
+           });
+}
+
+io::ExportOptions makeExportOptions(
+  const ExportFormat exportFormat, const std::filesystem::path& outputPath)
+{
+  switch (exportFormat)
+  {
+  case ExportFormat::Obj:
+    return io::ObjExportOptions{outputPath, io::ObjMtlPathMode::RelativeToExportPath};
+  case ExportFormat::Glb:
+    return io::GltfExportOptions{outputPath};
+    switchDefault();
+  }
+}
+
+QString exportFormatName(const ExportFormat exportFormat)
+{
+  switch (exportFormat)
+  {
+  case ExportFormat::Obj:
+    return "obj";
+  case ExportFormat::Glb:
+    return "glb";
+    switchDefault();
+  }
+}
+
+Result<void> checkOutputPath(
+  const std::filesystem::path& path, const std::filesystem::path& outputPath)
+{
+  return outputPath == path
+           ? Result<void>{Error{std::format(
+               "Refusing to overwrite input file {}", path.string())}}
+           : Result<void>{};
+}
+
+/**
+ * Loads the map at the given path and runs the requested operations on it. Returns a
+ * report containing the statistics and timings of each step and any errors.
+ */
+QJsonObject processMap(
+  const std::filesystem::path& path,
+  const mdl::GameManager& gameManager,
+  const Options& options,
+  kdl::task_manager& taskManager,
+  Logger& logger,
+  bool& success)
+{
+  auto report = QJsonObject{{"path", QString::fromStdString(path.string())}};
+  auto timings = QJsonObject{};
+  auto errors = QJsonArray{};
+
+  const auto recordError = [&](const auto& e) {
+    errors.append(QString::fromStdString(e.msg));
+    success = false;
+  };
+
+  detectGameAndFormat(path, gameManager, options) | kdl::and_then([&](const auto& pair) {
+    const auto [gameInfo, mapFormat] = pair;
+    return timed(timings, "load", [&]() {
+      return mdl::Map::loadMap(
+        path, mapFormat, *gameInfo, WorldBounds, taskManager, logger);
+    });
+  }) | kdl::transform([&](auto map) {
+    report["game"] = QString::fromStdString(map->gameInfo().gameConfig.name);
+    report["format"] =
+      QString::fromStdString(mdl::formatName(map->worldNode().mapFormat()));
+    report["nodes"] = countNodes(map->worldNode());
+
+    if (options.validate)
+    {
+      const auto issues = timed(timings, "validate", [&]() { return validate(*map); });
+      report["issues"] = issues;
+      if (options.failOnIssues && !issues.isEmpty())
+      {
+        success = false;
+      }
+    }
+
+    const auto stem = path.stem().string();
+    if (options.convertFormat)
+    {
+      const auto outputPath = options.outputDirectory / (stem + ".map");
+      timed(timings, "convert", [&]() {
+        return checkOutputPath(path, outputPath) | kdl::and_then([&]() {
+                 return convert(
+                   *map, path, *options.convertFormat, outputPath, taskManager, logger);
+               });
+      }) | kdl::transform_error(recordError);
+    }
+
+    for (const auto exportFormat : options.exportFormats)
+    {
+      const auto extension = exportFormatName(exportFormat);
+      const auto outputPath =
+        options.outputDirectory / (stem + "." + extension.toStdString());
+      timed(timings, "export_" + extension, [&]() {
+        return map->exportAs(makeExportOptions(exportFormat, outputPath));
+      }) | kdl::transform_error(recordError);
+    }
+  }) | kdl::transform_error(recordError);
+
+  report["timings"] = timings;
+  report["errors"] = errors;
+  return report;
+}
+
+Result<Options> parseOptions(const QCommandLineParser& parser)
+{
+  auto options = Options{};
+
+  if (parser.isSet("game"))
+  {
+    options.gameName = parser.value("game").toStdString();
+  }
+
+  if (parser.isSet("format"))
+  {
+    options.mapFormat = mdl::formatFromName(parser.value("format").toStdString());
+    if (options.mapFormat == mdl::MapFormat::Unknown)
+    {
+      return Error{std::format(
+        "Unknown map format '{}'", parser.value("format").toStdString())};
+    }
+  }
+
+  options.validate = parser.isSet("validate") || parser.isSet("fail-on-issues");
+  options.failOnIssues = parser.isSet("fail-on-issues");
+
+  if (parser.isSet("convert"))
+  {
+    const auto mapFormat = mdl::formatFromName(parser.value("convert").toStdString());
+    if (mapFormat == mdl::MapFormat::Unknown)
+    {
+      return Error{std::format(
+        "Unknown map format '{}'", parser.value("convert").toStdString())};
+    }
+    options.convertFormat = mapFormat;
+  }
+
+  for (const auto& value : parser.values("export"))
+  {
+    if (value == "obj")
+    {
+      options.exportFormats.push_back(ExportFormat::Obj);
+    }
+    else if (value == "glb")
+    {
+      options.exportFormats.push_back(ExportFormat::Glb);
+    }
+    else
+    {
+      return Error{std::format("Unknown export format '{}'", value.toStdString())};
+    }
+  }
+
+  if (options.convertFormat || !options.exportFormats.empty())
+  {
+    if (!parser.isSet("output"))
+    {
+      return Error{"--convert and --export require --output"};
+    }
+
+    options.outputDirectory =
+      std::filesystem::absolute(parser.value("output").toStdString());
+    if (fs::Disk::pathInfo(options.outputDirectory) != fs::PathInfo::Directory)
+    {
+      return Error{std::format(
+        "Output directory {} does not exist", options.outputDirectory.string())};
+    }
+  }
+
+  if (parser.positionalArguments().isEmpty())
+  {
+    return Error{"No map files given"};
+  }
+
+  return options;
+}
+
+int run(const QCommandLineParser& parser)
+{
+  auto logger = ConsoleLogger{parser.isSet("verbose")};
+  auto taskManager = kdl::task_manager{};
+
+  return parseOptions(parser) | kdl::and_then([&](const auto& options) {
+           return mdl::initializeGameManager(
+                    io::SystemPaths::findResourceDirectories("games"),
+                    io::SystemPaths::userGamesDirectory(),
+                    logger)
+                  | kdl::transform([&](auto gameManager, const auto& warnings) {
+                      for (const auto& warning : warnings)
+                      {
+                        logger.warn() << warning;
+                      }
+
+                      auto success = true;
+                      auto maps = QJsonArray{};
+                      for (const auto& arg : parser.positionalArguments())
+                      {
+                        const auto path =
+                          std::filesystem::absolute(arg.toStdString()).lexically_normal();
+                        maps.append(processMap(
+                          path, gameManager, options, taskManager, logger, success));
+                      }
+
+                      std::cout << QJsonDocument{QJsonObject{{"maps", maps}}}
+                                     .toJson(QJsonDocument::Indented)
+                                     .toStdString();
+                      return success ? 0 : 1;
+                    });
+         })
+         | kdl::transform_error([&](const auto& e) {
+             logger.error() << e.msg;
+             return 2;
+           })
+         | kdl::value();
+}
+
+} // namespace
+} // namespace tb
+
+int main(int argc, char* argv[])
+{
+  tb::setContractViolationHandler();
+
+  QSettings::setDefaultFormat(QSettings::IniFormat);
+
+  // read the game paths and other preferences that the editor stores
+  tb::PreferenceManager::createInstance<tb::AppPreferenceManager>();
+
+  auto app = QCoreApplication{argc, argv};
+  app.setApplicationName("BrumSchtick");
+  // Needs to be "" otherwise Qt adds this to the paths returned by QStandardPaths
+  // which would cause preferences to move from where they were with wx
+  app.setOrganizationName("");
+  app.setOrganizationDomain("io.github.themuffinator");
+
+  auto parser = QCommandLineParser{};
+  parser.setApplicationDescription(
+    "Loads, validates, converts and exports map files without opening the editor. "
+    "Prints a JSON report with statistics and timings to stdout.");
+  parser.addHelpOption();
+  parser.addOptions({
+    {"game", "Game of the maps, detected from the map header if omitted.", "name"},
+    {"format", "Map format, detected from the map header if omitted.", "format"},
+    {"validate", "Run the map validators and report all issues."},
+    {"fail-on-issues", "Like --validate, but exit with an error if there are issues."},
+    {"convert", "Convert the maps to the given map format.", "format"},
+    {"export", "Export the maps as obj or glb, can be given multiple times.", "format"},
+    {"output", "Directory for converted and exported files.", "directory"},
+    {"verbose", "Print all log messages to stderr."},
+  });
+  parser.addPositionalArgument("maps", "The map files to process.", "maps...");
+  parser.process(app);
+
+  const auto result = tb::run(parser);
+
+  tb::PreferenceManager::destroyInstance();
+  return result;
+}